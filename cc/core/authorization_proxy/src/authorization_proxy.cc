@@ -15,13 +15,16 @@
  */
 #include "cc/core/authorization_proxy/src/authorization_proxy.h"
 
+#include <chrono>
 #include <memory>
 #include <string>
 #include <utility>
 
 #include <nghttp2/asio_http2_client.h>
+#include <openssl/sha.h>
 
 #include "cc/core/authorization_proxy/src/error_codes.h"
+#include "cc/core/common/time_provider/src/time_provider.h"
 #include "cc/core/common/uuid/src/uuid.h"
 #include "cc/core/interface/http_types.h"
 
@@ -29,14 +32,69 @@ static constexpr const char kAuthorizationProxy[] = "AuthorizationProxy";
 
 static constexpr int kAuthorizationCacheEntryLifetimeSeconds = 150;
 
+// After a failed background refresh, the cached entry is not refreshed again
+// for this long so that an unavailable remote does not see a refresh per hit.
+static constexpr std::chrono::seconds kAuthorizationCacheRefreshRetryInterval =
+    std::chrono::seconds(5);
+
+static constexpr char kAuthorizationProxyMeter[] = "Authorization Proxy";
+static constexpr char kAuthorizationCacheEarlyRefreshesMetric[] =
+    "authorization_proxy.cache.early_refreshes";
+static constexpr char kAuthorizationCacheFailedRefreshesMetric[] =
+    "authorization_proxy.cache.failed_refreshes";
+static constexpr char kAuthorizationCacheEvictionsMetric[] =
+    "authorization_proxy.cache.evictions";
+
+// Approximate per entry overhead of the hash map node, the shared_ptr control
+// blocks and the allocator bookkeeping that is not visible through sizeof.
+static constexpr size_t kAuthorizationCacheEntryOverheadBytes = 128;
+
 namespace privacy_sandbox::pbs_common {
 
 using boost::system::error_code;
 using nghttp2::asio_http2::host_service_from_uri;
 
-void OnBeforeGarbageCollection(std::string&,
-                               std::shared_ptr<AuthorizationProxy::CacheEntry>&,
-                               std::function<void(bool)> should_delete_entry) {
+static_assert(sizeof(AuthorizationCacheKey) == SHA256_DIGEST_LENGTH);
+
+namespace {
+size_t EstimateCacheEntrySize(const AuthorizedMetadata& authorized_metadata) {
+  size_t size =
+      sizeof(AuthorizationProxy::CacheEntry) +
+      sizeof(AuthorizationProxy::CacheMap::AutoExpiryConcurrentMapEntry) +
+      sizeof(std::pair<AuthorizationCacheKey,
+                       std::shared_ptr<AuthorizationProxy::CacheEntry>>) +
+      kAuthorizationCacheEntryOverheadBytes;
+  if (authorized_metadata.authorized_domain) {
+    size += sizeof(AuthorizedDomain) +
+            authorized_metadata.authorized_domain->capacity();
+  }
+  return size;
+}
+}  // namespace
+
+AuthorizationCacheKey AuthorizationProxy::ComputeCacheKey(
+    const AuthorizationMetadata& authorization_metadata) {
+  // The claimed identity length is hashed as well so that moving characters
+  // between the identity and the token never yields the same key.
+  uint64_t claimed_identity_size =
+      authorization_metadata.claimed_identity.size();
+  SHA256_CTX sha256;
+  SHA256_Init(&sha256);
+  SHA256_Update(&sha256, &claimed_identity_size,
+                sizeof(claimed_identity_size));
+  SHA256_Update(&sha256, authorization_metadata.claimed_identity.data(),
+                authorization_metadata.claimed_identity.size());
+  SHA256_Update(&sha256, authorization_metadata.authorization_token.data(),
+                authorization_metadata.authorization_token.size());
+  AuthorizationCacheKey key;
+  SHA256_Final(key.data(), &sha256);
+  return key;
+}
+
+void AuthorizationProxy::OnBeforeGarbageCollection(
+    AuthorizationCacheKey&, std::shared_ptr<CacheEntry>& cache_entry,
+    std::function<void(bool)> should_delete_entry) {
+  UntrackCacheEntry(*cache_entry);
   should_delete_entry(true);
 }
 
@@ -68,16 +126,68 @@ AuthorizationProxy::AuthorizationProxy(
     const std::string& server_endpoint_url,
     const std::shared_ptr<AsyncExecutorInterface>& async_executor,
     const std::shared_ptr<HttpClientInterface>& http_client,
-    std::unique_ptr<HttpRequestResponseAuthInterceptorInterface> http_helper)
+    std::unique_ptr<HttpRequestResponseAuthInterceptorInterface> http_helper,
+    AuthorizationProxyOptions options,
+    absl::Nullable<MetricRouter*> metric_router)
     : cache_(kAuthorizationCacheEntryLifetimeSeconds,
              false /* extend_entry_lifetime_on_access */,
              false /* block_entry_while_eviction */,
-             bind(&OnBeforeGarbageCollection, std::placeholders::_1,
-                  std::placeholders::_2, std::placeholders::_3),
+             bind(&AuthorizationProxy::OnBeforeGarbageCollection, this,
+                  std::placeholders::_1, std::placeholders::_2,
+                  std::placeholders::_3),
              async_executor),
+      eviction_hand_(eviction_list_.end()),
+      cache_size_bytes_(0),
       server_endpoint_uri_(make_shared<std::string>(server_endpoint_url)),
       http_client_(http_client),
-      http_helper_(std::move(http_helper)) {}
+      http_helper_(std::move(http_helper)),
+      options_(options),
+      metric_router_(metric_router) {
+  MetricInit();
+}
+
+void AuthorizationProxy::MetricInit() {
+  if (!metric_router_) {
+    return;
+  }
+  meter_ = metric_router_->GetOrCreateMeter(kAuthorizationProxyMeter);
+
+  early_refresh_counter_ =
+      std::static_pointer_cast<opentelemetry::metrics::Counter<uint64_t>>(
+          metric_router_->GetOrCreateSyncInstrument(
+              kAuthorizationCacheEarlyRefreshesMetric,
+              [&]() -> std::shared_ptr<
+                        opentelemetry::metrics::SynchronousInstrument> {
+                return meter_->CreateUInt64Counter(
+                    kAuthorizationCacheEarlyRefreshesMetric,
+                    "Number of authorization cache entries refreshed ahead "
+                    "of their expiration");
+              }));
+
+  failed_refresh_counter_ =
+      std::static_pointer_cast<opentelemetry::metrics::Counter<uint64_t>>(
+          metric_router_->GetOrCreateSyncInstrument(
+              kAuthorizationCacheFailedRefreshesMetric,
+              [&]() -> std::shared_ptr<
+                        opentelemetry::metrics::SynchronousInstrument> {
+                return meter_->CreateUInt64Counter(
+                    kAuthorizationCacheFailedRefreshesMetric,
+                    "Number of failed background authorization cache "
+                    "refreshes");
+              }));
+
+  eviction_counter_ =
+      std::static_pointer_cast<opentelemetry::metrics::Counter<uint64_t>>(
+          metric_router_->GetOrCreateSyncInstrument(
+              kAuthorizationCacheEvictionsMetric,
+              [&]() -> std::shared_ptr<
+                        opentelemetry::metrics::SynchronousInstrument> {
+                return meter_->CreateUInt64Counter(
+                    kAuthorizationCacheEvictionsMetric,
+                    "Number of authorization cache entries evicted to stay "
+                    "within the memory budget");
+              }));
+}
 
 ExecutionResult AuthorizationProxy::Authorize(
     AsyncContext<AuthorizationProxyRequest, AuthorizationProxyResponse>&
@@ -91,13 +201,10 @@ ExecutionResult AuthorizationProxy::Authorize(
     return FailureExecutionResult(SC_AUTHORIZATION_PROXY_BAD_REQUEST);
   }
 
-  // Q: Is decoded token necessary here?
   std::shared_ptr<CacheEntry> cache_entry_result;
-  // TODO Current map doesn't allow custom types i.e. AuthorizationMetadata
-  // to be part of key because there is a need to specialise std::hash template
-  // for AuthorizationMetadata, keeping string for now as the key.
-  auto key_value_pair = make_pair(request.authorization_metadata.GetKey(),
-                                  std::make_shared<CacheEntry>());
+  auto key_value_pair =
+      make_pair(ComputeCacheKey(request.authorization_metadata),
+                std::make_shared<CacheEntry>());
   auto execution_result = cache_.Insert(key_value_pair, cache_entry_result);
   if (!execution_result.Successful()) {
     if (execution_result.status_code ==
@@ -111,10 +218,17 @@ ExecutionResult AuthorizationProxy::Authorize(
     }
 
     if (cache_entry_result->is_loaded) {
+      // Avoid dirtying the cache line of hot entries on every hit.
+      if (!cache_entry_result->is_referenced.load(std::memory_order_relaxed)) {
+        cache_entry_result->is_referenced.store(true,
+                                                std::memory_order_relaxed);
+      }
       authorization_context.response =
           std::make_shared<AuthorizationProxyResponse>();
       authorization_context.response->authorized_metadata =
-          cache_entry_result->authorized_metadata;
+          *cache_entry_result->GetAuthorizedMetadata();
+      MaybeRefreshCacheEntry(authorization_context, key_value_pair.first,
+                             cache_entry_result);
       authorization_context.result = SuccessExecutionResult();
       authorization_context.Finish();
       return SuccessExecutionResult();
@@ -134,6 +248,7 @@ ExecutionResult AuthorizationProxy::Authorize(
   http_request->method = HttpMethod::POST;
   http_request->path = server_endpoint_uri_;
   http_request->headers = std::make_shared<HttpHeaders>();
+  http_request->is_idempotent = true;
 
   execution_result = http_helper_->PrepareRequest(
       request.authorization_metadata, *http_request);
@@ -161,7 +276,7 @@ ExecutionResult AuthorizationProxy::Authorize(
 void AuthorizationProxy::HandleAuthorizeResponse(
     AsyncContext<AuthorizationProxyRequest, AuthorizationProxyResponse>&
         authorization_context,
-    std::string& cache_entry_key,
+    AuthorizationCacheKey& cache_entry_key,
     AsyncContext<HttpRequest, HttpResponse>& http_context) {
   if (!http_context.result.Successful()) {
     cache_.Erase(cache_entry_key);
@@ -193,18 +308,199 @@ void AuthorizationProxy::HandleAuthorizeResponse(
                       "Cannot find the cached entry.");
     authorization_context.result = SuccessExecutionResult();
     authorization_context.Finish();
+    return;
   }
 
-  cache_entry->authorized_metadata =
-      authorization_context.response->authorized_metadata;
+  cache_entry->SetAuthorizedMetadata(
+      authorization_context.response->authorized_metadata);
+  cache_entry->refresh_after_timestamp = GetRefreshAfterTimestamp();
   cache_entry->is_loaded = true;
+  TrackCacheEntry(cache_entry_key, cache_entry);
 
   execution_result = cache_.EnableEviction(cache_entry_key);
   if (!execution_result.Successful()) {
+    UntrackCacheEntry(*cache_entry);
     cache_.Erase(cache_entry_key);
   }
 
   authorization_context.result = SuccessExecutionResult();
   authorization_context.Finish();
 }
+
+void AuthorizationProxy::MaybeRefreshCacheEntry(
+    AsyncContext<AuthorizationProxyRequest, AuthorizationProxyResponse>&
+        authorization_context,
+    const AuthorizationCacheKey& cache_entry_key,
+    const std::shared_ptr<CacheEntry>& cache_entry) {
+  if (options_.refresh_ahead_fraction >= 1 ||
+      TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks() <
+          cache_entry->refresh_after_timestamp.load()) {
+    return;
+  }
+
+  // Only one refresh per entry at a time.
+  bool is_refreshing = false;
+  if (!cache_entry->is_refreshing.compare_exchange_strong(is_refreshing,
+                                                          true)) {
+    return;
+  }
+
+  auto http_request = std::make_shared<HttpRequest>();
+  http_request->method = HttpMethod::POST;
+  http_request->path = server_endpoint_uri_;
+  http_request->headers = std::make_shared<HttpHeaders>();
+  http_request->is_idempotent = true;
+
+  auto execution_result = http_helper_->PrepareRequest(
+      authorization_context.request->authorization_metadata, *http_request);
+  if (!execution_result.Successful()) {
+    OnRefreshFailed(*cache_entry);
+    return;
+  }
+
+  if (early_refresh_counter_) {
+    early_refresh_counter_->Add(1);
+  }
+
+  // The refresh outlives the request that triggered it, so it is not
+  // parented to it and gets its own correlation id.
+  AsyncContext<HttpRequest, HttpResponse> http_context(
+      std::move(http_request),
+      bind(&AuthorizationProxy::HandleRefreshResponse, this,
+           authorization_context.request, cache_entry_key, cache_entry,
+           std::placeholders::_1),
+      kZeroUuid, Uuid::GenerateUuid());
+  execution_result = http_client_->PerformRequest(http_context);
+  if (!execution_result.Successful()) {
+    OnRefreshFailed(*cache_entry);
+  }
+}
+
+void AuthorizationProxy::HandleRefreshResponse(
+    std::shared_ptr<AuthorizationProxyRequest>& request,
+    AuthorizationCacheKey& cache_entry_key,
+    std::shared_ptr<CacheEntry>& cache_entry,
+    AsyncContext<HttpRequest, HttpResponse>& http_context) {
+  if (!http_context.result.Successful()) {
+    SCP_DEBUG_CONTEXT(kAuthorizationProxy, http_context,
+                      "Background refresh of the cached entry failed.");
+    OnRefreshFailed(*cache_entry);
+    return;
+  }
+
+  auto metadata_or = http_helper_->ObtainAuthorizedMetadataFromResponse(
+      request->authorization_metadata, *(http_context.response));
+  if (!metadata_or.Successful()) {
+    SCP_DEBUG_CONTEXT(kAuthorizationProxy, http_context,
+                      "Background refresh of the cached entry failed to "
+                      "parse the remote response.");
+    OnRefreshFailed(*cache_entry);
+    return;
+  }
+
+  size_t size_bytes = EstimateCacheEntrySize(*metadata_or);
+  cache_entry->SetAuthorizedMetadata(std::move(*metadata_or));
+  ResizeCacheEntry(*cache_entry, size_bytes);
+  cache_entry->refresh_after_timestamp = GetRefreshAfterTimestamp();
+  // If the entry is already being evicted, the next request simply reloads it.
+  cache_.ResetExpiration(cache_entry_key);
+  cache_entry->is_refreshing = false;
+  EvictCacheEntriesOverBudget();
+}
+
+void AuthorizationProxy::OnRefreshFailed(CacheEntry& cache_entry) {
+  if (failed_refresh_counter_) {
+    failed_refresh_counter_->Add(1);
+  }
+  // The cached result keeps being served until the entry expires.
+  cache_entry.refresh_after_timestamp =
+      (TimeProvider::GetSteadyTimestampInNanoseconds() +
+       kAuthorizationCacheRefreshRetryInterval)
+          .count();
+  cache_entry.is_refreshing = false;
+}
+
+Timestamp AuthorizationProxy::GetRefreshAfterTimestamp() const {
+  return (TimeProvider::GetSteadyTimestampInNanoseconds() +
+          std::chrono::duration_cast<std::chrono::nanoseconds>(
+              std::chrono::duration<double>(
+                  kAuthorizationCacheEntryLifetimeSeconds *
+                  options_.refresh_ahead_fraction)))
+      .count();
+}
+
+void AuthorizationProxy::TrackCacheEntry(
+    const AuthorizationCacheKey& cache_entry_key,
+    const std::shared_ptr<CacheEntry>& cache_entry) {
+  {
+    std::lock_guard<std::mutex> lock(eviction_mutex_);
+    if (cache_entry->is_tracked) {
+      return;
+    }
+    // New entries are inserted right behind the hand so that they are the
+    // last ones to be considered for eviction.
+    cache_entry->eviction_position = eviction_list_.emplace(
+        eviction_hand_, cache_entry_key, cache_entry);
+    cache_entry->is_tracked = true;
+    cache_entry->size_bytes =
+        EstimateCacheEntrySize(*cache_entry->GetAuthorizedMetadata());
+    cache_size_bytes_ += cache_entry->size_bytes;
+  }
+  EvictCacheEntriesOverBudget();
+}
+
+void AuthorizationProxy::UntrackCacheEntry(CacheEntry& cache_entry) {
+  std::lock_guard<std::mutex> lock(eviction_mutex_);
+  if (!cache_entry.is_tracked) {
+    return;
+  }
+  if (eviction_hand_ == cache_entry.eviction_position) {
+    ++eviction_hand_;
+  }
+  eviction_list_.erase(cache_entry.eviction_position);
+  cache_entry.is_tracked = false;
+  cache_size_bytes_ -= cache_entry.size_bytes;
+}
+
+void AuthorizationProxy::ResizeCacheEntry(CacheEntry& cache_entry,
+                                          size_t size_bytes) {
+  std::lock_guard<std::mutex> lock(eviction_mutex_);
+  if (cache_entry.is_tracked) {
+    // Added before subtracting so that the total never goes below zero.
+    cache_size_bytes_ += size_bytes;
+    cache_size_bytes_ -= cache_entry.size_bytes;
+  }
+  cache_entry.size_bytes = size_bytes;
+}
+
+void AuthorizationProxy::EvictCacheEntriesOverBudget() {
+  if (cache_size_bytes_.load() <= options_.max_cache_size_bytes) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(eviction_mutex_);
+  // Two rounds are enough to clear every reference bit once and evict.
+  size_t remaining_steps = 2 * eviction_list_.size();
+  while (cache_size_bytes_.load() > options_.max_cache_size_bytes &&
+         remaining_steps-- > 0) {
+    if (eviction_hand_ == eviction_list_.end()) {
+      eviction_hand_ = eviction_list_.begin();
+    }
+    auto& [cache_entry_key, cache_entry] = *eviction_hand_;
+    if (cache_entry->is_referenced.exchange(false) ||
+        cache_entry->is_refreshing.load()) {
+      ++eviction_hand_;
+      continue;
+    }
+
+    auto cache_entry_key_to_erase = cache_entry_key;
+    cache_entry->is_tracked = false;
+    cache_size_bytes_ -= cache_entry->size_bytes;
+    eviction_hand_ = eviction_list_.erase(eviction_hand_);
+    cache_.Erase(cache_entry_key_to_erase);
+    if (eviction_counter_) {
+      eviction_counter_->Add(1);
+    }
+  }
+}
 }  // namespace privacy_sandbox::pbs_common
@@ -16,27 +16,144 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <list>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <utility>
 
+#include "absl/base/nullability.h"
 #include "cc/core/common/auto_expiry_concurrent_map/src/auto_expiry_concurrent_map.h"
 #include "cc/core/interface/authorization_proxy_interface.h"
 #include "cc/core/interface/http_client_interface.h"
 #include "cc/core/interface/http_request_response_auth_interceptor_interface.h"
+#include "cc/core/telemetry/src/metric/metric_router.h"
+#include "opentelemetry/metrics/meter.h"
+#include "opentelemetry/metrics/sync_instruments.h"
 
 namespace privacy_sandbox::pbs_common {
 
+/// Default fraction of the cache entry lifetime after which a cache hit
+/// triggers a background re-authorization of the entry.
+static constexpr double kDefaultAuthorizationCacheRefreshAheadFraction = 0.8;
+
+/// Default memory budget of the authorization cache.
+static constexpr size_t kDefaultAuthorizationCacheMaxSizeBytes =
+    256 * 1024 * 1024;
+
+struct AuthorizationProxyOptions {
+  AuthorizationProxyOptions()
+      : refresh_ahead_fraction(kDefaultAuthorizationCacheRefreshAheadFraction),
+        max_cache_size_bytes(kDefaultAuthorizationCacheMaxSizeBytes) {}
+
+  explicit AuthorizationProxyOptions(
+      double refresh_ahead_fraction,
+      size_t max_cache_size_bytes = kDefaultAuthorizationCacheMaxSizeBytes)
+      : refresh_ahead_fraction(refresh_ahead_fraction),
+        max_cache_size_bytes(max_cache_size_bytes) {}
+
+  /// Once a cached entry has lived for this fraction of its lifetime, the next
+  /// cache hit re-authorizes it in the background while the cached result
+  /// keeps being served. A value of 1 or above disables the early refresh.
+  const double refresh_ahead_fraction;
+  /// The approximate memory the cached entries may use. Once exceeded, the
+  /// least recently used entries are evicted (CLOCK approximation).
+  const size_t max_cache_size_bytes;
+};
+
+/// The authorization cache key, a SHA-256 digest of the claimed identity and
+/// the authorization token. Keeps lookups and memory independent of the token
+/// size.
+using AuthorizationCacheKey = std::array<uint8_t, 32>;
+
+/// Hash compare for AuthorizationCacheKey. The key is a cryptographic digest,
+/// so any of its words is already a well distributed hash.
+struct AuthorizationCacheKeyHashCompare {
+  size_t hash(const AuthorizationCacheKey& key) const {
+    size_t hash;
+    std::memcpy(&hash, key.data(), sizeof(hash));
+    return hash;
+  }
+
+  bool equal(const AuthorizationCacheKey& left,
+             const AuthorizationCacheKey& right) const {
+    return left == right;
+  }
+};
+
 class AuthorizationProxy : public AuthorizationProxyInterface {
  public:
   struct CacheEntry : public LoadableObject {
-    AuthorizedMetadata authorized_metadata;
+    CacheEntry()
+        : refresh_after_timestamp(0),
+          is_refreshing(false),
+          is_referenced(false),
+          is_tracked(false),
+          size_bytes(0) {}
+
+    /**
+     * @brief Returns the authorized metadata of a loaded entry. Must be used
+     * instead of reading authorized_metadata directly, since a background
+     * refresh may replace it concurrently. Hits never take a lock.
+     */
+    std::shared_ptr<const AuthorizedMetadata> GetAuthorizedMetadata() const {
+      return authorized_metadata.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Publishes the authorized metadata of the entry.
+     */
+    void SetAuthorizedMetadata(AuthorizedMetadata metadata) {
+      authorized_metadata.store(
+          std::make_shared<const AuthorizedMetadata>(std::move(metadata)),
+          std::memory_order_release);
+    }
+
+    /// Immutable once published, replaced as a whole on refresh. Null until
+    /// the entry is loaded.
+    std::atomic<std::shared_ptr<const AuthorizedMetadata>> authorized_metadata;
+    /// Steady clock timestamp after which a cache hit refreshes the entry.
+    std::atomic<Timestamp> refresh_after_timestamp;
+    /// Indicates whether a background refresh of the entry is in progress.
+    std::atomic<bool> is_refreshing;
+    /// Set on every cache hit and cleared by the eviction sweep.
+    std::atomic<bool> is_referenced;
+    /// Indicates whether the entry is accounted in the eviction list. Guarded
+    /// by eviction_mutex_.
+    bool is_tracked;
+    /// Position of the entry in the eviction list, valid while is_tracked.
+    std::list<std::pair<AuthorizationCacheKey,
+                        std::shared_ptr<CacheEntry>>>::iterator
+        eviction_position;
+    /// The approximate memory used by the entry.
+    size_t size_bytes;
   };
 
+  using CacheMap = AutoExpiryConcurrentMap<AuthorizationCacheKey,
+                                           std::shared_ptr<CacheEntry>,
+                                           AuthorizationCacheKeyHashCompare>;
+
+  /**
+   * @brief Constructs a new AuthorizationProxy.
+   *
+   * @param server_endpoint The remote authorization endpoint URI.
+   * @param async_executor The async executor used by the cache.
+   * @param http_client The http client to send remote requests with.
+   * @param http_helper The cloud specific request/response interceptor.
+   * @param options The authorization cache options.
+   * @param metric_router An optional metric router to emit cache metrics to.
+   */
   AuthorizationProxy(
       const std::string& server_endpoint,
       const std::shared_ptr<AsyncExecutorInterface>& async_executor,
       const std::shared_ptr<HttpClientInterface>& http_client,
-      std::unique_ptr<HttpRequestResponseAuthInterceptorInterface> http_helper);
+      std::unique_ptr<HttpRequestResponseAuthInterceptorInterface> http_helper,
+      AuthorizationProxyOptions options = AuthorizationProxyOptions(),
+      absl::Nullable<MetricRouter*> metric_router = nullptr);
 
   ExecutionResult Init() noexcept override;
 
@@ -48,6 +165,17 @@ class AuthorizationProxy : public AuthorizationProxyInterface {
       AsyncContext<AuthorizationProxyRequest,
                    AuthorizationProxyResponse>&) noexcept override;
 
+  /**
+   * @brief Computes the cache key of the authorization metadata.
+   */
+  static AuthorizationCacheKey ComputeCacheKey(
+      const AuthorizationMetadata& authorization_metadata);
+
+  /**
+   * @brief Returns the approximate memory used by the loaded cache entries.
+   */
+  size_t GetCacheSizeBytes() const { return cache_size_bytes_.load(); }
+
  protected:
   /**
    * @brief The handler when performing HttpClient operations.
@@ -60,11 +188,105 @@ class AuthorizationProxy : public AuthorizationProxyInterface {
   void HandleAuthorizeResponse(
       AsyncContext<AuthorizationProxyRequest, AuthorizationProxyResponse>&
           authorization_context,
-      std::string& cache_entry_key,
+      AuthorizationCacheKey& cache_entry_key,
       AsyncContext<HttpRequest, HttpResponse>& http_context);
 
+  /**
+   * @brief Starts a background re-authorization of a loaded cache entry if it
+   * is due for refresh and no other refresh is in progress. The caller keeps
+   * being served from the cached entry.
+   *
+   * @param authorization_context The authorization context that hit the
+   * entry.
+   * @param cache_entry_key key of the entry
+   * @param cache_entry The cached entry.
+   */
+  void MaybeRefreshCacheEntry(
+      AsyncContext<AuthorizationProxyRequest, AuthorizationProxyResponse>&
+          authorization_context,
+      const AuthorizationCacheKey& cache_entry_key,
+      const std::shared_ptr<CacheEntry>& cache_entry);
+
+  /**
+   * @brief The handler of the background re-authorization request.
+   *
+   * @param request The authorization request the refresh was issued for.
+   * @param cache_entry_key key of the entry
+   * @param cache_entry The cached entry being refreshed.
+   * @param http_context
+   */
+  void HandleRefreshResponse(
+      std::shared_ptr<AuthorizationProxyRequest>& request,
+      AuthorizationCacheKey& cache_entry_key,
+      std::shared_ptr<CacheEntry>& cache_entry,
+      AsyncContext<HttpRequest, HttpResponse>& http_context);
+
+  /**
+   * @brief Marks a refresh of the cache entry as failed. The cached result
+   * keeps being served until the entry expires.
+   */
+  void OnRefreshFailed(CacheEntry& cache_entry);
+
+  /**
+   * @brief Returns the steady clock timestamp after which an entry loaded now
+   * should be refreshed.
+   */
+  Timestamp GetRefreshAfterTimestamp() const;
+
+  /**
+   * @brief Creates the otel instruments of the authorization cache.
+   */
+  void MetricInit();
+
+  /**
+   * @brief Accounts a freshly loaded entry and evicts entries if the cache
+   * went over its memory budget.
+   */
+  void TrackCacheEntry(const AuthorizationCacheKey& cache_entry_key,
+                       const std::shared_ptr<CacheEntry>& cache_entry);
+
+  /**
+   * @brief Removes an entry from the memory accounting. Must be called before
+   * a loaded entry is removed from the cache.
+   */
+  void UntrackCacheEntry(CacheEntry& cache_entry);
+
+  /**
+   * @brief Updates the memory accounting of an entry whose authorized metadata
+   * was refreshed.
+   */
+  void ResizeCacheEntry(CacheEntry& cache_entry, size_t size_bytes);
+
+  /**
+   * @brief Evicts the least recently used entries until the cache fits into
+   * its memory budget.
+   */
+  void EvictCacheEntriesOverBudget();
+
+  /**
+   * @brief Called by the cache right before an expired entry is removed.
+   */
+  void OnBeforeGarbageCollection(AuthorizationCacheKey& cache_entry_key,
+                                 std::shared_ptr<CacheEntry>& cache_entry,
+                                 std::function<void(bool)> should_delete_entry);
+
   /// The authorization token cache.
-  AutoExpiryConcurrentMap<std::string, std::shared_ptr<CacheEntry>> cache_;
+  CacheMap cache_;
+
+  /// Loaded cache entries in CLOCK order. Every entry gets a second chance if
+  /// it was hit since the eviction hand last passed it.
+  std::list<std::pair<AuthorizationCacheKey, std::shared_ptr<CacheEntry>>>
+      eviction_list_;
+
+  /// The CLOCK hand into eviction_list_.
+  std::list<std::pair<AuthorizationCacheKey,
+                      std::shared_ptr<CacheEntry>>>::iterator eviction_hand_;
+
+  /// Protects eviction_list_, eviction_hand_ and the entries' tracking state.
+  std::mutex eviction_mutex_;
+
+  /// The approximate memory used by the loaded cache entries.
+  std::atomic<size_t> cache_size_bytes_;
 
   /// The remote authorization end point URI
   /// Ex: http://localhost:65534/endpoint
@@ -78,5 +300,26 @@ class AuthorizationProxy : public AuthorizationProxyInterface {
 
   /// Request Response helper for HTTP
   std::unique_ptr<HttpRequestResponseAuthInterceptorInterface> http_helper_;
+
+  /// The authorization cache options.
+  const AuthorizationProxyOptions options_;
+
+  /// An instance of metric router which will provide APIs to create metrics.
+  MetricRouter* metric_router_;
+
+  /// OpenTelemetry Meter used for creating and managing metrics.
+  std::shared_ptr<opentelemetry::metrics::Meter> meter_;
+
+  /// Number of cache entries re-authorized ahead of their expiration.
+  std::shared_ptr<opentelemetry::metrics::Counter<uint64_t>>
+      early_refresh_counter_;
+
+  /// Number of background re-authorizations that failed.
+  std::shared_ptr<opentelemetry::metrics::Counter<uint64_t>>
+      failed_refresh_counter_;
+
+  /// Number of cache entries evicted to stay within the memory budget.
+  std::shared_ptr<opentelemetry::metrics::Counter<uint64_t>>
+      eviction_counter_;
 };
 }  // namespace privacy_sandbox::pbs_common
@@ -0,0 +1,156 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <unistd.h>
+
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "cc/core/async_executor/src/async_executor.h"
+#include "cc/core/authorization_proxy/src/authorization_proxy.h"
+#include "cc/core/interface/async_context.h"
+#include "cc/core/interface/http_client_interface.h"
+#include "cc/core/interface/http_request_response_auth_interceptor_interface.h"
+
+namespace privacy_sandbox::pbs_common {
+namespace {
+
+// A typical base64 encoded token size.
+constexpr size_t kTokenSizeBytes = 2048;
+
+// Number of distinct cached identities looked up in the timed loop.
+constexpr size_t kLookedUpIdentities = 1024;
+
+// Completes every request synchronously with an empty response.
+class FakeHttpClient : public HttpClientInterface {
+ public:
+  ExecutionResult Init() noexcept override { return SuccessExecutionResult(); }
+
+  ExecutionResult Run() noexcept override { return SuccessExecutionResult(); }
+
+  ExecutionResult Stop() noexcept override { return SuccessExecutionResult(); }
+
+  ExecutionResult PerformRequest(
+      AsyncContext<HttpRequest, HttpResponse>& http_context) noexcept override {
+    http_context.response = std::make_shared<HttpResponse>();
+    http_context.result = SuccessExecutionResult();
+    http_context.Finish();
+    return SuccessExecutionResult();
+  }
+};
+
+class FakeAuthInterceptor : public HttpRequestResponseAuthInterceptorInterface {
+ public:
+  ExecutionResult PrepareRequest(const AuthorizationMetadata&,
+                                 HttpRequest&) override {
+    return SuccessExecutionResult();
+  }
+
+  ExecutionResultOr<AuthorizedMetadata> ObtainAuthorizedMetadataFromResponse(
+      const AuthorizationMetadata&, const HttpResponse&) override {
+    return AuthorizedMetadata{
+        std::make_shared<AuthorizedDomain>("https://origin.example.com")};
+  }
+};
+
+size_t GetResidentMemoryBytes() {
+  size_t total_pages = 0;
+  size_t resident_pages = 0;
+  std::ifstream statm("/proc/self/statm");
+  statm >> total_pages >> resident_pages;
+  return resident_pages * sysconf(_SC_PAGESIZE);
+}
+
+std::shared_ptr<AuthorizationProxyRequest> MakeRequest(size_t identity) {
+  auto request = std::make_shared<AuthorizationProxyRequest>();
+  request->authorization_metadata.claimed_identity = "origin.example.com";
+  request->authorization_metadata.authorization_token =
+      std::to_string(identity) + std::string(kTokenSizeBytes, 'a');
+  return request;
+}
+
+void Authorize(AuthorizationProxy& proxy,
+               const std::shared_ptr<AuthorizationProxyRequest>& request) {
+  AsyncContext<AuthorizationProxyRequest, AuthorizationProxyResponse> context;
+  context.request = request;
+  benchmark::DoNotOptimize(proxy.Authorize(context));
+}
+
+// Looks up cached identities with state.range(0) identities in the cache.
+void BM_AuthorizeCacheHit(benchmark::State& state) {
+  auto async_executor = std::make_shared<AsyncExecutor>(2, 1000);
+  async_executor->Init();
+  async_executor->Run();
+  AuthorizationProxy proxy(
+      "http://localhost:65534/endpoint", async_executor,
+      std::make_shared<FakeHttpClient>(),
+      std::make_unique<FakeAuthInterceptor>(),
+      AuthorizationProxyOptions(kDefaultAuthorizationCacheRefreshAheadFraction,
+                                std::numeric_limits<size_t>::max()));
+  proxy.Init();
+  proxy.Run();
+
+  const size_t identities = state.range(0);
+  size_t resident_memory_before = GetResidentMemoryBytes();
+  for (size_t identity = 0; identity < identities; ++identity) {
+    Authorize(proxy, MakeRequest(identity));
+  }
+  size_t resident_memory_after = GetResidentMemoryBytes();
+
+  std::vector<std::shared_ptr<AuthorizationProxyRequest>> requests;
+  for (size_t i = 0; i < kLookedUpIdentities; ++i) {
+    requests.push_back(MakeRequest(i * identities / kLookedUpIdentities));
+  }
+
+  size_t i = 0;
+  for (auto _ : state) {
+    Authorize(proxy, requests[i++ % kLookedUpIdentities]);
+  }
+
+  state.counters["cache_bytes"] = proxy.GetCacheSizeBytes();
+  state.counters["rss_growth_bytes"] =
+      resident_memory_after - resident_memory_before;
+  state.counters["rss_bytes_per_identity"] =
+      static_cast<double>(resident_memory_after - resident_memory_before) /
+      identities;
+
+  proxy.Stop();
+  async_executor->Stop();
+}
+
+// Cost of the cache key computation alone.
+void BM_ComputeCacheKey(benchmark::State& state) {
+  auto request = MakeRequest(0);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        AuthorizationProxy::ComputeCacheKey(request->authorization_metadata));
+  }
+}
+
+BENCHMARK(BM_AuthorizeCacheHit)
+    ->RangeMultiplier(32)
+    ->Range(1 << 10, 1 << 20)
+    ->Unit(benchmark::kNanosecond);
+BENCHMARK(BM_ComputeCacheKey);
+
+}  // namespace
+}  // namespace privacy_sandbox::pbs_common
+
+// Run the benchmark.
+BENCHMARK_MAIN();
@@ -19,15 +19,20 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <map>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "cc/core/async_executor/src/async_executor.h"
 #include "cc/core/authorization_proxy/src/error_codes.h"
 #include "cc/core/interface/async_context.h"
 #include "cc/core/interface/http_client_interface.h"
 #include "cc/core/interface/http_request_response_auth_interceptor_interface.h"
+#include "cc/core/telemetry/mock/in_memory_metric_router.h"
+#include "cc/core/telemetry/src/common/metric_utils.h"
 #include "cc/core/test/utils/conditional_wait.h"
 #include "cc/public/core/test/interface/execution_result_matchers.h"
 
@@ -37,6 +42,9 @@ namespace {
 using ::testing::_;
 using ::testing::Return;
 
+// Refreshes cache entries on the first hit after they are loaded.
+constexpr double kRefreshOnEveryHitFraction = 0.0;
+
 class HttpRequestResponseAuthInterceptorMock
     : public HttpRequestResponseAuthInterceptorInterface {
  public:
@@ -445,5 +453,337 @@ TEST_F(AuthorizationProxyTest,
     WaitUntil([&]() { return request_finished.load(); });
   }
 }
+
+TEST_F(AuthorizationProxyTest, CacheHitRefreshesEntryInBackground) {
+  auto authorization_http_helper =
+      std::make_unique<HttpRequestResponseAuthInterceptorMock>();
+
+  HttpRequestResponseAuthInterceptorMock* authorization_http_helper_mock =
+      authorization_http_helper.get();
+
+  AuthorizationProxy proxy(
+      server_endpoint_, async_executor_, mock_http_client_,
+      std::move(authorization_http_helper),
+      AuthorizationProxyOptions(kRefreshOnEveryHitFraction));
+  EXPECT_SUCCESS(proxy.Init());
+  EXPECT_SUCCESS(proxy.Run());
+
+  EXPECT_CALL(*authorization_http_helper_mock, PrepareRequest(_, _))
+      .Times(2)
+      .WillRepeatedly(Return(SuccessExecutionResult()));
+
+  // The refresh request is held until the cached answer has been served.
+  std::atomic<bool> refresh_requested(false);
+  std::shared_ptr<AsyncContext<HttpRequest, HttpResponse>> refresh_context;
+  EXPECT_CALL(*mock_http_client_, PerformRequest)
+      .WillOnce([](AsyncContext<HttpRequest, HttpResponse>& context) {
+        context.result = SuccessExecutionResult();
+        context.Finish();
+        return SuccessExecutionResult();
+      })
+      .WillOnce([&](AsyncContext<HttpRequest, HttpResponse>& context) {
+        refresh_context =
+            std::make_shared<AsyncContext<HttpRequest, HttpResponse>>(context);
+        refresh_requested = true;
+        return SuccessExecutionResult();
+      });
+
+  // Longer than the loaded domain, so that the entry grows on refresh.
+  auto refreshed_domain = std::make_shared<std::string>(
+      "refreshed-into-a-domain-longer-than-the-loaded-one.com");
+  EXPECT_CALL(*authorization_http_helper_mock,
+              ObtainAuthorizedMetadataFromResponse(_, _))
+      .WillOnce(
+          Return(AuthorizedMetadata{authorized_metadata_.authorized_domain}))
+      .WillOnce(Return(AuthorizedMetadata{refreshed_domain}));
+
+  auto authorize = [&](const std::string& expected_domain) {
+    std::atomic<bool> request_finished(false);
+    AsyncContext<AuthorizationProxyRequest, AuthorizationProxyResponse>
+        authorization_request;
+    authorization_request.request =
+        std::make_shared<AuthorizationProxyRequest>();
+    authorization_request.request->authorization_metadata =
+        authorization_metadata_;
+    authorization_request.callback = [&](auto context) {
+      EXPECT_SUCCESS(context.result);
+      EXPECT_EQ(*context.response->authorized_metadata.authorized_domain,
+                expected_domain);
+      request_finished = true;
+    };
+    EXPECT_SUCCESS(proxy.Authorize(authorization_request));
+    WaitUntil([&]() { return request_finished.load(); });
+  };
+
+  // Loads the entry.
+  authorize(*authorized_metadata_.authorized_domain);
+  size_t loaded_size_bytes = proxy.GetCacheSizeBytes();
+  // Served from the cache while the refresh is in flight.
+  authorize(*authorized_metadata_.authorized_domain);
+  WaitUntil([&]() { return refresh_requested.load(); });
+  authorize(*authorized_metadata_.authorized_domain);
+  // The refresh outlives the hit that triggered it, so it is a root context.
+  EXPECT_EQ(refresh_context->parent_activity_id, kZeroUuid);
+  EXPECT_NE(refresh_context->correlation_id, kZeroUuid);
+
+  refresh_context->response = std::make_shared<HttpResponse>();
+  refresh_context->result = SuccessExecutionResult();
+  refresh_context->Finish();
+
+  // The refreshed answer replaces the cached one. This hit triggers another
+  // refresh, which is left pending.
+  EXPECT_CALL(*authorization_http_helper_mock, PrepareRequest(_, _))
+      .WillOnce(Return(FailureExecutionResult(123)));
+  authorize(*refreshed_domain);
+  // The memory accounting follows the refreshed answer.
+  EXPECT_EQ(proxy.GetCacheSizeBytes(),
+            loaded_size_bytes + refreshed_domain->capacity() -
+                authorized_metadata_.authorized_domain->capacity());
+}
+
+TEST_F(AuthorizationProxyTest, FailedRefreshKeepsServingCachedEntry) {
+  auto metric_router = std::make_unique<InMemoryMetricRouter>();
+  auto authorization_http_helper =
+      std::make_unique<HttpRequestResponseAuthInterceptorMock>();
+
+  HttpRequestResponseAuthInterceptorMock* authorization_http_helper_mock =
+      authorization_http_helper.get();
+
+  AuthorizationProxy proxy(
+      server_endpoint_, async_executor_, mock_http_client_,
+      std::move(authorization_http_helper),
+      AuthorizationProxyOptions(kRefreshOnEveryHitFraction),
+      metric_router.get());
+  EXPECT_SUCCESS(proxy.Init());
+  EXPECT_SUCCESS(proxy.Run());
+
+  EXPECT_CALL(*authorization_http_helper_mock, PrepareRequest(_, _))
+      .Times(2)
+      .WillRepeatedly(Return(SuccessExecutionResult()));
+
+  std::atomic<size_t> remote_calls(0);
+  EXPECT_CALL(*mock_http_client_, PerformRequest)
+      .Times(2)
+      .WillRepeatedly([&](AsyncContext<HttpRequest, HttpResponse>& context) {
+        // The refresh fails remotely.
+        context.result = remote_calls++ == 0 ? SuccessExecutionResult()
+                                             : FailureExecutionResult(123);
+        context.Finish();
+        return SuccessExecutionResult();
+      });
+
+  EXPECT_CALL(*authorization_http_helper_mock,
+              ObtainAuthorizedMetadataFromResponse(_, _))
+      .WillOnce(
+          Return(AuthorizedMetadata{authorized_metadata_.authorized_domain}));
+
+  // The first request loads the entry, the second one triggers the failing
+  // refresh and the rest are served from the cache without retrying the
+  // refresh right away.
+  for (int i = 0; i < 4; i++) {
+    std::atomic<bool> request_finished(false);
+    AsyncContext<AuthorizationProxyRequest, AuthorizationProxyResponse>
+        authorization_request;
+    authorization_request.request =
+        std::make_shared<AuthorizationProxyRequest>();
+    authorization_request.request->authorization_metadata =
+        authorization_metadata_;
+    authorization_request.callback = [&](auto context) {
+      EXPECT_SUCCESS(context.result);
+      EXPECT_EQ(*context.response->authorized_metadata.authorized_domain,
+                *authorized_metadata_.authorized_domain);
+      request_finished = true;
+    };
+    EXPECT_SUCCESS(proxy.Authorize(authorization_request));
+    WaitUntil([&]() { return request_finished.load(); });
+  }
+
+  std::vector<opentelemetry::sdk::metrics::ResourceMetrics> data =
+      metric_router->GetExportedData();
+  const std::map<std::string, std::string> no_labels;
+  const opentelemetry::sdk::common::OrderedAttributeMap dimensions(
+      (opentelemetry::common::KeyValueIterableView<
+          std::map<std::string, std::string>>(no_labels)));
+
+  for (const char* metric_name :
+       {"authorization_proxy.cache.early_refreshes",
+        "authorization_proxy.cache.failed_refreshes"}) {
+    std::optional<opentelemetry::sdk::metrics::PointType> point_data =
+        GetMetricPointData(metric_name, dimensions, data);
+    ASSERT_TRUE(point_data.has_value()) << metric_name;
+    auto sum_point_data =
+        std::get<opentelemetry::sdk::metrics::SumPointData>(*point_data);
+    EXPECT_EQ(std::get<int64_t>(sum_point_data.value_), 1) << metric_name;
+  }
+}
+
+TEST(AuthorizationProxyCacheKeyTest, KeyIsDigestOfIdentityAndToken) {
+  AuthorizationMetadata metadata1;
+  metadata1.claimed_identity = "google.com";
+  metadata1.authorization_token = std::string(4096, 'a');
+  AuthorizationMetadata metadata2 = metadata1;
+  EXPECT_EQ(AuthorizationProxy::ComputeCacheKey(metadata1),
+            AuthorizationProxy::ComputeCacheKey(metadata2));
+
+  metadata2.authorization_token.back() = 'b';
+  EXPECT_NE(AuthorizationProxy::ComputeCacheKey(metadata1),
+            AuthorizationProxy::ComputeCacheKey(metadata2));
+
+  // Same concatenation of identity and token.
+  AuthorizationMetadata metadata3;
+  metadata3.claimed_identity = "google.co";
+  metadata3.authorization_token = "m" + metadata1.authorization_token;
+  EXPECT_NE(AuthorizationProxy::ComputeCacheKey(metadata1),
+            AuthorizationProxy::ComputeCacheKey(metadata3));
+}
+
+TEST_F(AuthorizationProxyTest, CacheAccountsMemoryOfLoadedEntries) {
+  auto authorization_http_helper =
+      std::make_unique<HttpRequestResponseAuthInterceptorMock>();
+
+  HttpRequestResponseAuthInterceptorMock* authorization_http_helper_mock =
+      authorization_http_helper.get();
+
+  AuthorizationProxy proxy(server_endpoint_, async_executor_, mock_http_client_,
+                           std::move(authorization_http_helper));
+  EXPECT_SUCCESS(proxy.Init());
+  EXPECT_SUCCESS(proxy.Run());
+  EXPECT_EQ(proxy.GetCacheSizeBytes(), 0);
+
+  EXPECT_CALL(*authorization_http_helper_mock, PrepareRequest(_, _))
+      .WillOnce(Return(SuccessExecutionResult()));
+  EXPECT_CALL(*mock_http_client_, PerformRequest)
+      .WillOnce([](AsyncContext<HttpRequest, HttpResponse>& context) {
+        context.result = SuccessExecutionResult();
+        context.Finish();
+        return SuccessExecutionResult();
+      });
+  EXPECT_CALL(*authorization_http_helper_mock,
+              ObtainAuthorizedMetadataFromResponse(_, _))
+      .WillOnce(
+          Return(AuthorizedMetadata{authorized_metadata_.authorized_domain}));
+
+  // The accounted size does not depend on the token size.
+  authorization_metadata_.authorization_token = std::string(64 * 1024, 'a');
+  std::atomic<bool> request_finished(false);
+  AsyncContext<AuthorizationProxyRequest, AuthorizationProxyResponse>
+      authorization_request;
+  authorization_request.request = std::make_shared<AuthorizationProxyRequest>();
+  authorization_request.request->authorization_metadata =
+      authorization_metadata_;
+  authorization_request.callback = [&](auto context) {
+    EXPECT_SUCCESS(context.result);
+    request_finished = true;
+  };
+  EXPECT_SUCCESS(proxy.Authorize(authorization_request));
+  WaitUntil([&]() { return request_finished.load(); });
+
+  EXPECT_GT(proxy.GetCacheSizeBytes(), 0);
+  EXPECT_LT(proxy.GetCacheSizeBytes(), 1024);
+}
+
+TEST_F(AuthorizationProxyTest, CacheEvictsUnreferencedEntriesOverBudget) {
+  auto metric_router = std::make_unique<InMemoryMetricRouter>();
+  auto authorization_http_helper =
+      std::make_unique<HttpRequestResponseAuthInterceptorMock>();
+
+  HttpRequestResponseAuthInterceptorMock* authorization_http_helper_mock =
+      authorization_http_helper.get();
+
+  // Measure the size of a single entry first.
+  size_t entry_size_bytes = 0;
+  {
+    auto helper = std::make_unique<HttpRequestResponseAuthInterceptorMock>();
+    EXPECT_CALL(*helper, PrepareRequest(_, _))
+        .WillOnce(Return(SuccessExecutionResult()));
+    EXPECT_CALL(*helper, ObtainAuthorizedMetadataFromResponse(_, _))
+        .WillOnce(
+            Return(AuthorizedMetadata{authorized_metadata_.authorized_domain}));
+    EXPECT_CALL(*mock_http_client_, PerformRequest)
+        .WillOnce([](AsyncContext<HttpRequest, HttpResponse>& context) {
+          context.result = SuccessExecutionResult();
+          context.Finish();
+          return SuccessExecutionResult();
+        });
+    AuthorizationProxy proxy(server_endpoint_, async_executor_,
+                             mock_http_client_, std::move(helper));
+    AsyncContext<AuthorizationProxyRequest, AuthorizationProxyResponse>
+        authorization_request;
+    authorization_request.request =
+        std::make_shared<AuthorizationProxyRequest>();
+    authorization_request.request->authorization_metadata =
+        authorization_metadata_;
+    EXPECT_SUCCESS(proxy.Authorize(authorization_request));
+    entry_size_bytes = proxy.GetCacheSizeBytes();
+    ASSERT_GT(entry_size_bytes, 0);
+  }
+
+  // Room for two entries.
+  AuthorizationProxy proxy(
+      server_endpoint_, async_executor_, mock_http_client_,
+      std::move(authorization_http_helper),
+      AuthorizationProxyOptions(kDefaultAuthorizationCacheRefreshAheadFraction,
+                                2 * entry_size_bytes),
+      metric_router.get());
+  EXPECT_SUCCESS(proxy.Init());
+  EXPECT_SUCCESS(proxy.Run());
+
+  EXPECT_CALL(*authorization_http_helper_mock, PrepareRequest(_, _))
+      .WillRepeatedly(Return(SuccessExecutionResult()));
+  std::atomic<size_t> remote_calls(0);
+  EXPECT_CALL(*mock_http_client_, PerformRequest)
+      .WillRepeatedly([&](AsyncContext<HttpRequest, HttpResponse>& context) {
+        remote_calls++;
+        context.result = SuccessExecutionResult();
+        context.Finish();
+        return SuccessExecutionResult();
+      });
+  EXPECT_CALL(*authorization_http_helper_mock,
+              ObtainAuthorizedMetadataFromResponse(_, _))
+      .WillRepeatedly(
+          Return(AuthorizedMetadata{authorized_metadata_.authorized_domain}));
+
+  auto authorize = [&](const std::string& token) {
+    AsyncContext<AuthorizationProxyRequest, AuthorizationProxyResponse>
+        authorization_request;
+    authorization_request.request =
+        std::make_shared<AuthorizationProxyRequest>();
+    authorization_request.request->authorization_metadata.claimed_identity =
+        authorization_metadata_.claimed_identity;
+    authorization_request.request->authorization_metadata.authorization_token =
+        token;
+    EXPECT_SUCCESS(proxy.Authorize(authorization_request));
+  };
+
+  authorize("token1");
+  authorize("token2");
+  // Referencing token1 gives it a second chance, so token2 is evicted when
+  // token3 is loaded.
+  authorize("token1");
+  authorize("token3");
+  EXPECT_EQ(remote_calls.load(), 3);
+  EXPECT_LE(proxy.GetCacheSizeBytes(), 2 * entry_size_bytes);
+
+  authorize("token1");
+  authorize("token3");
+  EXPECT_EQ(remote_calls.load(), 3);
+  authorize("token2");
+  EXPECT_EQ(remote_calls.load(), 4);
+
+  std::vector<opentelemetry::sdk::metrics::ResourceMetrics> data =
+      metric_router->GetExportedData();
+  const std::map<std::string, std::string> no_labels;
+  const opentelemetry::sdk::common::OrderedAttributeMap dimensions(
+      (opentelemetry::common::KeyValueIterableView<
+          std::map<std::string, std::string>>(no_labels)));
+  std::optional<opentelemetry::sdk::metrics::PointType> point_data =
+      GetMetricPointData("authorization_proxy.cache.evictions", dimensions,
+                         data);
+  ASSERT_TRUE(point_data.has_value());
+  EXPECT_EQ(std::get<int64_t>(
+                std::get<opentelemetry::sdk::metrics::SumPointData>(*point_data)
+                    .value_),
+            2);
+}
 }  // namespace
 }  // namespace privacy_sandbox::pbs_common
@@ -48,4 +48,15 @@ DEFINE_ERROR_CODE(SC_AUTHORIZATION_SERVICE_AUTH_TOKEN_IS_REFRESHING,
                   SC_AUTHORIZATION_SERVICE, 0x0006,
                   "The authentication token is being refreshed.",
                   HttpStatusCode::INTERNAL_SERVER_ERROR)
+
+DEFINE_ERROR_CODE(SC_AUTHORIZATION_SERVICE_INVALID_JWKS,
+                  SC_AUTHORIZATION_SERVICE, 0x0007,
+                  "The JSON Web Key Set is invalid or has no usable keys.",
+                  HttpStatusCode::INTERNAL_SERVER_ERROR)
+
+DEFINE_ERROR_CODE(SC_AUTHORIZATION_SERVICE_UNKNOWN_SIGNING_KEY,
+                  SC_AUTHORIZATION_SERVICE, 0x0008,
+                  "The token is signed by a key missing from the JSON Web "
+                  "Key Set.",
+                  HttpStatusCode::FORBIDDEN)
 }  // namespace privacy_sandbox::pbs_common
@@ -352,6 +352,22 @@ class AutoExpiryConcurrentMap : public ServiceInterface {
     return execution_result;
   }
 
+  /**
+   * @brief Restarts the lifetime of an element in the map provided by the key,
+   * i.e. the element will expire map_entry_lifetime_seconds from now.
+   *
+   * @param key The key to be used to find the element to extend.
+   * @return ExecutionResult The execution result of the operation.
+   */
+  virtual ExecutionResult ResetExpiration(const TKey& key) noexcept {
+    std::shared_ptr<AutoExpiryConcurrentMapEntry> record;
+    auto execution_result = concurrent_map_.Find(key, record);
+    if (!execution_result.Successful()) {
+      return execution_result;
+    }
+    return record->ExtendExpiration(map_entry_lifetime_seconds_);
+  }
+
  protected:
   /**
    * @brief Schedules a round of garbage collection in the next
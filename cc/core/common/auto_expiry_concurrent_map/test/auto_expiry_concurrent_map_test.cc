@@ -386,6 +386,34 @@ TEST_F(AutoExpiryConcurrentMapTest, EnableEviction) {
                   SC_AUTO_EXPIRY_CONCURRENT_MAP_ENTRY_BEING_DELETED)));
 }
 
+TEST_F(AutoExpiryConcurrentMapTest, ResetExpiration) {
+  MockAutoExpiryConcurrentMap<int, std::shared_ptr<EmptyEntry>> auto_expiry_map(
+      cache_lifetime_, false, true, on_before_element_deletion_callback_,
+      mock_async_executor_);
+
+  auto entry = std::make_shared<EmptyEntry>();
+  EXPECT_SUCCESS(auto_expiry_map.Run());
+  auto pair = make_pair(3, entry);
+  EXPECT_SUCCESS(auto_expiry_map.Insert(pair, entry));
+
+  std::shared_ptr<UnderlyingEntry> underlying_entry;
+  auto_expiry_map.GetUnderlyingConcurrentMap().Find(3, underlying_entry);
+
+  underlying_entry->expiration_time = 0;
+  EXPECT_TRUE(underlying_entry->IsExpired());
+  EXPECT_SUCCESS(auto_expiry_map.ResetExpiration(3));
+  EXPECT_FALSE(underlying_entry->IsExpired());
+
+  EXPECT_THAT(
+      auto_expiry_map.ResetExpiration(5),
+      ResultIs(FailureExecutionResult(SC_CONCURRENT_MAP_ENTRY_DOES_NOT_EXIST)));
+
+  underlying_entry->being_evicted = true;
+  EXPECT_THAT(auto_expiry_map.ResetExpiration(3),
+              ResultIs(FailureExecutionResult(
+                  SC_AUTO_EXPIRY_CONCURRENT_MAP_ENTRY_BEING_DELETED)));
+}
+
 TEST_F(AutoExpiryConcurrentMapTest, GarbageCollection) {
   std::vector<int> keys_to_be_deleted;
   auto on_before_element_deletion_callback_ =
@@ -20,7 +20,9 @@
 #include <string>
 #include <unordered_set>
 
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
+#include "cc/core/common/global_logger/src/log_site_limiter.h"
 #include "cc/core/interface/logger_interface.h"
 
 namespace privacy_sandbox::pbs_common {
@@ -38,6 +40,11 @@ class GlobalLogger {
   (std::string(__FILE__) + ":" + __func__ + ":" + std::to_string(__LINE__)) \
       .c_str()
 
+// The location of a log call site is built once, on its first log, rather than
+// on every log.
+#define __SCP_STATIC_LOCATION(location_variable) \
+  static const std::string location_variable(SCP_LOCATION)
+
 #define SCP_INFO(component_name, activity_id, message)                   \
   __SCP_INFO_LOG(component_name, privacy_sandbox::pbs_common::kZeroUuid, \
                  privacy_sandbox::pbs_common::kZeroUuid, activity_id, message)
@@ -52,9 +59,10 @@ class GlobalLogger {
   if (privacy_sandbox::pbs_common::GlobalLogger::GetGlobalLogger() &&      \
       privacy_sandbox::pbs_common::GlobalLogger::IsLogLevelEnabled(        \
           privacy_sandbox::pbs_common::LogLevel::kInfo)) {                 \
+    __SCP_STATIC_LOCATION(scp_log_location);                               \
     privacy_sandbox::pbs_common::GlobalLogger::GetGlobalLogger()->Info(    \
         component_name, correlation_id, parent_activity_id, activity_id,   \
-        SCP_LOCATION, message);                                            \
+        scp_log_location, message);                                        \
   }
 #define SCP_DEBUG(component_name, activity_id, message)                   \
   __SCP_DEBUG_LOG(component_name, privacy_sandbox::pbs_common::kZeroUuid, \
@@ -70,9 +78,10 @@ class GlobalLogger {
   if (privacy_sandbox::pbs_common::GlobalLogger::GetGlobalLogger() &&       \
       privacy_sandbox::pbs_common::GlobalLogger::IsLogLevelEnabled(         \
           privacy_sandbox::pbs_common::LogLevel::kDebug)) {                 \
+    __SCP_STATIC_LOCATION(scp_log_location);                                \
     privacy_sandbox::pbs_common::GlobalLogger::GetGlobalLogger()->Debug(    \
         component_name, correlation_id, parent_activity_id, activity_id,    \
-        SCP_LOCATION, message);                                             \
+        scp_log_location, message);                                         \
   }
 
 #define SCP_WARNING(component_name, activity_id, message)                   \
@@ -90,9 +99,10 @@ class GlobalLogger {
   if (privacy_sandbox::pbs_common::GlobalLogger::GetGlobalLogger() &&         \
       privacy_sandbox::pbs_common::GlobalLogger::IsLogLevelEnabled(           \
           privacy_sandbox::pbs_common::LogLevel::kWarning)) {                 \
+    __SCP_STATIC_LOCATION(scp_log_location);                                  \
     privacy_sandbox::pbs_common::GlobalLogger::GetGlobalLogger()->Warning(    \
         component_name, correlation_id, parent_activity_id, activity_id,      \
-        SCP_LOCATION, message);                                               \
+        scp_log_location, message);                                           \
   }
 
 #define SCP_ERROR(component_name, activity_id, execution_result, message) \
@@ -111,13 +121,14 @@ class GlobalLogger {
   if (privacy_sandbox::pbs_common::GlobalLogger::GetGlobalLogger() &&       \
       privacy_sandbox::pbs_common::GlobalLogger::IsLogLevelEnabled(         \
           privacy_sandbox::pbs_common::LogLevel::kError)) {                 \
-    auto message_with_error = std::string(message) +                        \
-                              std::string(" Failed with: ") +               \
-                              privacy_sandbox::pbs_common::GetErrorMessage( \
-                                  execution_result.status_code);            \
+    __SCP_STATIC_LOCATION(scp_log_location);                                \
+    auto message_with_error = absl::StrCat(                                 \
+        message, " Failed with: ",                                          \
+        privacy_sandbox::pbs_common::GetErrorMessage(                       \
+            execution_result.status_code));                                 \
     privacy_sandbox::pbs_common::GlobalLogger::GetGlobalLogger()->Error(    \
         component_name, correlation_id, parent_activity_id, activity_id,    \
-        SCP_LOCATION, message_with_error.c_str());                          \
+        scp_log_location, message_with_error);                              \
   }
 
 #define SCP_CRITICAL(component_name, activity_id, execution_result, message) \
@@ -136,13 +147,14 @@ class GlobalLogger {
   if (privacy_sandbox::pbs_common::GlobalLogger::GetGlobalLogger() &&          \
       privacy_sandbox::pbs_common::GlobalLogger::IsLogLevelEnabled(            \
           privacy_sandbox::pbs_common::LogLevel::kCritical)) {                 \
-    auto message_with_error = std::string(message) +                           \
-                              std::string(" Failed with: ") +                  \
-                              privacy_sandbox::pbs_common::GetErrorMessage(    \
-                                  execution_result.status_code);               \
+    __SCP_STATIC_LOCATION(scp_log_location);                                   \
+    auto message_with_error = absl::StrCat(                                    \
+        message, " Failed with: ",                                             \
+        privacy_sandbox::pbs_common::GetErrorMessage(                          \
+            execution_result.status_code));                                    \
     privacy_sandbox::pbs_common::GlobalLogger::GetGlobalLogger()->Critical(    \
         component_name, correlation_id, parent_activity_id, activity_id,       \
-        SCP_LOCATION, message_with_error.c_str());                             \
+        scp_log_location, message_with_error);                                 \
   }
 
 #define SCP_ALERT(component_name, activity_id, execution_result, message) \
@@ -161,13 +173,14 @@ class GlobalLogger {
   if (privacy_sandbox::pbs_common::GlobalLogger::GetGlobalLogger() &&       \
       privacy_sandbox::pbs_common::GlobalLogger::IsLogLevelEnabled(         \
           privacy_sandbox::pbs_common::LogLevel::kAlert)) {                 \
-    auto message_with_error = std::string(message) +                        \
-                              std::string(" Failed with: ") +               \
-                              privacy_sandbox::pbs_common::GetErrorMessage( \
-                                  execution_result.status_code);            \
+    __SCP_STATIC_LOCATION(scp_log_location);                                \
+    auto message_with_error = absl::StrCat(                                 \
+        message, " Failed with: ",                                          \
+        privacy_sandbox::pbs_common::GetErrorMessage(                       \
+            execution_result.status_code));                                 \
     privacy_sandbox::pbs_common::GlobalLogger::GetGlobalLogger()->Alert(    \
         component_name, correlation_id, parent_activity_id, activity_id,    \
-        SCP_LOCATION, message_with_error.c_str());                          \
+        scp_log_location, message_with_error);                              \
   }
 
 #define SCP_EMERGENCY(component_name, activity_id, execution_result, message) \
@@ -187,11 +200,98 @@ class GlobalLogger {
   if (privacy_sandbox::pbs_common::GlobalLogger::GetGlobalLogger() &&          \
       privacy_sandbox::pbs_common::GlobalLogger::IsLogLevelEnabled(            \
           privacy_sandbox::pbs_common::LogLevel::kEmergency)) {                \
-    auto message_with_error = std::string(message) +                           \
-                              std::string(" Failed with: ") +                  \
-                              privacy_sandbox::pbs_common::GetErrorMessage(    \
-                                  execution_result.status_code);               \
+    __SCP_STATIC_LOCATION(scp_log_location);                                   \
+    auto message_with_error = absl::StrCat(                                    \
+        message, " Failed with: ",                                             \
+        privacy_sandbox::pbs_common::GetErrorMessage(                          \
+            execution_result.status_code));                                    \
     privacy_sandbox::pbs_common::GlobalLogger::GetGlobalLogger()->Emergency(   \
         component_name, correlation_id, parent_activity_id, activity_id,       \
-        SCP_LOCATION, message_with_error.c_str());                             \
+        scp_log_location, message_with_error);                                 \
+  }
+
+// Rate limited and sampled logs, for call sites which can log for every request
+// of a storm. *_EVERY_N logs the first of every n lines of the call site, and
+// *_RATE_LIMITED at most max_per_second lines per second. The line logged
+// after lines were suppressed tells how many were.
+#define __SCP_LIMITED_LOG(log_level, should_log, log_macro, ...)             \
+  {                                                                          \
+    static privacy_sandbox::pbs_common::LogSiteLimiter scp_log_site_limiter; \
+    if (privacy_sandbox::pbs_common::GlobalLogger::GetGlobalLogger() &&      \
+        privacy_sandbox::pbs_common::GlobalLogger::IsLogLevelEnabled(        \
+            privacy_sandbox::pbs_common::LogLevel::log_level) &&             \
+        scp_log_site_limiter.should_log) {                                   \
+      log_macro(__VA_ARGS__);                                                \
+    }                                                                        \
   }
+
+#define __SCP_WITH_SUPPRESSED_LOG_COUNT(message)       \
+  privacy_sandbox::pbs_common::WithSuppressedLogCount( \
+      message, scp_log_site_limiter.TakeSuppressedCount())
+
+#define SCP_INFO_EVERY_N(component_name, activity_id, n, message)        \
+  __SCP_LIMITED_LOG(kInfo, ShouldLogEveryN(n), SCP_INFO, component_name, \
+                    activity_id, __SCP_WITH_SUPPRESSED_LOG_COUNT(message))
+
+#define SCP_INFO_CONTEXT_EVERY_N(component_name, async_context, n, message) \
+  __SCP_LIMITED_LOG(kInfo, ShouldLogEveryN(n), SCP_INFO_CONTEXT,            \
+                    component_name, async_context,                          \
+                    __SCP_WITH_SUPPRESSED_LOG_COUNT(message))
+
+#define SCP_INFO_RATE_LIMITED(component_name, activity_id, max_per_second, \
+                              message)                                     \
+  __SCP_LIMITED_LOG(kInfo, ShouldLogPerSecond(max_per_second), SCP_INFO,   \
+                    component_name, activity_id,                           \
+                    __SCP_WITH_SUPPRESSED_LOG_COUNT(message))
+
+#define SCP_INFO_CONTEXT_RATE_LIMITED(component_name, async_context, \
+                                      max_per_second, message)       \
+  __SCP_LIMITED_LOG(kInfo, ShouldLogPerSecond(max_per_second),       \
+                    SCP_INFO_CONTEXT, component_name, async_context, \
+                    __SCP_WITH_SUPPRESSED_LOG_COUNT(message))
+
+#define SCP_WARNING_EVERY_N(component_name, activity_id, n, message)           \
+  __SCP_LIMITED_LOG(kWarning, ShouldLogEveryN(n), SCP_WARNING, component_name, \
+                    activity_id, __SCP_WITH_SUPPRESSED_LOG_COUNT(message))
+
+#define SCP_WARNING_CONTEXT_EVERY_N(component_name, async_context, n, message) \
+  __SCP_LIMITED_LOG(kWarning, ShouldLogEveryN(n), SCP_WARNING_CONTEXT,         \
+                    component_name, async_context,                             \
+                    __SCP_WITH_SUPPRESSED_LOG_COUNT(message))
+
+#define SCP_WARNING_RATE_LIMITED(component_name, activity_id, max_per_second, \
+                                 message)                                     \
+  __SCP_LIMITED_LOG(kWarning, ShouldLogPerSecond(max_per_second),             \
+                    SCP_WARNING, component_name, activity_id,                 \
+                    __SCP_WITH_SUPPRESSED_LOG_COUNT(message))
+
+#define SCP_WARNING_CONTEXT_RATE_LIMITED(component_name, async_context, \
+                                         max_per_second, message)       \
+  __SCP_LIMITED_LOG(kWarning, ShouldLogPerSecond(max_per_second),       \
+                    SCP_WARNING_CONTEXT, component_name, async_context, \
+                    __SCP_WITH_SUPPRESSED_LOG_COUNT(message))
+
+#define SCP_ERROR_EVERY_N(component_name, activity_id, execution_result, n, \
+                          message)                                          \
+  __SCP_LIMITED_LOG(kError, ShouldLogEveryN(n), SCP_ERROR, component_name,  \
+                    activity_id, execution_result,                          \
+                    __SCP_WITH_SUPPRESSED_LOG_COUNT(message))
+
+#define SCP_ERROR_CONTEXT_EVERY_N(component_name, async_context,     \
+                                  execution_result, n, message)      \
+  __SCP_LIMITED_LOG(kError, ShouldLogEveryN(n), SCP_ERROR_CONTEXT,   \
+                    component_name, async_context, execution_result, \
+                    __SCP_WITH_SUPPRESSED_LOG_COUNT(message))
+
+#define SCP_ERROR_RATE_LIMITED(component_name, activity_id, execution_result, \
+                               max_per_second, message)                       \
+  __SCP_LIMITED_LOG(kError, ShouldLogPerSecond(max_per_second), SCP_ERROR,    \
+                    component_name, activity_id, execution_result,            \
+                    __SCP_WITH_SUPPRESSED_LOG_COUNT(message))
+
+#define SCP_ERROR_CONTEXT_RATE_LIMITED(component_name, async_context,    \
+                                       execution_result, max_per_second, \
+                                       message)                          \
+  __SCP_LIMITED_LOG(kError, ShouldLogPerSecond(max_per_second),          \
+                    SCP_ERROR_CONTEXT, component_name, async_context,    \
+                    execution_result, __SCP_WITH_SUPPRESSED_LOG_COUNT(message))
@@ -0,0 +1,68 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cc/core/common/global_logger/src/log_site_limiter.h"
+
+#include <chrono>
+#include <string>
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+
+namespace privacy_sandbox::pbs_common {
+
+bool LogSiteLimiter::ShouldLogEveryN(uint64_t n) noexcept {
+  if (n <= 1 || count_.fetch_add(1) % n == 0) {
+    return true;
+  }
+  suppressed_.fetch_add(1);
+  return false;
+}
+
+bool LogSiteLimiter::ShouldLogPerSecond(uint64_t max_per_second) noexcept {
+  return ShouldLogPerSecond(
+      max_per_second, std::chrono::duration_cast<std::chrono::seconds>(
+                          std::chrono::steady_clock::now().time_since_epoch())
+                          .count());
+}
+
+bool LogSiteLimiter::ShouldLogPerSecond(uint64_t max_per_second,
+                                        int64_t now_in_seconds) noexcept {
+  int64_t current_second = current_second_.load();
+  // Only the thread moving the window to the new second resets the count. The
+  // lines counted by other threads in between are at most a few extra lines.
+  if (now_in_seconds > current_second &&
+      current_second_.compare_exchange_strong(current_second,
+                                              now_in_seconds)) {
+    count_.store(0);
+  }
+  if (count_.fetch_add(1) < max_per_second) {
+    return true;
+  }
+  suppressed_.fetch_add(1);
+  return false;
+}
+
+std::string WithSuppressedLogCount(absl::string_view message,
+                                   uint64_t suppressed_count) {
+  if (suppressed_count == 0) {
+    return std::string(message);
+  }
+  return absl::StrCat("[", suppressed_count, " similar lines suppressed] ",
+                      message);
+}
+
+}  // namespace privacy_sandbox::pbs_common
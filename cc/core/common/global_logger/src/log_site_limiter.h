@@ -0,0 +1,66 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "absl/strings/string_view.h"
+
+namespace privacy_sandbox::pbs_common {
+
+/**
+ * @brief Limits the lines logged by a single call site, either to one of every
+ * N lines or to at most N lines per second, and counts the lines suppressed in
+ * between so that the next line logged can tell how many there were.
+ *
+ * Used through the SCP_*_EVERY_N and SCP_*_RATE_LIMITED macros, which keep an
+ * instance per call site. Thread safe and lock free.
+ */
+class LogSiteLimiter {
+ public:
+  constexpr LogSiteLimiter() = default;
+
+  /// Allows the first of every n lines.
+  bool ShouldLogEveryN(uint64_t n) noexcept;
+
+  /// Allows at most max_per_second lines per second of the steady clock.
+  bool ShouldLogPerSecond(uint64_t max_per_second) noexcept;
+
+  /// Allows at most max_per_second lines in the second now_in_seconds.
+  bool ShouldLogPerSecond(uint64_t max_per_second,
+                          int64_t now_in_seconds) noexcept;
+
+  /// Returns the number of lines suppressed since the last call, and resets
+  /// it.
+  uint64_t TakeSuppressedCount() noexcept { return suppressed_.exchange(0); }
+
+ private:
+  std::atomic<uint64_t> count_ = 0;
+  std::atomic<int64_t> current_second_ = -1;
+  std::atomic<uint64_t> suppressed_ = 0;
+};
+
+/**
+ * @brief Prefixes the message with the number of similar lines suppressed
+ * before it, if any.
+ */
+std::string WithSuppressedLogCount(absl::string_view message,
+                                   uint64_t suppressed_count);
+
+}  // namespace privacy_sandbox::pbs_common
@@ -0,0 +1,119 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cc/core/common/global_logger/src/log_site_limiter.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cc/core/common/global_logger/src/global_logger.h"
+#include "cc/core/common/uuid/src/uuid.h"
+#include "cc/core/interface/errors.h"
+#include "cc/core/logger/mock/mock_logger.h"
+
+namespace privacy_sandbox::pbs_common {
+namespace {
+
+TEST(LogSiteLimiterTest, ShouldLogEveryN) {
+  LogSiteLimiter limiter;
+  std::vector<bool> logged;
+  for (int i = 0; i < 7; ++i) {
+    logged.push_back(limiter.ShouldLogEveryN(3));
+  }
+  EXPECT_EQ(logged, std::vector<bool>(
+                        {true, false, false, true, false, false, true}));
+  EXPECT_EQ(limiter.TakeSuppressedCount(), 4);
+  EXPECT_EQ(limiter.TakeSuppressedCount(), 0);
+
+  LogSiteLimiter every_line_limiter;
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_TRUE(every_line_limiter.ShouldLogEveryN(1));
+    EXPECT_TRUE(every_line_limiter.ShouldLogEveryN(0));
+  }
+}
+
+TEST(LogSiteLimiterTest, ShouldLogPerSecond) {
+  LogSiteLimiter limiter;
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_TRUE(limiter.ShouldLogPerSecond(2, /*now_in_seconds=*/10));
+  }
+  EXPECT_FALSE(limiter.ShouldLogPerSecond(2, /*now_in_seconds=*/10));
+  EXPECT_FALSE(limiter.ShouldLogPerSecond(2, /*now_in_seconds=*/10));
+  EXPECT_EQ(limiter.TakeSuppressedCount(), 2);
+
+  // A line logged late for an earlier second does not reset the count.
+  EXPECT_FALSE(limiter.ShouldLogPerSecond(2, /*now_in_seconds=*/9));
+
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_TRUE(limiter.ShouldLogPerSecond(2, /*now_in_seconds=*/11));
+  }
+  EXPECT_FALSE(limiter.ShouldLogPerSecond(2, /*now_in_seconds=*/11));
+  EXPECT_EQ(limiter.TakeSuppressedCount(), 2);
+}
+
+TEST(LogSiteLimiterTest, WithSuppressedLogCount) {
+  EXPECT_EQ(WithSuppressedLogCount("Message", 0), "Message");
+  EXPECT_EQ(WithSuppressedLogCount("Message", 12),
+            "[12 similar lines suppressed] Message");
+}
+
+TEST(LogSiteLimiterTest, EveryNMacrosLogTheSuppressedCount) {
+  GlobalLogger::SetGlobalLogger(std::make_unique<MockLogger>());
+  ExecutionResult execution_result = FailureExecutionResult(SC_UNKNOWN);
+  for (int i = 0; i < 5; ++i) {
+    SCP_ERROR_EVERY_N("Component", kZeroUuid, execution_result, 2,
+                      "Message " + std::to_string(i));
+  }
+  auto messages =
+      dynamic_cast<MockLogger&>(*GlobalLogger::GetGlobalLogger()).GetMessages();
+  GlobalLogger::SetGlobalLogger(nullptr);
+
+  ASSERT_EQ(messages.size(), 3);
+  EXPECT_TRUE(messages[0].ends_with(": Message 0 Failed with: Unknown Error"));
+  EXPECT_TRUE(messages[1].ends_with(
+      ": [1 similar lines suppressed] Message 2 Failed with: Unknown Error"));
+  EXPECT_TRUE(messages[2].ends_with(
+      ": [1 similar lines suppressed] Message 4 Failed with: Unknown Error"));
+}
+
+TEST(LogSiteLimiterTest, RateLimitedMacrosLimitEachCallSite) {
+  GlobalLogger::SetGlobalLogger(std::make_unique<MockLogger>());
+  for (int i = 0; i < 10; ++i) {
+    SCP_INFO_RATE_LIMITED("Component", kZeroUuid, 2, "First site");
+    SCP_INFO_RATE_LIMITED("Component", kZeroUuid, 3, "Second site");
+  }
+  auto messages =
+      dynamic_cast<MockLogger&>(*GlobalLogger::GetGlobalLogger()).GetMessages();
+  GlobalLogger::SetGlobalLogger(nullptr);
+
+  // A second boundary in the loop lets more lines through.
+  size_t first_site_lines = 0;
+  size_t second_site_lines = 0;
+  for (const auto& message : messages) {
+    first_site_lines += message.ends_with("First site");
+    second_site_lines += message.ends_with("Second site");
+  }
+  EXPECT_GE(first_site_lines, 2);
+  EXPECT_LE(first_site_lines, 4);
+  EXPECT_GE(second_site_lines, 3);
+  EXPECT_LE(second_site_lines, 6);
+}
+
+}  // namespace
+}  // namespace privacy_sandbox::pbs_common
@@ -0,0 +1,162 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+namespace privacy_sandbox::pbs_common {
+
+/// Options of CircuitBreaker.
+struct CircuitBreakerOptions {
+  /// The number of consecutive failures which opens the circuit. The circuit
+  /// never opens when 0.
+  size_t failure_threshold = 0;
+  /// How long an open circuit fails operations before probing again.
+  std::chrono::milliseconds open_duration = std::chrono::milliseconds(5000);
+  /// The number of probing operations let through a half open circuit at a
+  /// time.
+  size_t half_open_max_probes = 1;
+};
+
+/// States of a CircuitBreaker.
+enum class CircuitBreakerState {
+  /// Operations go through.
+  Closed = 0,
+  /// A few operations go through to probe whether the target recovered.
+  HalfOpen = 1,
+  /// Operations fail right away.
+  Open = 2,
+};
+
+/**
+ * @brief Fails operations to an unhealthy target right away instead of
+ * queueing retries against it.
+ *
+ * The circuit opens after failure_threshold consecutive failures. Once
+ * open_duration elapsed, it lets half_open_max_probes operations through: the
+ * first success closes it, and a failure opens it again.
+ *
+ * Closed circuits are checked with a single atomic load, and can be used from
+ * any thread.
+ */
+class CircuitBreaker {
+ public:
+  explicit CircuitBreaker(CircuitBreakerOptions options)
+      : options_(options),
+        state_(CircuitBreakerState::Closed),
+        consecutive_failures_(0),
+        probes_in_flight_(0),
+        rejected_operations_(0) {}
+
+  /**
+   * @brief Admits an operation if the circuit allows it. Every admitted
+   * operation must report its outcome with OnSuccess or OnFailure.
+   *
+   * @return true if the operation is admitted.
+   */
+  bool TryAcquire() noexcept {
+    if (state_.load() == CircuitBreakerState::Closed) {
+      return true;
+    }
+
+    std::lock_guard lock(lock_);
+    if (state_ == CircuitBreakerState::Open) {
+      if (std::chrono::steady_clock::now() < open_until_) {
+        rejected_operations_++;
+        return false;
+      }
+      state_ = CircuitBreakerState::HalfOpen;
+      probes_in_flight_ = 0;
+    }
+
+    if (state_ == CircuitBreakerState::HalfOpen) {
+      if (probes_in_flight_ >= options_.half_open_max_probes) {
+        rejected_operations_++;
+        return false;
+      }
+      probes_in_flight_++;
+    }
+    return true;
+  }
+
+  /// Reports an admitted operation which reached the target.
+  void OnSuccess() noexcept {
+    if (state_.load() == CircuitBreakerState::Closed &&
+        consecutive_failures_.load() == 0) {
+      return;
+    }
+
+    std::lock_guard lock(lock_);
+    consecutive_failures_ = 0;
+    if (state_ == CircuitBreakerState::HalfOpen) {
+      state_ = CircuitBreakerState::Closed;
+    }
+  }
+
+  /// Reports an admitted operation which failed to reach the target.
+  void OnFailure() noexcept {
+    if (options_.failure_threshold == 0) {
+      return;
+    }
+
+    std::lock_guard lock(lock_);
+    switch (state_.load()) {
+      case CircuitBreakerState::Closed:
+        if (++consecutive_failures_ >= options_.failure_threshold) {
+          Open();
+        }
+        return;
+      case CircuitBreakerState::HalfOpen:
+        Open();
+        return;
+      case CircuitBreakerState::Open:
+        // An operation admitted before the circuit opened.
+        return;
+    }
+  }
+
+  /// The current state of the circuit.
+  CircuitBreakerState GetState() const noexcept { return state_.load(); }
+
+  /// The number of operations rejected since the circuit breaker was created.
+  uint64_t GetRejectedOperationCount() const noexcept {
+    return rejected_operations_.load();
+  }
+
+ private:
+  /// Opens the circuit. Must be called with lock_ held.
+  void Open() noexcept {
+    state_ = CircuitBreakerState::Open;
+    open_until_ = std::chrono::steady_clock::now() + options_.open_duration;
+    consecutive_failures_ = 0;
+    probes_in_flight_ = 0;
+  }
+
+  const CircuitBreakerOptions options_;
+  std::mutex lock_;
+  std::atomic<CircuitBreakerState> state_;
+  std::atomic<size_t> consecutive_failures_;
+  size_t probes_in_flight_;
+  std::chrono::steady_clock::time_point open_until_;
+  std::atomic<uint64_t> rejected_operations_;
+};
+
+}  // namespace privacy_sandbox::pbs_common
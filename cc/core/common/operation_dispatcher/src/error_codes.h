@@ -35,4 +35,12 @@ DEFINE_ERROR_CODE(SC_DISPATCHER_NOT_ENOUGH_TIME_REMAINED_FOR_OPERATION,
                   "Not enough time remaining to continue the operation.",
                   HttpStatusCode::REQUEST_TIMEOUT)
 
+DEFINE_ERROR_CODE(SC_DISPATCHER_RETRY_BUDGET_EXHAUSTED, SC_DISPATCHER, 0x0004,
+                  "The retry budget is exhausted.",
+                  HttpStatusCode::SERVICE_UNAVAILABLE)
+
+DEFINE_ERROR_CODE(SC_DISPATCHER_CIRCUIT_BREAKER_OPEN, SC_DISPATCHER, 0x0005,
+                  "The circuit breaker of the target is open.",
+                  HttpStatusCode::SERVICE_UNAVAILABLE)
+
 }  // namespace privacy_sandbox::pbs_common
@@ -16,11 +16,16 @@
 
 #pragma once
 
+#include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <memory>
+#include <utility>
 
 #include "cc/core/common/global_logger/src/global_logger.h"
+#include "cc/core/common/operation_dispatcher/src/circuit_breaker.h"
 #include "cc/core/common/operation_dispatcher/src/error_codes.h"
+#include "cc/core/common/operation_dispatcher/src/retry_budget.h"
 #include "cc/core/common/operation_dispatcher/src/retry_strategy.h"
 #include "cc/core/common/time_provider/src/time_provider.h"
 #include "cc/core/interface/async_executor_interface.h"
@@ -32,6 +37,10 @@ static constexpr char kOperationDispatcher[] = "OperationDispatcher";
 /**
  * @brief Provides dispatching mechanism for the callers to automatically retry
  * on the Retry status code.
+ *
+ * Retries can be limited by a retry budget shared by all the dispatched
+ * operations, and operations to an unhealthy target can be failed right away
+ * by a circuit breaker, which counts the Retry status codes as failures.
  */
 class OperationDispatcher {
  public:
@@ -41,11 +50,18 @@ class OperationDispatcher {
    * @param async_executor The async executor instance.
    * @param retry_strategy The retry strategy for dispatch operations in case of
    * Retry status code.
+   * @param retry_budget The budget of the retries of all the dispatched
+   * operations. Retries are only limited by the retry strategy if null.
    */
   OperationDispatcher(
       const std::shared_ptr<AsyncExecutorInterface>& async_executor,
-      RetryStrategy retry_strategy)
-      : async_executor_(async_executor), retry_strategy_(retry_strategy) {}
+      RetryStrategy retry_strategy,
+      std::shared_ptr<RetryBudget> retry_budget = nullptr)
+      : async_executor_(async_executor),
+        retry_strategy_(retry_strategy),
+        retry_budget_(std::move(retry_budget)),
+        retry_count_(0),
+        rejected_retry_count_(0) {}
 
   /**
    * @brief Dispatches an async_context object to the target component with a
@@ -55,33 +71,74 @@ class OperationDispatcher {
    * @param async_context The async context of the operation to be executed.
    * @param dispatch_to_target_function The function to call the target
    * component.
+   * @param circuit_breaker The circuit breaker of the target component, if
+   * any.
    */
   template <class Context>
-  void Dispatch(Context& async_context,
-                const std::function<ExecutionResult(Context&)>&
-                    dispatch_to_target_function) {
+  void Dispatch(
+      Context& async_context,
+      const std::function<ExecutionResult(Context&)>&
+          dispatch_to_target_function,
+      const std::shared_ptr<CircuitBreaker>& circuit_breaker = nullptr) {
+    if (retry_budget_) {
+      retry_budget_->Deposit();
+    }
+
     auto original_callback = async_context.callback;
     async_context.callback = [this, dispatch_to_target_function,
+                              circuit_breaker,
                               original_callback](Context& async_context) {
+      // The failures of the dispatcher itself, e.g. an open circuit or
+      // exhausted retries, are not outcomes of the target.
+      if (circuit_breaker &&
+          ExtractComponentCode(async_context.result.status_code) !=
+              SC_DISPATCHER) {
+        if (async_context.result.status == ExecutionStatus::Retry) {
+          circuit_breaker->OnFailure();
+        } else {
+          circuit_breaker->OnSuccess();
+        }
+      }
+
       if (async_context.result.status == ExecutionStatus::Retry) {
         async_context.retry_count++;
-        DispatchWithRetry(async_context, dispatch_to_target_function);
+        DispatchWithRetry(async_context, dispatch_to_target_function,
+                          circuit_breaker);
         return;
       }
 
       original_callback(async_context);
     };
 
-    DispatchWithRetry<Context>(async_context, dispatch_to_target_function);
+    DispatchWithRetry<Context>(async_context, dispatch_to_target_function,
+                               circuit_breaker);
+  }
+
+  /// The number of retries scheduled since the dispatcher was created.
+  uint64_t GetRetryCount() const noexcept { return retry_count_.load(); }
+
+  /// The number of retries rejected by the retry budget since the dispatcher
+  /// was created.
+  uint64_t GetRejectedRetryCount() const noexcept {
+    return rejected_retry_count_.load();
   }
 
  private:
   template <class Context>
-  void DispatchWithRetry(Context& async_context,
-                         const std::function<ExecutionResult(Context&)>&
-                             dispatch_to_target_function) {
-    auto async_operation = [async_context,
-                            dispatch_to_target_function]() mutable {
+  void DispatchWithRetry(
+      Context& async_context,
+      const std::function<ExecutionResult(Context&)>&
+          dispatch_to_target_function,
+      const std::shared_ptr<CircuitBreaker>& circuit_breaker) {
+    auto async_operation = [async_context, dispatch_to_target_function,
+                            circuit_breaker]() mutable {
+      if (circuit_breaker && !circuit_breaker->TryAcquire()) {
+        async_context.result =
+            FailureExecutionResult(SC_DISPATCHER_CIRCUIT_BREAKER_OPEN);
+        async_context.Finish();
+        return;
+      }
+
       auto execution_result = dispatch_to_target_function(async_context);
       if (!execution_result.Successful()) {
         async_context.result = execution_result;
@@ -145,6 +202,20 @@ class OperationDispatcher {
       return;
     }
 
+    if (retry_budget_ && !retry_budget_->TryAcquire()) {
+      rejected_retry_count_++;
+      // Expected while a dependency fails, and counted rather than logged.
+      SCP_DEBUG_CONTEXT(
+          kOperationDispatcher, async_context,
+          absl::StrFormat("Retry budget exhausted. Total retries: %lld",
+                          async_context.retry_count));
+      async_context.result =
+          FailureExecutionResult(SC_DISPATCHER_RETRY_BUDGET_EXHAUSTED);
+      async_context.Finish();
+      return;
+    }
+
+    retry_count_++;
     auto execution_result = async_executor_->ScheduleFor(
         async_operation, current_time + back_off_duration_ns);
     if (!execution_result.Successful()) {
@@ -157,5 +228,11 @@ class OperationDispatcher {
   const std::shared_ptr<AsyncExecutorInterface> async_executor_;
   /// The retry strategy for the dispatcher.
   RetryStrategy retry_strategy_;
+  /// The retry budget for the dispatcher, if any.
+  const std::shared_ptr<RetryBudget> retry_budget_;
+  /// Total retries scheduled.
+  std::atomic<uint64_t> retry_count_;
+  /// Total retries rejected by the retry budget.
+  std::atomic<uint64_t> rejected_retry_count_;
 };
 }  // namespace privacy_sandbox::pbs_common
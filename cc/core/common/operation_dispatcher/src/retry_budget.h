@@ -0,0 +1,66 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include "cc/core/common/operation_dispatcher/src/token_bucket.h"
+
+namespace privacy_sandbox::pbs_common {
+
+/// Options of RetryBudget.
+struct RetryBudgetOptions {
+  /// The ratio of retries to operations, e.g. 0.1 for 10%. Retries are not
+  /// limited when 0.
+  double ratio = 0;
+  /// The number of retries which can be made in a burst.
+  size_t max_tokens = 10;
+};
+
+/**
+ * @brief Limits retries with a token bucket: each dispatched operation
+ * deposits ratio tokens and each retry takes one. This keeps a failing
+ * dependency from being hit with a multiple of its normal load.
+ */
+class RetryBudget {
+ public:
+  explicit RetryBudget(const RetryBudgetOptions& options)
+      : is_unlimited_(options.ratio <= 0),
+        token_bucket_(options.ratio, options.max_tokens) {}
+
+  /// Adds the tokens of a dispatched operation.
+  void Deposit() noexcept {
+    if (!is_unlimited_) {
+      token_bucket_.Deposit();
+    }
+  }
+
+  /**
+   * @brief Takes the token of a retry.
+   *
+   * @return true if the budget allows the retry.
+   */
+  bool TryAcquire() noexcept {
+    return is_unlimited_ || token_bucket_.TryAcquire();
+  }
+
+ private:
+  const bool is_unlimited_;
+  TokenBucket token_bucket_;
+};
+
+}  // namespace privacy_sandbox::pbs_common
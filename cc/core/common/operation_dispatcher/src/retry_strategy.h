@@ -17,6 +17,7 @@
 #pragma once
 
 #include <cmath>
+#include <random>
 
 #include "cc/core/interface/type_def.h"
 
@@ -26,6 +27,11 @@ namespace privacy_sandbox::pbs_common {
 enum class RetryStrategyType {
   Linear = 0,
   Exponential = 1,
+  /// Exponential back off randomized over [0, backoff], so that the callers
+  /// failing together do not retry together.
+  ExponentialWithFullJitter = 2,
+  /// Exponential back off randomized over [backoff / 2, backoff].
+  ExponentialWithEqualJitter = 3,
 };
 
 /// RetryStrategy options.
@@ -39,7 +45,8 @@ struct RetryStrategyOptions {
         delay_duration_ms(delay_duration_ms),
         maximum_allowed_retry_count(maximum_allowed_retry_count) {}
 
-  /// The type of the retry strategy, linear or exponential.
+  /// The type of the retry strategy, linear or exponential with or without
+  /// jitter.
   const RetryStrategyType retry_strategy_type;
 
   /// The initial delay for any types of retries in milliseconds.
@@ -51,7 +58,7 @@ struct RetryStrategyOptions {
 
 /**
  * @brief A structure to represent retry strategy for operation. Linear and
- * Exponential retry strategies are supported.
+ * Exponential retry strategies are supported, the latter optionally jittered.
  */
 class RetryStrategy {
  public:
@@ -94,9 +101,15 @@ class RetryStrategy {
     switch (retry_strategy_type_) {
       case RetryStrategyType::Linear:
         return retry_count * delay_duration_ms_;
+      case RetryStrategyType::ExponentialWithFullJitter:
+        return GetJitter(GetExponentialBackOff(retry_count));
+      case RetryStrategyType::ExponentialWithEqualJitter: {
+        auto back_off = GetExponentialBackOff(retry_count);
+        return back_off - GetJitter(back_off / 2);
+      }
       case RetryStrategyType::Exponential:
       default:
-        return pow(2, retry_count - 1) * delay_duration_ms_;
+        return GetExponentialBackOff(retry_count);
     }
   }
 
@@ -108,6 +121,17 @@ class RetryStrategy {
   size_t GetMaximumAllowedRetryCount() { return maximum_allowed_retry_count_; }
 
  private:
+  TimeDuration GetExponentialBackOff(size_t retry_count) {
+    return pow(2, retry_count - 1) * delay_duration_ms_;
+  }
+
+  /// Returns a uniformly random duration in [0, max_duration_ms].
+  static TimeDuration GetJitter(TimeDuration max_duration_ms) {
+    thread_local std::mt19937_64 generator(std::random_device{}());
+    return std::uniform_int_distribution<TimeDuration>(0, max_duration_ms)(
+        generator);
+  }
+
   /// Retry strategy type.
   RetryStrategyType retry_strategy_type_;
   /// The delay in the back off time in milliseconds.
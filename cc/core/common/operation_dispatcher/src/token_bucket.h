@@ -0,0 +1,81 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace privacy_sandbox::pbs_common {
+
+/**
+ * @brief Limits an extra load, e.g. retries or hedged requests, with a token
+ * bucket: each request deposits ratio tokens, up to max_tokens, and each unit
+ * of extra load takes one, so that the extra load is at most ratio of the
+ * requests once the initial burst is spent.
+ *
+ * Lock free and can be called from any thread.
+ */
+class TokenBucket {
+ public:
+  /**
+   * @brief Constructs a new Token Bucket object, full.
+   *
+   * @param ratio The ratio of the extra load to the requests.
+   * @param max_tokens The extra load which can be sent in a burst.
+   */
+  TokenBucket(double ratio, size_t max_tokens)
+      : tokens_per_request_(
+            static_cast<int64_t>(std::max(ratio, 0.0) * kTokenScale)),
+        max_tokens_(static_cast<int64_t>(max_tokens) * kTokenScale),
+        tokens_(max_tokens_) {}
+
+  /// Adds the tokens of a request.
+  void Deposit() noexcept {
+    auto tokens = tokens_.load();
+    while (tokens < max_tokens_ &&
+           !tokens_.compare_exchange_weak(
+               tokens, std::min(tokens + tokens_per_request_, max_tokens_))) {
+    }
+  }
+
+  /**
+   * @brief Takes a token.
+   *
+   * @return true if the budget allows the extra load.
+   */
+  bool TryAcquire() noexcept {
+    auto tokens = tokens_.load();
+    while (tokens >= kTokenScale) {
+      if (tokens_.compare_exchange_weak(tokens, tokens - kTokenScale)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+ private:
+  /// Tokens are kept in thousandths to support fractional ratios.
+  static constexpr int64_t kTokenScale = 1000;
+
+  const int64_t tokens_per_request_;
+  const int64_t max_tokens_;
+  std::atomic<int64_t> tokens_;
+};
+
+}  // namespace privacy_sandbox::pbs_common
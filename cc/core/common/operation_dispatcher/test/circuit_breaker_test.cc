@@ -0,0 +1,98 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cc/core/common/operation_dispatcher/src/circuit_breaker.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+
+namespace privacy_sandbox::pbs_common {
+namespace {
+
+CircuitBreakerOptions GetOptions(size_t half_open_max_probes = 1) {
+  CircuitBreakerOptions options;
+  options.failure_threshold = 3;
+  options.open_duration = std::chrono::milliseconds(50);
+  options.half_open_max_probes = half_open_max_probes;
+  return options;
+}
+
+TEST(CircuitBreakerTest, NeverOpensWhenDisabled) {
+  CircuitBreaker circuit_breaker({});
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_TRUE(circuit_breaker.TryAcquire());
+    circuit_breaker.OnFailure();
+  }
+  EXPECT_EQ(circuit_breaker.GetState(), CircuitBreakerState::Closed);
+}
+
+TEST(CircuitBreakerTest, OpensAfterConsecutiveFailures) {
+  CircuitBreaker circuit_breaker(GetOptions());
+  circuit_breaker.OnFailure();
+  circuit_breaker.OnFailure();
+  // A success resets the consecutive failures.
+  circuit_breaker.OnSuccess();
+  circuit_breaker.OnFailure();
+  circuit_breaker.OnFailure();
+  EXPECT_EQ(circuit_breaker.GetState(), CircuitBreakerState::Closed);
+  EXPECT_TRUE(circuit_breaker.TryAcquire());
+
+  circuit_breaker.OnFailure();
+  EXPECT_EQ(circuit_breaker.GetState(), CircuitBreakerState::Open);
+  EXPECT_FALSE(circuit_breaker.TryAcquire());
+  EXPECT_FALSE(circuit_breaker.TryAcquire());
+  EXPECT_EQ(circuit_breaker.GetRejectedOperationCount(), 2);
+}
+
+TEST(CircuitBreakerTest, SuccessfulProbeClosesTheCircuit) {
+  CircuitBreaker circuit_breaker(GetOptions());
+  for (int i = 0; i < 3; ++i) {
+    circuit_breaker.OnFailure();
+  }
+  EXPECT_FALSE(circuit_breaker.TryAcquire());
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(60));
+  EXPECT_TRUE(circuit_breaker.TryAcquire());
+  EXPECT_EQ(circuit_breaker.GetState(), CircuitBreakerState::HalfOpen);
+  // Only one probe at a time.
+  EXPECT_FALSE(circuit_breaker.TryAcquire());
+
+  circuit_breaker.OnSuccess();
+  EXPECT_EQ(circuit_breaker.GetState(), CircuitBreakerState::Closed);
+  EXPECT_TRUE(circuit_breaker.TryAcquire());
+  EXPECT_TRUE(circuit_breaker.TryAcquire());
+}
+
+TEST(CircuitBreakerTest, FailedProbeOpensTheCircuitAgain) {
+  CircuitBreaker circuit_breaker(GetOptions(/*half_open_max_probes=*/2));
+  for (int i = 0; i < 3; ++i) {
+    circuit_breaker.OnFailure();
+  }
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(60));
+  EXPECT_TRUE(circuit_breaker.TryAcquire());
+  EXPECT_TRUE(circuit_breaker.TryAcquire());
+  EXPECT_FALSE(circuit_breaker.TryAcquire());
+
+  circuit_breaker.OnFailure();
+  EXPECT_EQ(circuit_breaker.GetState(), CircuitBreakerState::Open);
+  EXPECT_FALSE(circuit_breaker.TryAcquire());
+}
+
+}  // namespace
+}  // namespace privacy_sandbox::pbs_common
@@ -192,5 +192,106 @@ TEST(OperationDispatcherTests, RetryOnAcceptance) {
   dispatcher.Dispatch(context, dispatch_to_component);
   WaitUntil([&]() { return condition.load(); });
 }
+
+TEST(OperationDispatcherTests, RetryBudgetLimitsRetries) {
+  std::shared_ptr<AsyncExecutorInterface> mock_async_executor =
+      std::make_shared<MockAsyncExecutor>();
+  RetryStrategy retry_strategy(RetryStrategyType::Exponential, 0, 5);
+  RetryBudgetOptions retry_budget_options;
+  retry_budget_options.ratio = 0.1;
+  retry_budget_options.max_tokens = 2;
+  OperationDispatcher dispatcher(
+      mock_async_executor, retry_strategy,
+      std::make_shared<RetryBudget>(retry_budget_options));
+
+  std::atomic<bool> condition(false);
+  AsyncContext<std::string, std::string> context;
+  context.callback = [&](AsyncContext<std::string, std::string>& context) {
+    EXPECT_THAT(
+        context.result,
+        ResultIs(FailureExecutionResult(SC_DISPATCHER_RETRY_BUDGET_EXHAUSTED)));
+    condition = true;
+  };
+
+  std::function<ExecutionResult(AsyncContext<std::string, std::string>&)>
+      dispatch_to_component =
+          [](AsyncContext<std::string, std::string>& context) {
+            return RetryExecutionResult(1234);
+          };
+
+  dispatcher.Dispatch(context, dispatch_to_component);
+  WaitUntil([&]() { return condition.load(); });
+  EXPECT_EQ(dispatcher.GetRetryCount(), 2);
+  EXPECT_EQ(dispatcher.GetRejectedRetryCount(), 1);
+}
+
+TEST(OperationDispatcherTests, RetryBudgetWithoutARatioDoesNotLimitRetries) {
+  std::shared_ptr<AsyncExecutorInterface> mock_async_executor =
+      std::make_shared<MockAsyncExecutor>();
+  RetryStrategy retry_strategy(RetryStrategyType::Exponential, 0, 5);
+  RetryBudgetOptions retry_budget_options;
+  retry_budget_options.ratio = 0;
+  retry_budget_options.max_tokens = 2;
+  OperationDispatcher dispatcher(
+      mock_async_executor, retry_strategy,
+      std::make_shared<RetryBudget>(retry_budget_options));
+
+  std::atomic<bool> condition(false);
+  AsyncContext<std::string, std::string> context;
+  context.callback = [&](AsyncContext<std::string, std::string>& context) {
+    EXPECT_THAT(
+        context.result,
+        ResultIs(FailureExecutionResult(SC_DISPATCHER_EXHAUSTED_RETRIES)));
+    condition = true;
+  };
+
+  std::function<ExecutionResult(AsyncContext<std::string, std::string>&)>
+      dispatch_to_component =
+          [](AsyncContext<std::string, std::string>& context) {
+            return RetryExecutionResult(1234);
+          };
+
+  dispatcher.Dispatch(context, dispatch_to_component);
+  WaitUntil([&]() { return condition.load(); });
+  // Runs out of retries rather than budget.
+  EXPECT_EQ(dispatcher.GetRetryCount(), 4);
+  EXPECT_EQ(dispatcher.GetRejectedRetryCount(), 0);
+}
+
+TEST(OperationDispatcherTests, OpenCircuitBreakerFailsOperationsRightAway) {
+  std::shared_ptr<AsyncExecutorInterface> mock_async_executor =
+      std::make_shared<MockAsyncExecutor>();
+  RetryStrategy retry_strategy(RetryStrategyType::Exponential, 0, 5);
+  OperationDispatcher dispatcher(mock_async_executor, retry_strategy);
+  CircuitBreakerOptions circuit_breaker_options;
+  circuit_breaker_options.failure_threshold = 2;
+  auto circuit_breaker =
+      std::make_shared<CircuitBreaker>(circuit_breaker_options);
+
+  std::atomic<int> calls(0);
+  std::function<ExecutionResult(AsyncContext<std::string, std::string>&)>
+      dispatch_to_component =
+          [&](AsyncContext<std::string, std::string>& context) {
+            calls++;
+            return RetryExecutionResult(1234);
+          };
+
+  for (int i = 0; i < 2; ++i) {
+    std::atomic<bool> condition(false);
+    AsyncContext<std::string, std::string> context;
+    context.callback = [&](AsyncContext<std::string, std::string>& context) {
+      EXPECT_THAT(context.result, ResultIs(FailureExecutionResult(
+                                      SC_DISPATCHER_CIRCUIT_BREAKER_OPEN)));
+      condition = true;
+    };
+    dispatcher.Dispatch(context, dispatch_to_component, circuit_breaker);
+    WaitUntil([&]() { return condition.load(); });
+  }
+
+  // The second operation did not reach the component at all.
+  EXPECT_EQ(calls.load(), 2);
+  EXPECT_EQ(circuit_breaker->GetState(), CircuitBreakerState::Open);
+  EXPECT_EQ(circuit_breaker->GetRejectedOperationCount(), 2);
+}
 }  // namespace
 }  // namespace privacy_sandbox::pbs_common
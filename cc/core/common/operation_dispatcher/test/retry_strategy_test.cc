@@ -41,4 +41,31 @@ TEST(RetryStrategyTests, LinearRetryStrategyTest) {
   EXPECT_EQ(retry_strategy.GetMaximumAllowedRetryCount(), 5);
 }
 
+TEST(RetryStrategyTests, ExponentialWithFullJitterRetryStrategyTest) {
+  RetryStrategy retry_strategy(RetryStrategyType::ExponentialWithFullJitter,
+                               1000, 5);
+  EXPECT_EQ(retry_strategy.GetBackOffDurationInMilliseconds(0), 0);
+  bool jittered = false;
+  for (int i = 0; i < 100; ++i) {
+    auto back_off = retry_strategy.GetBackOffDurationInMilliseconds(3);
+    EXPECT_LE(back_off, 4000);
+    jittered |= back_off != retry_strategy.GetBackOffDurationInMilliseconds(3);
+  }
+  EXPECT_TRUE(jittered);
+}
+
+TEST(RetryStrategyTests, ExponentialWithEqualJitterRetryStrategyTest) {
+  RetryStrategy retry_strategy(RetryStrategyType::ExponentialWithEqualJitter,
+                               1000, 5);
+  EXPECT_EQ(retry_strategy.GetBackOffDurationInMilliseconds(0), 0);
+  bool jittered = false;
+  for (int i = 0; i < 100; ++i) {
+    auto back_off = retry_strategy.GetBackOffDurationInMilliseconds(3);
+    EXPECT_GE(back_off, 2000);
+    EXPECT_LE(back_off, 4000);
+    jittered |= back_off != retry_strategy.GetBackOffDurationInMilliseconds(3);
+  }
+  EXPECT_TRUE(jittered);
+}
+
 }  // namespace privacy_sandbox::pbs_common
@@ -0,0 +1,59 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cc/core/common/operation_dispatcher/src/token_bucket.h"
+
+#include <gtest/gtest.h>
+
+namespace privacy_sandbox::pbs_common {
+namespace {
+
+TEST(TokenBucketTest, AllowsABurstThenARatioOfTheRequests) {
+  TokenBucket token_bucket(/*ratio=*/0.1, /*max_tokens=*/2);
+
+  EXPECT_TRUE(token_bucket.TryAcquire());
+  EXPECT_TRUE(token_bucket.TryAcquire());
+  EXPECT_FALSE(token_bucket.TryAcquire());
+
+  for (int i = 0; i < 9; ++i) {
+    token_bucket.Deposit();
+  }
+  EXPECT_FALSE(token_bucket.TryAcquire());
+  token_bucket.Deposit();
+  EXPECT_TRUE(token_bucket.TryAcquire());
+  EXPECT_FALSE(token_bucket.TryAcquire());
+}
+
+TEST(TokenBucketTest, TokensDoNotExceedTheBurst) {
+  TokenBucket token_bucket(/*ratio=*/1, /*max_tokens=*/1);
+
+  for (int i = 0; i < 10; ++i) {
+    token_bucket.Deposit();
+  }
+  EXPECT_TRUE(token_bucket.TryAcquire());
+  EXPECT_FALSE(token_bucket.TryAcquire());
+}
+
+TEST(TokenBucketTest, NeverRefillsWithoutARatio) {
+  TokenBucket token_bucket(/*ratio=*/0, /*max_tokens=*/1);
+
+  EXPECT_TRUE(token_bucket.TryAcquire());
+  token_bucket.Deposit();
+  EXPECT_FALSE(token_bucket.TryAcquire());
+}
+
+}  // namespace
+}  // namespace privacy_sandbox::pbs_common
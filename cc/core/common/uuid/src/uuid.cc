@@ -42,12 +42,10 @@ Uuid Uuid::GenerateUuid() noexcept {
   return Uuid{.high = high, .low = low};
 }
 
-inline void AppendHex(uint64_t byte, std::string& string_to_append) {
-  int first_digit = byte >> 4;
-  string_to_append += kHexMap[first_digit];
-
-  int second_digit = byte & 0x0F;
-  string_to_append += kHexMap[second_digit];
+inline char* WriteHex(uint64_t byte, char* output) {
+  *output++ = kHexMap[byte >> 4];
+  *output++ = kHexMap[byte & 0x0F];
+  return output;
 }
 
 inline int HexToPosition(char hex) {
@@ -59,50 +57,51 @@ inline uint64_t ReadHex(const std::string& string_to_read, int offset) {
          HexToPosition(string_to_read[offset + 1]);
 }
 
-std::string ToString(const Uuid& uuid) noexcept {
+void ToString(const Uuid& uuid, char* output) noexcept {
   // Uuid has two 8 bytes variable, high and low. Printing each byte to a
   // hexadecimal value a guid can be generated.
-  std::string uuid_string;
-  uuid_string.reserve(36);
-
   const uint64_t& high = uuid.high;
   const uint64_t& low = uuid.low;
 
   // Guid format is 00000000-0000-0000-0000-000000000000
   // 4 bytes
-  AppendHex((high >> 56) & 0xFF, uuid_string);
-  AppendHex((high >> 48) & 0xFF, uuid_string);
-  AppendHex((high >> 40) & 0xFF, uuid_string);
-  AppendHex((high >> 32) & 0xFF, uuid_string);
+  output = WriteHex((high >> 56) & 0xFF, output);
+  output = WriteHex((high >> 48) & 0xFF, output);
+  output = WriteHex((high >> 40) & 0xFF, output);
+  output = WriteHex((high >> 32) & 0xFF, output);
 
-  uuid_string += "-";
+  *output++ = '-';
 
   // 2 bytes
-  AppendHex((high >> 24) & 0xFF, uuid_string);
-  AppendHex((high >> 16) & 0xFF, uuid_string);
+  output = WriteHex((high >> 24) & 0xFF, output);
+  output = WriteHex((high >> 16) & 0xFF, output);
 
-  uuid_string += "-";
+  *output++ = '-';
 
   // 2 bytes
-  AppendHex((high >> 8) & 0xFF, uuid_string);
-  AppendHex(high & 0xFF, uuid_string);
+  output = WriteHex((high >> 8) & 0xFF, output);
+  output = WriteHex(high & 0xFF, output);
 
-  uuid_string += "-";
+  *output++ = '-';
 
   // 2 bytes
-  AppendHex((low >> 56) & 0xFF, uuid_string);
-  AppendHex((low >> 48) & 0xFF, uuid_string);
+  output = WriteHex((low >> 56) & 0xFF, output);
+  output = WriteHex((low >> 48) & 0xFF, output);
 
-  uuid_string += "-";
+  *output++ = '-';
 
   // 6 bytes
-  AppendHex((low >> 40) & 0xFF, uuid_string);
-  AppendHex((low >> 32) & 0xFF, uuid_string);
-  AppendHex((low >> 24) & 0xFF, uuid_string);
-  AppendHex((low >> 16) & 0xFF, uuid_string);
-  AppendHex((low >> 8) & 0xFF, uuid_string);
-  AppendHex(low & 0xFF, uuid_string);
+  output = WriteHex((low >> 40) & 0xFF, output);
+  output = WriteHex((low >> 32) & 0xFF, output);
+  output = WriteHex((low >> 24) & 0xFF, output);
+  output = WriteHex((low >> 16) & 0xFF, output);
+  output = WriteHex((low >> 8) & 0xFF, output);
+  WriteHex(low & 0xFF, output);
+}
 
+std::string ToString(const Uuid& uuid) noexcept {
+  std::string uuid_string(kUuidStringLength, '0');
+  ToString(uuid, uuid_string.data());
   return uuid_string;
 }
 
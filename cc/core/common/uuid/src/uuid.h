@@ -76,6 +76,19 @@ struct UuidHash {
  */
 std::string ToString(const Uuid& uuid) noexcept;
 
+/// The length of a Uuid converted to string.
+inline constexpr size_t kUuidStringLength = 36;
+
+/**
+ * @brief Converts a Uuid object to string without allocating. The format of
+ * the output is the same as ToString(uuid).
+ *
+ * @param uuid The uuid to be converted to guid string.
+ * @param output The buffer of at least kUuidStringLength characters the guid
+ * is written to. It is not null terminated.
+ */
+void ToString(const Uuid& uuid, char* output) noexcept;
+
 /**
  * @brief Parses a Uuid object from a provided string.
  *
@@ -40,6 +40,15 @@ TEST(UuidTests, UuidToString) {
   EXPECT_EQ(parsed_uuid, uuid);
 }
 
+TEST(UuidTests, UuidToBuffer) {
+  Uuid uuid{.high = 0x0123456789ABCDEF, .low = 0xFEDCBA9876543210};
+
+  char buffer[kUuidStringLength + 1] = {};
+  ToString(uuid, buffer);
+  EXPECT_STREQ(buffer, "01234567-89AB-CDEF-FEDC-BA9876543210");
+  EXPECT_EQ(ToString(uuid), buffer);
+}
+
 TEST(UuidTests, InvalidUuidString) {
   std::string uuid_string = "123";
   Uuid parsed_uuid;
@@ -32,9 +32,17 @@ class MockHttpConnectionPool : public HttpConnectionPool {
   MockHttpConnectionPool(
       const std::shared_ptr<AsyncExecutorInterface>& async_executor,
       absl::Nullable<MetricRouter*> metric_router,
-      size_t max_connection_per_host)
+      size_t max_connection_per_host,
+      size_t max_elastic_connections_per_host = 0,
+      size_t connection_growth_streams = kDefaultConnectionGrowthStreams,
+      TimeDuration idle_connection_timeout_in_sec =
+          kDefaultIdleConnectionTimeoutInSeconds)
       : HttpConnectionPool(async_executor, metric_router,
-                           max_connection_per_host) {}
+                           max_connection_per_host,
+                           kDefaultHttp2ReadTimeoutInSeconds,
+                           max_elastic_connections_per_host,
+                           connection_growth_streams,
+                           idle_connection_timeout_in_sec) {}
 
   std::shared_ptr<HttpConnection> CreateHttpConnection(
       std::string host, std::string service, bool is_https,
@@ -56,6 +64,7 @@ class MockHttpConnectionPool : public HttpConnectionPool {
     for (auto& key : keys) {
       std::shared_ptr<MockHttpConnectionPool::HttpConnectionPoolEntry> value;
       EXPECT_SUCCESS(connections_.Find(key, value));
+      std::lock_guard lock(value->lock);
       for (auto& http_connection : value->http_connections) {
         connections[key].push_back(http_connection);
       }
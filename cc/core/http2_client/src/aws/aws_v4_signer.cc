@@ -19,9 +19,10 @@
 #include <time.h>
 
 #include <algorithm>
+#include <cctype>
 #include <chrono>
-#include <sstream>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -35,7 +36,6 @@ using boost::algorithm::find_nth;
 using boost::algorithm::is_any_of;
 using boost::algorithm::join;
 using boost::algorithm::split;
-using boost::algorithm::to_lower_copy;
 using boost::algorithm::token_compress_off;
 using boost::algorithm::token_compress_on;
 
@@ -47,6 +47,7 @@ static constexpr const char* kAmzDateFormat = "%Y%m%dT%H%M%SZ";
 static constexpr const char* kAmzSecurityTokenHeader = "X-Amz-Security-Token";
 static constexpr const char* kAuthorizationHeader = "Authorization";
 static constexpr const char* kSigV4Algorithm = "AWS4-HMAC-SHA256";
+static constexpr std::string_view kCredentialScopeSuffix = "/aws4_request";
 static constexpr const char* hex_lookup = "0123456789abcdef";
 
 namespace privacy_sandbox::pbs_common {
@@ -62,7 +63,7 @@ static std::string HexEncode(unsigned char data[], size_t size) {
   return result;
 }
 
-static std::string Sha256(const std::string& data) {
+static std::string Sha256(std::string_view data) {
   SHA256_CTX sha256;
   SHA256_Init(&sha256);
   SHA256_Update(&sha256, data.data(), data.size());
@@ -72,7 +73,7 @@ static std::string Sha256(const std::string& data) {
 }
 
 std::vector<unsigned char> HmacSha256(const std::vector<unsigned char>& key,
-                                      const std::string& data) {
+                                      std::string_view data) {
   unsigned char hmac[EVP_MAX_MD_SIZE];
   unsigned int size = 0;
   HMAC(EVP_sha256(), key.data(), key.size(),
@@ -81,6 +82,17 @@ std::vector<unsigned char> HmacSha256(const std::vector<unsigned char>& key,
   return std::vector(hmac, hmac + size);
 }
 
+static char ToLowerAscii(char c) {
+  return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+}
+
+/// Appends \a value to \a out in lower case.
+static void AppendLowerCase(std::string& out, std::string_view value) {
+  for (char c : value) {
+    out.push_back(ToLowerAscii(c));
+  }
+}
+
 AwsV4Signer::AwsV4Signer(const std::string& aws_access_key,
                          const std::string& aws_secret_key,
                          const std::string& aws_security_token,
@@ -100,6 +112,33 @@ ExecutionResult AwsV4Signer::SignRequest(
   return SignRequest(http_request, headers);
 }
 
+void AwsV4Signer::SortHeadersToSign(std::vector<std::string>& headers_to_sign) {
+  std::sort(headers_to_sign.begin(), headers_to_sign.end(),
+            [](const std::string& a, const std::string& b) {
+              return std::lexicographical_compare(
+                  a.begin(), a.end(), b.begin(), b.end(), [](char x, char y) {
+                    return ToLowerAscii(x) < ToLowerAscii(y);
+                  });
+            });
+}
+
+std::string AwsV4Signer::JoinSignedHeaders(
+    const std::vector<std::string>& headers_to_sign) {
+  size_t size = 0;
+  for (const auto& header : headers_to_sign) {
+    size += header.size() + 1;
+  }
+  std::string signed_headers;
+  signed_headers.reserve(size);
+  for (const auto& header : headers_to_sign) {
+    if (!signed_headers.empty()) {
+      signed_headers.push_back(';');
+    }
+    AppendLowerCase(signed_headers, header);
+  }
+  return signed_headers;
+}
+
 ExecutionResult AwsV4Signer::GetSignatureParts(
     HttpRequest& http_request, std::vector<std::string>& headers_to_sign,
     std::string& signature, std::string& x_amz_date) noexcept {
@@ -151,10 +190,7 @@ ExecutionResult AwsV4Signer::GetSignatureParts(
   }
 
   // Sort all headers in headers_to_sign by its all lower cases order.
-  std::sort(headers_to_sign.begin(), headers_to_sign.end(),
-            [](const std::string& a, const std::string& b) {
-              return to_lower_copy(a) < to_lower_copy(b);
-            });
+  SortHeadersToSign(headers_to_sign);
   // #1 Create canonical request
   // https://docs.aws.amazon.com/general/latest/gr/sigv4-create-canonical-request.html
   std::string canonical_request;
@@ -165,14 +201,23 @@ ExecutionResult AwsV4Signer::GetSignatureParts(
   }
   // #2 Create std::string to sign
   // https://docs.aws.amazon.com/general/latest/gr/sigv4-create-std::string-to-sign.html
-  std::stringstream str_to_sign_builder;
-  str_to_sign_builder << kSigV4Algorithm << '\n' << timestamp_value << '\n';
   // Take the front part of the timestamp as date.
-  std::string date = DateFromTimestamp(timestamp_value);
-  str_to_sign_builder << date << '/' << aws_region_ << '/' << service_name_
-                      << "/aws4_request\n";
-  str_to_sign_builder << Sha256(canonical_request);
-  std::string str_to_sign = str_to_sign_builder.str();
+  std::string_view date = DateFromTimestamp(timestamp_value);
+  std::string str_to_sign;
+  str_to_sign.reserve(128 + timestamp_value.size() + aws_region_.size() +
+                      service_name_.size());
+  str_to_sign.append(kSigV4Algorithm)
+      .append(1, '\n')
+      .append(timestamp_value)
+      .append(1, '\n')
+      .append(date)
+      .append(1, '/')
+      .append(aws_region_)
+      .append(1, '/')
+      .append(service_name_)
+      .append(kCredentialScopeSuffix)
+      .append(1, '\n')
+      .append(Sha256(canonical_request));
   // #3 Calculate signature
   // https://docs.aws.amazon.com/general/latest/gr/sigv4-calculate-signature.html
   std::string signature_hex = CalculateSignature(str_to_sign, date);
@@ -195,16 +240,17 @@ ExecutionResult AwsV4Signer::SignRequest(
   if (!ret) {
     return ret;
   }
-  std::string date = DateFromTimestamp(x_amz_date);
   // #4 Add to HTTP request
   // https://docs.aws.amazon.com/general/latest/gr/sigv4-add-signature-to-request.html
-  AddSignatureHeader(http_request, headers_to_sign, date, signature);
+  AddSignatureHeader(http_request, aws_access_key_, aws_security_token_,
+                     JoinSignedHeaders(headers_to_sign),
+                     DateFromTimestamp(x_amz_date), signature);
 
   return SuccessExecutionResult();
 }
 
 std::string AwsV4Signer::CalculateSignature(const std::string& string_to_sign,
-                                            const std::string& date) noexcept {
+                                            std::string_view date) noexcept {
   std::string init_key_str = std::string("AWS4") + aws_secret_key_;
   std::vector<unsigned char> secret(init_key_str.begin(), init_key_str.end());
   auto hmac_date = HmacSha256(secret, date);
@@ -218,36 +264,40 @@ std::string AwsV4Signer::CalculateSignature(const std::string& string_to_sign,
 ExecutionResult AwsV4Signer::CreateCanonicalRequest(
     std::string& canonical_request, HttpRequest& http_request,
     const std::vector<std::string>& headers_to_sign) noexcept {
-  std::stringstream canonical_request_builder;
   if (http_request.method == HttpMethod::UNKNOWN) {
     return FailureExecutionResult(SC_HTTP2_CLIENT_AUTH_BAD_REQUEST);
   }
   if (!http_request.path || !http_request.headers) {
     return FailureExecutionResult(SC_HTTP2_CLIENT_AUTH_BAD_REQUEST);
   }
+  // The whole canonical request is written into a single buffer. Reserve
+  // enough for the common case upfront so that it is allocated only once.
+  canonical_request.clear();
+  canonical_request.reserve(256 + http_request.path->size() +
+                            (http_request.query ? http_request.query->size()
+                                                : 0));
   if (http_request.method == HttpMethod::GET) {
-    canonical_request_builder << "GET\n";
+    canonical_request.append("GET\n");
   }
   if (http_request.method == HttpMethod::POST) {
-    canonical_request_builder << "POST\n";
+    canonical_request.append("POST\n");
   }
 
   // If path is in the form of "/path/to/resource", use it as-is. Otherwise,
   // assume it is in form of "https://example.com/path/to/resource", and here we
   // extract the path part after the host name by finding the third '/'
   auto& path = *http_request.path;
-  std::string canonical_path;
   if (path.length() > 0 && path[0] == '/') {
-    canonical_path = path;
+    canonical_request.append(path);
   } else {
     auto itr = find_nth(path, "/", 2);
     if (itr.empty()) {
-      canonical_path = "/";
+      canonical_request.append(1, '/');
     } else {
-      canonical_path = path.substr(std::distance(path.begin(), itr.begin()));
+      canonical_request.append(itr.begin(), path.end());
     }
   }
-  canonical_request_builder << canonical_path << "\n";
+  canonical_request.append(1, '\n');
   if (http_request.query && http_request.query->size() > 0) {
     // If we have any query parameters, sort them.
     // First, we split by '&';
@@ -256,16 +306,11 @@ ExecutionResult AwsV4Signer::CreateCanonicalRequest(
     split(query_params, *http_request.query, predicate, token_compress_off);
     // Then, sort and re-assemble
     std::sort(query_params.begin(), query_params.end());
-    std::string sorted_query = join(query_params, "&");
-    canonical_request_builder << sorted_query;
+    canonical_request.append(join(query_params, "&"));
   }
-  canonical_request_builder << "\n";
-  // The "signed headers" in the form of ';' delimited, all lower case
-  // std::string. e.g. content-type;host;x-amz-date
+  canonical_request.append(1, '\n');
+  // Produce the header:value strings in the canonical request.
   auto& headers = http_request.headers;
-  std::stringstream signed_headers;
-  // In the following loop, we produce two things: the header:value strings in
-  // the canonical request, and the "signed headers";
   for (const auto& header : headers_to_sign) {
     // There might be multiple values of the same header name, in which case the
     // values are put as a comma delimited list.
@@ -274,30 +319,33 @@ ExecutionResult AwsV4Signer::CreateCanonicalRequest(
       // The required header does not exist in http_request. Return error.
       return FailureExecutionResult(SC_HTTP2_CLIENT_AUTH_MISSING_HEADER);
     }
-    auto header_lower = to_lower_copy(header);
     auto iter = header_entry.first;
     // Put the first header
-    canonical_request_builder << header_lower << ':' << iter->second;
+    AppendLowerCase(canonical_request, header);
+    canonical_request.append(1, ':').append(iter->second);
     ++iter;
     for (; iter != header_entry.second; ++iter) {
-      canonical_request_builder << ',' << iter->second;
+      canonical_request.append(1, ',').append(iter->second);
     }
-    canonical_request_builder << '\n';
-    signed_headers << header_lower << ';';
+    canonical_request.append(1, '\n');
   }
-  canonical_request_builder << "\n";
+  canonical_request.append(1, '\n');
 
-  signed_headers.seekp(-1, std::ios_base::end);  // remove the last semi-colon
-  signed_headers << '\n';
-  canonical_request_builder << signed_headers.str();
+  // The "signed headers" in the form of ';' delimited, all lower case
+  // std::string. e.g. content-type;host;x-amz-date
+  for (size_t i = 0; i < headers_to_sign.size(); ++i) {
+    if (i > 0) {
+      canonical_request.append(1, ';');
+    }
+    AppendLowerCase(canonical_request, headers_to_sign[i]);
+  }
+  canonical_request.append(1, '\n');
   if (http_request.body.length > 0) {
-    std::string body(http_request.body.bytes->data(),
-                     http_request.body.bytes->size());
-    canonical_request_builder << Sha256(body);
+    canonical_request.append(Sha256(std::string_view(
+        http_request.body.bytes->data(), http_request.body.bytes->size())));
   } else {
-    canonical_request_builder << kEmptyStringSha256;
+    canonical_request.append(kEmptyStringSha256);
   }
-  canonical_request = canonical_request_builder.str();
   return SuccessExecutionResult();
 }
 
@@ -305,43 +353,66 @@ ExecutionResult AwsV4Signer::SignRequestWithSignature(
     HttpRequest& http_request, std::vector<std::string>& headers_to_sign,
     const std::string& x_amz_date, const std::string& signature) noexcept {
   // Sort all headers in headers_to_sign by its all lower cases order.
-  std::sort(headers_to_sign.begin(), headers_to_sign.end(),
-            [](const std::string& a, const std::string& b) {
-              return to_lower_copy(a) < to_lower_copy(b);
-            });
+  SortHeadersToSign(headers_to_sign);
+  return SignRequestWithSignature(http_request, aws_access_key_,
+                                  aws_security_token_,
+                                  JoinSignedHeaders(headers_to_sign),
+                                  x_amz_date, signature);
+}
+
+ExecutionResult AwsV4Signer::SignRequestWithSignature(
+    HttpRequest& http_request, std::string_view aws_access_key,
+    std::string_view aws_security_token, std::string_view signed_headers,
+    std::string_view x_amz_date, std::string_view signature) const noexcept {
   if (!http_request.headers) {
     return FailureExecutionResult(SC_HTTP2_CLIENT_AUTH_BAD_REQUEST);
   }
   // Remove potentially existing X-Amz-Date header, insert designated one.
   http_request.headers->erase(std::string(kAmzDateHeader));
-  http_request.headers->insert({std::string(kAmzDateHeader), x_amz_date});
-  std::string date = DateFromTimestamp(x_amz_date);
-  AddSignatureHeader(http_request, headers_to_sign, date, signature);
+  http_request.headers->insert(
+      {std::string(kAmzDateHeader), std::string(x_amz_date)});
+  AddSignatureHeader(http_request, aws_access_key, aws_security_token,
+                     signed_headers, DateFromTimestamp(x_amz_date), signature);
   return SuccessExecutionResult();
 }
 
-void AwsV4Signer::AddSignatureHeader(
-    HttpRequest& http_request, const std::vector<std::string>& headers_to_sign,
-    const std::string& date, const std::string& signature) {
+void AwsV4Signer::AddSignatureHeader(HttpRequest& http_request,
+                                     std::string_view aws_access_key,
+                                     std::string_view aws_security_token,
+                                     std::string_view signed_headers,
+                                     std::string_view date,
+                                     std::string_view signature) const {
   auto& headers = http_request.headers;
-  std::stringstream auth_header_value_builder;
-  auth_header_value_builder
-      << kSigV4Algorithm << " Credential=" << aws_access_key_ << '/' << date
-      << '/' << aws_region_ << '/' << service_name_ << "/aws4_request, "
-      << "SignedHeaders=";
-  for (const auto& header : headers_to_sign) {
-    auth_header_value_builder << to_lower_copy(header) << ';';
-  }
-  auth_header_value_builder.seekp(-1, std::ios_base::end);
-  auth_header_value_builder << ", Signature=" << signature;
-  auto auth_header_value = auth_header_value_builder.str();
-  headers->insert({kAuthorizationHeader, auth_header_value});
+  static constexpr std::string_view kCredential = " Credential=";
+  static constexpr std::string_view kSignedHeaders = ", SignedHeaders=";
+  static constexpr std::string_view kSignature = ", Signature=";
+  std::string auth_header_value;
+  auth_header_value.reserve(
+      64 + kCredential.size() + aws_access_key.size() + date.size() +
+      aws_region_.size() + service_name_.size() +
+      kCredentialScopeSuffix.size() + kSignedHeaders.size() +
+      signed_headers.size() + kSignature.size() + signature.size());
+  auth_header_value.append(kSigV4Algorithm)
+      .append(kCredential)
+      .append(aws_access_key)
+      .append(1, '/')
+      .append(date)
+      .append(1, '/')
+      .append(aws_region_)
+      .append(1, '/')
+      .append(service_name_)
+      .append(kCredentialScopeSuffix)
+      .append(kSignedHeaders)
+      .append(signed_headers)
+      .append(kSignature)
+      .append(signature);
+  headers->insert({kAuthorizationHeader, std::move(auth_header_value)});
 
   // If the X-Amz-Security-Token header does not exist, add it.
-  std::string token;
-  if (!aws_security_token_.empty() &&
+  if (!aws_security_token.empty() &&
       headers->count(kAmzSecurityTokenHeader) == 0) {
-    headers->insert({kAmzSecurityTokenHeader, aws_security_token_});
+    headers->insert(
+        {kAmzSecurityTokenHeader, std::string(aws_security_token)});
   }
 }
 
@@ -16,6 +16,7 @@
 
 #pragma once
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "cc/core/interface/http_types.h"
@@ -90,6 +91,25 @@ class AwsV4Signer {
       HttpRequest& http_request, std::vector<std::string>& headers_to_sign,
       const std::string& x_amz_date, const std::string& signature) noexcept;
 
+  /**
+   * @brief Sign the request based on a pre-calculated signature made with the
+   * given credentials instead of the signer's own. This lets a single signer
+   * per region and service sign the requests of any caller.
+   *
+   * @param[in,out] http_request The HttpRequest to sign.
+   * @param aws_access_key The access key the signature was made with.
+   * @param aws_security_token The session token, if any.
+   * @param signed_headers The lower case headers to include, sorted and ";"
+   * delimited, e.g. "host;x-amz-date".
+   * @param x_amz_date The date string the signature was made at.
+   * @param signature The pre-calculated signature.
+   * @return ExecutionResult
+   */
+  ExecutionResult SignRequestWithSignature(
+      HttpRequest& http_request, std::string_view aws_access_key,
+      std::string_view aws_security_token, std::string_view signed_headers,
+      std::string_view x_amz_date, std::string_view signature) const noexcept;
+
   /**
    * @brief Calculate the signature of a request. Return the parts useful for
    * signing or pre-signing.
@@ -131,29 +151,44 @@ class AwsV4Signer {
    */
   static std::string GetSigningTime();
 
-  static inline std::string DateFromTimestamp(const std::string x_amz_date) {
+  static inline std::string_view DateFromTimestamp(
+      std::string_view x_amz_date) {
     constexpr size_t date_len = sizeof("YYYYMMdd") - 1;
     return x_amz_date.substr(0, date_len);
   }
 
+  /**
+   * @brief Sort \a headers_to_sign by their lower case order.
+   */
+  static void SortHeadersToSign(std::vector<std::string>& headers_to_sign);
+
+  /**
+   * @brief Produce the "signed headers" of the pre-sorted \a headers_to_sign,
+   * i.e. their lower case names delimited by ';'.
+   */
+  static std::string JoinSignedHeaders(
+      const std::vector<std::string>& headers_to_sign);
+
   /**
    * @brief Calculate the signature of string_to_sign.
    *
    * @return std::string The signature in hex string form.
    */
   std::string CalculateSignature(const std::string& string_to_sign,
-                                 const std::string& date) noexcept;
+                                 std::string_view date) noexcept;
 
   /**
    * @brief Produce a signature header and add to the request.
    *
-   * @param[in] headers_to_sign The pre-sorted headers to sign.
+   * @param[in] signed_headers The ";" delimited lower case headers to sign.
    * @param signature  The signature in hex.
    */
   void AddSignatureHeader(HttpRequest& http_request,
-                          const std::vector<std::string>& headers_to_sign,
-                          const std::string& date,
-                          const std::string& signature);
+                          std::string_view aws_access_key,
+                          std::string_view aws_security_token,
+                          std::string_view signed_headers,
+                          std::string_view date,
+                          std::string_view signature) const;
 
   const std::string aws_access_key_;
   const std::string aws_secret_key_;
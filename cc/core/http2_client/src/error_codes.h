@@ -176,4 +176,10 @@ DEFINE_ERROR_CODE(SC_HTTP2_CLIENT_HTTP_CONNECTION_NOT_READY, SC_HTTP2_CLIENT,
 DEFINE_ERROR_CODE(SC_HTTP2_CLIENT_REQUEST_HEADER_NOT_FOUND, SC_HTTP2_CLIENT,
                   0x00036, "Request header not found.",
                   HttpStatusCode::BAD_REQUEST)
+DEFINE_ERROR_CODE(SC_HTTP2_CLIENT_INVALID_IO_CONTEXT_POOL_SIZE, SC_HTTP2_CLIENT,
+                  0x0037, "The shared io context pool has no io context",
+                  HttpStatusCode::INTERNAL_SERVER_ERROR)
+DEFINE_ERROR_CODE(SC_HTTP2_CLIENT_HEDGED_REQUEST_CANCELLED, SC_HTTP2_CLIENT,
+                  0x0038, "Another attempt of the hedged request completed",
+                  HttpStatusCode::INTERNAL_SERVER_ERROR)
 }  // namespace privacy_sandbox::pbs_common
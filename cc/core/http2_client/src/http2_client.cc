@@ -16,25 +16,61 @@
 
 #include "cc/core/http2_client/src/http2_client.h"
 
+#include <chrono>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <utility>
+#include <vector>
 
+#include <boost/system/error_code.hpp>
+#include <nghttp2/asio_http2.h>
+
+#include "absl/strings/str_cat.h"
+#include "cc/core/common/time_provider/src/time_provider.h"
+#include "cc/core/http2_client/src/error_codes.h"
 #include "cc/core/http2_client/src/http_client_def.h"
 #include "cc/core/utils/src/http.h"
 #include "opentelemetry/metrics/provider.h"
+#include "opentelemetry/sdk/resource/semantic_conventions.h"
 
 namespace privacy_sandbox::pbs_common {
+using nghttp2::asio_http2::host_service_from_uri;
+
+using ::opentelemetry::sdk::resource::SemanticConventions::kServerAddress;
+using ::opentelemetry::sdk::resource::SemanticConventions::kServerPort;
 
 constexpr char kHttpClient[] = "Http2Client";
 
+namespace {
+/// Parses the host and the port of a uri, returning false if it is invalid.
+bool GetHostAndService(const Uri& uri, std::string& host,
+                       std::string& service) {
+  boost::system::error_code ec;
+  std::string scheme;
+  return !host_service_from_uri(ec, scheme, host, service, uri);
+}
+}  // namespace
+
 HttpClient::HttpClient(std::shared_ptr<AsyncExecutorInterface>& async_executor,
                        HttpClientOptions options,
                        absl::Nullable<MetricRouter*> metric_router)
     : http_connection_pool_(make_unique<HttpConnectionPool>(
           async_executor, metric_router, options.max_connections_per_host,
-          options.http2_read_timeout_in_sec)),
-      operation_dispatcher_(async_executor,
-                            RetryStrategy(options.retry_strategy_options)),
+          options.http2_read_timeout_in_sec,
+          options.max_elastic_connections_per_host,
+          options.connection_growth_streams,
+          options.idle_connection_timeout_in_sec,
+          options.shared_io_context_threads)),
+      operation_dispatcher_(
+          async_executor, RetryStrategy(options.retry_strategy_options),
+          options.retry_budget.ratio > 0
+              ? std::make_shared<RetryBudget>(options.retry_budget)
+              : nullptr),
+      async_executor_(async_executor),
+      hedging_options_(options.hedging),
+      hedge_budget_(options.hedging.budget_ratio, options.hedging.max_budget),
+      circuit_breaker_options_(options.circuit_breaker),
       metric_router_(metric_router) {
   if (metric_router_) {
     meter_ = opentelemetry::metrics::Provider::GetMeterProvider()->GetMeter(
@@ -50,6 +86,91 @@ HttpClient::HttpClient(std::shared_ptr<AsyncExecutorInterface>& async_executor,
                       kClientConnectionCreationErrorsMetric,
                       "Total number of client connection creation errors");
                 }));
+
+    client_retries_instrument_ =
+        metric_router_->GetOrCreateObservableInstrument(
+            kClientRetriesMetric,
+            [&]() -> std::shared_ptr<
+                      opentelemetry::metrics::ObservableInstrument> {
+              return meter_->CreateInt64ObservableCounter(
+                  kClientRetriesMetric, "Total number of retried requests");
+            });
+
+    client_rejected_retries_instrument_ =
+        metric_router_->GetOrCreateObservableInstrument(
+            kClientRejectedRetriesMetric,
+            [&]() -> std::shared_ptr<
+                      opentelemetry::metrics::ObservableInstrument> {
+              return meter_->CreateInt64ObservableCounter(
+                  kClientRejectedRetriesMetric,
+                  "Total number of retries rejected by the retry budget");
+            });
+
+    client_circuit_breaker_state_instrument_ =
+        metric_router_->GetOrCreateObservableInstrument(
+            kClientCircuitBreakerStateMetric,
+            [&]() -> std::shared_ptr<
+                      opentelemetry::metrics::ObservableInstrument> {
+              return meter_->CreateInt64ObservableGauge(
+                  kClientCircuitBreakerStateMetric,
+                  "Circuit breaker state per host: 0 closed, 1 half open, 2 "
+                  "open");
+            });
+
+    client_circuit_breaker_rejected_requests_instrument_ =
+        metric_router_->GetOrCreateObservableInstrument(
+            kClientCircuitBreakerRejectedRequestsMetric,
+            [&]() -> std::shared_ptr<
+                      opentelemetry::metrics::ObservableInstrument> {
+              return meter_->CreateInt64ObservableCounter(
+                  kClientCircuitBreakerRejectedRequestsMetric,
+                  "Total number of requests rejected by an open circuit "
+                  "breaker, per host");
+            });
+
+    client_retries_instrument_->AddCallback(
+        reinterpret_cast<opentelemetry::metrics::ObservableCallbackPtr>(
+            &HttpClient::ObserveClientRetriesCallback),
+        this);
+    client_rejected_retries_instrument_->AddCallback(
+        reinterpret_cast<opentelemetry::metrics::ObservableCallbackPtr>(
+            &HttpClient::ObserveClientRejectedRetriesCallback),
+        this);
+    client_circuit_breaker_state_instrument_->AddCallback(
+        reinterpret_cast<opentelemetry::metrics::ObservableCallbackPtr>(
+            &HttpClient::ObserveClientCircuitBreakerStateCallback),
+        this);
+    client_circuit_breaker_rejected_requests_instrument_->AddCallback(
+        reinterpret_cast<opentelemetry::metrics::ObservableCallbackPtr>(
+            &HttpClient::ObserveClientCircuitBreakerRejectedRequestsCallback),
+        this);
+  }
+}
+
+HttpClient::~HttpClient() {
+  if (client_retries_instrument_) {
+    client_retries_instrument_->RemoveCallback(
+        reinterpret_cast<opentelemetry::metrics::ObservableCallbackPtr>(
+            &HttpClient::ObserveClientRetriesCallback),
+        this);
+  }
+  if (client_rejected_retries_instrument_) {
+    client_rejected_retries_instrument_->RemoveCallback(
+        reinterpret_cast<opentelemetry::metrics::ObservableCallbackPtr>(
+            &HttpClient::ObserveClientRejectedRetriesCallback),
+        this);
+  }
+  if (client_circuit_breaker_state_instrument_) {
+    client_circuit_breaker_state_instrument_->RemoveCallback(
+        reinterpret_cast<opentelemetry::metrics::ObservableCallbackPtr>(
+            &HttpClient::ObserveClientCircuitBreakerStateCallback),
+        this);
+  }
+  if (client_circuit_breaker_rejected_requests_instrument_) {
+    client_circuit_breaker_rejected_requests_instrument_->RemoveCallback(
+        reinterpret_cast<opentelemetry::metrics::ObservableCallbackPtr>(
+            &HttpClient::ObserveClientCircuitBreakerRejectedRequestsCallback),
+        this);
   }
 }
 
@@ -67,6 +188,16 @@ ExecutionResult HttpClient::Stop() noexcept {
 
 ExecutionResult HttpClient::PerformRequest(
     AsyncContext<HttpRequest, HttpResponse>& http_context) noexcept {
+  if (IsHedgingEnabled() && http_context.request->is_idempotent) {
+    return PerformHedgedRequest(http_context);
+  }
+
+  DispatchRequest(http_context);
+  return SuccessExecutionResult();
+}
+
+void HttpClient::DispatchRequest(
+    AsyncContext<HttpRequest, HttpResponse>& http_context) noexcept {
   operation_dispatcher_.Dispatch<AsyncContext<HttpRequest, HttpResponse>>(
       http_context,
       [this](AsyncContext<HttpRequest, HttpResponse>& http_context) mutable {
@@ -85,11 +216,284 @@ ExecutionResult HttpClient::PerformRequest(
                 http_connection.get(), http_context.retry_count));
 
         return http_connection->Execute(http_context);
-      });
+      },
+      GetCircuitBreaker(http_context.request->path));
+}
 
+ExecutionResult HttpClient::PerformHedgedRequest(
+    AsyncContext<HttpRequest, HttpResponse>& http_context) noexcept {
+  auto hedged_request = std::make_shared<HedgedRequest>(http_context);
+
+  std::chrono::nanoseconds delay =
+      std::chrono::milliseconds(hedging_options_.delay_in_ms);
+  if (hedging_options_.latency_percentile > 0) {
+    std::string host;
+    std::string service;
+    if (GetHostAndService(*http_context.request->path, host, service)) {
+      hedged_request->latency_tracker =
+          GetLatencyTracker(absl::StrCat(host, ":", service));
+      auto percentile = hedged_request->latency_tracker->GetPercentile();
+      if (percentile.count() > 0) {
+        delay = percentile;
+      }
+    }
+  }
+
+  hedge_budget_.Deposit();
+  DispatchAttempt(hedged_request);
+  if (delay.count() == 0) {
+    return SuccessExecutionResult();
+  }
+
+  // The hedge is best effort, the request goes on without it if it cannot be
+  // scheduled.
+  TaskCancellationLambda cancel_hedge;
+  async_executor_->ScheduleFor(
+      [this, hedged_request]() { Hedge(hedged_request); },
+      (TimeProvider::GetSteadyTimestampInNanoseconds() + delay).count(),
+      cancel_hedge);
+  {
+    std::lock_guard lock(hedged_request->lock);
+    if (!hedged_request->is_finished) {
+      hedged_request->cancel_hedge = std::move(cancel_hedge);
+      return SuccessExecutionResult();
+    }
+  }
+  if (cancel_hedge) {
+    cancel_hedge();
+  }
   return SuccessExecutionResult();
 }
 
+void HttpClient::DispatchAttempt(
+    const std::shared_ptr<HedgedRequest>& hedged_request) noexcept {
+  size_t index;
+  {
+    std::lock_guard lock(hedged_request->lock);
+    if (hedged_request->is_finished) {
+      return;
+    }
+    index = hedged_request->attempts.size();
+    hedged_request->attempts.emplace_back();
+    hedged_request->attempts_in_flight++;
+  }
+
+  AsyncContext<HttpRequest, HttpResponse> attempt_context(
+      hedged_request->http_context);
+  attempt_context.callback =
+      [this, hedged_request, index,
+       start_time = std::chrono::steady_clock::now()](
+          AsyncContext<HttpRequest, HttpResponse>& attempt_context) {
+        OnAttemptCompleted(hedged_request, index, start_time, attempt_context);
+      };
+
+  operation_dispatcher_.Dispatch<AsyncContext<HttpRequest, HttpResponse>>(
+      attempt_context,
+      [this, hedged_request, index](
+          AsyncContext<HttpRequest, HttpResponse>& attempt_context)
+          -> ExecutionResult {
+        std::shared_ptr<HttpConnection> other_connection;
+        {
+          std::lock_guard lock(hedged_request->lock);
+          // The attempts cancelled by the winner are not retried.
+          if (hedged_request->is_finished) {
+            return FailureExecutionResult(
+                SC_HTTP2_CLIENT_HEDGED_REQUEST_CANCELLED);
+          }
+          if (index > 0) {
+            other_connection = hedged_request->attempts[0].connection;
+          }
+        }
+
+        std::shared_ptr<HttpConnection> http_connection;
+        auto execution_result = http_connection_pool_->GetConnection(
+            attempt_context.request->path, http_connection);
+        if (execution_result.Successful() && other_connection &&
+            http_connection == other_connection) {
+          // The hedge goes to another connection than the slow attempt, if
+          // the host has one.
+          execution_result = http_connection_pool_->GetConnection(
+              attempt_context.request->path, http_connection);
+        }
+        if (!execution_result.Successful()) {
+          IncrementClientConnectionCreationError(attempt_context);
+          return execution_result;
+        }
+
+        Uuid request_id;
+        execution_result =
+            http_connection->Execute(attempt_context, request_id);
+        if (!execution_result.Successful()) {
+          return execution_result;
+        }
+
+        bool is_finished;
+        {
+          std::lock_guard lock(hedged_request->lock);
+          hedged_request->attempts[index] = {http_connection, request_id};
+          is_finished = hedged_request->is_finished;
+        }
+        if (is_finished) {
+          http_connection->CancelRequest(request_id);
+        }
+        return SuccessExecutionResult();
+      },
+      GetCircuitBreaker(hedged_request->http_context.request->path));
+}
+
+void HttpClient::Hedge(
+    const std::shared_ptr<HedgedRequest>& hedged_request) noexcept {
+  {
+    std::lock_guard lock(hedged_request->lock);
+    if (hedged_request->is_finished) {
+      return;
+    }
+  }
+  if (!hedge_budget_.TryAcquire()) {
+    return;
+  }
+
+  SCP_DEBUG_CONTEXT(kHttpClient, hedged_request->http_context,
+                    "Hedging the request.");
+  DispatchAttempt(hedged_request);
+}
+
+void HttpClient::OnAttemptCompleted(
+    const std::shared_ptr<HedgedRequest>& hedged_request, size_t index,
+    std::chrono::steady_clock::time_point start_time,
+    AsyncContext<HttpRequest, HttpResponse>& attempt_context) noexcept {
+  if (attempt_context.result.Successful() && hedged_request->latency_tracker) {
+    hedged_request->latency_tracker->Record(std::chrono::steady_clock::now() -
+                                            start_time);
+  }
+
+  std::vector<HedgedRequest::Attempt> other_attempts;
+  TaskCancellationLambda cancel_hedge;
+  {
+    std::lock_guard lock(hedged_request->lock);
+    hedged_request->attempts_in_flight--;
+    if (hedged_request->is_finished) {
+      return;
+    }
+    // A failed attempt leaves the outcome to the attempts still in flight.
+    if (!attempt_context.result.Successful() &&
+        hedged_request->attempts_in_flight > 0) {
+      return;
+    }
+
+    hedged_request->is_finished = true;
+    for (size_t i = 0; i < hedged_request->attempts.size(); ++i) {
+      if (i != index && hedged_request->attempts[i].connection) {
+        other_attempts.push_back(hedged_request->attempts[i]);
+      }
+    }
+    cancel_hedge = std::move(hedged_request->cancel_hedge);
+  }
+
+  if (cancel_hedge) {
+    cancel_hedge();
+  }
+  for (auto& attempt : other_attempts) {
+    attempt.connection->CancelRequest(attempt.request_id);
+  }
+
+  auto& http_context = hedged_request->http_context;
+  http_context.response = attempt_context.response;
+  http_context.result = attempt_context.result;
+  http_context.Finish();
+}
+
+std::shared_ptr<HttpLatencyTracker> HttpClient::GetLatencyTracker(
+    const std::string& host) noexcept {
+  std::lock_guard lock(latency_trackers_lock_);
+  auto& latency_tracker = latency_trackers_[host];
+  if (!latency_tracker) {
+    latency_tracker = std::make_shared<HttpLatencyTracker>(
+        hedging_options_.latency_percentile);
+  }
+  return latency_tracker;
+}
+
+std::shared_ptr<CircuitBreaker> HttpClient::GetCircuitBreaker(
+    const std::shared_ptr<Uri>& uri) noexcept {
+  if (circuit_breaker_options_.failure_threshold == 0 || !uri) {
+    return nullptr;
+  }
+
+  std::pair<std::string, std::string> host_and_service;
+  if (!GetHostAndService(*uri, host_and_service.first,
+                         host_and_service.second)) {
+    return nullptr;
+  }
+
+  std::lock_guard lock(circuit_breakers_lock_);
+  auto& circuit_breaker = circuit_breakers_[host_and_service];
+  if (!circuit_breaker) {
+    circuit_breaker =
+        std::make_shared<CircuitBreaker>(circuit_breaker_options_);
+  }
+  return circuit_breaker;
+}
+
+void HttpClient::ObserveClientRetriesCallback(
+    opentelemetry::metrics::ObserverResult observer_result,
+    absl::Nonnull<HttpClient*> self_ptr) {
+  auto observer = std::get<
+      std::shared_ptr<opentelemetry::metrics::ObserverResultT<int64_t>>>(
+      observer_result);
+  observer->Observe(
+      static_cast<int64_t>(self_ptr->operation_dispatcher_.GetRetryCount()));
+}
+
+void HttpClient::ObserveClientRejectedRetriesCallback(
+    opentelemetry::metrics::ObserverResult observer_result,
+    absl::Nonnull<HttpClient*> self_ptr) {
+  auto observer = std::get<
+      std::shared_ptr<opentelemetry::metrics::ObserverResultT<int64_t>>>(
+      observer_result);
+  observer->Observe(static_cast<int64_t>(
+      self_ptr->operation_dispatcher_.GetRejectedRetryCount()));
+}
+
+void HttpClient::ObserveClientCircuitBreakerStateCallback(
+    opentelemetry::metrics::ObserverResult observer_result,
+    absl::Nonnull<HttpClient*> self_ptr) {
+  auto observer = std::get<
+      std::shared_ptr<opentelemetry::metrics::ObserverResultT<int64_t>>>(
+      observer_result);
+
+  std::lock_guard lock(self_ptr->circuit_breakers_lock_);
+  for (const auto& [host_and_service, circuit_breaker] :
+       self_ptr->circuit_breakers_) {
+    absl::flat_hash_map<absl::string_view, std::string> labels = {
+        {kServerAddress, host_and_service.first},
+        {kServerPort, host_and_service.second},
+    };
+    observer->Observe(static_cast<int64_t>(circuit_breaker->GetState()),
+                      labels);
+  }
+}
+
+void HttpClient::ObserveClientCircuitBreakerRejectedRequestsCallback(
+    opentelemetry::metrics::ObserverResult observer_result,
+    absl::Nonnull<HttpClient*> self_ptr) {
+  auto observer = std::get<
+      std::shared_ptr<opentelemetry::metrics::ObserverResultT<int64_t>>>(
+      observer_result);
+
+  std::lock_guard lock(self_ptr->circuit_breakers_lock_);
+  for (const auto& [host_and_service, circuit_breaker] :
+       self_ptr->circuit_breakers_) {
+    absl::flat_hash_map<absl::string_view, std::string> labels = {
+        {kServerAddress, host_and_service.first},
+        {kServerPort, host_and_service.second},
+    };
+    observer->Observe(
+        static_cast<int64_t>(circuit_breaker->GetRejectedOperationCount()),
+        labels);
+  }
+}
+
 void HttpClient::IncrementClientConnectionCreationError(
     const AsyncContext<HttpRequest, HttpResponse>& http_context) {
   if (!metric_router_) {
@@ -16,10 +16,19 @@
 
 #pragma once
 
+#include <chrono>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
 
+#include "absl/container/flat_hash_map.h"
+#include "cc/core/common/operation_dispatcher/src/circuit_breaker.h"
 #include "cc/core/common/operation_dispatcher/src/operation_dispatcher.h"
+#include "cc/core/common/operation_dispatcher/src/token_bucket.h"
 #include "cc/core/http2_client/src/http_connection_pool.h"
+#include "cc/core/http2_client/src/http_hedging.h"
 #include "cc/core/http2_client/src/http_options.h"
 #include "cc/core/interface/async_context.h"
 #include "cc/core/interface/async_executor_interface.h"
@@ -31,6 +40,15 @@
 namespace privacy_sandbox::pbs_common {
 
 /*! @copydoc HttpClientInterface
+ *
+ * The requests marked as idempotent are hedged when HttpHedgingOptions enable
+ * it: an attempt still in flight after the hedging delay is duplicated on
+ * another connection, within a budget. The first successful attempt wins and
+ * the other one is cancelled with RST_STREAM.
+ *
+ * The retries of all the requests are limited by a retry budget, and the
+ * requests to a host are failed right away while its circuit breaker is open,
+ * when HttpClientOptions enable them.
  */
 class HttpClient : public HttpClientInterface {
  public:
@@ -51,6 +69,8 @@ class HttpClient : public HttpClientInterface {
                       HttpClientOptions options = HttpClientOptions(),
                       absl::Nullable<MetricRouter*> metric_router = nullptr);
 
+  ~HttpClient() override;
+
   ExecutionResult Init() noexcept override;
   ExecutionResult Run() noexcept override;
   ExecutionResult Stop() noexcept override;
@@ -59,6 +79,91 @@ class HttpClient : public HttpClientInterface {
       AsyncContext<HttpRequest, HttpResponse>& http_context) noexcept override;
 
  private:
+  /// The state shared by the attempts of a hedged request.
+  struct HedgedRequest {
+    /// An attempt sent on a connection.
+    struct Attempt {
+      std::shared_ptr<HttpConnection> connection;
+      Uuid request_id;
+    };
+
+    explicit HedgedRequest(
+        const AsyncContext<HttpRequest, HttpResponse>& http_context)
+        : http_context(http_context) {}
+
+    /// The context of the caller.
+    AsyncContext<HttpRequest, HttpResponse> http_context;
+    /// Learns the latency of the host, if the delay is a percentile.
+    std::shared_ptr<HttpLatencyTracker> latency_tracker;
+    std::mutex lock;
+    bool is_finished = false;
+    size_t attempts_in_flight = 0;
+    std::vector<Attempt> attempts;
+    /// Cancels the scheduled hedge.
+    TaskCancellationLambda cancel_hedge;
+  };
+
+  /// Whether the requests marked as idempotent are hedged.
+  bool IsHedgingEnabled() const noexcept {
+    return hedging_options_.delay_in_ms > 0 ||
+           hedging_options_.latency_percentile > 0;
+  }
+
+  /// Sends a request with the connection pool, retrying with the operation
+  /// dispatcher.
+  void DispatchRequest(
+      AsyncContext<HttpRequest, HttpResponse>& http_context) noexcept;
+
+  /// Sends the first attempt of a hedged request and schedules the hedge.
+  ExecutionResult PerformHedgedRequest(
+      AsyncContext<HttpRequest, HttpResponse>& http_context) noexcept;
+
+  /// Sends an attempt of a hedged request.
+  void DispatchAttempt(
+      const std::shared_ptr<HedgedRequest>& hedged_request) noexcept;
+
+  /// Sends the hedge of a request still in flight, if the budget allows it.
+  void Hedge(const std::shared_ptr<HedgedRequest>& hedged_request) noexcept;
+
+  /// Finishes the hedged request with the first successful attempt, or with
+  /// the last failed one, and cancels the other attempts.
+  void OnAttemptCompleted(
+      const std::shared_ptr<HedgedRequest>& hedged_request, size_t index,
+      std::chrono::steady_clock::time_point start_time,
+      AsyncContext<HttpRequest, HttpResponse>& attempt_context) noexcept;
+
+  /// Returns the latency tracker of a host, creating it if needed.
+  std::shared_ptr<HttpLatencyTracker> GetLatencyTracker(
+      const std::string& host) noexcept;
+
+  /// Returns the circuit breaker of the host of a uri, creating it if needed,
+  /// or null if circuit breaking is disabled.
+  std::shared_ptr<CircuitBreaker> GetCircuitBreaker(
+      const std::shared_ptr<Uri>& uri) noexcept;
+
+  /// Callback to be used with an OTel ObservableInstrument for the retries.
+  static void ObserveClientRetriesCallback(
+      opentelemetry::metrics::ObserverResult observer_result,
+      absl::Nonnull<HttpClient*> self_ptr);
+
+  /// Callback to be used with an OTel ObservableInstrument for the retries
+  /// rejected by the retry budget.
+  static void ObserveClientRejectedRetriesCallback(
+      opentelemetry::metrics::ObserverResult observer_result,
+      absl::Nonnull<HttpClient*> self_ptr);
+
+  /// Callback to be used with an OTel ObservableInstrument for the state of
+  /// the circuit breakers, per host.
+  static void ObserveClientCircuitBreakerStateCallback(
+      opentelemetry::metrics::ObserverResult observer_result,
+      absl::Nonnull<HttpClient*> self_ptr);
+
+  /// Callback to be used with an OTel ObservableInstrument for the requests
+  /// rejected by the circuit breakers, per host.
+  static void ObserveClientCircuitBreakerRejectedRequestsCallback(
+      opentelemetry::metrics::ObserverResult observer_result,
+      absl::Nonnull<HttpClient*> self_ptr);
+
   /**
    * Increments the client connection creation error counter.
    */
@@ -71,6 +176,29 @@ class HttpClient : public HttpClientInterface {
   // Operation dispatcher
   OperationDispatcher operation_dispatcher_;
 
+  // An instance of the async executor, scheduling the hedges.
+  std::shared_ptr<AsyncExecutorInterface> async_executor_;
+
+  // Hedging options.
+  HttpHedgingOptions hedging_options_;
+
+  // Limits the hedged requests.
+  TokenBucket hedge_budget_;
+
+  // The latency trackers of the hosts, when hedging after a percentile.
+  absl::flat_hash_map<std::string, std::shared_ptr<HttpLatencyTracker>>
+      latency_trackers_;
+  std::mutex latency_trackers_lock_;
+
+  // Circuit breaker options.
+  CircuitBreakerOptions circuit_breaker_options_;
+
+  // The circuit breakers of the hosts, keyed by host and port.
+  absl::flat_hash_map<std::pair<std::string, std::string>,
+                      std::shared_ptr<CircuitBreaker>>
+      circuit_breakers_;
+  std::mutex circuit_breakers_lock_;
+
   // An instance of metric router which will provide APIs to create metrics.
   MetricRouter* metric_router_;
 
@@ -80,5 +208,15 @@ class HttpClient : public HttpClientInterface {
   // OpenTelemetry Instrument for client connection creation errors.
   std::shared_ptr<opentelemetry::metrics::Counter<uint64_t>>
       client_connection_creation_error_counter_;
+
+  // OpenTelemetry Instruments for the retries and the circuit breakers.
+  std::shared_ptr<opentelemetry::metrics::ObservableInstrument>
+      client_retries_instrument_;
+  std::shared_ptr<opentelemetry::metrics::ObservableInstrument>
+      client_rejected_retries_instrument_;
+  std::shared_ptr<opentelemetry::metrics::ObservableInstrument>
+      client_circuit_breaker_state_instrument_;
+  std::shared_ptr<opentelemetry::metrics::ObservableInstrument>
+      client_circuit_breaker_rejected_requests_instrument_;
 };
 }  // namespace privacy_sandbox::pbs_common
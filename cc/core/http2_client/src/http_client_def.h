@@ -45,6 +45,13 @@ inline constexpr absl::string_view kClientConnectionDurationMetric =
     "http.client.connection.duration";
 inline constexpr absl::string_view kClientConnectionCreationErrorsMetric =
     "http.client.connection.creation_errors";
+inline constexpr absl::string_view kClientRetriesMetric = "http.client.retries";
+inline constexpr absl::string_view kClientRejectedRetriesMetric =
+    "http.client.rejected_retries";
+inline constexpr absl::string_view kClientCircuitBreakerStateMetric =
+    "http.client.circuit_breaker.state";
+inline constexpr absl::string_view kClientCircuitBreakerRejectedRequestsMetric =
+    "http.client.circuit_breaker.rejected_requests";
 
 // Labels
 inline constexpr absl::string_view kUriLabel = "server.uri";
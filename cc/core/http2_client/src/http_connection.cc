@@ -18,8 +18,10 @@
 
 #include <algorithm>
 #include <functional>
+#include <future>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -29,13 +31,16 @@
 #include <nghttp2/asio_http2.h>
 #include <nghttp2/asio_http2_client.h>
 
+#include "absl/strings/match.h"
 #include "cc/core/common/global_logger/src/global_logger.h"
 #include "cc/core/common/uuid/src/uuid.h"
 #include "cc/core/http2_client/src/error_codes.h"
 #include "cc/core/http2_client/src/http_client_def.h"
 #include "cc/core/interface/async_context.h"
 #include "cc/core/telemetry/src/metric/metric_router.h"
+#include "cc/core/utils/src/compression.h"
 #include "cc/core/utils/src/http.h"
+#include "cc/core/utils/src/tls_session.h"
 #include "cc/public/core/interface/execution_result.h"
 #include "opentelemetry/sdk/resource/semantic_conventions.h"
 
@@ -63,17 +68,23 @@ static constexpr char kContentLengthHeader[] = "content-length";
 static constexpr char kHttp2Client[] = "Http2Client";
 static constexpr char kHttpMethodGetTag[] = "GET";
 static constexpr char kHttpMethodPostTag[] = "POST";
+// Upper bound of the decompressed size of gzip encoded response bodies.
+static constexpr size_t kMaxDecompressedResponseBodySize = 256 * 1024 * 1024;
 
 HttpConnection::HttpConnection(
     const std::shared_ptr<AsyncExecutorInterface>& async_executor,
     const std::string& host, const std::string& service, bool is_https,
     absl::Nullable<MetricRouter*> metric_router,
-    TimeDuration http2_read_timeout_in_sec)
+    TimeDuration http2_read_timeout_in_sec,
+    std::shared_ptr<HttpIoContextPool> io_context_pool)
     : async_executor_(async_executor),
       host_(host),
       service_(service),
       is_https_(is_https),
       http2_read_timeout_in_sec_(http2_read_timeout_in_sec),
+      io_context_pool_(std::move(io_context_pool)),
+      io_context_(nullptr),
+      is_session_active_(std::make_shared<bool>(false)),
       tls_context_(context::sslv23),
       is_ready_(false),
       is_dropped_(false),
@@ -81,10 +92,18 @@ HttpConnection::HttpConnection(
 
 ExecutionResult HttpConnection::Init() noexcept {
   try {
-    io_service_ = std::make_unique<io_service>();
-    work_guard_ =
-        std::make_unique<executor_work_guard<io_context::executor_type>>(
-            make_work_guard(io_service_->get_executor()));
+    if (io_context_pool_) {
+      io_context_ = &io_context_pool_->GetNextIoContext();
+    } else {
+      io_service_ = std::make_unique<io_service>();
+      work_guard_ =
+          std::make_unique<executor_work_guard<io_context::executor_type>>(
+              make_work_guard(io_service_->get_executor()));
+      io_context_ = io_service_.get();
+    }
+    // The handlers of a previous session, if any, stay inactive.
+    is_session_active_ = std::make_shared<bool>(true);
+    active_streams_.clear();
 
     tls_context_.set_default_verify_paths();
     error_code ec;
@@ -97,19 +116,33 @@ ExecutionResult HttpConnection::Init() noexcept {
       return result;
     }
 
+    if (is_https_) {
+      // Reconnects, including the ones of recycled connections, resume the
+      // TLS session rather than doing a full handshake.
+      auto result =
+          EnableTlsClientSessionResumption(tls_context_.native_handle());
+      if (!result.Successful()) {
+        result = FailureExecutionResult(SC_HTTP2_CLIENT_TLS_CTX_ERROR);
+        SCP_ERROR(kHttp2Client, kZeroUuid, result,
+                  "Failed to enable TLS session resumption.");
+        return result;
+      }
+    }
+
     RETURN_IF_FAILURE(MetricInit());
 
     if (is_https_) {
-      session_ = std::make_shared<session>(*io_service_, tls_context_, host_,
+      session_ = std::make_shared<session>(*io_context_, tls_context_, host_,
                                            service_);
     } else {
-      session_ = std::make_shared<session>(*io_service_, host_, service_);
+      session_ = std::make_shared<session>(*io_context_, host_, service_);
     }
 
     session_->read_timeout(seconds(http2_read_timeout_in_sec_));
-    session_->on_connect(std::bind(&HttpConnection::OnConnectionCreated, this,
-                                   std::placeholders::_1));
-    session_->on_error(std::bind(&HttpConnection::OnConnectionError, this));
+    session_->on_connect(BindToSession(std::bind(
+        &HttpConnection::OnConnectionCreated, this, std::placeholders::_1)));
+    session_->on_error(
+        BindToSession(std::bind(&HttpConnection::OnConnectionError, this)));
     return SuccessExecutionResult();
   } catch (...) {
     auto result = FailureExecutionResult(
@@ -123,6 +156,10 @@ ExecutionResult HttpConnection::Init() noexcept {
 }
 
 ExecutionResult HttpConnection::Run() noexcept {
+  if (io_context_pool_) {
+    return SuccessExecutionResult();
+  }
+
   worker_ = std::make_shared<std::thread>([this]() {
     try {
       io_service_->run();
@@ -138,8 +175,8 @@ ExecutionResult HttpConnection::Stop() noexcept {
   if (session_) {
     // Post session_->shutdown in io_service to make sure only one thread invoke
     // the session.
-    post(*io_service_, [this]() {
-      session_->shutdown();
+    post(*io_context_, [session = session_]() {
+      session->shutdown();
       SCP_INFO(kHttp2Client, kZeroUuid, "Session is being shutdown.");
     });
   }
@@ -148,6 +185,14 @@ ExecutionResult HttpConnection::Stop() noexcept {
   RecordClientConnectionDuration();
 
   try {
+    if (io_context_pool_) {
+      // The shared io_context keeps running, only the handlers of the session
+      // stop.
+      DeactivateSession();
+      CancelPendingCallbacks();
+      return SuccessExecutionResult();
+    }
+
     work_guard_->reset();
     // Post io_service_->stop to make sure pervious tasks completed before
     // stop io_service_.
@@ -172,6 +217,27 @@ ExecutionResult HttpConnection::Stop() noexcept {
   }
 }
 
+void HttpConnection::DeactivateSession() noexcept {
+  if (!io_context_) {
+    return;
+  }
+
+  auto is_session_active = is_session_active_;
+  if (io_context_->get_executor().running_in_this_thread()) {
+    *is_session_active = false;
+    return;
+  }
+
+  // The io_context runs the handlers one at a time, so none runs once this
+  // one did.
+  std::promise<void> deactivated;
+  post(*io_context_, [&]() {
+    *is_session_active = false;
+    deactivated.set_value();
+  });
+  deactivated.get_future().wait();
+}
+
 ExecutionResult HttpConnection::MetricInit() noexcept {
   if (!metric_router_) {
     return SuccessExecutionResult();
@@ -216,7 +282,15 @@ ExecutionResult HttpConnection::MetricInit() noexcept {
       /*view_description=*/"Connection duration histogram",
       /*unit=*/kSecondUnit);
 
-  client_connect_error_counter_ =
+  // The attributes of the connection metrics do not change during the
+  // lifetime of the connection.
+  absl::flat_hash_map<absl::string_view, std::string> connection_labels = {
+      {kServerAddress, host_},
+      {kServerPort, service_},
+      {kUrlScheme, is_https_ ? "https" : "http"},
+  };
+
+  client_connect_error_counter_ = BoundCounter<uint64_t>(
       std::static_pointer_cast<opentelemetry::metrics::Counter<uint64_t>>(
           metric_router_->GetOrCreateSyncInstrument(
               kClientConnectErrorsMetric,
@@ -225,7 +299,9 @@ ExecutionResult HttpConnection::MetricInit() noexcept {
                 return meter_->CreateUInt64Counter(
                     kClientConnectErrorsMetric,
                     "Total number of client connect errors");
-              }));
+              })),
+      metric_router_->GetOrCreateAttributes(kClientConnectErrorsMetric,
+                                            connection_labels));
 
   client_server_latency_ =
       std::static_pointer_cast<opentelemetry::metrics::Histogram<double>>(
@@ -273,7 +349,7 @@ ExecutionResult HttpConnection::MetricInit() noexcept {
                     kByteUnit);
               }));
 
-  client_connection_duration_ =
+  client_connection_duration_ = BoundHistogram<double>(
       std::static_pointer_cast<opentelemetry::metrics::Histogram<double>>(
           metric_router_->GetOrCreateSyncInstrument(
               kClientConnectionDurationMetric,
@@ -282,23 +358,25 @@ ExecutionResult HttpConnection::MetricInit() noexcept {
                 return meter_->CreateDoubleHistogram(
                     kClientConnectionDurationMetric,
                     "Client connection duration in seconds", kSecondUnit);
-              }));
+              })),
+      metric_router_->GetOrCreateAttributes(kClientConnectionDurationMetric,
+                                            connection_labels));
 
   return SuccessExecutionResult();
 }
 
 void HttpConnection::OnConnectionCreated(tcp::resolver::iterator) noexcept {
-  post(*io_service_, [this]() mutable {
+  post(*io_context_, BindToSession([this]() mutable {
     SCP_INFO(kHttp2Client, kZeroUuid,
              absl::StrFormat("Connection %p for host %s is established.", this,
                              host_.c_str()));
     is_ready_ = true;
     connection_creation_time_ = std::chrono::steady_clock::now();
-  });
+  }));
 }
 
 void HttpConnection::OnConnectionError() noexcept {
-  post(*io_service_, [this]() mutable {
+  post(*io_context_, BindToSession([this]() mutable {
     auto failure = FailureExecutionResult(SC_HTTP2_CLIENT_CONNECTION_DROPPED);
     SCP_ERROR(kHttp2Client, kZeroUuid, failure,
               absl::StrFormat("Connection %p for host %s got an error.", this,
@@ -311,8 +389,9 @@ void HttpConnection::OnConnectionError() noexcept {
 
     RecordClientConnectionDuration();
 
+    active_streams_.clear();
     CancelPendingCallbacks();
-  });
+  }));
 }
 
 void HttpConnection::CancelPendingCallbacks() noexcept {
@@ -375,6 +454,13 @@ bool HttpConnection::IsReady() noexcept {
 
 ExecutionResult HttpConnection::Execute(
     AsyncContext<HttpRequest, HttpResponse>& http_context) noexcept {
+  Uuid request_id;
+  return Execute(http_context, request_id);
+}
+
+ExecutionResult HttpConnection::Execute(
+    AsyncContext<HttpRequest, HttpResponse>& http_context,
+    Uuid& request_id) noexcept {
   if (!is_ready_) {
     auto failure =
         RetryExecutionResult(SC_HTTP2_CLIENT_NO_CONNECTION_ESTABLISHED);
@@ -385,19 +471,32 @@ ExecutionResult HttpConnection::Execute(
 
   // This call needs to pass, otherwise there will be orphaned context when
   // connection drop happens.
-  auto request_id = Uuid::GenerateUuid();
+  request_id = Uuid::GenerateUuid();
   auto pair = std::make_pair(request_id, http_context);
   auto execution_result = pending_network_calls_.Insert(pair, http_context);
   if (!execution_result.Successful()) {
     return execution_result;
   }
 
-  post(*io_service_, [this, http_context, request_id]() mutable {
-    SendHttpRequest(request_id, http_context);
-  });
+  post(*io_context_,
+       BindToSession([this, http_context, request_id]() mutable {
+         SendHttpRequest(request_id, http_context);
+       }));
   return SuccessExecutionResult();
 }
 
+void HttpConnection::CancelRequest(const Uuid& request_id) noexcept {
+  // Is posted after the request was sent, since both are run in order by the
+  // io_context.
+  post(*io_context_, BindToSession([this, request_id]() {
+         auto stream = active_streams_.find(request_id);
+         if (stream == active_streams_.end()) {
+           return;
+         }
+         stream->second->cancel(NGHTTP2_CANCEL);
+       }));
+}
+
 void HttpConnection::SendHttpRequest(
     Uuid& request_id,
     AsyncContext<HttpRequest, HttpResponse>& http_context) noexcept {
@@ -481,13 +580,14 @@ void HttpConnection::SendHttpRequest(
     return;
   }
 
+  active_streams_[request_id] = http_request;
   http_context.response = std::make_shared<HttpResponse>();
-  http_request->on_response(bind(&HttpConnection::OnResponseCallback, this,
-                                 http_context, std::placeholders::_1,
-                                 submit_request_time));
-  http_request->on_close(bind(&HttpConnection::OnRequestResponseClosed, this,
-                              request_id, http_context, std::placeholders::_1,
-                              submit_request_time));
+  http_request->on_response(BindToSession(
+      bind(&HttpConnection::OnResponseCallback, this, http_context,
+           std::placeholders::_1, submit_request_time)));
+  http_request->on_close(BindToSession(
+      bind(&HttpConnection::OnRequestResponseClosed, this, request_id,
+           http_context, std::placeholders::_1, submit_request_time)));
 }
 
 void HttpConnection::OnRequestResponseClosed(
@@ -495,6 +595,7 @@ void HttpConnection::OnRequestResponseClosed(
     uint32_t error_code,
     std::chrono::time_point<std::chrono::steady_clock>
         submit_request_time) noexcept {
+  active_streams_.erase(request_id);
   if (!pending_network_calls_.Erase(request_id).Successful()) {
     return;
   }
@@ -507,6 +608,9 @@ void HttpConnection::OnRequestResponseClosed(
 
   // `!error_code` means no error during on_close.
   if (!error_code) {
+    if (result.Successful()) {
+      result = DecodeResponseBody(http_context);
+    }
     http_context.result = result;
     SCP_DEBUG_CONTEXT(
         kHttp2Client, http_context,
@@ -567,9 +671,9 @@ void HttpConnection::OnResponseCallback(
     http_context.response->body.capacity = http_response.content_length();
   }
 
-  http_response.on_data(bind(&HttpConnection::OnResponseBodyCallback, this,
-                             http_context, std::placeholders::_1,
-                             std::placeholders::_2));
+  http_response.on_data(BindToSession(
+      bind(&HttpConnection::OnResponseBodyCallback, this, http_context,
+           std::placeholders::_1, std::placeholders::_2)));
 }
 
 void HttpConnection::OnResponseBodyCallback(
@@ -588,6 +692,34 @@ void HttpConnection::OnResponseBodyCallback(
   }
 }
 
+ExecutionResult HttpConnection::DecodeResponseBody(
+    AsyncContext<HttpRequest, HttpResponse>& http_context) noexcept {
+  auto& response = *http_context.response;
+  if (!response.headers) {
+    return SuccessExecutionResult();
+  }
+  auto content_encoding = response.headers->find(kContentEncodingHeader);
+  if (content_encoding == response.headers->end() ||
+      !absl::EqualsIgnoreCase(content_encoding->second,
+                              kGzipContentEncoding)) {
+    return SuccessExecutionResult();
+  }
+
+  std::string decompressed;
+  auto execution_result = GzipDecompress(
+      std::string_view(response.body.bytes->data(), response.body.length),
+      kMaxDecompressedResponseBodySize, decompressed);
+  if (!execution_result.Successful()) {
+    SCP_ERROR_CONTEXT(kHttp2Client, http_context, execution_result,
+                      "Failed to decompress the gzip response body.");
+    return execution_result;
+  }
+  // Callers only ever see the decoded body.
+  response.body = BytesBuffer(decompressed);
+  response.headers->erase(content_encoding);
+  return SuccessExecutionResult();
+}
+
 ExecutionResult HttpConnection::ConvertHttpStatusCodeToExecutionResult(
     const HttpStatusCode status_code) noexcept {
   switch (status_code) {
@@ -684,13 +816,8 @@ void HttpConnection::IncrementClientConnectError() {
   if (!client_connect_error_counter_) {
     return;
   }
-  absl::flat_hash_map<absl::string_view, std::string> labels = {
-      {kServerAddress, host_},
-      {kServerPort, service_},
-      {kUrlScheme, is_https_ ? "https" : "http"},
-  };
 
-  client_connect_error_counter_->Add(1, labels);
+  client_connect_error_counter_.Add(1);
 }
 
 void HttpConnection::RecordClientServerLatency(
@@ -755,12 +882,7 @@ void HttpConnection::RecordClientConnectionDuration() {
       std::chrono::steady_clock::now() - connection_creation_time_;
   double latency_s = latency / std::chrono::seconds(1);
 
-  absl::flat_hash_map<absl::string_view, std::string> labels = {
-      {kServerAddress, host_},
-      {kServerPort, service_},
-      {kUrlScheme, is_https_ ? "https" : "http"}};
-  opentelemetry::context::Context context;
-  client_connection_duration_->Record(latency_s, labels, context);
+  client_connection_duration_.Record(latency_s);
 }
 
 void HttpConnection::RecordClientRequestBodySize(
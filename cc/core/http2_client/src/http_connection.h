@@ -19,13 +19,18 @@
 #include <memory>
 #include <string>
 #include <thread>
+#include <utility>
 
 #include <nghttp2/asio_http2_client.h>
 
+#include "absl/container/flat_hash_map.h"
+
 #include "cc/core/common/concurrent_map/src/concurrent_map.h"
+#include "cc/core/http2_client/src/http_io_context_pool.h"
 #include "cc/core/interface/async_context.h"
 #include "cc/core/interface/async_executor_interface.h"
 #include "cc/core/interface/http_types.h"
+#include "cc/core/telemetry/src/metric/metric_attributes.h"
 #include "cc/core/telemetry/src/metric/metric_router.h"
 #include "cc/public/core/interface/execution_result.h"
 #include "opentelemetry/metrics/meter.h"
@@ -48,12 +53,16 @@ class HttpConnection : public ServiceInterface {
    * It could be nullptr as passed from the HttpClient or through
    * MockHttpConnectionPool for testing.
    * @param http2_read_timeout_in_sec nghttp2 read timeout in second.
+   * @param io_context_pool The io_contexts shared with other connections. The
+   * connection runs its own io_service on its own thread when nullptr.
    */
-  HttpConnection(const std::shared_ptr<AsyncExecutorInterface>& async_executor,
-                 const std::string& host, const std::string& service,
-                 bool is_https, absl::Nullable<MetricRouter*> metric_router,
-                 TimeDuration http2_read_timeout_in_sec =
-                     kDefaultHttp2ReadTimeoutInSeconds);
+  HttpConnection(
+      const std::shared_ptr<AsyncExecutorInterface>& async_executor,
+      const std::string& host, const std::string& service, bool is_https,
+      absl::Nullable<MetricRouter*> metric_router,
+      TimeDuration http2_read_timeout_in_sec =
+          kDefaultHttp2ReadTimeoutInSeconds,
+      std::shared_ptr<HttpIoContextPool> io_context_pool = nullptr);
 
   ExecutionResult Init() noexcept override;
   ExecutionResult Run() noexcept override;
@@ -68,6 +77,24 @@ class HttpConnection : public ServiceInterface {
   ExecutionResult Execute(
       AsyncContext<HttpRequest, HttpResponse>& http_context) noexcept;
 
+  /**
+   * @brief Same as above, and provides the id of the request to cancel it.
+   *
+   * @param http_context The context of the http operation.
+   * @param request_id The id of the request.
+   * @return ExecutionResult The execution result of the operation.
+   */
+  ExecutionResult Execute(AsyncContext<HttpRequest, HttpResponse>& http_context,
+                          Uuid& request_id) noexcept;
+
+  /**
+   * @brief Cancels a request with RST_STREAM. Its context is finished with a
+   * retryable error. Is a no-op if the request already completed.
+   *
+   * @param request_id The id of the request provided by Execute.
+   */
+  void CancelRequest(const Uuid& request_id) noexcept;
+
   /**
    * @brief Indicates whether the connection to the remote server is dropped.
    *
@@ -144,6 +171,17 @@ class HttpConnection : public ServiceInterface {
       AsyncContext<HttpRequest, HttpResponse>& http_context,
       const uint8_t* data, size_t chunk_length) noexcept;
 
+  /**
+   * @brief Decompresses a gzip encoded response body in place, removing the
+   * Content-Encoding header. Other bodies are left as is.
+   *
+   * @param http_context The http context of the operation.
+   * @return ExecutionResult SC_CORE_UTILS_INVALID_COMPRESSED_DATA or
+   * SC_CORE_UTILS_DECOMPRESSED_SIZE_TOO_LARGE if the body cannot be decoded.
+   */
+  ExecutionResult DecodeResponseBody(
+      AsyncContext<HttpRequest, HttpResponse>& http_context) noexcept;
+
   /**
    * @brief Is called when the connection to the remote host is established.
    */
@@ -239,6 +277,30 @@ class HttpConnection : public ServiceInterface {
   void RecordClientResponseBodySize(
       const AsyncContext<HttpRequest, HttpResponse>& http_context);
 
+  /**
+   * @brief Wraps a handler run on the io_context of the connection so that it
+   * does nothing once the session is stopped. A shared io_context keeps
+   * running the handlers of a stopped session, possibly after the connection
+   * was reset or destroyed.
+   *
+   * @param handler The handler to wrap.
+   */
+  template <typename Handler>
+  auto BindToSession(Handler handler) noexcept {
+    return [is_session_active = is_session_active_,
+            handler = std::move(handler)](auto&&... args) mutable {
+      if (*is_session_active) {
+        handler(std::forward<decltype(args)>(args)...);
+      }
+    };
+  }
+
+  /**
+   * @brief Stops running the handlers of the session on a shared io_context.
+   * Waits for the handler running meanwhile, if any, to complete.
+   */
+  void DeactivateSession() noexcept;
+
   // An instance of the async executor.
   const std::shared_ptr<AsyncExecutorInterface> async_executor_;
 
@@ -254,9 +316,21 @@ class HttpConnection : public ServiceInterface {
   // http2 read timeout in seconds.
   TimeDuration http2_read_timeout_in_sec_;
 
-  // The asio io_service to provide http functionality.
+  // The io_contexts shared with other connections, if any.
+  std::shared_ptr<HttpIoContextPool> io_context_pool_;
+
+  // The asio io_service to provide http functionality, when the connection
+  // does not share io_contexts.
   std::unique_ptr<boost::asio::io_service> io_service_;
 
+  // The io_context running the session, either io_service_ or one of
+  // io_context_pool_.
+  boost::asio::io_context* io_context_;
+
+  // Whether the handlers of the current session run. Only accessed on
+  // io_context_ once the connection runs.
+  std::shared_ptr<bool> is_session_active_;
+
   // The worker guard to run the io_service_.
   std::unique_ptr<
       boost::asio::executor_work_guard<boost::asio::io_context::executor_type>>
@@ -279,6 +353,12 @@ class HttpConnection : public ServiceInterface {
   ConcurrentMap<Uuid, AsyncContext<HttpRequest, HttpResponse>, UuidCompare>
       pending_network_calls_;
 
+  // The streams of the requests sent on the session. Is only accessed on the
+  // io_context of the session.
+  absl::flat_hash_map<Uuid, const nghttp2::asio_http2::client::request*,
+                      UuidHash>
+      active_streams_;
+
  private:
   /**
    * Initializes the metrics.
@@ -292,9 +372,8 @@ class HttpConnection : public ServiceInterface {
   std::shared_ptr<opentelemetry::metrics::Meter> meter_;
 
   // OpenTelemetry Instrument for client connect errors which happen when
-  // making a connection to the client.
-  std::shared_ptr<opentelemetry::metrics::Counter<uint64_t>>
-      client_connect_error_counter_;
+  // making a connection to the client, bound to the connection attributes.
+  BoundCounter<uint64_t> client_connect_error_counter_;
 
   // OpenTelemetry Instrument for measuring client-server latency. It is time
   // from the client request to receiving the first byte of response.
@@ -316,9 +395,8 @@ class HttpConnection : public ServiceInterface {
       client_response_body_size_;
 
   // OpenTelemetry Instrument for measuring connection duration. It tracks the
-  // lifecyle duration of the connection.
-  std::shared_ptr<opentelemetry::metrics::Histogram<double>>
-      client_connection_duration_;
+  // lifecyle duration of the connection, bound to the connection attributes.
+  BoundHistogram<double> client_connection_duration_;
 
   // Time at creating the connection.
   std::chrono::time_point<std::chrono::steady_clock> connection_creation_time_;
@@ -16,8 +16,10 @@
  */
 #include "cc/core/http2_client/src/http_connection_pool.h"
 
+#include <chrono>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -30,6 +32,7 @@
 #include "cc/core/http2_client/src/error_codes.h"
 #include "cc/core/http2_client/src/http_client_def.h"
 #include "cc/core/http2_client/src/http_connection.h"
+#include "cc/core/interface/async_executor_interface.h"
 #include "cc/public/core/interface/execution_result.h"
 
 namespace privacy_sandbox::pbs_common {
@@ -40,8 +43,12 @@ using nghttp2::asio_http2::host_service_from_uri;
 static constexpr char kHttpsTag[] = "https";
 static constexpr char kHttpTag[] = "http";
 static constexpr char kHttpConnection[] = "HttpConnection";
+// How often elastic pools are looked at for idle connections to close.
+static constexpr std::chrono::seconds kShrinkCheckPeriod =
+    std::chrono::seconds(1);
 
 HttpConnectionPool::~HttpConnectionPool() {
+  StopGrowingPools();
   if (client_active_requests_instrument_) {
     client_active_requests_instrument_->RemoveCallback(
         reinterpret_cast<opentelemetry::metrics::ObservableCallbackPtr>(
@@ -57,6 +64,10 @@ HttpConnectionPool::~HttpConnectionPool() {
 }
 
 ExecutionResult HttpConnectionPool::Init() noexcept {
+  if (io_context_pool_) {
+    RETURN_IF_FAILURE(io_context_pool_->Init());
+  }
+
   if (metric_router_) {
     meter_ = metric_router_->GetOrCreateMeter(kHttpConnectionPoolMeter);
 
@@ -103,12 +114,16 @@ ExecutionResult HttpConnectionPool::Init() noexcept {
 }
 
 ExecutionResult HttpConnectionPool::Run() noexcept {
+  if (io_context_pool_) {
+    RETURN_IF_FAILURE(io_context_pool_->Run());
+  }
+
   is_running_ = true;
   return SuccessExecutionResult();
 }
 
 ExecutionResult HttpConnectionPool::Stop() noexcept {
-  is_running_ = false;
+  StopGrowingPools();
   std::vector<std::string> keys;
   auto execution_result = connections_.Keys(keys);
   if (!execution_result.Successful()) {
@@ -122,7 +137,12 @@ ExecutionResult HttpConnectionPool::Stop() noexcept {
       return execution_result;
     }
 
-    for (auto connection : entry->http_connections) {
+    std::vector<std::shared_ptr<HttpConnection>> http_connections;
+    {
+      std::lock_guard lock(entry->lock);
+      http_connections = entry->http_connections;
+    }
+    for (auto& connection : http_connections) {
       execution_result = connection->Stop();
       if (!execution_result.Successful()) {
         return execution_result;
@@ -130,6 +150,9 @@ ExecutionResult HttpConnectionPool::Stop() noexcept {
     }
   }
 
+  if (io_context_pool_) {
+    return io_context_pool_->Stop();
+  }
   return SuccessExecutionResult();
 }
 
@@ -137,8 +160,8 @@ std::shared_ptr<HttpConnection> HttpConnectionPool::CreateHttpConnection(
     std::string host, std::string service, bool is_https,
     TimeDuration http2_read_timeout_in_sec) {
   return make_shared<HttpConnection>(async_executor_, host, service, is_https,
-                                     metric_router_,
-                                     http2_read_timeout_in_sec_);
+                                     metric_router_, http2_read_timeout_in_sec_,
+                                     io_context_pool_);
 }
 
 ExecutionResult HttpConnectionPool::GetConnection(
@@ -170,17 +193,17 @@ ExecutionResult HttpConnectionPool::GetConnection(
   }
 
   auto http_connection_entry = std::make_shared<HttpConnectionPoolEntry>();
+  http_connection_entry->host = host;
+  http_connection_entry->service = service;
+  http_connection_entry->is_https = is_https;
   auto pair = std::make_pair(host + ":" + service, http_connection_entry);
   if (connections_.Insert(pair, http_connection_entry).Successful()) {
     for (size_t i = 0; i < max_connections_per_host_; ++i) {
-      auto http_connection = CreateHttpConnection(host, service, is_https,
-                                                  http2_read_timeout_in_sec_);
-      http_connection_entry->http_connections.push_back(http_connection);
-      auto execution_result = http_connection->Init();
-
+      std::shared_ptr<HttpConnection> http_connection;
+      auto execution_result =
+          StartHttpConnection(*http_connection_entry, http_connection);
       if (!execution_result.Successful()) {
         // Stop the connections already created before.
-        http_connection_entry->http_connections.pop_back();
         for (auto& http_connection : http_connection_entry->http_connections) {
           http_connection->Stop();
         }
@@ -188,21 +211,13 @@ ExecutionResult HttpConnectionPool::GetConnection(
         return execution_result;
       }
 
-      execution_result = http_connection->Run();
-      if (!execution_result.Successful()) {
-        // Stop the connections already created before.
-        http_connection_entry->http_connections.pop_back();
-        for (auto& http_connection : http_connection_entry->http_connections) {
-          http_connection->Stop();
-        }
-        connections_.Erase(pair.first);
-        return execution_result;
-      }
-      SCP_INFO(
-          kHttpConnection, kZeroUuid,
-          absl::StrFormat("Successfully initialized a connection %p for %s",
-                          http_connection.get(), pair.first.c_str()));
+      std::lock_guard lock(http_connection_entry->lock);
+      http_connection_entry->http_connections.push_back(http_connection);
+      http_connection_entry->last_active_times.push_back(
+          std::chrono::steady_clock::now());
     }
+    http_connection_entry->next_shrink_time =
+        std::chrono::steady_clock::now() + kShrinkCheckPeriod;
     http_connection_entry->is_initialized = true;
   }
 
@@ -210,36 +225,195 @@ ExecutionResult HttpConnectionPool::GetConnection(
     return RetryExecutionResult(SC_HTTP2_CLIENT_NO_CONNECTION_ESTABLISHED);
   }
 
-  auto value = http_connection_entry->order_counter.fetch_add(1);
-  auto connections_index = value % max_connections_per_host_;
-  connection = http_connection_entry->http_connections.at(connections_index);
-
-  if (connection->IsDropped()) {
-    RecycleConnection(connection);
-    // If the current connection is not ready, pick another connection that is
-    // ready. This allows the caller's request execution attempt to not go
-    // waste.
-    if (!connection->IsReady()) {
-      size_t cur_index = connections_index;
-      for (int i = 0; i < http_connection_entry->http_connections.size(); i++) {
-        auto http_connection =
-            http_connection_entry->http_connections[cur_index];
-        if (http_connection->IsReady()) {
-          connection = http_connection;
-          break;
-        }
-        cur_index = (cur_index + 1) % max_connections_per_host_;
+  HttpConnectionPoolEntry& entry = *http_connection_entry;
+  auto now = std::chrono::steady_clock::now();
+  // The connection in turn is recycled if it dropped, and idle connections are
+  // closed, once the lock is released since it takes a while.
+  std::shared_ptr<HttpConnection> dropped_connection;
+  std::vector<std::shared_ptr<HttpConnection>> idle_connections;
+  bool is_connection_dropped = false;
+  bool should_grow = false;
+  {
+    std::lock_guard lock(entry.lock);
+    const auto& http_connections = entry.http_connections;
+    size_t offset = entry.order_counter.fetch_add(1) % http_connections.size();
+
+    std::optional<size_t> chosen_index;
+    size_t chosen_streams = 0;
+    bool are_all_ready = true;
+    for (size_t i = 0; i < http_connections.size(); ++i) {
+      size_t index = (offset + i) % http_connections.size();
+      const auto& http_connection = http_connections[index];
+      if (i == 0 && http_connection->IsDropped()) {
+        dropped_connection = http_connection;
       }
-      // Return a retry if we are not able to pick a ready connection.
-      if (!connection->IsReady()) {
-        return RetryExecutionResult(SC_HTTP2_CLIENT_HTTP_CONNECTION_NOT_READY);
+      if (!http_connection->IsReady()) {
+        are_all_ready = false;
+        continue;
+      }
+
+      size_t streams = http_connection->ActiveClientRequestsSize();
+      if (streams > 0) {
+        entry.last_active_times[index] = now;
+      }
+      if (!chosen_index || streams < chosen_streams) {
+        chosen_index = index;
+        chosen_streams = streams;
+      }
+    }
+
+    if (chosen_index) {
+      connection = http_connections[*chosen_index];
+      entry.last_active_times[*chosen_index] = now;
+    } else {
+      // No connection is ready, so the one in turn is returned unless it
+      // dropped, in which case the caller retries.
+      connection = http_connections[offset];
+      is_connection_dropped = dropped_connection != nullptr;
+    }
+
+    if (max_elastic_connections_per_host_ > max_connections_per_host_) {
+      // A connection which is still connecting, or which dropped, is not
+      // loaded and the pool does not need to grow.
+      should_grow =
+          are_all_ready && chosen_streams >= connection_growth_streams_ &&
+          http_connections.size() < max_elastic_connections_per_host_;
+
+      if (now >= entry.next_shrink_time) {
+        entry.next_shrink_time = now + kShrinkCheckPeriod;
+        while (entry.http_connections.size() > max_connections_per_host_) {
+          const auto& http_connection = entry.http_connections.back();
+          if (http_connection == connection ||
+              http_connection->ActiveClientRequestsSize() > 0 ||
+              now - entry.last_active_times.back() < idle_connection_timeout_) {
+            break;
+          }
+          idle_connections.push_back(http_connection);
+          entry.http_connections.pop_back();
+          entry.last_active_times.pop_back();
+        }
       }
     }
   }
 
+  if (dropped_connection) {
+    RecycleConnection(dropped_connection);
+  }
+  for (auto& http_connection : idle_connections) {
+    http_connection->Stop();
+    SCP_INFO(kHttpConnection, kZeroUuid,
+             absl::StrFormat("Closed the idle connection %p for %s",
+                             http_connection.get(), pair.first.c_str()));
+  }
+  if (should_grow) {
+    GrowPool(http_connection_entry);
+  }
+
+  if (is_connection_dropped && !connection->IsReady()) {
+    return RetryExecutionResult(SC_HTTP2_CLIENT_HTTP_CONNECTION_NOT_READY);
+  }
   return SuccessExecutionResult();
 }
 
+ExecutionResult HttpConnectionPool::StartHttpConnection(
+    const HttpConnectionPoolEntry& entry,
+    std::shared_ptr<HttpConnection>& connection) noexcept {
+  connection = CreateHttpConnection(entry.host, entry.service, entry.is_https,
+                                    http2_read_timeout_in_sec_);
+  auto execution_result = connection->Init();
+  if (!execution_result.Successful()) {
+    return execution_result;
+  }
+
+  execution_result = connection->Run();
+  if (!execution_result.Successful()) {
+    return execution_result;
+  }
+  SCP_INFO(kHttpConnection, kZeroUuid,
+           absl::StrFormat("Successfully initialized a connection %p for %s:%s",
+                           connection.get(), entry.host.c_str(),
+                           entry.service.c_str()));
+  return SuccessExecutionResult();
+}
+
+void HttpConnectionPool::GrowPool(
+    const std::shared_ptr<HttpConnectionPoolEntry>& entry) noexcept {
+  if (entry->is_growing.exchange(true)) {
+    return;
+  }
+
+  {
+    std::lock_guard lock(grow_pool_tasks_lock_);
+    if (!is_running_) {
+      entry->is_growing = false;
+      return;
+    }
+    pending_grow_pool_tasks_++;
+  }
+  // Keeps the pool from being stopped until the last copy of the task is
+  // destroyed, whether the async executor ran it or dropped it.
+  std::shared_ptr<HttpConnectionPool> pool(
+      this, [](HttpConnectionPool* pool) { pool->OnGrowPoolTaskDone(); });
+
+  // Starting a connection resolves the host, so it is kept off the request
+  // which found the pool loaded.
+  auto execution_result = async_executor_->Schedule(
+      [pool, entry]() { pool->AddConnection(*entry); }, AsyncPriority::Normal);
+  if (!execution_result.Successful()) {
+    SCP_ERROR(kHttpConnection, kZeroUuid, execution_result,
+              absl::StrFormat("Failed to grow the connection pool of %s:%s",
+                              entry->host.c_str(), entry->service.c_str()));
+    entry->is_growing = false;
+  }
+}
+
+void HttpConnectionPool::AddConnection(
+    HttpConnectionPoolEntry& entry) noexcept {
+  // The pool may have stopped before the task ran.
+  if (!is_running_) {
+    entry.is_growing = false;
+    return;
+  }
+
+  std::shared_ptr<HttpConnection> connection;
+  auto execution_result = StartHttpConnection(entry, connection);
+  if (!execution_result.Successful()) {
+    SCP_ERROR(kHttpConnection, kZeroUuid, execution_result,
+              absl::StrFormat("Failed to grow the connection pool of %s:%s",
+                              entry.host.c_str(), entry.service.c_str()));
+    entry.is_growing = false;
+    return;
+  }
+
+  {
+    std::lock_guard lock(entry.lock);
+    // The pool may have stopped in the meantime.
+    if (is_running_) {
+      entry.http_connections.push_back(connection);
+      entry.last_active_times.push_back(std::chrono::steady_clock::now());
+      connection = nullptr;
+    }
+  }
+  if (connection) {
+    connection->Stop();
+  }
+  entry.is_growing = false;
+}
+
+void HttpConnectionPool::StopGrowingPools() noexcept {
+  std::unique_lock lock(grow_pool_tasks_lock_);
+  is_running_ = false;
+  grow_pool_tasks_done_.wait(
+      lock, [this]() { return pending_grow_pool_tasks_ == 0; });
+}
+
+void HttpConnectionPool::OnGrowPoolTaskDone() noexcept {
+  std::lock_guard lock(grow_pool_tasks_lock_);
+  if (--pending_grow_pool_tasks_ == 0) {
+    grow_pool_tasks_done_.notify_all();
+  }
+}
+
 void HttpConnectionPool::RecycleConnection(
     std::shared_ptr<HttpConnection>& connection) noexcept {
   std::lock_guard lock(connection_lock_);
@@ -285,6 +459,7 @@ void HttpConnectionPool::ObserveClientActiveRequestsCallback(
       return;
     }
 
+    std::lock_guard lock(entry->lock);
     for (const std::shared_ptr<HttpConnection>& connection :
          entry->http_connections) {
       total_active_requests +=
@@ -321,6 +496,7 @@ void HttpConnectionPool::ObserveClientOpenConnectionsCallback(
       return;
     }
 
+    std::lock_guard lock(entry->lock);
     for (const std::shared_ptr<HttpConnection>& connection :
          entry->http_connections) {
       if (connection->IsReady()) {
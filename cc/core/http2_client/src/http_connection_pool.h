@@ -17,6 +17,8 @@
 
 #pragma once
 
+#include <chrono>
+#include <condition_variable>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -26,6 +28,7 @@
 
 #include "cc/core/common/concurrent_map/src/concurrent_map.h"
 #include "cc/core/http2_client/src/http_connection.h"
+#include "cc/core/http2_client/src/http_io_context_pool.h"
 #include "cc/core/telemetry/src/metric/metric_router.h"
 #include "cc/public/core/interface/execution_result.h"
 #include "opentelemetry/metrics/meter.h"
@@ -35,8 +38,18 @@ namespace privacy_sandbox::pbs_common {
 /**
  * @brief Provides connection pool functionality. Once the object is created,
  * the caller can get a connection to the remote host by calling get connection.
- * The order of the connections is chosen in a round robin fashion.
+ * The ready connection with the fewest streams in flight is chosen, so that a
+ * slow or reconnecting connection does not hold up a share of the requests.
+ * Equally loaded connections are chosen in a round robin fashion.
  *
+ * The pool of a host is elastic when max_elastic_connections_per_host is
+ * greater than max_connections_per_host: it grows by one connection at a time
+ * while every connection carries connection_growth_streams streams, the
+ * connection being started on the async executor, and closes the extra
+ * connections once they are idle.
+ *
+ * When shared_io_context_threads is set, the connections of all the hosts are
+ * served by that many threads rather than by a thread each.
  */
 class HttpConnectionPool : public ServiceInterface {
  protected:
@@ -45,14 +58,33 @@ class HttpConnectionPool : public ServiceInterface {
    * the active connections.
    */
   struct HttpConnectionPoolEntry {
-    HttpConnectionPoolEntry() : is_initialized(false), order_counter(0) {}
+    HttpConnectionPoolEntry()
+        : is_initialized(false),
+          order_counter(0),
+          is_https(false),
+          is_growing(false) {}
 
-    /// The current cached connections.
+    /// The current cached connections. Guarded by lock once the entry is
+    /// initialized, since elastic pools add and remove connections.
     std::vector<std::shared_ptr<HttpConnection>> http_connections;
+    /// When each of http_connections was last chosen or seen with streams in
+    /// flight.
+    std::vector<std::chrono::steady_clock::time_point> last_active_times;
     /// Indicates whether the entry is initialized.
     std::atomic<bool> is_initialized;
-    /// Is used to apply a round robin fashion selection of the connections.
+    /// Rotates the first connection looked at, so that equally loaded
+    /// connections are chosen in a round robin fashion.
     std::atomic<uint64_t> order_counter;
+    /// Guards http_connections and last_active_times.
+    std::mutex lock;
+    /// The host, service and scheme new connections are created with.
+    std::string host;
+    std::string service;
+    bool is_https;
+    /// Indicates whether a connection is being added to the pool.
+    std::atomic<bool> is_growing;
+    /// When the pool is next looked at for idle connections to close.
+    std::chrono::steady_clock::time_point next_shrink_time;
   };
 
   /// Callback to be used with an OTel ObservableInstrument for client active
@@ -79,17 +111,40 @@ class HttpConnectionPool : public ServiceInterface {
    * be a nullptr as passed from HttpClient or in testing from
    * MockHttpConnectionPool.
    * @param max_connections_per_host The max number of connections created per
-   * host.
+   * host, or the min number of connections of elastic pools.
+   * @param http2_read_timeout_in_sec nghttp2 read timeout in second.
+   * @param max_elastic_connections_per_host The max number of connections per
+   * host of elastic pools. Pools are not elastic when it is not greater than
+   * max_connections_per_host.
+   * @param connection_growth_streams The streams in flight on every connection
+   * of a host beyond which its elastic pool grows.
+   * @param idle_connection_timeout_in_sec How long the extra connections of an
+   * elastic pool stay open while idle.
+   * @param shared_io_context_threads The number of threads serving all the
+   * connections. Each connection runs its own thread when 0.
    */
   explicit HttpConnectionPool(
       const std::shared_ptr<AsyncExecutorInterface>& async_executor,
       absl::Nullable<MetricRouter*> metric_router,
       size_t max_connections_per_host = kDefaultMaxConnectionsPerHost,
       TimeDuration http2_read_timeout_in_sec =
-          kDefaultHttp2ReadTimeoutInSeconds)
+          kDefaultHttp2ReadTimeoutInSeconds,
+      size_t max_elastic_connections_per_host = 0,
+      size_t connection_growth_streams = kDefaultConnectionGrowthStreams,
+      TimeDuration idle_connection_timeout_in_sec =
+          kDefaultIdleConnectionTimeoutInSeconds,
+      size_t shared_io_context_threads = 0)
       : async_executor_(async_executor),
         max_connections_per_host_(max_connections_per_host),
         http2_read_timeout_in_sec_(http2_read_timeout_in_sec),
+        max_elastic_connections_per_host_(max_elastic_connections_per_host),
+        connection_growth_streams_(connection_growth_streams),
+        idle_connection_timeout_(
+            std::chrono::seconds(idle_connection_timeout_in_sec)),
+        io_context_pool_(shared_io_context_threads > 0
+                             ? std::make_shared<HttpIoContextPool>(
+                                   shared_io_context_threads)
+                             : nullptr),
         is_running_(false),
         metric_router_(metric_router) {}
 
@@ -132,6 +187,43 @@ class HttpConnectionPool : public ServiceInterface {
   virtual void RecycleConnection(
       std::shared_ptr<HttpConnection>& connection) noexcept;
 
+  /**
+   * @brief Creates, initializes and runs a connection for the entry.
+   *
+   * @param entry The entry to create the connection for.
+   * @param connection The created connection.
+   * @return ExecutionResult The execution result of the operation.
+   */
+  ExecutionResult StartHttpConnection(
+      const HttpConnectionPoolEntry& entry,
+      std::shared_ptr<HttpConnection>& connection) noexcept;
+
+  /**
+   * @brief Schedules the addition of a connection to an elastic pool on the
+   * async executor. Is a no-op if a connection is already being added, or if
+   * the pool stopped. Stop waits for the scheduled task.
+   *
+   * @param entry The entry of the pool.
+   */
+  void GrowPool(const std::shared_ptr<HttpConnectionPoolEntry>& entry) noexcept;
+
+  /**
+   * @brief Starts a connection and adds it to an elastic pool, unless the pool
+   * stopped. Runs on the async executor.
+   *
+   * @param entry The entry of the pool.
+   */
+  void AddConnection(HttpConnectionPoolEntry& entry) noexcept;
+
+  /**
+   * @brief Stops scheduling GrowPool tasks, and waits for the scheduled ones
+   * to be run or dropped by the async executor, as they use the pool.
+   */
+  void StopGrowingPools() noexcept;
+
+  /// Is called once the last copy of a GrowPool task is destroyed.
+  void OnGrowPoolTaskDone() noexcept;
+
   /// Instance of the async executor.
   const std::shared_ptr<AsyncExecutorInterface> async_executor_;
 
@@ -141,6 +233,18 @@ class HttpConnectionPool : public ServiceInterface {
   /// http2 connection read timeout in seconds.
   TimeDuration http2_read_timeout_in_sec_;
 
+  /// Max number of connections per host of elastic pools.
+  size_t max_elastic_connections_per_host_;
+
+  /// Streams in flight on every connection beyond which elastic pools grow.
+  size_t connection_growth_streams_;
+
+  /// How long the extra connections of elastic pools stay open while idle.
+  std::chrono::seconds idle_connection_timeout_;
+
+  /// The threads shared by all the connections, if any.
+  std::shared_ptr<HttpIoContextPool> io_context_pool_;
+
   /// The pool of all the connections.
   ConcurrentMap<std::string, std::shared_ptr<HttpConnectionPoolEntry>>
       connections_;
@@ -150,6 +254,14 @@ class HttpConnectionPool : public ServiceInterface {
   /// Mutex for recycling connection
   std::mutex connection_lock_;
 
+  /// Guards pending_grow_pool_tasks_, and the stop of the pool against the
+  /// scheduling of GrowPool tasks.
+  std::mutex grow_pool_tasks_lock_;
+  /// Notified once no GrowPool task is pending anymore.
+  std::condition_variable grow_pool_tasks_done_;
+  /// Number of GrowPool tasks scheduled and not destroyed yet.
+  size_t pending_grow_pool_tasks_ = 0;
+
   /// An instance of metric router which will provide APIs to create metrics.
   MetricRouter* metric_router_;
 
@@ -0,0 +1,59 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cc/core/http2_client/src/http_hedging.h"
+
+#include <algorithm>
+#include <cmath>
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+namespace privacy_sandbox::pbs_common {
+
+HttpLatencyTracker::HttpLatencyTracker(double percentile, size_t window_size)
+    : percentile_(std::clamp(percentile, 0.0, 1.0)),
+      latencies_(std::max<size_t>(window_size, 1)),
+      next_(0),
+      recorded_(0),
+      percentile_nanos_(0) {}
+
+void HttpLatencyTracker::Record(std::chrono::nanoseconds latency) noexcept {
+  std::lock_guard lock(lock_);
+  latencies_[next_] = latency.count();
+  next_ = (next_ + 1) % latencies_.size();
+  ++recorded_;
+
+  // The percentile is known once a quarter of the window is filled, and then
+  // refreshed every eighth of the window.
+  const size_t min_recorded = std::max<size_t>(latencies_.size() / 4, 1);
+  const size_t refresh_period = std::max<size_t>(latencies_.size() / 8, 1);
+  if (recorded_ < min_recorded || recorded_ % refresh_period != 0) {
+    return;
+  }
+
+  std::vector<int64_t> latencies(
+      latencies_.begin(),
+      latencies_.begin() + std::min(recorded_, latencies_.size()));
+  // Nearest rank.
+  auto rank = static_cast<size_t>(std::max(
+      std::ceil(percentile_ * static_cast<double>(latencies.size())) - 1, 0.0));
+  std::nth_element(latencies.begin(), latencies.begin() + rank,
+                   latencies.end());
+  percentile_nanos_ = latencies[rank];
+}
+
+}  // namespace privacy_sandbox::pbs_common
@@ -0,0 +1,68 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace privacy_sandbox::pbs_common {
+
+/// Number of latencies a HttpLatencyTracker computes its percentile over.
+inline constexpr size_t kDefaultHttpLatencyTrackerWindowSize = 256;
+
+/**
+ * @brief Tracks a latency percentile over the most recent requests to a host.
+ *
+ * The percentile is recomputed every few recorded latencies rather than on
+ * each read, so that reading it is a single atomic load.
+ */
+class HttpLatencyTracker {
+ public:
+  /**
+   * @brief Constructs a new Http Latency Tracker object.
+   *
+   * @param percentile The percentile to track, in (0, 1].
+   * @param window_size The number of most recent latencies the percentile is
+   * computed over.
+   */
+  explicit HttpLatencyTracker(
+      double percentile,
+      size_t window_size = kDefaultHttpLatencyTrackerWindowSize);
+
+  /// Records the latency of a completed request.
+  void Record(std::chrono::nanoseconds latency) noexcept;
+
+  /// Returns the tracked percentile, or 0 until enough latencies are recorded.
+  std::chrono::nanoseconds GetPercentile() const noexcept {
+    return std::chrono::nanoseconds(percentile_nanos_.load());
+  }
+
+ private:
+  const double percentile_;
+  std::mutex lock_;
+  /// Circular buffer of the most recent latencies.
+  std::vector<int64_t> latencies_;
+  size_t next_;
+  size_t recorded_;
+  std::atomic<int64_t> percentile_nanos_;
+};
+
+}  // namespace privacy_sandbox::pbs_common
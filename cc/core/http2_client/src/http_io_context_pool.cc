@@ -0,0 +1,92 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cc/core/http2_client/src/http_io_context_pool.h"
+
+#include <memory>
+#include <thread>
+
+#include "cc/core/common/global_logger/src/global_logger.h"
+#include "cc/core/common/uuid/src/uuid.h"
+#include "cc/core/http2_client/src/error_codes.h"
+
+namespace privacy_sandbox::pbs_common {
+using boost::asio::io_context;
+using boost::asio::make_work_guard;
+
+static constexpr char kHttpIoContextPool[] = "HttpIoContextPool";
+
+HttpIoContextPool::HttpIoContextPool(size_t size) : next_io_context_(0) {
+  for (size_t i = 0; i < size; ++i) {
+    io_contexts_.push_back(std::make_unique<io_context>(1));
+  }
+}
+
+HttpIoContextPool::~HttpIoContextPool() {
+  Stop();
+}
+
+ExecutionResult HttpIoContextPool::Init() noexcept {
+  if (io_contexts_.empty()) {
+    return FailureExecutionResult(SC_HTTP2_CLIENT_INVALID_IO_CONTEXT_POOL_SIZE);
+  }
+
+  for (auto& io_context : io_contexts_) {
+    work_guards_.push_back(std::make_unique<WorkGuard>(
+        make_work_guard(io_context->get_executor())));
+  }
+  return SuccessExecutionResult();
+}
+
+ExecutionResult HttpIoContextPool::Run() noexcept {
+  for (auto& io_context : io_contexts_) {
+    threads_.emplace_back([io_context = io_context.get()]() {
+      // The handlers of the connections do not throw, the loop keeps going if
+      // one does anyway.
+      while (true) {
+        try {
+          io_context->run();
+          return;
+        } catch (...) {
+          SCP_ERROR(kHttpIoContextPool, kZeroUuid,
+                    FailureExecutionResult(SC_HTTP2_CLIENT_CONNECTION_DROPPED),
+                    "A connection handler threw.");
+        }
+      }
+    });
+  }
+  return SuccessExecutionResult();
+}
+
+ExecutionResult HttpIoContextPool::Stop() noexcept {
+  work_guards_.clear();
+  for (auto& io_context : io_contexts_) {
+    io_context->stop();
+  }
+  for (auto& thread : threads_) {
+    if (thread.joinable()) {
+      thread.join();
+    }
+  }
+  threads_.clear();
+  return SuccessExecutionResult();
+}
+
+io_context& HttpIoContextPool::GetNextIoContext() noexcept {
+  return *io_contexts_[next_io_context_.fetch_add(1) % io_contexts_.size()];
+}
+
+}  // namespace privacy_sandbox::pbs_common
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+
+#include "cc/core/interface/service_interface.h"
+#include "cc/public/core/interface/execution_result.h"
+
+namespace privacy_sandbox::pbs_common {
+
+/**
+ * @brief A fixed set of io_contexts, each run by a single thread, which
+ * HttpConnections share instead of running a thread each. The number of
+ * threads is then independent of the number of connections.
+ *
+ * A connection is bound to one io_context for its lifetime. Since each
+ * io_context is run by a single thread, it acts as a strand: the handlers of a
+ * connection never run concurrently, and connections on the same io_context
+ * are served by the same core.
+ */
+class HttpIoContextPool : public ServiceInterface {
+ public:
+  /**
+   * @brief Constructs a new Http Io Context Pool object.
+   *
+   * @param size The number of io_contexts and threads.
+   */
+  explicit HttpIoContextPool(size_t size);
+
+  ~HttpIoContextPool();
+
+  ExecutionResult Init() noexcept override;
+  ExecutionResult Run() noexcept override;
+
+  /**
+   * @brief Stops the threads. The connections using the pool must be stopped
+   * first.
+   */
+  ExecutionResult Stop() noexcept override;
+
+  /// Returns the io_context a new connection is bound to, in a round robin
+  /// fashion.
+  boost::asio::io_context& GetNextIoContext() noexcept;
+
+  /// The number of io_contexts.
+  size_t Size() const noexcept { return io_contexts_.size(); }
+
+ private:
+  using WorkGuard =
+      boost::asio::executor_work_guard<boost::asio::io_context::executor_type>;
+
+  std::vector<std::unique_ptr<boost::asio::io_context>> io_contexts_;
+  /// Keeps the io_contexts running while they have no work.
+  std::vector<std::unique_ptr<WorkGuard>> work_guards_;
+  std::vector<std::thread> threads_;
+  /// Is used to apply a round robin fashion selection of the io_contexts.
+  std::atomic<size_t> next_io_context_;
+};
+
+}  // namespace privacy_sandbox::pbs_common
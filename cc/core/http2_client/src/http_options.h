@@ -17,10 +17,28 @@
 #ifndef CC_CORE_HTTP2_CLIENT_SRC_HTTP_OPTIONS_H_
 #define CC_CORE_HTTP2_CLIENT_SRC_HTTP_OPTIONS_H_
 
+#include "cc/core/common/operation_dispatcher/src/circuit_breaker.h"
+#include "cc/core/common/operation_dispatcher/src/retry_budget.h"
 #include "cc/core/common/operation_dispatcher/src/retry_strategy.h"
 
 namespace privacy_sandbox::pbs_common {
 
+/// Hedging of the idempotent requests: a request still in flight after a delay
+/// is sent again on another connection, and the first response wins.
+struct HttpHedgingOptions {
+  /// Delay after which a request is hedged. Hedging is disabled when both
+  /// delay_in_ms and latency_percentile are 0.
+  TimeDuration delay_in_ms = 0;
+  /// When greater than 0, e.g. 0.95, requests are hedged after this
+  /// percentile of the latencies learned per host. delay_in_ms applies until
+  /// enough latencies of the host are known.
+  double latency_percentile = 0;
+  /// Max ratio of hedged requests to idempotent requests.
+  double budget_ratio = 0.1;
+  /// Number of requests which can be hedged in a burst.
+  size_t max_budget = 10;
+};
+
 struct HttpClientOptions {
   HttpClientOptions()
       : retry_strategy_options(RetryStrategyOptions(
@@ -42,6 +60,27 @@ struct HttpClientOptions {
   const size_t max_connections_per_host;
   /// nghttp client read timeout.
   const TimeDuration http2_read_timeout_in_sec;
+  /// When greater than max_connections_per_host, the connections to a host
+  /// grow up to this many while every connection carries at least
+  /// connection_growth_streams streams, and the extra connections are closed
+  /// once they stayed idle for idle_connection_timeout_in_sec.
+  size_t max_elastic_connections_per_host = 0;
+  /// Streams in flight on every connection to a host beyond which an elastic
+  /// pool grows. Keep it below the max concurrent streams of the peer, 100 for
+  /// nghttp2 servers, so that requests are not queued on the client.
+  size_t connection_growth_streams = kDefaultConnectionGrowthStreams;
+  /// How long the extra connections of an elastic pool stay open while idle.
+  TimeDuration idle_connection_timeout_in_sec =
+      kDefaultIdleConnectionTimeoutInSeconds;
+  /// When greater than 0, the connections share this many io threads, e.g. one
+  /// per core, instead of running a thread each.
+  size_t shared_io_context_threads = 0;
+  /// Hedging of the requests marked as idempotent.
+  HttpHedgingOptions hedging;
+  /// Limits the retries of all the requests to a ratio of the requests.
+  RetryBudgetOptions retry_budget;
+  /// Fails the requests to a host right away while its circuit is open.
+  CircuitBreakerOptions circuit_breaker;
 };
 
 }  // namespace privacy_sandbox::pbs_common
@@ -85,7 +85,11 @@ SyncHttpClient::SyncHttpClient(HttpClientOptions options)
       std::make_shared<SynchronousExecutor>();
   http_connection_pool_ = std::make_unique<HttpConnectionPool>(
       sync_executor, nullptr, options.max_connections_per_host,
-      options.http2_read_timeout_in_sec);
+      options.http2_read_timeout_in_sec,
+      options.max_elastic_connections_per_host,
+      options.connection_growth_streams,
+      options.idle_connection_timeout_in_sec,
+      options.shared_io_context_threads);
 
   CHECK(http_connection_pool_->Init());
   CHECK(http_connection_pool_->Run());
@@ -0,0 +1,175 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "cc/core/async_executor/src/async_executor.h"
+#include "cc/core/authorization_proxy/src/pass_thru_authorization_proxy.h"
+#include "cc/core/config_provider/mock/mock_config_provider.h"
+#include "cc/core/http2_client/src/http2_client.h"
+#include "cc/core/http2_server/src/http2_server.h"
+
+namespace privacy_sandbox::pbs_common {
+namespace {
+
+constexpr char kHost[] = "localhost";
+constexpr char kPort[] = "8098";
+constexpr char kPath[] = "/v1/benchmark";
+constexpr int64_t kConnections = 64;
+
+// Returns the number of threads of the process.
+int64_t GetThreadCount() {
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.rfind("Threads:", 0) == 0) {
+      return std::stoll(line.substr(sizeof("Threads:") - 1));
+    }
+  }
+  return 0;
+}
+
+// Spreads 8 concurrent requests per connection over kConnections client
+// connections, each running its own io thread when state.range(0) is 0, or all
+// sharing state.range(0) io threads otherwise. Reports the request to response
+// latency and the number of threads of the process.
+void BM_Http2ClientSharedIoContextLoopback(benchmark::State& state) {
+  auto server_executor = std::make_shared<AsyncExecutor>(
+      4 /* thread pool size */, 100000 /* queue size */,
+      true /* drop_tasks_on_stop */);
+  auto client_executor = std::make_shared<AsyncExecutor>(
+      4 /* thread pool size */, 100000 /* queue size */,
+      true /* drop_tasks_on_stop */);
+  HttpClientOptions client_options(
+      RetryStrategyOptions(RetryStrategyType::Linear, 100 /* delay in ms */,
+                           5 /* num retries */),
+      kConnections /* max connections per host */,
+      5 /* read timeout in sec */);
+  client_options.shared_io_context_threads = state.range(0);
+  auto http_client =
+      std::make_shared<HttpClient>(client_executor, client_options);
+  auto http_server = std::make_shared<Http2Server>(
+      kHost, kPort, 4 /* http server thread pool size */, server_executor,
+      std::make_shared<PassThruAuthorizationProxy>(),
+      /*aws_authorization_proxy=*/nullptr,
+      std::make_shared<MockConfigProvider>());
+
+  HttpHandler handler = [](AsyncContext<HttpRequest, HttpResponse>& context) {
+    context.response = std::make_shared<HttpResponse>();
+    context.response->code = HttpStatusCode::OK;
+    context.result = SuccessExecutionResult();
+    context.Finish();
+    return SuccessExecutionResult();
+  };
+  std::string path = kPath;
+  http_server->RegisterResourceHandler(HttpMethod::GET, path, handler);
+
+  client_executor->Init();
+  server_executor->Init();
+  http_server->Init();
+  http_client->Init();
+  client_executor->Run();
+  server_executor->Run();
+  http_server->Run();
+  http_client->Run();
+
+  const auto uri = std::make_shared<std::string>(std::string("http://") +
+                                                 kHost + ":" + kPort + kPath);
+  const int64_t requests_per_iteration = kConnections * 8;
+  std::vector<std::chrono::nanoseconds> latencies(requests_per_iteration);
+  std::vector<std::chrono::nanoseconds> all_latencies;
+  std::atomic<int64_t> completed = 0;
+  std::atomic<int64_t> failed = 0;
+  auto perform_requests = [&]() {
+    completed = 0;
+    for (int64_t i = 0; i < requests_per_iteration; ++i) {
+      auto request = std::make_shared<HttpRequest>();
+      request->method = HttpMethod::GET;
+      request->path = uri;
+      const auto start = std::chrono::steady_clock::now();
+      AsyncContext<HttpRequest, HttpResponse> context(
+          std::move(request),
+          [&, i, start](AsyncContext<HttpRequest, HttpResponse>& context) {
+            latencies[i] = std::chrono::steady_clock::now() - start;
+            if (!context.result.Successful()) {
+              failed++;
+            }
+            completed++;
+          });
+      if (!http_client->PerformRequest(context).Successful()) {
+        latencies[i] = std::chrono::nanoseconds(0);
+        failed++;
+        completed++;
+      }
+    }
+    while (completed.load() < requests_per_iteration) {
+      std::this_thread::yield();
+    }
+  };
+
+  // Establishes the connections.
+  perform_requests();
+  failed = 0;
+  const int64_t threads = GetThreadCount();
+
+  for (auto _ : state) {
+    perform_requests();
+    state.PauseTiming();
+    all_latencies.insert(all_latencies.end(), latencies.begin(),
+                         latencies.end());
+    state.ResumeTiming();
+  }
+
+  std::sort(all_latencies.begin(), all_latencies.end());
+  std::chrono::nanoseconds total_latency(0);
+  for (const auto& latency : all_latencies) {
+    total_latency += latency;
+  }
+
+  state.SetItemsProcessed(state.iterations() * requests_per_iteration);
+  state.counters["failed_requests"] = failed.load();
+  state.counters["threads"] = threads;
+  state.counters["mean_latency_us"] =
+      total_latency.count() / 1000.0 / all_latencies.size();
+  state.counters["p99_latency_us"] =
+      all_latencies[all_latencies.size() * 99 / 100].count() / 1000.0;
+
+  http_client->Stop();
+  http_server->Stop();
+  client_executor->Stop();
+  server_executor->Stop();
+}
+
+BENCHMARK(BM_Http2ClientSharedIoContextLoopback)
+    ->Arg(0)
+    ->Arg(2)
+    ->Arg(4)
+    ->ArgName("shared_io_threads")
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace privacy_sandbox::pbs_common
+
+// Run the benchmark.
+BENCHMARK_MAIN();
@@ -17,15 +17,18 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <chrono>
 #include <functional>
 #include <future>
 #include <map>
 #include <memory>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
 #include <boost/algorithm/string.hpp>
+#include <boost/asio/steady_timer.hpp>
 #include <nghttp2/asio_http2_server.h>
 #include <openssl/rand.h>
 #include <openssl/sha.h>
@@ -47,6 +50,9 @@ using ::nghttp2::asio_http2::server::request;
 using ::nghttp2::asio_http2::server::response;
 
 static constexpr TimeDuration kHttp2ReadTimeoutInSeconds = 10;
+// How long /slow requests block the server thread of their connection.
+static constexpr std::chrono::milliseconds kSlowRequestDuration =
+    std::chrono::milliseconds(1000);
 
 class RandomGenHandler : std::enable_shared_from_this<RandomGenHandler> {
  public:
@@ -94,6 +100,38 @@ class HttpServer {
       res.end("hello, world\n");
     });
 
+    server.handle("/slow", [](const request& req, const response& res) {
+      std::this_thread::sleep_for(kSlowRequestDuration);
+      res.write_head(200);
+      res.end("hello, world\n");
+    });
+
+    // Every other request is slow, without blocking the server thread.
+    server.handle("/bimodal", [this](const request& req, const response& res) {
+      if (bimodal_requests_++ % 2 == 0) {
+        res.write_head(200);
+        res.end("hello, world\n");
+        return;
+      }
+      auto timer = std::make_shared<boost::asio::steady_timer>(
+          res.io_service(), kSlowRequestDuration);
+      auto is_closed = std::make_shared<bool>(false);
+      timer->async_wait(
+          [&res, is_closed](const boost::system::error_code& error_code) {
+            if (!error_code && !*is_closed) {
+              res.write_head(200);
+              res.end("hello, world\n");
+            }
+          });
+      res.on_close([this, timer, is_closed](uint32_t error_code) {
+        *is_closed = true;
+        timer->cancel();
+        if (error_code != 0) {
+          cancelled_bimodal_requests_++;
+        }
+      });
+    });
+
     server.handle(
         "/pingpong_query_param", [](const request& req, const response& res) {
           res.write_head(200, {{"query_param", {req.uri().raw_query.c_str()}}});
@@ -146,10 +184,14 @@ class HttpServer {
 
   int PortInUse() { return server.ports()[0]; }
 
+  int CancelledBimodalRequests() { return cancelled_bimodal_requests_.load(); }
+
   http2 server;
 
  private:
   std::atomic<bool> is_running_{false};
+  std::atomic<int> bimodal_requests_{0};
+  std::atomic<int> cancelled_bimodal_requests_{0};
   std::string address_;
   std::string port_;
   size_t num_threads_;
@@ -183,6 +225,97 @@ TEST(HttpClientTest, FailedToConnect) {
   async_executor->Stop();
 }
 
+// A slow request blocks the server thread handling its connection, and with it
+// the other requests of that connection. The client sends the following
+// requests on the other connection, which has fewer streams in flight.
+TEST(HttpClientTest, RequestsAvoidTheConnectionOfASlowRequest) {
+  // One server thread per connection.
+  HttpServer server("localhost", "0", kDefaultMaxConnectionsPerHost);
+  server.Run();
+  std::shared_ptr<AsyncExecutorInterface> async_executor =
+      std::make_shared<AsyncExecutor>(2, 1000);
+  async_executor->Init();
+  async_executor->Run();
+  HttpClient http_client(async_executor);
+  http_client.Init();
+  http_client.Run();
+
+  auto perform_request = [&](const std::string& path) {
+    auto request = std::make_shared<HttpRequest>();
+    request->method = HttpMethod::GET;
+    request->path = std::make_shared<std::string>(
+        "http://localhost:" + std::to_string(server.PortInUse()) + path);
+    auto done = std::make_shared<std::promise<void>>();
+    auto future = done->get_future();
+    AsyncContext<HttpRequest, HttpResponse> context(
+        std::move(request),
+        [done](AsyncContext<HttpRequest, HttpResponse>& context) {
+          EXPECT_SUCCESS(context.result);
+          done->set_value();
+        });
+    EXPECT_SUCCESS(http_client.PerformRequest(context));
+    return future;
+  };
+
+  // Connects both connections.
+  perform_request("/test").get();
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  auto slow_request = perform_request("/slow");
+  for (int i = 0; i < 4; ++i) {
+    auto start = std::chrono::steady_clock::now();
+    perform_request("/test").get();
+    EXPECT_LT(std::chrono::steady_clock::now() - start,
+              kSlowRequestDuration / 2);
+  }
+  slow_request.get();
+
+  http_client.Stop();
+  async_executor->Stop();
+  server.Stop();
+}
+
+// The hedge of a slow /bimodal request is fast and wins, and the slow request
+// is cancelled.
+TEST(HttpClientTest, HedgedRequestsAvoidTheSlowResponses) {
+  HttpServer server("localhost", "0", kDefaultMaxConnectionsPerHost);
+  server.Run();
+  std::shared_ptr<AsyncExecutorInterface> async_executor =
+      std::make_shared<AsyncExecutor>(2, 1000);
+  async_executor->Init();
+  async_executor->Run();
+  HttpClientOptions options;
+  options.hedging.delay_in_ms = 50;
+  HttpClient http_client(async_executor, options);
+  http_client.Init();
+  http_client.Run();
+
+  for (int i = 0; i < 10; ++i) {
+    auto request = std::make_shared<HttpRequest>();
+    request->method = HttpMethod::GET;
+    request->path = std::make_shared<std::string>(
+        "http://localhost:" + std::to_string(server.PortInUse()) + "/bimodal");
+    request->is_idempotent = true;
+    std::promise<void> done;
+    AsyncContext<HttpRequest, HttpResponse> context(
+        std::move(request),
+        [&done](AsyncContext<HttpRequest, HttpResponse>& context) {
+          EXPECT_SUCCESS(context.result);
+          done.set_value();
+        });
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_SUCCESS(http_client.PerformRequest(context));
+    done.get_future().get();
+    EXPECT_LT(std::chrono::steady_clock::now() - start,
+              kSlowRequestDuration / 2);
+  }
+  WaitUntil([&]() { return server.CancelledBimodalRequests() > 0; });
+
+  http_client.Stop();
+  async_executor->Stop();
+  server.Stop();
+}
+
 class HttpClientTestII : public ::testing::Test {
  protected:
   void SetUp() override {
@@ -15,9 +15,13 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <chrono>
 #include <map>
 #include <memory>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
 #include "cc/core/async_executor/mock/mock_async_executor.h"
@@ -35,6 +39,43 @@ namespace privacy_sandbox::pbs_common {
 namespace {
 using ::testing::IsEmpty;
 
+// A ready connection which does not connect anywhere, whose streams in flight
+// are set by the test.
+class FakeHttpConnection : public MockHttpConnection {
+ public:
+  using MockHttpConnection::MockHttpConnection;
+
+  ExecutionResult Init() noexcept override {
+    SetIsReady();
+    return SuccessExecutionResult();
+  }
+
+  ExecutionResult Run() noexcept override { return SuccessExecutionResult(); }
+
+  ExecutionResult Stop() noexcept override {
+    SetIsNotReady();
+    return SuccessExecutionResult();
+  }
+
+  void SetStreams(size_t streams) {
+    while (ActiveClientRequestsSize() < streams) {
+      AsyncContext<HttpRequest, HttpResponse> context;
+      GetPendingNetworkCallbacks().Insert(
+          std::make_pair(Uuid::GenerateUuid(), context), context);
+    }
+    std::vector<Uuid> keys;
+    GetPendingNetworkCallbacks().Keys(keys);
+    for (size_t i = streams; i < keys.size(); ++i) {
+      GetPendingNetworkCallbacks().Erase(keys[i]);
+    }
+  }
+};
+
+std::shared_ptr<FakeHttpConnection> AsFake(
+    const std::shared_ptr<HttpConnection>& connection) {
+  return std::static_pointer_cast<FakeHttpConnection>(connection);
+}
+
 class HttpConnectionPoolTest : public testing::Test {
  protected:
   void SetUp() override {
@@ -449,5 +490,156 @@ TEST_F(HttpConnectionPoolTest, TestAddressErrorsOtelMetric) {
       << "Expected client_address_errors_sum_point_data.value_ to be 1 "
          "(int64_t)";
 }
+
+class ElasticHttpConnectionPoolTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    async_executor_ = std::make_shared<MockAsyncExecutor>();
+    // Grows from 2 up to 3 connections while every connection has a stream in
+    // flight, and closes the extra connection as soon as it is idle.
+    connection_pool_ = std::make_shared<MockHttpConnectionPool>(
+        async_executor_, nullptr, /*max_connection_per_host=*/2,
+        /*max_elastic_connections_per_host=*/3,
+        /*connection_growth_streams=*/1,
+        /*idle_connection_timeout_in_sec=*/0);
+    connection_pool_->create_connection_override_ =
+        [async_executor = async_executor_](std::string host,
+                                           std::string service, bool is_https) {
+          std::shared_ptr<HttpConnection> connection =
+              std::make_shared<FakeHttpConnection>(async_executor, host,
+                                                   service, is_https, nullptr);
+          return connection;
+        };
+
+    EXPECT_SUCCESS(connection_pool_->Init());
+    EXPECT_SUCCESS(connection_pool_->Run());
+  }
+
+  void TearDown() override { EXPECT_SUCCESS(connection_pool_->Stop()); }
+
+  std::vector<std::shared_ptr<HttpConnection>> GetConnections() {
+    return connection_pool_->GetConnectionsMap()["www.google.com:80"];
+  }
+
+  std::shared_ptr<AsyncExecutorInterface> async_executor_;
+  std::shared_ptr<MockHttpConnectionPool> connection_pool_;
+  std::shared_ptr<Uri> uri_ =
+      std::make_shared<Uri>("https://www.google.com:80");
+};
+
+TEST_F(ElasticHttpConnectionPoolTest,
+       GetConnectionReturnsTheConnectionWithTheFewestStreams) {
+  std::shared_ptr<HttpConnection> connection;
+  ASSERT_SUCCESS(connection_pool_->GetConnection(uri_, connection));
+  auto connections = GetConnections();
+  ASSERT_EQ(connections.size(), 2);
+
+  AsFake(connections[0])->SetStreams(5);
+  AsFake(connections[1])->SetStreams(0);
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_SUCCESS(connection_pool_->GetConnection(uri_, connection));
+    EXPECT_EQ(connection, connections[1]);
+  }
+
+  // A connection which is not ready is skipped however few streams it has.
+  AsFake(connections[1])->SetIsNotReady();
+  ASSERT_SUCCESS(connection_pool_->GetConnection(uri_, connection));
+  EXPECT_EQ(connection, connections[0]);
+  // The pool does not grow while a connection is not ready.
+  EXPECT_EQ(GetConnections().size(), 2);
+}
+
+TEST_F(ElasticHttpConnectionPoolTest, GetConnectionGrowsAndShrinksThePool) {
+  std::shared_ptr<HttpConnection> connection;
+  ASSERT_SUCCESS(connection_pool_->GetConnection(uri_, connection));
+  auto connections = GetConnections();
+  ASSERT_EQ(connections.size(), 2);
+
+  AsFake(connections[0])->SetStreams(1);
+  AsFake(connections[1])->SetStreams(1);
+  ASSERT_SUCCESS(connection_pool_->GetConnection(uri_, connection));
+  connections = GetConnections();
+  ASSERT_EQ(connections.size(), 3);
+
+  // The new connection is the least loaded.
+  ASSERT_SUCCESS(connection_pool_->GetConnection(uri_, connection));
+  EXPECT_EQ(connection, connections[2]);
+
+  // The pool does not grow beyond its max.
+  AsFake(connections[2])->SetStreams(1);
+  ASSERT_SUCCESS(connection_pool_->GetConnection(uri_, connection));
+  EXPECT_EQ(GetConnections().size(), 3);
+
+  // Once idle, the extra connection is closed, the others are kept.
+  for (auto& connection : connections) {
+    AsFake(connection)->SetStreams(0);
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+  ASSERT_SUCCESS(connection_pool_->GetConnection(uri_, connection));
+  EXPECT_NE(connection, connections[2]);
+  EXPECT_EQ(GetConnections().size(), 2);
+  EXPECT_FALSE(connections[2]->IsReady());
+  EXPECT_TRUE(connections[0]->IsReady());
+  EXPECT_TRUE(connections[1]->IsReady());
+}
+
+TEST_F(ElasticHttpConnectionPoolTest, GetConnectionGrowsThePoolAsynchronously) {
+  std::shared_ptr<HttpConnection> connection;
+  ASSERT_SUCCESS(connection_pool_->GetConnection(uri_, connection));
+  auto connections = GetConnections();
+  ASSERT_EQ(connections.size(), 2);
+
+  std::vector<AsyncOperation> scheduled_work;
+  std::static_pointer_cast<MockAsyncExecutor>(async_executor_)->schedule_mock =
+      [&](const AsyncOperation& work) {
+        scheduled_work.push_back(work);
+        return SuccessExecutionResult();
+      };
+  AsFake(connections[0])->SetStreams(1);
+  AsFake(connections[1])->SetStreams(1);
+  ASSERT_SUCCESS(connection_pool_->GetConnection(uri_, connection));
+  EXPECT_EQ(GetConnections().size(), 2);
+  // A single connection is added however many requests find the pool loaded.
+  ASSERT_SUCCESS(connection_pool_->GetConnection(uri_, connection));
+  ASSERT_EQ(scheduled_work.size(), 1);
+
+  scheduled_work[0]();
+  EXPECT_EQ(GetConnections().size(), 3);
+}
+
+TEST_F(ElasticHttpConnectionPoolTest, StopWaitsForTheTaskGrowingThePool) {
+  std::shared_ptr<HttpConnection> connection;
+  ASSERT_SUCCESS(connection_pool_->GetConnection(uri_, connection));
+  auto connections = GetConnections();
+  ASSERT_EQ(connections.size(), 2);
+
+  std::vector<AsyncOperation> scheduled_work;
+  std::static_pointer_cast<MockAsyncExecutor>(async_executor_)->schedule_mock =
+      [&](const AsyncOperation& work) {
+        scheduled_work.push_back(work);
+        return SuccessExecutionResult();
+      };
+  AsFake(connections[0])->SetStreams(1);
+  AsFake(connections[1])->SetStreams(1);
+  ASSERT_SUCCESS(connection_pool_->GetConnection(uri_, connection));
+  ASSERT_EQ(scheduled_work.size(), 1);
+
+  std::atomic<bool> stopped = false;
+  std::thread stopper([&]() {
+    EXPECT_SUCCESS(connection_pool_->Stop());
+    stopped = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_FALSE(stopped);
+
+  // The task no longer adds a connection once run, and Stop returns once the
+  // task is destroyed.
+  scheduled_work[0]();
+  EXPECT_FALSE(stopped);
+  scheduled_work.clear();
+  stopper.join();
+  EXPECT_TRUE(stopped);
+  EXPECT_EQ(GetConnections().size(), 2);
+}
 }  // namespace
 }  // namespace privacy_sandbox::pbs_common
@@ -33,6 +33,8 @@
 #include "cc/core/telemetry/mock/in_memory_metric_router.h"
 #include "cc/core/telemetry/src/common/metric_utils.h"
 #include "cc/core/test/utils/conditional_wait.h"
+#include "cc/core/utils/src/compression.h"
+#include "cc/core/utils/src/error_codes.h"
 #include "cc/public/core/interface/execution_result.h"
 #include "cc/public/core/test/interface/execution_result_matchers.h"
 #include "opentelemetry/sdk/resource/semantic_conventions.h"
@@ -307,6 +309,70 @@ TEST_F(HttpConnectionTest, SuccessfulImmediateResponse) {
   EXPECT_THAT(keys, IsEmpty());
 }
 
+TEST_F(HttpConnectionTest, GzipResponseBodyIsDecompressed) {
+  std::string body(10000, 'a');
+  std::string compressed;
+  ASSERT_SUCCESS(GzipCompress(body, compressed));
+  server_.handle(/*pattern=*/"/gzip",
+                 [&](const nghttp2::asio_http2::server::request& req,
+                     const nghttp2::asio_http2::server::response& res) {
+                   res.write_head(200, {{kContentEncodingHeader,
+                                         {kGzipContentEncoding, false}}});
+                   res.end(compressed);
+                 });
+  server_.handle(/*pattern=*/"/truncated_gzip",
+                 [&](const nghttp2::asio_http2::server::request& req,
+                     const nghttp2::asio_http2::server::response& res) {
+                   res.write_head(200, {{kContentEncodingHeader,
+                                         {kGzipContentEncoding, false}}});
+                   res.end(compressed.substr(0, compressed.size() / 2));
+                 });
+
+  auto async_executor =
+      std::make_shared<AsyncExecutor>(/*thread_count=*/2, /*queue_cap=*/20);
+  MockHttpConnection connection(async_executor, /*host=*/"localhost",
+                                std::to_string(server_.ports()[0]),
+                                /*is_https=*/false, metric_router_.get());
+
+  ASSERT_TRUE(connection.Init());
+  ASSERT_TRUE(connection.Run());
+  ASSERT_SUCCESS(WaitUntilOrReturn([&]() { return connection.IsReady(); }))
+      << "Connection is not ready within the expected time.";
+
+  absl::BlockingCounter counter(2);
+  AsyncContext<HttpRequest, HttpResponse> http_context;
+  http_context.request = std::make_shared<HttpRequest>();
+  http_context.request->path =
+      std::make_shared<std::string>("http://localhost/gzip");
+  http_context.request->method = HttpMethod::GET;
+  http_context.callback =
+      [&](AsyncContext<HttpRequest, HttpResponse>& context) {
+        EXPECT_SUCCESS(context.result);
+        EXPECT_EQ(context.response->body.ToString(), body);
+        EXPECT_FALSE(
+            context.response->headers->contains(kContentEncodingHeader));
+        counter.DecrementCount();
+      };
+  EXPECT_SUCCESS(connection.Execute(http_context));
+
+  AsyncContext<HttpRequest, HttpResponse> truncated_http_context;
+  truncated_http_context.request = std::make_shared<HttpRequest>();
+  truncated_http_context.request->path =
+      std::make_shared<std::string>("http://localhost/truncated_gzip");
+  truncated_http_context.request->method = HttpMethod::GET;
+  truncated_http_context.callback =
+      [&](AsyncContext<HttpRequest, HttpResponse>& context) {
+        EXPECT_THAT(context.result,
+                    ResultIs(FailureExecutionResult(
+                        SC_CORE_UTILS_INVALID_COMPRESSED_DATA)));
+        counter.DecrementCount();
+      };
+  EXPECT_SUCCESS(connection.Execute(truncated_http_context));
+
+  counter.Wait();
+  connection.Stop();
+}
+
 TEST_F(HttpConnectionTest, UnsupportedHttpMethod) {
   auto async_executor =
       std::make_shared<AsyncExecutor>(/*thread_count=*/2, /*queue_cap=*/20);
@@ -0,0 +1,47 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cc/core/http2_client/src/http_hedging.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+namespace privacy_sandbox::pbs_common {
+namespace {
+
+TEST(HttpLatencyTrackerTest, IsUnknownUntilEnoughLatenciesAreRecorded) {
+  HttpLatencyTracker tracker(0.5, 8);
+  tracker.Record(std::chrono::milliseconds(10));
+  EXPECT_EQ(tracker.GetPercentile().count(), 0);
+  tracker.Record(std::chrono::milliseconds(10));
+  EXPECT_EQ(tracker.GetPercentile(), std::chrono::milliseconds(10));
+}
+
+TEST(HttpLatencyTrackerTest, TracksThePercentileOfTheRecentLatencies) {
+  HttpLatencyTracker tracker(0.9, 200);
+  for (int i = 1; i <= 200; ++i) {
+    tracker.Record(std::chrono::milliseconds(i));
+  }
+  EXPECT_EQ(tracker.GetPercentile(), std::chrono::milliseconds(180));
+
+  // The older latencies leave the window.
+  for (int i = 0; i < 200; ++i) {
+    tracker.Record(std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(tracker.GetPercentile(), std::chrono::milliseconds(1));
+}
+
+}  // namespace
+}  // namespace privacy_sandbox::pbs_common
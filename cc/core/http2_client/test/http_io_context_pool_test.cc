@@ -0,0 +1,89 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cc/core/http2_client/src/http_io_context_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <set>
+#include <stdexcept>
+#include <thread>
+
+#include <boost/asio/post.hpp>
+
+#include "cc/core/http2_client/src/error_codes.h"
+#include "cc/core/test/utils/conditional_wait.h"
+#include "cc/public/core/test/interface/execution_result_matchers.h"
+
+namespace privacy_sandbox::pbs_common {
+namespace {
+
+TEST(HttpIoContextPoolTest, InitFailsWithoutIoContexts) {
+  HttpIoContextPool pool(0);
+  EXPECT_THAT(pool.Init(), ResultIs(FailureExecutionResult(
+                               SC_HTTP2_CLIENT_INVALID_IO_CONTEXT_POOL_SIZE)));
+}
+
+TEST(HttpIoContextPoolTest, HandsOutIoContextsInRoundRobin) {
+  HttpIoContextPool pool(3);
+  EXPECT_EQ(pool.Size(), 3);
+
+  std::set<boost::asio::io_context*> io_contexts;
+  for (int i = 0; i < 3; ++i) {
+    io_contexts.insert(&pool.GetNextIoContext());
+  }
+  EXPECT_EQ(io_contexts.size(), 3);
+  EXPECT_EQ(io_contexts.count(&pool.GetNextIoContext()), 1);
+}
+
+TEST(HttpIoContextPoolTest, RunsTheHandlersOfEachIoContextOnOneThread) {
+  HttpIoContextPool pool(2);
+  EXPECT_SUCCESS(pool.Init());
+  EXPECT_SUCCESS(pool.Run());
+
+  auto& io_context = pool.GetNextIoContext();
+  std::atomic<std::thread::id> first_thread_id;
+  std::atomic<int> completed = 0;
+  for (int i = 0; i < 100; ++i) {
+    boost::asio::post(io_context, [&]() {
+      std::thread::id no_thread_id;
+      first_thread_id.compare_exchange_strong(no_thread_id,
+                                              std::this_thread::get_id());
+      EXPECT_EQ(first_thread_id.load(), std::this_thread::get_id());
+      completed++;
+    });
+  }
+  WaitUntil([&]() { return completed.load() == 100; });
+  EXPECT_NE(first_thread_id.load(), std::this_thread::get_id());
+
+  EXPECT_SUCCESS(pool.Stop());
+}
+
+TEST(HttpIoContextPoolTest, KeepsRunningWhenAHandlerThrows) {
+  HttpIoContextPool pool(1);
+  EXPECT_SUCCESS(pool.Init());
+  EXPECT_SUCCESS(pool.Run());
+
+  std::atomic<bool> ran = false;
+  auto& io_context = pool.GetNextIoContext();
+  boost::asio::post(io_context, []() { throw std::runtime_error("error"); });
+  boost::asio::post(io_context, [&]() { ran = true; });
+  WaitUntil([&]() { return ran.load(); });
+
+  EXPECT_SUCCESS(pool.Stop());
+}
+
+}  // namespace
+}  // namespace privacy_sandbox::pbs_common
@@ -16,7 +16,12 @@
 
 #pragma once
 
+#include <memory>
+#include <string_view>
+#include <utility>
+
 #include "cc/core/http2_server/src/http2_request.h"
+#include "cc/core/http2_server/src/http2_router.h"
 
 namespace privacy_sandbox::pbs_common {
 
@@ -85,6 +90,48 @@ class MockNgHttp2RequestWithOverrides : public NgHttp2Request {
                                                    on_request_body_received_);
   }
 
+  /**
+   * @brief Streams the expected request body to the consumer instead of
+   * buffering it.
+   *
+   * @param body_consumer
+   * @param max_request_body_size
+   */
+  ExecutionResult StreamRequestBody(
+      std::shared_ptr<HttpRequestBodyConsumerInterface> body_consumer,
+      size_t max_request_body_size = kDefaultMaxRequestBodySize) {
+    SetContentLength(expected_request_body_length_to_receive_);
+    return PrepareRequestBody(max_request_body_size, std::move(body_consumer));
+  }
+
+  /**
+   * @brief Prepares a gzip encoded body of the given compressed length,
+   * buffered or streamed to the consumer.
+   *
+   * @param compressed_length
+   * @param max_request_body_size
+   * @param body_consumer
+   */
+  ExecutionResult PrepareGzipRequestBody(
+      size_t compressed_length,
+      size_t max_request_body_size = kDefaultMaxRequestBodySize,
+      std::shared_ptr<HttpRequestBodyConsumerInterface> body_consumer =
+          nullptr) {
+    SetContentLength(compressed_length);
+    is_body_gzip_encoded_ = true;
+    return PrepareRequestBody(max_request_body_size, std::move(body_consumer));
+  }
+
+  /**
+   * @brief Sets what UnwrapNgHttp2Request reads from the Accept-Encoding
+   * header of the request.
+   *
+   * @param accept_encoding
+   */
+  void SimulateAcceptEncoding(std::string_view accept_encoding) {
+    is_gzip_response_accepted_ = IsGzipAccepted(accept_encoding);
+  }
+
   /**
    * @brief Set the callback to be invoked when data receiving is complete.
    *
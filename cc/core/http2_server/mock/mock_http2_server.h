@@ -37,5 +37,12 @@ class MockHttp2Server : public HttpServerInterface {
       HttpHandler& handler) noexcept override {
     return SuccessExecutionResult();
   }
+
+  ExecutionResult RegisterStreamingResourceHandler(
+      HttpMethod http_method, std::string& resource_path,
+      HttpStreamingHandler& handler,
+      size_t max_request_body_size) noexcept override {
+    return SuccessExecutionResult();
+  }
 };
 }  // namespace privacy_sandbox::pbs_common
@@ -31,11 +31,12 @@ class MockHttp2ServerWithOverrides : public Http2Server {
       std::shared_ptr<AuthorizationProxyInterface> authorization_proxy,
       std::shared_ptr<AuthorizationProxyInterface> aws_authorization_proxy,
       const std::shared_ptr<ConfigProviderInterface>& config_provider = nullptr,
-      MetricRouter* metric_router = nullptr)
+      MetricRouter* metric_router = nullptr,
+      Http2ServerOptions options = Http2ServerOptions())
       : Http2Server(host_address, port, 2 /* thread_pool_size */,
                     async_executor, authorization_proxy,
-                    aws_authorization_proxy, config_provider,
-                    Http2ServerOptions(), metric_router) {}
+                    aws_authorization_proxy, config_provider, options,
+                    metric_router) {}
 
   void OnHttp2Response(
       AsyncContext<NgHttp2Request, NgHttp2Response>& http_context,
@@ -49,43 +50,44 @@ class MockHttp2ServerWithOverrides : public Http2Server {
   void OnAuthorizationCallback(
       AsyncContext<AuthorizationProxyRequest, AuthorizationProxyResponse>&
           authorization_context,
-      Uuid& request_id,
       const std::shared_ptr<Http2SynchronizationContext>& sync_context) noexcept
       override {
-    Http2Server::OnAuthorizationCallback(authorization_context, request_id,
-                                         sync_context);
+    Http2Server::OnAuthorizationCallback(authorization_context, sync_context);
   }
 
   void HandleHttp2Request(
       AsyncContext<NgHttp2Request, NgHttp2Response>& http2_context,
-      HttpHandler& http_handler) noexcept override {
+      HttpHandler& http_handler,
+      const std::shared_ptr<Http2SynchronizationContext>& sync_context) noexcept
+      override {
     if (handle_http2_request_mock_) {
       return handle_http2_request_mock_(http2_context, http_handler);
     }
-    return Http2Server::HandleHttp2Request(http2_context, http_handler);
+    return Http2Server::HandleHttp2Request(http2_context, http_handler,
+                                           sync_context);
   }
 
-  void OnHttp2PendingCallback(ExecutionResult execution_result,
-                              const Uuid& request_id) noexcept override {
-    Http2Server::OnHttp2PendingCallback(execution_result, request_id);
+  void OnHttp2PendingCallback(
+      ExecutionResult execution_result,
+      const std::shared_ptr<Http2SynchronizationContext>& sync_context) noexcept
+      override {
+    Http2Server::OnHttp2PendingCallback(execution_result, sync_context);
   }
 
-  void OnHttp2Cleanup(const Http2SynchronizationContext& sync_context,
+  void CompressResponseBody(
+      AsyncContext<NgHttp2Request, NgHttp2Response>& http_context) noexcept
+      override {
+    Http2Server::CompressResponseBody(http_context);
+  }
+
+  void OnHttp2Cleanup(Http2SynchronizationContext& sync_context,
                       uint32_t error_code) noexcept override {
     Http2Server::OnHttp2Cleanup(sync_context, error_code);
   }
 
-  ConcurrentMap<std::string,
-                std::shared_ptr<ConcurrentMap<HttpMethod, HttpHandler>>>&
-  GetRegisteredResourceHandlers() {
-    return resource_handlers_;
-  }
+  const Http2Router& GetRouter() { return router_; }
 
-  ConcurrentMap<Uuid, std::shared_ptr<Http2SynchronizationContext>,
-                UuidCompare>&
-  GetActiveRequests() {
-    return active_requests_;
-  }
+  int64_t GetActiveRequestsCount() { return active_requests_count_.load(); }
 
   std::function<void(AsyncContext<NgHttp2Request, NgHttp2Response>&,
                      HttpHandler& http_handler)>
@@ -65,4 +65,31 @@ DEFINE_ERROR_CODE(SC_HTTP2_SERVER_FAILED_TO_RESOLVE_ROUTE, SC_HTTP2_SERVER,
 DEFINE_ERROR_CODE(SC_HTTP2_SERVER_FAILED_TO_ROUTE, SC_HTTP2_SERVER, 0x000B,
                   "Http2Server failed to route the request.",
                   HttpStatusCode::INTERNAL_SERVER_ERROR)
+
+DEFINE_ERROR_CODE(SC_HTTP2_SERVER_REQUEST_BODY_TOO_LARGE, SC_HTTP2_SERVER,
+                  0x000C,
+                  "Http2Server request body exceeds the limit of the route.",
+                  HttpStatusCode::REQUEST_ENTITY_TOO_LARGE)
+
+DEFINE_ERROR_CODE(SC_HTTP2_SERVER_ROUTE_NOT_FOUND, SC_HTTP2_SERVER, 0x000D,
+                  "Http2Server has no handler for the request path.",
+                  HttpStatusCode::NOT_FOUND)
+
+DEFINE_ERROR_CODE(SC_HTTP2_SERVER_HANDLER_ALREADY_REGISTERED, SC_HTTP2_SERVER,
+                  0x000E,
+                  "Http2Server already has a handler for the path and method.",
+                  HttpStatusCode::BAD_REQUEST)
+
+DEFINE_ERROR_CODE(SC_HTTP2_SERVER_UNSUPPORTED_CONTENT_ENCODING, SC_HTTP2_SERVER,
+                  0x000F,
+                  "Http2Server does not support the request content encoding.",
+                  HttpStatusCode::UNSUPPORTED_MEDIA_TYPE)
+
+DEFINE_ERROR_CODE(SC_HTTP2_SERVER_OVERLOADED, SC_HTTP2_SERVER, 0x0010,
+                  "Http2Server has too many requests in flight.",
+                  HttpStatusCode::SERVICE_UNAVAILABLE)
+
+DEFINE_ERROR_CODE(SC_HTTP2_SERVER_ROUTE_OVERLOADED, SC_HTTP2_SERVER, 0x0011,
+                  "Http2Server has too many requests in flight on the route.",
+                  HttpStatusCode::TOO_MANY_REQUESTS)
 }  // namespace privacy_sandbox::pbs_common
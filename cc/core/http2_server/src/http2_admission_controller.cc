@@ -0,0 +1,98 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cc/core/http2_server/src/http2_admission_controller.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace privacy_sandbox::pbs_common {
+
+Http2AdmissionController::Http2AdmissionController(
+    Http2AdmissionControllerOptions options)
+    : options_(options),
+      limit_(options.max_concurrent_requests),
+      in_flight_(0),
+      next_decrease_nanos_(0) {}
+
+bool Http2AdmissionController::TryAdmit() noexcept {
+  if (!IsEnabled()) {
+    return true;
+  }
+
+  if (in_flight_.fetch_add(1) >= limit_.load()) {
+    in_flight_.fetch_sub(1);
+    return false;
+  }
+  return true;
+}
+
+void Http2AdmissionController::Release(
+    std::chrono::steady_clock::duration latency) noexcept {
+  if (!IsEnabled()) {
+    return;
+  }
+
+  auto in_flight = in_flight_.fetch_sub(1);
+  if (options_.adaptive) {
+    Adapt(latency, in_flight);
+  }
+}
+
+void Http2AdmissionController::Cancel() noexcept {
+  if (IsEnabled()) {
+    in_flight_.fetch_sub(1);
+  }
+}
+
+void Http2AdmissionController::Adapt(
+    std::chrono::steady_clock::duration latency, size_t in_flight) noexcept {
+  auto limit = limit_.load();
+  if (latency <= options_.latency_threshold) {
+    // Only grow a limit which is actually used, otherwise it grows unbounded
+    // during quiet periods and protects nothing when load returns.
+    while (in_flight * 2 >= limit && limit < options_.max_concurrent_requests &&
+           !limit_.compare_exchange_weak(limit, limit + 1)) {
+    }
+    return;
+  }
+
+  // The requests in flight when the limit decreased complete slowly too, and
+  // must not decrease it again.
+  int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch())
+                    .count();
+  int64_t next_decrease = next_decrease_nanos_.load();
+  if (now < next_decrease ||
+      !next_decrease_nanos_.compare_exchange_strong(
+          next_decrease,
+          now + std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    options_.latency_threshold)
+                    .count())) {
+    return;
+  }
+
+  size_t decreased_limit;
+  do {
+    decreased_limit = std::max<size_t>(
+        {1, options_.min_concurrent_requests,
+         static_cast<size_t>(static_cast<double>(limit) *
+                             options_.backoff_ratio)});
+  } while (decreased_limit < limit &&
+           !limit_.compare_exchange_weak(limit, decreased_limit));
+}
+
+}  // namespace privacy_sandbox::pbs_common
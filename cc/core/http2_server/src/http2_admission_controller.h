@@ -0,0 +1,99 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace privacy_sandbox::pbs_common {
+
+/// Options of Http2AdmissionController.
+struct Http2AdmissionControllerOptions {
+  /// Upper bound of the requests in flight. Every request is admitted when 0.
+  size_t max_concurrent_requests = 0;
+  /// Whether the limit adapts to the observed latency, between
+  /// min_concurrent_requests and max_concurrent_requests.
+  bool adaptive = false;
+  /// Lower bound of the adaptive limit.
+  size_t min_concurrent_requests = 1;
+  /// Requests slower than this decrease the adaptive limit.
+  std::chrono::milliseconds latency_threshold = std::chrono::milliseconds(500);
+  /// Factor the adaptive limit is multiplied with when it decreases.
+  double backoff_ratio = 0.9;
+};
+
+/**
+ * @brief Caps the number of requests in flight, so that the requests exceeding
+ * the capacity of the server are rejected right away rather than queued until
+ * they time out.
+ *
+ * The limit is either fixed, or adapted with AIMD (additive increase,
+ * multiplicative decrease) to the latency of the completed requests: it grows
+ * by one for each fast request completing while the limit is at least half
+ * used, and shrinks by backoff_ratio when requests are slower than the
+ * latency threshold, at most once per threshold period.
+ *
+ * Admission and release are lock free and can be called from any thread.
+ */
+class Http2AdmissionController {
+ public:
+  explicit Http2AdmissionController(Http2AdmissionControllerOptions options);
+
+  /// Whether the controller limits anything.
+  bool IsEnabled() const noexcept {
+    return options_.max_concurrent_requests > 0;
+  }
+
+  /**
+   * @brief Admits a request if the limit allows it. Every admitted request
+   * must be released.
+   *
+   * @return true if the request is admitted.
+   */
+  bool TryAdmit() noexcept;
+
+  /**
+   * @brief Releases an admitted request.
+   *
+   * @param latency The time the request took, which adapts the limit.
+   */
+  void Release(std::chrono::steady_clock::duration latency) noexcept;
+
+  /// Releases an admitted request which did not run, leaving the limit as is.
+  void Cancel() noexcept;
+
+  /// The current limit of requests in flight.
+  size_t GetLimit() const noexcept { return limit_.load(); }
+
+  /// The number of requests in flight.
+  size_t GetInFlight() const noexcept { return in_flight_.load(); }
+
+ private:
+  /// Adapts the limit to the latency of a released request.
+  void Adapt(std::chrono::steady_clock::duration latency,
+             size_t in_flight) noexcept;
+
+  const Http2AdmissionControllerOptions options_;
+  std::atomic<size_t> limit_;
+  std::atomic<size_t> in_flight_;
+  /// Steady clock nanoseconds before which the limit is not decreased again.
+  std::atomic<int64_t> next_decrease_nanos_;
+};
+
+}  // namespace privacy_sandbox::pbs_common
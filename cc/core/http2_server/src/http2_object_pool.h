@@ -0,0 +1,170 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace privacy_sandbox::pbs_common {
+
+/// Default number of objects each thread keeps around for reuse.
+inline constexpr size_t kDefaultHttp2ObjectPoolCapacity = 256;
+
+/**
+ * @brief A pool of per-stream objects local to the calling thread, i.e. to the
+ * nghttp2 io thread the stream is handled on, so acquiring involves no locking.
+ *
+ * Objects are handed out as regular std::shared_ptr whose deleter returns them
+ * to the pool of the thread which acquired them, from whichever thread drops
+ * the last reference, which means their allocation, and the capacity of their
+ * members, are reused across streams. A returned object is cleared with
+ * T::Release(), if T has one, and reinitialized once recycled with T::Reset()
+ * taking the same arguments as the constructor of T.
+ *
+ * Returned objects are pushed on a lock-free stack, which the owning thread
+ * takes as a whole once it has no free object left, so that neither acquiring
+ * nor returning scans the pool.
+ *
+ * @tparam T The pooled type.
+ * @tparam kCapacity Upper bound of objects kept by each thread. Objects
+ * acquired once the pool is full and all its objects are in use are not
+ * pooled.
+ */
+template <typename T, size_t kCapacity = kDefaultHttp2ObjectPoolCapacity>
+class Http2ObjectPool {
+ public:
+  template <typename... Args>
+  static std::shared_ptr<T> Acquire(Args&&... args) {
+    Pool& pool = GetPool();
+    if (pool.free_nodes.empty()) {
+      pool.ReclaimReturnedNodes();
+    }
+
+    Node* node;
+    if (!pool.free_nodes.empty()) {
+      node = pool.free_nodes.back();
+      pool.free_nodes.pop_back();
+      node->value.Reset(std::forward<Args>(args)...);
+    } else {
+      node = new Node(std::forward<Args>(args)...);
+      if (pool.size < kCapacity) {
+        node->pooled = true;
+        pool.size++;
+      }
+    }
+    return std::shared_ptr<T>(&node->value,
+                              NodeReturner{node, pool.returned_nodes});
+  }
+
+  /// Number of objects pooled by the calling thread, in use or not.
+  static size_t Size() { return GetPool().size; }
+
+ private:
+  struct Node {
+    template <typename... Args>
+    explicit Node(Args&&... args) : value(std::forward<Args>(args)...) {}
+
+    T value;
+    /// Whether the node goes back to its pool once returned.
+    bool pooled = false;
+    /// The next node of the stack of returned nodes.
+    Node* next = nullptr;
+  };
+
+  /// The nodes returned to a pool, possibly by other threads. It is shared
+  /// with the acquired objects, so that the nodes returned once the thread of
+  /// the pool exited are deleted along with it.
+  class ReturnedNodes {
+   public:
+    ~ReturnedNodes() { DeleteAll(TakeAll()); }
+
+    void Push(Node* node) {
+      Node* head = head_.load(std::memory_order_relaxed);
+      do {
+        node->next = head;
+      } while (!head_.compare_exchange_weak(head, node,
+                                            std::memory_order_release,
+                                            std::memory_order_relaxed));
+    }
+
+    /// Takes all the nodes returned so far, as a list linked by Node::next.
+    Node* TakeAll() {
+      // Pairs with the return of the nodes, which may have happened on
+      // another thread.
+      return head_.exchange(nullptr, std::memory_order_acquire);
+    }
+
+    static void DeleteAll(Node* node) {
+      while (node != nullptr) {
+        delete std::exchange(node, node->next);
+      }
+    }
+
+   private:
+    std::atomic<Node*> head_ = nullptr;
+  };
+
+  /// The deleter of the acquired objects.
+  struct NodeReturner {
+    void operator()(T*) const {
+      if constexpr (requires(T& value) { value.Release(); }) {
+        node->value.Release();
+      }
+      if (node->pooled) {
+        returned_nodes->Push(node);
+      } else {
+        delete node;
+      }
+    }
+
+    Node* node;
+    std::shared_ptr<ReturnedNodes> returned_nodes;
+  };
+
+  struct Pool {
+    ~Pool() {
+      for (Node* node : free_nodes) {
+        delete node;
+      }
+      ReturnedNodes::DeleteAll(returned_nodes->TakeAll());
+    }
+
+    void ReclaimReturnedNodes() {
+      for (Node* node = returned_nodes->TakeAll(); node != nullptr;
+           node = node->next) {
+        free_nodes.push_back(node);
+      }
+    }
+
+    /// Nodes ready to be recycled.
+    std::vector<Node*> free_nodes;
+    std::shared_ptr<ReturnedNodes> returned_nodes =
+        std::make_shared<ReturnedNodes>();
+    /// Number of pooled nodes, in use or not.
+    size_t size = 0;
+  };
+
+  static Pool& GetPool() {
+    static thread_local Pool pool;
+    return pool;
+  }
+};
+
+}  // namespace privacy_sandbox::pbs_common
@@ -18,19 +18,61 @@
 
 #include <algorithm>
 #include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
+#include "absl/strings/match.h"
 #include "cc/core/http2_server/src/http2_utils.h"
 #include "cc/public/core/interface/execution_result.h"
 
 namespace privacy_sandbox::pbs_common {
 
-static constexpr size_t kMaxRequestBodySize = 1 * 1024 * 1024 * 1024;  // 100MB
+// Larger body buffers are not kept around by recycled requests.
+static constexpr size_t kMaxRecycledBodyCapacity = 64 * 1024;
+
+void NgHttp2Request::Reset(
+    const nghttp2::asio_http2::server::request& ng2_request) noexcept {
+  ng2_request_ = &ng2_request;
+  id = Uuid::GenerateUuid();
+  Release();
+}
+
+void NgHttp2Request::Release() noexcept {
+  handler_path.clear();
+  method = HttpMethod::UNKNOWN;
+  path.reset();
+  query.reset();
+  auth_context.authorized_domain.reset();
+  metric_labels.clear();
+  metric_attributes.clear();
+  // Headers are only copied on demand, see CopyHeaders.
+  headers.reset();
+  indexed_headers_.fill(std::nullopt);
+  are_headers_indexed_ = false;
+  // The body may still be referenced by whoever handled the previous request,
+  // in which case it is left to them.
+  if (body.bytes && body.bytes.use_count() == 1 &&
+      body.bytes->capacity() <= kMaxRecycledBodyCapacity) {
+    body.bytes->clear();
+  } else {
+    body.bytes.reset();
+  }
+  body.length = 0;
+  body.capacity = 0;
+  content_length_ = 0;
+  is_body_gzip_encoded_ = false;
+  is_gzip_response_accepted_ = false;
+  body_consumer_.reset();
+  streamed_body_length_ = 0;
+  received_body_length_ = 0;
+  is_body_done_ = false;
+}
 
 ExecutionResult NgHttp2Request::ReadUri() noexcept {
-  handler_path = ng2_request_.uri().path;
+  handler_path = ng2_request_->uri().path;
   // We should also fill NgHttp2Request::query here from
   // ng2_request_.uri().raw_query
   return SuccessExecutionResult();
@@ -38,11 +80,11 @@ ExecutionResult NgHttp2Request::ReadUri() noexcept {
 
 ExecutionResult NgHttp2Request::ReadMethod() noexcept {
   // Parse the method
-  if (ng2_request_.method() == "GET") {
+  if (ng2_request_->method() == "GET") {
     method = HttpMethod::GET;
     return SuccessExecutionResult();
   }
-  if (ng2_request_.method() == "POST") {
+  if (ng2_request_->method() == "POST") {
     method = HttpMethod::POST;
     return SuccessExecutionResult();
   }
@@ -52,22 +94,111 @@ ExecutionResult NgHttp2Request::ReadMethod() noexcept {
 }
 
 ExecutionResult NgHttp2Request::ReadHeaders() noexcept {
-  headers = std::make_shared<HttpHeaders>();
-  for (const auto& header : ng2_request_.header()) {
-    headers->insert({header.first, header.second.value});
+  headers.reset();
+  indexed_headers_.fill(std::nullopt);
+  for (const auto& [name, value] : ng2_request_->header()) {
+    for (size_t i = 0; i < kIndexedHeaders.size(); ++i) {
+      if (!indexed_headers_[i] &&
+          absl::EqualsIgnoreCase(name, kIndexedHeaders[i])) {
+        indexed_headers_[i] = value.value;
+        break;
+      }
+    }
   }
+  are_headers_indexed_ = true;
   return SuccessExecutionResult();
 }
 
+std::optional<std::string_view> NgHttp2Request::FindHeader(
+    std::string_view name) const noexcept {
+  if (headers) {
+    for (const auto& [header_name, value] : *headers) {
+      if (absl::EqualsIgnoreCase(header_name, name)) {
+        return value;
+      }
+    }
+    return std::nullopt;
+  }
+  if (!are_headers_indexed_) {
+    return std::nullopt;
+  }
+  for (size_t i = 0; i < kIndexedHeaders.size(); ++i) {
+    if (absl::EqualsIgnoreCase(name, kIndexedHeaders[i])) {
+      return indexed_headers_[i];
+    }
+  }
+  for (const auto& [header_name, value] : ng2_request_->header()) {
+    if (absl::EqualsIgnoreCase(header_name, name)) {
+      return value.value;
+    }
+  }
+  return std::nullopt;
+}
+
+void NgHttp2Request::CopyHeaders() noexcept {
+  if (headers || !are_headers_indexed_) {
+    return;
+  }
+  headers = std::make_shared<HttpHeaders>();
+  for (const auto& [name, value] : ng2_request_->header()) {
+    // Handlers only ever see the decoded body.
+    if (name != kContentEncodingHeader) {
+      headers->emplace(name, value.value);
+    }
+  }
+}
+
 void NgHttp2Request::OnRequestBodyDataChunkReceived(
     const uint8_t* data, std::size_t length,
     const RequestBodyDataReceivedCallback& callback) noexcept {
+  if (is_body_done_) {
+    return;
+  }
+  if (body_consumer_ || is_body_gzip_encoded_) {
+    if (length == 0) {
+      auto execution_result = SuccessExecutionResult();
+      if (received_body_length_ < content_length_) {
+        execution_result =
+            FailureExecutionResult(SC_HTTP2_SERVER_PARTIAL_REQUEST_BODY);
+      } else if (is_body_gzip_encoded_ && received_body_length_ > 0) {
+        // Catches gzip streams truncated by the client.
+        execution_result = body_decompressor_->Finish();
+      }
+      is_body_done_ = true;
+      callback(execution_result);
+      return;
+    }
+    // More data than announced. Avoiding overflow here.
+    if (length > content_length_ ||
+        received_body_length_ > content_length_ - length) {
+      is_body_done_ = true;
+      callback(FailureExecutionResult(SC_HTTP2_SERVER_PARTIAL_REQUEST_BODY));
+      return;
+    }
+    received_body_length_ += length;
+    std::string_view chunk(reinterpret_cast<const char*>(data), length);
+    auto execution_result =
+        is_body_gzip_encoded_
+            ? body_decompressor_->Decompress(
+                  chunk,
+                  [this](std::string_view decompressed) {
+                    return ConsumeBodyChunk(decompressed);
+                  })
+            : ConsumeBodyChunk(chunk);
+    if (!execution_result.Successful()) {
+      is_body_done_ = true;
+      callback(execution_result);
+    }
+    return;
+  }
+
   if (length == 0) {
     auto execution_result = SuccessExecutionResult();
     if (body.length < body.capacity) {
       execution_result =
           FailureExecutionResult(SC_HTTP2_SERVER_PARTIAL_REQUEST_BODY);
     }
+    is_body_done_ = true;
     callback(execution_result);
     return;
   }
@@ -75,6 +206,7 @@ void NgHttp2Request::OnRequestBodyDataChunkReceived(
   if (length > body.capacity || body.length > body.capacity - length) {
     auto execution_result =
         FailureExecutionResult(SC_HTTP2_SERVER_PARTIAL_REQUEST_BODY);
+    is_body_done_ = true;
     callback(execution_result);
     return;
   }
@@ -83,6 +215,19 @@ void NgHttp2Request::OnRequestBodyDataChunkReceived(
   body.length += length;
 }
 
+ExecutionResult NgHttp2Request::ConsumeBodyChunk(
+    std::string_view chunk) noexcept {
+  if (body_consumer_) {
+    streamed_body_length_ += chunk.size();
+    return body_consumer_->OnBodyChunk(chunk);
+  }
+  // The decompressed size is unknown up front, so the buffer grows with it.
+  body.bytes->insert(body.bytes->end(), chunk.begin(), chunk.end());
+  body.length += chunk.size();
+  body.capacity = body.bytes->size();
+  return SuccessExecutionResult();
+}
+
 ExecutionResult NgHttp2Request::UnwrapNgHttp2Request() noexcept {
   auto execution_result = ReadUri();
   if (!execution_result.Successful()) {
@@ -99,26 +244,72 @@ ExecutionResult NgHttp2Request::UnwrapNgHttp2Request() noexcept {
     return execution_result;
   }
 
-  size_t content_length = 0;
+  content_length_ = 0;
   if (method != HttpMethod::GET) {
-    execution_result = Http2Utils::ParseContentLength(headers, content_length);
+    execution_result = Http2Utils::ParseContentLength(
+        FindHeader("content-length"), content_length_);
     if (!execution_result.Successful()) {
       return execution_result;
     }
+  }
+
+  is_body_gzip_encoded_ = false;
+  auto content_encoding = FindHeader(kContentEncodingHeader);
+  if (content_encoding) {
+    if (absl::EqualsIgnoreCase(*content_encoding, kGzipContentEncoding)) {
+      is_body_gzip_encoded_ = true;
+    } else if (!absl::EqualsIgnoreCase(*content_encoding, "identity")) {
+      return FailureExecutionResult(
+          SC_HTTP2_SERVER_UNSUPPORTED_CONTENT_ENCODING);
+    }
+  }
+
+  auto accept_encoding = FindHeader(kAcceptEncodingHeader);
+  is_gzip_response_accepted_ =
+      accept_encoding && IsGzipAccepted(*accept_encoding);
+  return SuccessExecutionResult();
+}
+
+ExecutionResult NgHttp2Request::PrepareRequestBody(
+    size_t max_request_body_size,
+    std::shared_ptr<HttpRequestBodyConsumerInterface> body_consumer) noexcept {
+  if (content_length_ > max_request_body_size) {
+    return FailureExecutionResult(SC_HTTP2_SERVER_REQUEST_BODY_TOO_LARGE);
+  }
 
-    if (content_length > kMaxRequestBodySize) {
-      return FailureExecutionResult(SC_HTTP2_SERVER_INVALID_HEADER);
+  body_consumer_ = std::move(body_consumer);
+  streamed_body_length_ = 0;
+  received_body_length_ = 0;
+  is_body_done_ = false;
+  if (is_body_gzip_encoded_) {
+    if (body_decompressor_) {
+      body_decompressor_->Reset(max_request_body_size);
+    } else {
+      body_decompressor_ =
+          std::make_unique<GzipDecompressor>(max_request_body_size);
     }
   }
-  body.bytes = std::make_shared<std::vector<Byte>>(content_length);
+  // A streamed body is never buffered and a compressed one is buffered as it
+  // is decompressed, so only an empty buffer is kept for them.
+  size_t buffered_length =
+      body_consumer_ || is_body_gzip_encoded_ ? 0 : content_length_;
+  if (body.bytes && body.bytes.use_count() == 1) {
+    body.bytes->assign(buffered_length, 0);
+  } else {
+    body.bytes = std::make_shared<std::vector<Byte>>(buffered_length);
+  }
   body.length = 0;
-  body.capacity = content_length;
+  body.capacity = buffered_length;
   return SuccessExecutionResult();
 }
 
+size_t NgHttp2Request::GetReceivedBodyLength() const noexcept {
+  return body_consumer_ ? streamed_body_length_ : body.length;
+}
+
 void NgHttp2Request::SetOnRequestBodyDataReceivedCallback(
     const RequestBodyDataReceivedCallback& callback) {
-  ng2_request_.on_data(
+  ng2_request_->on_data(
       std::bind(&NgHttp2Request::OnRequestBodyDataChunkReceived, this,
                 std::placeholders::_1, std::placeholders::_2, callback));
 }
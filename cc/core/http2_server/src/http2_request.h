@@ -16,13 +16,23 @@
 
 #pragma once
 
+#include <array>
 #include <functional>
+#include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
 
 #include <nghttp2/asio_http2_server.h>
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
 #include "cc/core/common/uuid/src/uuid.h"
+#include "cc/core/interface/http_server_interface.h"
 #include "cc/core/interface/http_types.h"
+#include "cc/core/interface/type_def.h"
+#include "cc/core/telemetry/src/metric/metric_attributes.h"
+#include "cc/core/utils/src/compression.h"
 
 namespace privacy_sandbox::pbs_common {
 
@@ -33,24 +43,104 @@ class NgHttp2Request : public HttpRequest {
  public:
   explicit NgHttp2Request(
       const nghttp2::asio_http2::server::request& ng2_request)
-      : id(Uuid::GenerateUuid()), ng2_request_(ng2_request) {}
+      : id(Uuid::GenerateUuid()), ng2_request_(&ng2_request) {}
 
   using RequestBodyDataReceivedCallback = std::function<void(ExecutionResult)>;
 
   /**
-   * @brief Unwraps the ngHttp2 request and update the current object.
+   * @brief Rebinds a recycled object to the request of another stream. The
+   * request gets a new id and the state of the previous request is cleared,
+   * keeping the allocations which are not shared with anyone else.
    *
-   * @return ExecutionResult The execution result of the operation.
+   * @param ng2_request The nghttp2 request of the new stream.
+   */
+  void Reset(const nghttp2::asio_http2::server::request& ng2_request) noexcept;
+
+  /**
+   * @brief Clears the state of the request once its stream is closed, so that
+   * a recycled object waiting in its pool does not keep the headers or the
+   * body of the request alive. Only a small body buffer is kept for reuse.
+   */
+  void Release() noexcept;
+
+  /**
+   * @brief Unwraps the ngHttp2 request and update the current object. The
+   * body is set up separately with PrepareRequestBody once the route of the
+   * request is known.
+   *
+   * A gzip Content-Encoding is consumed here: the header is removed and the
+   * body is decompressed as it is received.
+   *
+   * @return ExecutionResult SC_HTTP2_SERVER_UNSUPPORTED_CONTENT_ENCODING if the
+   * body is encoded with anything but gzip.
    */
   ExecutionResult UnwrapNgHttp2Request() noexcept;
 
+  /**
+   * @brief Sets up how the request body is received. Without a body consumer
+   * the body is buffered into body, otherwise each chunk is handed to the
+   * consumer as it arrives and body stays empty.
+   *
+   * @param max_request_body_size The body size limit of the route. It bounds
+   * both the received and, for gzip bodies, the decompressed size.
+   * @param body_consumer The consumer of a streamed body, if any.
+   * @return ExecutionResult SC_HTTP2_SERVER_REQUEST_BODY_TOO_LARGE if the
+   * content length exceeds the limit.
+   */
+  ExecutionResult PrepareRequestBody(
+      size_t max_request_body_size,
+      std::shared_ptr<HttpRequestBodyConsumerInterface> body_consumer =
+          nullptr) noexcept;
+
+  /// Number of body bytes received so far, buffered or streamed, after
+  /// decompression.
+  size_t GetReceivedBodyLength() const noexcept;
+
+  /// Whether the client accepts a gzip response body. It is read when the
+  /// request is unwrapped, so it can be used past the nghttp2 io thread.
+  bool IsGzipResponseAccepted() const noexcept {
+    return is_gzip_response_accepted_;
+  }
+
+  /**
+   * @brief Finds a request header, matching its name case insensitively,
+   * without copying it. The headers the server reads itself are found in
+   * constant time.
+   *
+   * Until CopyHeaders() is called, the value points into the nghttp2 stream
+   * and must only be used on its io thread, while the stream is open.
+   *
+   * @param name The header name.
+   * @return std::optional<std::string_view> The value of the first header with
+   * this name, if any.
+   */
+  std::optional<std::string_view> FindHeader(
+      std::string_view name) const noexcept;
+
+  /**
+   * @brief Copies the request headers into headers, for the handlers to use
+   * past the nghttp2 io thread. Does nothing if they are already copied. The
+   * Content-Encoding header, which is consumed by the server, is left out.
+   */
+  void CopyHeaders() noexcept;
+
   /// Path of the handler in the URI.
   /// Example: https://www.foo.com/handler/path, '/handler/path' is the
   /// handler_path.
   std::string handler_path;
 
   /// The auto-generated id of the request.
-  const Uuid id;
+  Uuid id;
+
+  /// OpenTelemetry attributes of the server metrics of the request. They are
+  /// built once, by the first metric recorded for the request.
+  absl::flat_hash_map<absl::string_view, std::string> metric_labels;
+
+  /// The attribute sets of metric_labels, by metric name. Each is looked up
+  /// once per metric and cleared whenever metric_labels changes.
+  absl::flat_hash_map<absl::string_view,
+                      std::shared_ptr<const MetricAttributes>>
+      metric_attributes;
 
   /**
    * @brief Set callback to be invoked when the request body is completely
@@ -78,14 +168,16 @@ class NgHttp2Request : public HttpRequest {
   ExecutionResult ReadMethod() noexcept;
 
   /**
-   * @brief Reads the http headers from the ngHttp2Request object.
+   * @brief Indexes the http headers of the ngHttp2Request object the server
+   * reads itself. Nothing is copied, see CopyHeaders.
    *
    * @return ExecutionResult The execution result of the operation.
    */
   ExecutionResult ReadHeaders() noexcept;
 
   /**
-   * @brief Is called when there is a body on the request.
+   * @brief Is called when there is a body on the request. The callback is
+   * invoked once, when the body is complete or as soon as receiving it fails.
    *
    * @param bytes The bytes received.
    * @param length The length of the bytes received.
@@ -96,9 +188,66 @@ class NgHttp2Request : public HttpRequest {
       const uint8_t* bytes, std::size_t length,
       const RequestBodyDataReceivedCallback& callback) noexcept;
 
+  /**
+   * @brief Overrides the content length read from the request headers.
+   *
+   * @param content_length The length of the body on the wire.
+   */
+  void SetContentLength(size_t content_length) noexcept {
+    content_length_ = content_length;
+  }
+
+  /// Whether the body is gzip encoded.
+  bool is_body_gzip_encoded_ = false;
+
+  /// Whether the Accept-Encoding header of the request allows gzip.
+  bool is_gzip_response_accepted_ = false;
+
  private:
-  /// A ref to the original ng2_request.
-  const nghttp2::asio_http2::server::request& ng2_request_;
+  /**
+   * @brief Buffers or streams a chunk of the decoded body of a streamed or
+   * compressed request.
+   *
+   * @param chunk The decoded chunk.
+   * @return ExecutionResult The result of the body consumer, if any.
+   */
+  ExecutionResult ConsumeBodyChunk(std::string_view chunk) noexcept;
+
+  /// The original ng2_request, owned by nghttp2 for the stream lifetime.
+  const nghttp2::asio_http2::server::request* ng2_request_;
+
+  /// The content length of the request.
+  size_t content_length_ = 0;
+
+  /// The headers the server reads for every request, looked up once when the
+  /// request is unwrapped.
+  static constexpr std::array<std::string_view, 6> kIndexedHeaders = {
+      kAuthHeader,           kClaimedIdentityHeader, "content-length",
+      kContentEncodingHeader, kAcceptEncodingHeader,  kUserAgentHeader,
+  };
+
+  /// The values of kIndexedHeaders, pointing into ng2_request_.
+  std::array<std::optional<std::string_view>, kIndexedHeaders.size()>
+      indexed_headers_;
+
+  /// Whether the headers of ng2_request_ have been indexed by ReadHeaders.
+  bool are_headers_indexed_ = false;
+
+  /// The consumer of the body when it is streamed.
+  std::shared_ptr<HttpRequestBodyConsumerInterface> body_consumer_;
+
+  /// Number of bytes handed to the body consumer.
+  size_t streamed_body_length_ = 0;
+
+  /// Number of bytes received on the wire when the body is streamed or
+  /// compressed.
+  size_t received_body_length_ = 0;
+
+  /// The decompressor of gzip bodies, kept by recycled requests.
+  std::unique_ptr<GzipDecompressor> body_decompressor_;
+
+  /// Whether the body data callback has been invoked.
+  bool is_body_done_ = false;
 };
 
 }  // namespace privacy_sandbox::pbs_common
@@ -23,6 +23,26 @@ namespace privacy_sandbox::pbs_common {
 using nghttp2::asio_http2::header_map;
 using nghttp2::asio_http2::header_value;
 
+void NgHttp2Response::Reset(
+    const nghttp2::asio_http2::server::response& ng2_response) noexcept {
+  std::unique_lock lock(on_close_mutex_);
+  ng2_response_ = &ng2_response;
+  is_closed_ = false;
+  code = HttpStatusCode::UNKNOWN;
+  Release();
+}
+
+void NgHttp2Response::Release() noexcept {
+  // The headers may still be referenced by whoever handled the previous
+  // request, in which case they are left to them.
+  if (headers && headers.use_count() == 1) {
+    headers->clear();
+  } else {
+    headers = std::make_shared<HttpHeaders>();
+  }
+  body.Reset();
+}
+
 void NgHttp2Response::OnClose(OnCloseErrorCode close_error_code,
                               OnCloseCallback callback) noexcept {
   // While Onclose is running, ensure that there is no concurrent
@@ -35,7 +55,7 @@ void NgHttp2Response::OnClose(OnCloseErrorCode close_error_code,
 }
 
 void NgHttp2Response::SetOnCloseCallback(const OnCloseCallback& callback) {
-  ng2_response_.on_close(std::bind(&NgHttp2Response::OnClose, this,
+  ng2_response_->on_close(std::bind(&NgHttp2Response::OnClose, this,
                                    std::placeholders::_1, callback));
 }
 
@@ -54,11 +74,11 @@ void NgHttp2Response::Send() noexcept {
     response_headers.insert({header, ng_header_val});
   }
   try {
-    ng2_response_.write_head(static_cast<int>(code), response_headers);
+    ng2_response_->write_head(static_cast<int>(code), response_headers);
     if (body.length > 0) {
-      ng2_response_.end(body.ToString());
+      ng2_response_->end(body.ToString());
     } else {
-      ng2_response_.end("");
+      ng2_response_->end("");
     }
   } catch (const boost::exception& ex) {
     // TODO: handle this
@@ -77,6 +97,6 @@ void NgHttp2Response::SubmitWorkOnIoService(
   if (is_closed_) {
     return;
   }
-  ng2_response_.io_service().post(work);
+  ng2_response_->io_service().post(work);
 }
 }  // namespace privacy_sandbox::pbs_common
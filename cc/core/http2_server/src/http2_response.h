@@ -34,7 +34,23 @@ class NgHttp2Response : public HttpResponse {
  public:
   explicit NgHttp2Response(
       const nghttp2::asio_http2::server::response& ng2_response)
-      : ng2_response_(ng2_response), is_closed_(false) {}
+      : ng2_response_(&ng2_response), is_closed_(false) {}
+
+  /**
+   * @brief Rebinds a recycled object to the response of another stream,
+   * clearing the state of the previous response.
+   *
+   * @param ng2_response The nghttp2 response of the new stream.
+   */
+  void Reset(
+      const nghttp2::asio_http2::server::response& ng2_response) noexcept;
+
+  /**
+   * @brief Clears the headers and the body of the response once its stream is
+   * closed, so that a recycled object waiting in its pool does not keep them
+   * alive.
+   */
+  void Release() noexcept;
 
   /**
    * @brief Callback for connection closing.
@@ -76,8 +92,8 @@ class NgHttp2Response : public HttpResponse {
    */
   void OnClose(uint32_t error_code, OnCloseCallback callback) noexcept;
 
-  /// A reference to the ng2 response object.
-  const nghttp2::asio_http2::server::response& ng2_response_;
+  /// The ng2 response object, owned by nghttp2 for the stream lifetime.
+  const nghttp2::asio_http2::server::response* ng2_response_;
 
   /// Indicates whether the response stream is closed.
   bool is_closed_;
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cc/core/http2_server/src/http2_router.h"
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "cc/core/http2_server/src/error_codes.h"
+
+namespace privacy_sandbox::pbs_common {
+
+ExecutionResult Http2Router::AddRoute(
+    HttpMethod method, std::string_view path,
+    Http2ResourceHandler resource_handler) noexcept {
+  auto method_index = static_cast<size_t>(method);
+  if (method_index >= kRoutableMethods) {
+    return FailureExecutionResult(SC_HTTP2_SERVER_INVALID_METHOD);
+  }
+
+  auto route = routes_.begin() + (LowerBound(path) - routes_.cbegin());
+  if (route == routes_.end() || route->path != path) {
+    route = routes_.insert(route, Route{std::string(path), {}});
+  }
+  auto& handler = route->handlers[method_index];
+  if (handler.has_value()) {
+    return FailureExecutionResult(SC_HTTP2_SERVER_HANDLER_ALREADY_REGISTERED);
+  }
+  handler = std::move(resource_handler);
+  return SuccessExecutionResult();
+}
+
+ExecutionResultOr<const Http2ResourceHandler*> Http2Router::Find(
+    std::string_view path, HttpMethod method) const noexcept {
+  auto route = LowerBound(path);
+  if (route == routes_.end() || route->path != path) {
+    return FailureExecutionResult(SC_HTTP2_SERVER_ROUTE_NOT_FOUND);
+  }
+  auto method_index = static_cast<size_t>(method);
+  if (method_index >= kRoutableMethods ||
+      !route->handlers[method_index].has_value()) {
+    return FailureExecutionResult(SC_HTTP2_SERVER_INVALID_METHOD);
+  }
+  return &*route->handlers[method_index];
+}
+
+std::vector<std::string> Http2Router::GetPaths() const {
+  std::vector<std::string> paths;
+  paths.reserve(routes_.size());
+  for (const auto& route : routes_) {
+    paths.push_back(route.path);
+  }
+  return paths;
+}
+
+std::vector<Http2Router::Route>::const_iterator Http2Router::LowerBound(
+    std::string_view path) const noexcept {
+  return std::lower_bound(
+      routes_.begin(), routes_.end(), path,
+      [](const Route& route, std::string_view path) {
+        return std::string_view(route.path) < path;
+      });
+}
+
+}  // namespace privacy_sandbox::pbs_common
@@ -0,0 +1,102 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "cc/core/http2_server/src/http2_admission_controller.h"
+#include "cc/core/interface/http_server_interface.h"
+#include "cc/core/interface/http_types.h"
+#include "cc/public/core/interface/execution_result.h"
+
+namespace privacy_sandbox::pbs_common {
+
+/// Body size limit of routes registered without an explicit one.
+inline constexpr size_t kDefaultMaxRequestBodySize = 1024 * 1024 * 1024;
+
+/// The handler registered for a path and method. Exactly one of handler and
+/// streaming_handler is set.
+struct Http2ResourceHandler {
+  /// Handles requests once their body is buffered.
+  HttpHandler handler;
+  /// Creates the consumer of the streamed body of requests.
+  HttpStreamingHandler streaming_handler;
+  /// Requests whose body is larger are rejected.
+  size_t max_request_body_size = kDefaultMaxRequestBodySize;
+  /// Caps the requests in flight on the route. Not set if unlimited.
+  std::shared_ptr<Http2AdmissionController> admission_controller;
+};
+
+/**
+ * @brief The routing table of Http2Server.
+ *
+ * Routes are kept sorted by path, each with a handler slot per routable
+ * method, so a lookup is a binary search over string_views followed by an
+ * array access: it neither locks nor allocates. Routes are only added while
+ * the server is not running; afterwards the table is immutable and shared by
+ * all io threads.
+ */
+class Http2Router {
+ public:
+  /**
+   * @brief Adds the handler of a path and method.
+   *
+   * @return ExecutionResult SC_HTTP2_SERVER_HANDLER_ALREADY_REGISTERED if the
+   * path and method already have a handler, SC_HTTP2_SERVER_INVALID_METHOD if
+   * the method cannot be routed.
+   */
+  ExecutionResult AddRoute(HttpMethod method, std::string_view path,
+                           Http2ResourceHandler resource_handler) noexcept;
+
+  /**
+   * @brief Finds the handler of a path and method.
+   *
+   * @return The handler, SC_HTTP2_SERVER_ROUTE_NOT_FOUND if no handler is
+   * registered for the path, or SC_HTTP2_SERVER_INVALID_METHOD if the path has
+   * no handler for the method.
+   */
+  ExecutionResultOr<const Http2ResourceHandler*> Find(
+      std::string_view path, HttpMethod method) const noexcept;
+
+  /// The registered paths, in order.
+  std::vector<std::string> GetPaths() const;
+
+ private:
+  /// GET, POST and PUT, the methods whose value can index a handler slot.
+  static constexpr size_t kRoutableMethods = 3;
+
+  struct Route {
+    std::string path;
+    std::array<std::optional<Http2ResourceHandler>, kRoutableMethods>
+        handlers;
+  };
+
+  /// Returns the first route whose path is not less than the given one.
+  std::vector<Route>::const_iterator LowerBound(
+      std::string_view path) const noexcept;
+
+  /// Routes sorted by path.
+  std::vector<Route> routes_;
+};
+
+}  // namespace privacy_sandbox::pbs_common
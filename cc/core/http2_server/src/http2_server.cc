@@ -16,23 +16,30 @@
 
 #include "cc/core/http2_server/src/http2_server.h"
 
+#include <algorithm>
 #include <chrono>
 #include <memory>
 #include <set>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
+#include <boost/asio/post.hpp>
 #include <nghttp2/asio_http2_server.h>
+#include <nghttp2/asio_http2_server_connection_limits.h>
 #include <nlohmann/json.hpp>
 
-#include "cc/core/common/concurrent_map/src/error_codes.h"
+#include "absl/strings/match.h"
+#include "cc/core/async_executor/src/async_executor_utils.h"
 #include "cc/core/common/uuid/src/uuid.h"
 #include "cc/core/http2_server/src/error_codes.h"
 #include "cc/core/interface/configuration_keys.h"
 #include "cc/core/interface/errors.h"
 #include "cc/core/utils/src/base64.h"
+#include "cc/core/utils/src/compression.h"
 #include "cc/core/utils/src/http.h"
+#include "cc/core/utils/src/tls_session.h"
 #include "cc/public/core/interface/execution_result.h"
 #include "opentelemetry/sdk/resource/semantic_conventions.h"
 
@@ -43,9 +50,13 @@ namespace {
 using ::boost::asio::ssl::context;
 using ::boost::system::error_code;
 using ::boost::system::errc::success;
+using ::nghttp2::asio_http2::server::clear_connection_limits;
 using ::nghttp2::asio_http2::server::configure_tls_context_easy;
+using ::nghttp2::asio_http2::server::connection_limits;
+using ::nghttp2::asio_http2::server::connection_watch_interval;
 using ::nghttp2::asio_http2::server::request;
 using ::nghttp2::asio_http2::server::response;
+using ::nghttp2::asio_http2::server::set_connection_limits;
 using ::opentelemetry::sdk::resource::SemanticConventions::kHttpRequestMethod;
 using ::opentelemetry::sdk::resource::SemanticConventions::
     kHttpResponseStatusCode;
@@ -55,6 +66,17 @@ using ::opentelemetry::sdk::resource::SemanticConventions::kServerPort;
 
 static constexpr char kHttp2Server[] = "Http2Server";
 static constexpr size_t kConnectionReadTimeoutInSeconds = 90;
+// The GOAWAY of a drained connection is sent in two steps by the connection
+// watch: a shutdown notice at its next tick, then the final GOAWAY at the tick
+// after. The margin covers the tick running late and the write of the frame.
+static constexpr std::chrono::milliseconds kGoAwayDuration =
+    2 * connection_watch_interval + std::chrono::milliseconds(500);
+static constexpr std::chrono::milliseconds kDrainPollInterval =
+    std::chrono::milliseconds(10);
+static constexpr char kRetryAfterHeader[] = "retry-after";
+// Failed responses are counted by the request metrics, by status code, so the
+// logs only need a sample of them.
+static constexpr size_t kMaxErrorResponseLogsPerSecond = 10;
 
 static const std::set<HttpStatusCode> kHttpStatusCode4xxMap = {
     HttpStatusCode::BAD_REQUEST,
@@ -87,6 +109,16 @@ static const std::set<HttpStatusCode> kHttpStatusCode5xxMap = {
 // authenticate requests that come from AWS PBS to GCP PBS via DNS.
 bool UseAwsAuthorizationProxy(
     const AuthorizationMetadata& authorization_metadata) {
+  static constexpr absl::string_view kAmzDate = "amz_date";
+  // AWS tokens are base64 encoded JSON objects. GCP tokens are JWTs, whose
+  // parts are separated by dots which base64 never produces, so they are
+  // told apart without decoding.
+  const std::string& encoded_token = authorization_metadata.authorization_token;
+  if (encoded_token.empty() ||
+      encoded_token.find('.') != std::string::npos) {
+    return false;
+  }
+
   ExecutionResultOr<std::string> padded_token =
       PadBase64Encoding(authorization_metadata.authorization_token);
   if (!padded_token.Successful()) {
@@ -98,67 +130,19 @@ bool UseAwsAuthorizationProxy(
       !execution_result.Successful()) {
     return false;
   }
+  // Only parse tokens which may contain the field.
+  if (!absl::StrContains(token, kAmzDate)) {
+    return false;
+  }
   nlohmann::json json_token;
   try {
     json_token = nlohmann::json::parse(token);
   } catch (...) {
     return false;
   }
-  static constexpr absl::string_view kAmzDate = "amz_date";
   return json_token.contains(kAmzDate);
 }
 
-/*
- * @brief Sets up the synchronization context by retrieving it from the active
- * requests map (or creating if it doesn't exist). It assigns the handler,
- * context, and necessary callbacks for managing the HTTP2 request.
- *
- * @param http2_context The async context for the HTTP2 request and response.
- * @param http_handler The HTTP handler function to process requests.
- * @param active_requests A concurrent map containing active requests, mapped by
- * UUID.
- * @param sync_context A shared pointer to the synchronization context for the
- * HTTP2 request.
- *
- * @return ExecutionResult indicating success or failure of setting up the sync
- * context.
- */
-ExecutionResult SetSyncContext(
-    const AsyncContext<NgHttp2Request, NgHttp2Response>& http2_context,
-    const HttpHandler& http_handler,
-    ConcurrentMap<Uuid,
-                  std::shared_ptr<Http2Server::Http2SynchronizationContext>,
-                  UuidCompare>& active_requests,
-    std::shared_ptr<Http2Server::Http2SynchronizationContext>& sync_context) {
-  ExecutionResult execution_result;
-
-  execution_result =
-      active_requests.Find(http2_context.request->id, sync_context);
-  if (!execution_result.Successful()) {
-    SCP_DEBUG_CONTEXT(kHttp2Server, http2_context,
-                      "[HandleHttp2Request] Cannot find the sync context in "
-                      "the active requests map! Creating new sync context and "
-                      "adding to the active requests map!");
-
-    sync_context = std::make_shared<Http2Server::Http2SynchronizationContext>();
-
-    auto context_pair = std::make_pair(http2_context.request->id, sync_context);
-    execution_result = active_requests.Insert(context_pair, sync_context);
-    if (!execution_result.Successful()) {
-      SCP_ERROR_CONTEXT(kHttp2Server, http2_context, execution_result,
-                        "[HandleHttp2Request] Cannot insert the sync context "
-                        "to the active requests map!");
-      return execution_result;
-    }
-  }
-
-  sync_context->pending_callbacks = 2;  // 1 for authorization, 1 for body data.
-  sync_context->http2_context = http2_context;
-  sync_context->http_handler = http_handler;
-  sync_context->failed = false;
-
-  return SuccessExecutionResult();
-}
 }  // namespace
 
 Http2Server::~Http2Server() {
@@ -236,6 +220,17 @@ ExecutionResult Http2Server::OtelMetricInit() noexcept {
                     kByteUnit);
               }));
 
+  server_rejected_requests_ =
+      std::static_pointer_cast<opentelemetry::metrics::Counter<uint64_t>>(
+          metric_router_->GetOrCreateSyncInstrument(
+              kServerRejectedRequestsMetric,
+              [&]() -> std::shared_ptr<
+                        opentelemetry::metrics::SynchronousInstrument> {
+                return meter_->CreateUInt64Counter(
+                    kServerRejectedRequestsMetric,
+                    "Number of requests rejected by admission control.");
+              }));
+
   return SuccessExecutionResult();
 }
 
@@ -264,6 +259,17 @@ ExecutionResult Http2Server::Init() noexcept {
                     nghttp2_error_code.value()));
       return execution_result;
     }
+
+    if (tls_session_ticket_key_rotation_seconds_ > 0) {
+      auto execution_result = EnableTlsSessionTickets(
+          tls_context_.native_handle(),
+          std::chrono::seconds(tls_session_ticket_key_rotation_seconds_));
+      if (!execution_result.Successful()) {
+        SCP_ERROR(kHttp2Server, kZeroUuid, execution_result,
+                  "Failed to enable TLS session tickets.");
+        return execution_result;
+      }
+    }
   }
 
   // Otel metrics setup.
@@ -278,42 +284,91 @@ ExecutionResult Http2Server::Run() noexcept {
   }
 
   is_running_ = true;
+  http2_servers_.clear();
+  listener_request_counts_.clear();
 
-  std::vector<std::string> paths;
-  auto execution_result = resource_handlers_.Keys(paths);
-  if (!execution_result.Successful()) {
-    return execution_result;
+  if (reuse_port_listeners_ <= 1) {
+    return StartListener(port_, thread_pool_size_);
   }
 
-  for (const auto& path : paths) {
-    // TODO: here we are binding a universal handler, and the real
-    // handler is looked up again inside it. Ideally, we can do the look up
-    // here, and pass the result to std::bind(), to save runtime cost.
-    http2_server_.handle(
-        path, std::bind(&Http2Server::OnHttp2Request, this,
-                        std::placeholders::_1, std::placeholders::_2));
+  // The first listener resolves the port, which may have been picked by the OS,
+  // and the other listeners join it.
+  std::string port = port_;
+  // hardware_concurrency may return 0 when it cannot tell.
+  const size_t cpu_count = std::max(1u, std::thread::hardware_concurrency());
+  for (size_t i = 0; i < reuse_port_listeners_; ++i) {
+    RETURN_IF_FAILURE(
+        StartListener(port, 1 /* thread_count */, i % cpu_count));
+    port = std::to_string(http2_servers_[0]->ports()[0]);
+  }
+  return SuccessExecutionResult();
+}
+
+ExecutionResult Http2Server::StartListener(
+    const std::string& port, size_t thread_count,
+    std::optional<size_t> cpu_affinity) noexcept {
+  auto http2_server = std::make_unique<nghttp2::asio_http2::server::http2>();
+  auto request_count = std::make_unique<std::atomic<int64_t>>(0);
+
+  for (const auto& path : router_.GetPaths()) {
+    // The handler is looked up again in OnHttp2Request, which is a lock free
+    // binary search over the routes.
+    http2_server->handle(path, [this, request_count = request_count.get()](
+                                   const request& request,
+                                   const response& response) {
+      request_count->fetch_add(1, std::memory_order_relaxed);
+      OnHttp2Request(request, response);
+    });
   }
 
-  http2_server_.read_timeout(
+  http2_server->read_timeout(
       boost::posix_time::seconds(kConnectionReadTimeoutInSeconds));
-  http2_server_.num_threads(thread_pool_size_);
+  http2_server->num_threads(thread_count);
+  // Only the listeners of this server share the port. A single listener keeps
+  // it to itself, so that no other process can bind it too.
+  http2_server->reuse_port(reuse_port_listeners_ > 1);
 
   error_code nghttp2_error_code;
   error_code server_listen_and_serve_error_code;
   const bool asynchronous = true;
 
   if (use_tls_) {
-    server_listen_and_serve_error_code = http2_server_.listen_and_serve(
-        nghttp2_error_code, tls_context_, host_address_, port_, asynchronous);
+    server_listen_and_serve_error_code = http2_server->listen_and_serve(
+        nghttp2_error_code, tls_context_, host_address_, port, asynchronous);
   } else {
-    server_listen_and_serve_error_code = http2_server_.listen_and_serve(
-        nghttp2_error_code, host_address_, port_, asynchronous);
+    server_listen_and_serve_error_code = http2_server->listen_and_serve(
+        nghttp2_error_code, host_address_, port, asynchronous);
   }
 
+  // Added before checking the result so that Stop also joins the threads of a
+  // listener which failed to start.
+  http2_servers_.push_back(std::move(http2_server));
+  listener_request_counts_.push_back(std::move(request_count));
+
   if (server_listen_and_serve_error_code) {
     return FailureExecutionResult(SC_HTTP2_SERVER_INITIALIZATION_FAILED);
   }
 
+  // Connections accepted before the limits are set are not limited, which is
+  // harmless as the server just started accepting.
+  if (max_connection_age_seconds_ > 0 || max_connection_requests_ > 0 ||
+      drain_timeout_ms_ > 0) {
+    connection_limits limits;
+    limits.max_age = std::chrono::seconds(max_connection_age_seconds_);
+    limits.max_requests = max_connection_requests_;
+    for (auto& io_service : http2_servers_.back()->io_services()) {
+      set_connection_limits(*io_service, limits);
+    }
+  }
+
+  if (cpu_affinity.has_value()) {
+    for (auto& io_service : http2_servers_.back()->io_services()) {
+      boost::asio::post(*io_service, [cpu = *cpu_affinity]() {
+        AsyncExecutorUtils::SetAffinity(cpu);
+      });
+    }
+  }
+
   return SuccessExecutionResult();
 }
 
@@ -323,39 +378,105 @@ ExecutionResult Http2Server::Stop() noexcept {
   }
 
   is_running_ = false;
-  try {
-    http2_server_.stop();
-    for (auto& io_service : http2_server_.io_services()) {
-      io_service->stop();
+  if (drain_timeout_ms_ > 0) {
+    DrainConnections();
+  }
+
+  for (auto& http2_server : http2_servers_) {
+    try {
+      for (auto& io_service : http2_server->io_services()) {
+        clear_connection_limits(*io_service);
+      }
+      http2_server->stop();
+      for (auto& io_service : http2_server->io_services()) {
+        io_service->stop();
+      }
+      http2_server->join();
+    } catch (...) {
+      // Doing the best to stop, ignore otherwise.
     }
-    http2_server_.join();
-  } catch (...) {
-    // Doing the best to stop, ignore otherwise.
   }
 
   return SuccessExecutionResult();
 }
 
+void Http2Server::DrainConnections() noexcept {
+  // Stops accepting first, so that no connection opened during the drain
+  // misses the GOAWAY.
+  for (auto& http2_server : http2_servers_) {
+    try {
+      http2_server->stop_accepting();
+    } catch (...) {
+      // Doing the best to stop accepting, ignore otherwise.
+    }
+  }
+
+  connection_limits limits;
+  limits.drain = true;
+  for (auto& http2_server : http2_servers_) {
+    for (auto& io_service : http2_server->io_services()) {
+      set_connection_limits(*io_service, limits);
+    }
+  }
+
+  // Requests may still arrive until the final GOAWAY reached the clients.
+  auto now = std::chrono::steady_clock::now();
+  const auto goaway_deadline = now + kGoAwayDuration;
+  const auto drain_deadline =
+      now + std::chrono::milliseconds(drain_timeout_ms_);
+  while (now < drain_deadline &&
+         (now < goaway_deadline || active_requests_count_.load() > 0)) {
+    std::this_thread::sleep_for(kDrainPollInterval);
+    now = std::chrono::steady_clock::now();
+  }
+
+  if (active_requests_count_.load() > 0) {
+    SCP_WARNING(kHttp2Server, kZeroUuid,
+                absl::StrFormat("Drain timeout elapsed with %d requests in "
+                                "flight.",
+                                active_requests_count_.load()));
+  }
+}
+
+std::vector<int64_t> Http2Server::GetRequestCountPerListener() const noexcept {
+  std::vector<int64_t> request_counts;
+  request_counts.reserve(listener_request_counts_.size());
+  for (const auto& request_count : listener_request_counts_) {
+    request_counts.push_back(request_count->load(std::memory_order_relaxed));
+  }
+  return request_counts;
+}
+
 ExecutionResult Http2Server::RegisterResourceHandler(
     HttpMethod http_method, std::string& path, HttpHandler& handler) noexcept {
+  Http2ResourceHandler resource_handler;
+  resource_handler.handler = handler;
+  return RegisterHandler(http_method, path, std::move(resource_handler));
+}
+
+ExecutionResult Http2Server::RegisterStreamingResourceHandler(
+    HttpMethod http_method, std::string& path, HttpStreamingHandler& handler,
+    size_t max_request_body_size) noexcept {
+  Http2ResourceHandler resource_handler;
+  resource_handler.streaming_handler = handler;
+  resource_handler.max_request_body_size = max_request_body_size;
+  return RegisterHandler(http_method, path, std::move(resource_handler));
+}
+
+ExecutionResult Http2Server::RegisterHandler(
+    HttpMethod http_method, const std::string& path,
+    Http2ResourceHandler resource_handler) noexcept {
   if (is_running_) {
     return FailureExecutionResult(SC_HTTP2_SERVER_CANNOT_REGISTER_HANDLER);
   }
-  auto verb_to_handler_map =
-      std::make_shared<ConcurrentMap<HttpMethod, HttpHandler>>();
-  auto path_to_map_pair = std::make_pair(path, verb_to_handler_map);
-
-  auto execution_result =
-      resource_handlers_.Insert(path_to_map_pair, verb_to_handler_map);
-  if (!execution_result.Successful()) {
-    if (execution_result !=
-        FailureExecutionResult(SC_CONCURRENT_MAP_ENTRY_ALREADY_EXISTS)) {
-      return execution_result;
-    }
+  auto route_limit = route_max_concurrent_requests_.find(path);
+  if (route_limit != route_max_concurrent_requests_.end()) {
+    Http2AdmissionControllerOptions admission_control;
+    admission_control.max_concurrent_requests = route_limit->second;
+    resource_handler.admission_controller =
+        std::make_shared<Http2AdmissionController>(admission_control);
   }
-
-  auto verb_to_handler_pair = std::make_pair(http_method, handler);
-  return verb_to_handler_map->Insert(verb_to_handler_pair, handler);
+  return router_.AddRoute(http_method, path, std::move(resource_handler));
 }
 
 void Http2Server::OnHttp2Request(const request& request,
@@ -364,7 +485,10 @@ void Http2Server::OnHttp2Request(const request& request,
   std::chrono::time_point<std::chrono::steady_clock> entry_time =
       std::chrono::steady_clock::now();
   auto parent_activity_id = Uuid::GenerateUuid();
-  auto http2Request = std::make_shared<NgHttp2Request>(request);
+  auto sync_context =
+      Http2ObjectPool<Http2SynchronizationContext>::Acquire();
+  sync_context->entry_time = entry_time;
+  auto http2Request = Http2ObjectPool<NgHttp2Request>::Acquire(request);
   auto request_endpoint_type = RequestTargetEndpointType::Local;
 
   // This is the entry point of a Http2Request.
@@ -376,85 +500,152 @@ void Http2Server::OnHttp2Request(const request& request,
                 request_endpoint_type),
       parent_activity_id, http2Request->id);
 
-  http2_context.response = std::make_shared<NgHttp2Response>(response);
-  http2_context.response->headers = std::make_shared<HttpHeaders>();
-
-  auto sync_context = std::make_shared<Http2SynchronizationContext>();
-  sync_context->entry_time = entry_time;
-  auto context_pair = std::make_pair(http2Request->id, sync_context);
-  auto execution_result = active_requests_.Insert(context_pair, sync_context);
-  if (!execution_result.Successful()) {
-    SCP_ERROR_CONTEXT(kHttp2Server, http2_context, execution_result,
-                      "[OnHttp2Request] Cannot insert the sync context to "
-                      "the active requests map!");
-    FinishContext(execution_result, http2_context);
-    return;
+  http2_context.response = Http2ObjectPool<NgHttp2Response>::Acquire(response);
+  if (!http2_context.response->headers) {
+    http2_context.response->headers = std::make_shared<HttpHeaders>();
   }
 
   SCP_DEBUG_CONTEXT(kHttp2Server, http2_context, "Received a http2 request");
 
-  execution_result = http2_context.request->UnwrapNgHttp2Request();
+  auto execution_result = http2_context.request->UnwrapNgHttp2Request();
   if (!execution_result.Successful()) {
     http2_context.result = execution_result;
     http2_context.Finish();
     return;
   }
 
-  // Check if path is registered
-  std::shared_ptr<ConcurrentMap<HttpMethod, HttpHandler>> resource_handler;
-  execution_result = resource_handlers_.Find(
-      http2_context.request->handler_path, resource_handler);
-  if (!execution_result.Successful()) {
-    http2_context.result = execution_result;
+  // Find the handler of the path and method. Unknown paths and methods are
+  // rejected here, before anything is allocated for the request body.
+  auto resource_handler_or = router_.Find(http2_context.request->handler_path,
+                                          http2_context.request->method);
+  if (!resource_handler_or.Successful()) {
+    http2_context.result = resource_handler_or.result();
     http2_context.Finish();
     return;
   }
+  const Http2ResourceHandler& resource_handler = **resource_handler_or;
 
-  // Check if there is an active handler for the specific method.
-  HttpHandler http_handler;
-  execution_result =
-      resource_handler->Find(http2_context.request->method, http_handler);
+  // Requests over the limits are rejected before their body is read, so that
+  // an overloaded server spends as little as possible on them.
+  execution_result = AdmitHttp2Request(resource_handler);
   if (!execution_result.Successful()) {
+    RejectHttp2Request(http2_context, execution_result);
+    return;
+  }
+
+  // For streaming routes, the body consumer is created from the headers and
+  // completes the request once the body is received and authorized.
+  HttpHandler http_handler = resource_handler.handler;
+  std::shared_ptr<HttpRequestBodyConsumerInterface> body_consumer;
+  if (resource_handler.streaming_handler) {
+    http2_context.request->CopyHeaders();
+    auto body_consumer_or =
+        resource_handler.streaming_handler(*http2_context.request);
+    if (!body_consumer_or.Successful()) {
+      CancelHttp2RequestAdmission(resource_handler);
+      http2_context.result = body_consumer_or.result();
+      http2_context.Finish();
+      return;
+    }
+    body_consumer = std::move(body_consumer_or).value();
+    http_handler = [body_consumer](
+                       AsyncContext<HttpRequest, HttpResponse>& http_context) {
+      return body_consumer->OnBodyComplete(http_context);
+    };
+  }
+
+  execution_result = http2_context.request->PrepareRequestBody(
+      resource_handler.max_request_body_size, std::move(body_consumer));
+  if (!execution_result.Successful()) {
+    CancelHttp2RequestAdmission(resource_handler);
     http2_context.result = execution_result;
     http2_context.Finish();
     return;
   }
 
-  return HandleHttp2Request(http2_context, http_handler);
+  // Released when the stream closes, see OnHttp2Cleanup.
+  sync_context->route_admission_controller =
+      resource_handler.admission_controller;
+  return HandleHttp2Request(http2_context, http_handler, sync_context);
+}
+
+ExecutionResult Http2Server::AdmitHttp2Request(
+    const Http2ResourceHandler& resource_handler) noexcept {
+  if (!admission_controller_.TryAdmit()) {
+    return FailureExecutionResult(SC_HTTP2_SERVER_OVERLOADED);
+  }
+  if (resource_handler.admission_controller &&
+      !resource_handler.admission_controller->TryAdmit()) {
+    admission_controller_.Cancel();
+    return FailureExecutionResult(SC_HTTP2_SERVER_ROUTE_OVERLOADED);
+  }
+  return SuccessExecutionResult();
+}
+
+void Http2Server::CancelHttp2RequestAdmission(
+    const Http2ResourceHandler& resource_handler) noexcept {
+  admission_controller_.Cancel();
+  if (resource_handler.admission_controller) {
+    resource_handler.admission_controller->Cancel();
+  }
+}
+
+void Http2Server::RejectHttp2Request(
+    AsyncContext<NgHttp2Request, NgHttp2Response>& http2_context,
+    const ExecutionResult& result) noexcept {
+  http2_context.response->headers->insert(
+      {kRetryAfterHeader, rejected_request_retry_after_});
+  // Set ahead of OnHttp2Response, so that the rejection is recorded with the
+  // same attributes as the rest of the server metrics of the request.
+  http2_context.response->code = GetErrorHttpStatusCode(result.status_code);
+
+  if (server_rejected_requests_) {
+    GetOtelMetricLabels(http2_context);
+    http2_context.request->metric_labels.insert_or_assign(
+        kScpAdmissionLimitLabel,
+        result == FailureExecutionResult(SC_HTTP2_SERVER_OVERLOADED)
+            ? "server"
+            : "route");
+    http2_context.request->metric_attributes.clear();
+    server_rejected_requests_->Add(
+        1, GetOtelMetricAttributes(http2_context,
+                                   kServerRejectedRequestsMetric)
+               .Get());
+  }
+
+  http2_context.result = result;
+  http2_context.Finish();
 }
 
 void Http2Server::HandleHttp2Request(
     AsyncContext<NgHttp2Request, NgHttp2Response>& http2_context,
-    HttpHandler& http_handler) noexcept {
+    HttpHandler& http_handler,
+    const std::shared_ptr<Http2SynchronizationContext>& sync_context) noexcept {
   // We should not wait for the whole request body to be received since this
   // can be a source for attacks. What is done here is to validate the
   // authorization token in parallel. If the authorization fails, the response
   // will be sent immediately, if it is successful the flow will proceed.
-
-  std::shared_ptr<Http2SynchronizationContext> sync_context;
-  auto execution_result = SetSyncContext(http2_context, http_handler,
-                                         active_requests_, sync_context);
-  if (!execution_result.Successful()) {
-    FinishContext(execution_result, http2_context);
-    return;
-  }
+  sync_context->pending_callbacks = 2;  // 1 for authorization, 1 for body data.
+  // 1 for the stream close, 1 for the last pending callback.
+  sync_context->stream_state_users = 2;
+  sync_context->http2_context = http2_context;
+  sync_context->http_handler = http_handler;
+  sync_context->failed = false;
+  active_requests_count_.fetch_add(1);
 
   auto authorization_request = std::make_shared<AuthorizationProxyRequest>();
-  auto& headers = http2_context.request->headers;
-
-  if (headers) {
-    auto auth_headers_iter = headers->find(kAuthHeader);
-    if (auth_headers_iter != headers->end()) {
-      authorization_request->authorization_metadata.authorization_token =
-          auth_headers_iter->second;
-    }
-
-    auth_headers_iter = headers->find(kClaimedIdentityHeader);
-    if (auth_headers_iter != headers->end()) {
-      authorization_request->authorization_metadata.claimed_identity =
-          auth_headers_iter->second;
-    }
+  if (auto auth_token = http2_context.request->FindHeader(kAuthHeader)) {
+    authorization_request->authorization_metadata.authorization_token =
+        *auth_token;
   }
+  if (auto claimed_identity =
+          http2_context.request->FindHeader(kClaimedIdentityHeader)) {
+    authorization_request->authorization_metadata.claimed_identity =
+        *claimed_identity;
+  }
+  // The labels are built from the headers, which can only be read here on the
+  // nghttp2 io thread, while the request may still fail on another thread.
+  GetOtelMetricLabels(http2_context);
 
   SCP_DEBUG_CONTEXT(
       kHttp2Server, http2_context,
@@ -469,17 +660,13 @@ void Http2Server::HandleHttp2Request(
       authorization_context(authorization_request,
                             std::bind(&Http2Server::OnAuthorizationCallback,
                                       this, std::placeholders::_1,
-                                      http2_context.request->id, sync_context),
+                                      sync_context),
                             http2_context);
 
   std::shared_ptr<AuthorizationProxyInterface> authorization_proxy_to_use =
       authorization_proxy_;
 
-  bool dns_routing_enabled = false;
-  if (config_provider_ != nullptr &&
-      config_provider_->Get(kHttpServerDnsRoutingEnabled, dns_routing_enabled)
-          .Successful() &&
-      dns_routing_enabled) {
+  if (dns_routing_enabled_) {
     if (aws_authorization_proxy_ != nullptr &&
         UseAwsAuthorizationProxy(
             authorization_context.request->authorization_metadata)) {
@@ -516,47 +703,41 @@ void Http2Server::HandleHttp2Request(
   // invoked)
   // 3. Connection is terminated (response.on_closed is invoked)
   //
+  // Both callbacks are owned by the nghttp2 stream and keep the sync context
+  // alive until the stream is closed.
   http2_context.request->SetOnRequestBodyDataReceivedCallback(
-      std::bind(&Http2Server::OnHttp2PendingCallback, this,
-                std::placeholders::_1, http2_context.request->id));
+      [this, sync_context](ExecutionResult execution_result) {
+        // The handler reads the headers past the nghttp2 io thread, so they
+        // are copied while the stream is open, unless the request failed.
+        if (execution_result.Successful() && !sync_context->failed.load()) {
+          sync_context->http2_context.request->CopyHeaders();
+        }
+        OnHttp2PendingCallback(execution_result, sync_context);
+      });
   http2_context.response->SetOnCloseCallback(
-      std::bind(&Http2Server::OnHttp2Cleanup, this, std::cref(*sync_context),
-                std::placeholders::_1));
+      [this, sync_context](NgHttp2Response::OnCloseErrorCode error_code) {
+        OnHttp2Cleanup(*sync_context, error_code);
+      });
 }
 
 void Http2Server::OnAuthorizationCallback(
     AsyncContext<AuthorizationProxyRequest, AuthorizationProxyResponse>&
         authorization_context,
-    Uuid& request_id,
     const std::shared_ptr<Http2SynchronizationContext>& sync_context) noexcept {
   if (!authorization_context.result.Successful()) {
     SCP_DEBUG_CONTEXT(kHttp2Server, authorization_context,
                       "Authorization failed.");
   } else {
-    sync_context->http2_context.request->auth_context
-        .authorized_domain = std::make_shared<std::string>(
-        authorization_context.request->authorization_metadata.claimed_identity);
     sync_context->http2_context.request->auth_context.authorized_domain =
         authorization_context.response->authorized_metadata.authorized_domain;
   }
 
-  OnHttp2PendingCallback(authorization_context.result, request_id);
+  OnHttp2PendingCallback(authorization_context.result, sync_context);
 }
 
 void Http2Server::OnHttp2PendingCallback(
     ExecutionResult callback_execution_result,
-    const Uuid& request_id) noexcept {
-  // Lookup the sync context
-  std::shared_ptr<Http2SynchronizationContext> sync_context;
-  auto execution_result = active_requests_.Find(request_id, sync_context);
-  if (!execution_result.Successful()) {
-    SCP_DEBUG(kHttp2Server, request_id,
-              "Could not find Http2SynchronizationContext(current request) in "
-              "active requests map. This could happen if the request was "
-              "already finished or if the request ID is invalid.");
-    return;
-  }
-
+    const std::shared_ptr<Http2SynchronizationContext>& sync_context) noexcept {
   if (!callback_execution_result.Successful()) {
     auto failed = false;
     // Only change if the current status was false.
@@ -572,6 +753,7 @@ void Http2Server::OnHttp2PendingCallback(
 
   if (sync_context->failed.load()) {
     // If it is failed, the callback has been called before.
+    ReleaseStreamStateIfUnused(*sync_context);
     return;
   }
 
@@ -597,12 +779,12 @@ void Http2Server::OnHttp2PendingCallback(
   // reaches here.
   RecordRequestBodySize(sync_context->http2_context);
 
-  execution_result = sync_context->http_handler(http_context);
+  auto execution_result = sync_context->http_handler(http_context);
   if (!execution_result.Successful()) {
     sync_context->http2_context.result = execution_result;
     sync_context->http2_context.Finish();
-    return;
   }
+  ReleaseStreamStateIfUnused(*sync_context);
 }
 
 void Http2Server::OnHttp2Response(
@@ -612,14 +794,27 @@ void Http2Server::OnHttp2Response(
   if (!http_context.result.Successful()) {
     auto error_code = GetErrorHttpStatusCode(http_context.result.status_code);
     http_context.response->code = error_code;
-    SCP_ERROR_CONTEXT(
-        kHttp2Server, http_context, http_context.result,
-        absl::StrFormat(
-            "http2 request finished with error. http status code: '%d', "
-            "request endpoint type: '%d'",
-            static_cast<typename std::underlying_type<HttpStatusCode>::type>(
-                http_context.response->code),
-            static_cast<size_t>(endpoint_type)));
+    if (IsExpectedOutcome(http_context.result.status_code)) {
+      SCP_DEBUG_CONTEXT(
+          kHttp2Server, http_context,
+          absl::StrFormat(
+              "http2 request finished. http status code: '%d', request "
+              "endpoint type: '%d', Message: '%s'",
+              static_cast<typename std::underlying_type<HttpStatusCode>::type>(
+                  http_context.response->code),
+              static_cast<size_t>(endpoint_type),
+              GetErrorMessage(http_context.result.status_code)));
+    } else {
+      SCP_ERROR_CONTEXT_RATE_LIMITED(
+          kHttp2Server, http_context, http_context.result,
+          kMaxErrorResponseLogsPerSecond,
+          absl::StrFormat(
+              "http2 request finished with error. http status code: '%d', "
+              "request endpoint type: '%d'",
+              static_cast<typename std::underlying_type<HttpStatusCode>::type>(
+                  http_context.response->code),
+              static_cast<size_t>(endpoint_type)));
+    }
   } else {
     SCP_DEBUG_CONTEXT(
         kHttp2Server, http_context,
@@ -631,6 +826,11 @@ void Http2Server::OnHttp2Response(
   // Record response body size in Bytes - response is prepared here to be sent.
   RecordResponseBodySize(http_context);
 
+  // Compressing here keeps the CPU cost off the nghttp2 io threads.
+  if (response_compression_min_size_ > 0) {
+    CompressResponseBody(http_context);
+  }
+
   // Capture the shared_ptr to keep the response object alive when the work
   // actually starts executing. Do not execute response->Send() on a thread
   // that does not belong to nghttp2response as it could lead to concurrency
@@ -639,11 +839,56 @@ void Http2Server::OnHttp2Response(
       [response = http_context.response]() { response->Send(); });
 }
 
-void Http2Server::OnHttp2Cleanup(
-    const Http2SynchronizationContext& sync_context,
-    uint32_t error_code) noexcept {
-  auto request_id_str = ToString(sync_context.http2_context.request->id);
+void Http2Server::CompressResponseBody(
+    AsyncContext<NgHttp2Request, NgHttp2Response>& http_context) noexcept {
+  auto& response = *http_context.response;
+  if (!response.headers) {
+    response.headers = std::make_shared<HttpHeaders>();
+  }
+  // Whether a response is compressed depends on the Accept-Encoding header of
+  // the request, so caches must key every response on it, compressed or not.
+  auto [vary_begin, vary_end] = response.headers->equal_range(kVaryHeader);
+  if (std::none_of(vary_begin, vary_end, [](const auto& header) {
+        return header.second == kAcceptEncodingHeader;
+      })) {
+    response.headers->insert({kVaryHeader, kAcceptEncodingHeader});
+  }
+
+  if (response.body.length < response_compression_min_size_) {
+    return;
+  }
+  if (!http_context.request->IsGzipResponseAccepted()) {
+    return;
+  }
+  if (response.headers->contains(kContentEncodingHeader)) {
+    return;
+  }
+
+  std::string compressed;
+  auto execution_result = GzipCompress(
+      std::string_view(response.body.bytes->data(), response.body.length),
+      compressed);
+  if (!execution_result.Successful()) {
+    SCP_ERROR_CONTEXT(kHttp2Server, http_context, execution_result,
+                      "Failed to compress the response body.");
+    return;
+  }
+  if (compressed.size() >= response.body.length) {
+    return;
+  }
+  response.body = BytesBuffer(compressed);
+  // A content length set by the handler refers to the uncompressed body.
+  if (response.headers->erase("content-length") > 0) {
+    response.headers->insert(
+        {"content-length", std::to_string(response.body.length)});
+  }
+  response.headers->insert({kContentEncodingHeader, kGzipContentEncoding});
+}
+
+void Http2Server::OnHttp2Cleanup(Http2SynchronizationContext& sync_context,
+                                 uint32_t error_code) noexcept {
   if (error_code != 0) {
+    auto request_id_str = ToString(sync_context.http2_context.request->id);
     SCP_DEBUG(
         kHttp2Server, sync_context.http2_context.parent_activity_id,
         absl::StrFormat(
@@ -651,39 +896,84 @@ void Http2Server::OnHttp2Cleanup(
             request_id_str, error_code));
   }
   RecordServerLatency(sync_context);
-  // sync_context should not be used after this line because it has been
-  // deallocated.
-  active_requests_.Erase(sync_context.http2_context.request->id);
+
+  auto latency = std::chrono::steady_clock::now() - sync_context.entry_time;
+  admission_controller_.Release(latency);
+  if (sync_context.route_admission_controller) {
+    sync_context.route_admission_controller->Release(latency);
+  }
+  active_requests_count_.fetch_sub(1);
+  ReleaseStreamStateIfUnused(sync_context);
+}
+
+void Http2Server::ReleaseStreamStateIfUnused(
+    Http2SynchronizationContext& sync_context) noexcept {
+  if (sync_context.stream_state_users.fetch_sub(1) == 1) {
+    sync_context.ReleaseStreamState();
+  }
 }
 
-absl::flat_hash_map<absl::string_view, std::string>
+bool Http2Server::IsDnsRoutingEnabled(
+    const std::shared_ptr<ConfigProviderInterface>& config_provider) {
+  bool dns_routing_enabled = false;
+  return config_provider != nullptr &&
+         config_provider->Get(kHttpServerDnsRoutingEnabled, dns_routing_enabled)
+             .Successful() &&
+         dns_routing_enabled;
+}
+
+const absl::flat_hash_map<absl::string_view, std::string>&
 Http2Server::GetOtelMetricLabels(
     const AsyncContext<NgHttp2Request, NgHttp2Response>& http_context) {
-  absl::flat_hash_map<std::string_view, std::string> labels = {
-      {kServerAddress, host_address_},
-      {kServerPort, port_},
-      {kHttpRoute, http_context.request->handler_path},
-      {kHttpRequestMethod, HttpMethodToString(http_context.request->method)},
-      {kPbsClaimedIdentityLabel,
-       GetClaimedIdentityOrUnknownValue(http_context)},
-      {kScpHttpRequestClientVersionLabel,
-       GetUserAgentOrUnknownValue(http_context)}};
+  absl::flat_hash_map<std::string_view, std::string>& labels =
+      http_context.request->metric_labels;
+  if (labels.empty()) {
+    labels.insert({
+        {kServerAddress, host_address_},
+        {kServerPort, port_},
+        {kHttpRoute, http_context.request->handler_path},
+        {kHttpRequestMethod, HttpMethodToString(http_context.request->method)},
+        {kPbsClaimedIdentityLabel,
+         GetClaimedIdentityOrUnknownValue(http_context)},
+        {kScpHttpRequestClientVersionLabel,
+         GetUserAgentOrUnknownValue(http_context)},
+    });
+  }
 
+  // The status code changes once the response is prepared.
   if (http_context.response != nullptr) {
-    labels.try_emplace(
-        kHttpResponseStatusCode,
-        std::to_string(static_cast<int>(http_context.response->code)));
+    std::string status_code =
+        std::to_string(static_cast<int>(http_context.response->code));
+    if (auto it = labels.find(kHttpResponseStatusCode);
+        it == labels.end() || it->second != status_code) {
+      labels.insert_or_assign(kHttpResponseStatusCode, std::move(status_code));
+      http_context.request->metric_attributes.clear();
+    }
   }
 
   if (std::string* auth_domain =
           http_context.request->auth_context.authorized_domain.get();
-      auth_domain != nullptr) {
-    labels.try_emplace(kPbsAuthDomainLabel, *auth_domain);
+      auth_domain != nullptr &&
+      labels.try_emplace(kPbsAuthDomainLabel, *auth_domain).second) {
+    http_context.request->metric_attributes.clear();
   }
 
   return labels;
 }
 
+const MetricAttributes& Http2Server::GetOtelMetricAttributes(
+    const AsyncContext<NgHttp2Request, NgHttp2Response>& http_context,
+    absl::string_view metric_name) {
+  const absl::flat_hash_map<absl::string_view, std::string>& labels =
+      GetOtelMetricLabels(http_context);
+  std::shared_ptr<const MetricAttributes>& attributes =
+      http_context.request->metric_attributes[metric_name];
+  if (attributes == nullptr) {
+    attributes = metric_router_->GetOrCreateAttributes(metric_name, labels);
+  }
+  return *attributes;
+}
+
 void Http2Server::RecordServerLatency(
     const Http2SynchronizationContext& sync_context) {
   if (!server_request_duration_) {
@@ -694,11 +984,13 @@ void Http2Server::RecordServerLatency(
       std::chrono::steady_clock::now() - sync_context.entry_time;
   double latency_s = latency / std::chrono::seconds(1);
 
-  absl::flat_hash_map<absl::string_view, std::string> labels =
-      GetOtelMetricLabels(sync_context.http2_context);
-
   opentelemetry::context::Context context;
-  server_request_duration_->Record(latency_s, labels, context);
+  server_request_duration_->Record(
+      latency_s,
+      GetOtelMetricAttributes(sync_context.http2_context,
+                              kServerRequestDurationMetric)
+          .Get(),
+      context);
 }
 
 void Http2Server::RecordRequestBodySize(
@@ -707,12 +999,11 @@ void Http2Server::RecordRequestBodySize(
     return;
   }
 
-  absl::flat_hash_map<absl::string_view, std::string> labels =
-      GetOtelMetricLabels(http_context);
-
   opentelemetry::context::Context context;
-  server_request_body_size_->Record(http_context.request->body.length, labels,
-                                    context);
+  server_request_body_size_->Record(
+      http_context.request->GetReceivedBodyLength(),
+      GetOtelMetricAttributes(http_context, kServerRequestBodySizeMetric).Get(),
+      context);
 }
 
 void Http2Server::RecordResponseBodySize(
@@ -721,12 +1012,12 @@ void Http2Server::RecordResponseBodySize(
     return;
   }
 
-  absl::flat_hash_map<absl::string_view, std::string> labels =
-      GetOtelMetricLabels(http_context);
-
   opentelemetry::context::Context context;
-  server_response_body_size_->Record(http_context.response->body.length, labels,
-                                     context);
+  server_response_body_size_->Record(
+      http_context.response->body.length,
+      GetOtelMetricAttributes(http_context, kServerResponseBodySizeMetric)
+          .Get(),
+      context);
 }
 
 void Http2Server::ObserveActiveRequestsCallback(
@@ -735,7 +1026,7 @@ void Http2Server::ObserveActiveRequestsCallback(
   auto observer = std::get<
       std::shared_ptr<opentelemetry::metrics::ObserverResultT<int64_t>>>(
       observer_result);
-  observer->Observe(self_ptr->active_requests_.Size());
+  observer->Observe(self_ptr->active_requests_count_.load());
 }
 
 }  // namespace privacy_sandbox::pbs_common
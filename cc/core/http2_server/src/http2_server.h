@@ -18,17 +18,22 @@
 
 #include <atomic>
 #include <memory>
+#include <optional>
 #include <string>
 #include <thread>
 #include <utility>
+#include <vector>
 
 #include <nghttp2/asio_http2_server.h>
 
-#include "cc/core/common/concurrent_map/src/concurrent_map.h"
+#include "absl/container/flat_hash_map.h"
 #include "cc/core/common/operation_dispatcher/src/operation_dispatcher.h"
 #include "cc/core/common/uuid/src/uuid.h"
+#include "cc/core/http2_server/src/http2_admission_controller.h"
+#include "cc/core/http2_server/src/http2_object_pool.h"
 #include "cc/core/http2_server/src/http2_request.h"
 #include "cc/core/http2_server/src/http2_response.h"
+#include "cc/core/http2_server/src/http2_router.h"
 #include "cc/core/interface/async_executor_interface.h"
 #include "cc/core/interface/authorization_proxy_interface.h"
 #include "cc/core/interface/config_provider_interface.h"
@@ -70,6 +75,37 @@ class Http2ServerOptions {
   const std::shared_ptr<std::string> certificate_chain_file;
   /// Retry strategy options.
   const RetryStrategyOptions retry_strategy_options;
+  /// Response bodies of at least this size are gzip compressed for clients
+  /// accepting it. Responses are never compressed when 0.
+  size_t response_compression_min_size = 0;
+  /// When greater than 1, the server runs this many listeners on the same
+  /// port with SO_REUSEPORT instead of a single listener shared by all its io
+  /// threads. Each listener owns one io thread pinned to its own core, and the
+  /// kernel balances the incoming connections across the listeners.
+  size_t reuse_port_listeners = 0;
+  /// Connections older than this are drained with a graceful GOAWAY, so that
+  /// clients reconnect and spread over the current server instances. The age
+  /// is jittered by +/-10% per connection. No limit when 0.
+  size_t max_connection_age_seconds = 0;
+  /// Connections which received this many requests are drained with a
+  /// graceful GOAWAY. No limit when 0.
+  size_t max_connection_requests = 0;
+  /// On Stop, every connection is drained with a graceful GOAWAY and the
+  /// in-flight requests are given this long to complete before the
+  /// connections are closed. Connections are closed right away when 0.
+  size_t drain_timeout_ms = 0;
+  /// Caps the requests in flight on the server. Requests over the limit are
+  /// rejected with 503 before their body is read.
+  Http2AdmissionControllerOptions admission_control;
+  /// Caps the requests in flight per route path. Requests over the limit of
+  /// their route are rejected with 429 before their body is read.
+  absl::flat_hash_map<std::string, size_t> route_max_concurrent_requests;
+  /// Value of the Retry-After header of rejected requests, in seconds.
+  size_t rejected_request_retry_after_seconds = 1;
+  /// When TLS is used and this is greater than 0, the server issues session
+  /// tickets so that reconnecting clients resume their TLS session instead of
+  /// doing a full handshake. The ticket keys are rotated at this interval.
+  size_t tls_session_ticket_key_rotation_seconds = 0;
 
  private:
   static constexpr TimeDuration kHttpServerRetryStrategyDelayInMs = 31;
@@ -91,14 +127,28 @@ class Http2Server : public HttpServerInterface {
         port_(port),
         thread_pool_size_(thread_pool_size),
         is_running_(false),
+        active_requests_count_(0),
         authorization_proxy_(authorization_proxy),
         aws_authorization_proxy_(aws_authorization_proxy),
         config_provider_(config_provider),
+        dns_routing_enabled_(IsDnsRoutingEnabled(config_provider)),
         otel_server_metrics_enabled_(false),
         async_executor_(async_executor),
         operation_dispatcher_(async_executor,
                               RetryStrategy(options.retry_strategy_options)),
+        response_compression_min_size_(options.response_compression_min_size),
+        reuse_port_listeners_(options.reuse_port_listeners),
+        max_connection_age_seconds_(options.max_connection_age_seconds),
+        max_connection_requests_(options.max_connection_requests),
+        drain_timeout_ms_(options.drain_timeout_ms),
+        admission_controller_(options.admission_control),
+        route_max_concurrent_requests_(
+            std::move(options.route_max_concurrent_requests)),
+        rejected_request_retry_after_(
+            std::to_string(options.rejected_request_retry_after_seconds)),
         use_tls_(options.use_tls),
+        tls_session_ticket_key_rotation_seconds_(
+            options.tls_session_ticket_key_rotation_seconds),
         private_key_file_(*options.private_key_file),
         certificate_chain_file_(*options.certificate_chain_file),
         tls_context_(boost::asio::ssl::context::sslv23),
@@ -116,6 +166,18 @@ class Http2Server : public HttpServerInterface {
       HttpMethod http_method, std::string& path,
       HttpHandler& handler) noexcept override;
 
+  ExecutionResult RegisterStreamingResourceHandler(
+      HttpMethod http_method, std::string& path,
+      HttpStreamingHandler& handler,
+      size_t max_request_body_size) noexcept override;
+
+  /**
+   * @brief Returns the number of requests received by each listener since the
+   * server started running. Shows how evenly the kernel balances connections
+   * across SO_REUSEPORT listeners.
+   */
+  std::vector<int64_t> GetRequestCountPerListener() const noexcept;
+
   /**
    * @brief This context is used for the synchronization between two callbacks.
    * The authorization proxy callback and the data receive callback from the
@@ -123,10 +185,41 @@ class Http2Server : public HttpServerInterface {
    * caller can easily send multiple requests with huge amount of data on the
    * body. If the authorization validation happens earlier than the data being
    * ready the request can be terminated immediately.
+   *
+   * The context lives as long as the nghttp2 stream of the request, whose
+   * callbacks own it, or any callback still pending on it. Contexts are
+   * recycled through a per io thread Http2ObjectPool.
    */
   struct Http2SynchronizationContext {
+    /// Reinitializes a recycled context.
+    void Reset() {
+      pending_callbacks = 0;
+      stream_state_users = 0;
+      failed = false;
+    }
+
+    /// Releases the state of the stream of a context returned to its pool.
+    void Release() { ReleaseStreamState(); }
+
+    /**
+     * @brief Releases the request, the response and the handler of the
+     * stream, so that an idle context does not keep them alive. The request
+     * and response go back to their pools, which release their data, once
+     * the handler does not hold them either.
+     */
+    void ReleaseStreamState() {
+      http2_context.request.reset();
+      http2_context.response.reset();
+      http2_context.callback = nullptr;
+      http_handler = nullptr;
+      route_admission_controller.reset();
+    }
+
     /// Total pending callbacks.
     std::atomic<size_t> pending_callbacks;
+    /// The stream close and the last pending callback, the last of which
+    /// releases the state of the stream.
+    std::atomic<size_t> stream_state_users;
     /// Indicates whether any callback has failed.
     std::atomic<bool> failed;
     /// A copy of the original http2 context.
@@ -135,6 +228,8 @@ class Http2Server : public HttpServerInterface {
     HttpHandler http_handler;
     /// Time for entry point of the request.
     std::chrono::time_point<std::chrono::steady_clock> entry_time;
+    /// Admitted the request on its route, if the route is limited.
+    std::shared_ptr<Http2AdmissionController> route_admission_controller;
   };
 
   /**
@@ -150,13 +245,28 @@ class Http2Server : public HttpServerInterface {
   };
 
  protected:
+  /**
+   * @brief Registers the handler of a path and method. Handlers can only be
+   * registered while the server is not running.
+   *
+   * @param http_method The method of the operation.
+   * @param path The resource path in REST format.
+   * @param resource_handler The handler of the specific path and method.
+   * @return ExecutionResult
+   */
+  ExecutionResult RegisterHandler(
+      HttpMethod http_method, const std::string& path,
+      Http2ResourceHandler resource_handler) noexcept;
+
   /**
    * @brief Handles the incoming nghttp2 native request and response. This is
    * the first function to receive the HTTP request. It initializes the
    * asynchronous context to store the request and response, binds the
-   * OnHttp2Response callback, and creates a synchronous context to track active
-   * requests. Finally, it sets up the request handler. The request is then
-   * forwarded for further processing in RouteOrHandleHttp2Request.
+   * OnHttp2Response callback, and acquires the synchronization context of the
+   * stream. The request, response and synchronization context objects are
+   * recycled from pools local to the io thread. Finally, it sets up the request
+   * handler, and the body consumer for routes with a streaming handler. The
+   * request is then forwarded for further processing in HandleHttp2Request.
    *
    * @param request The nghttp2 server request object.
    * @param response The nghttp2 server response object.
@@ -178,6 +288,17 @@ class Http2Server : public HttpServerInterface {
       AsyncContext<NgHttp2Request, NgHttp2Response>& http_context,
       RequestTargetEndpointType request_destination_type) noexcept;
 
+  /**
+   * @brief Gzip compresses the response body if it is large enough and the
+   * client accepts gzip. The body is left as is when compression does not
+   * make it smaller or the handler already encoded it. Every response is
+   * marked as varying on Accept-Encoding, whether compressed or not.
+   *
+   * @param http_context The context of the hghttp2 request.
+   */
+  virtual void CompressResponseBody(
+      AsyncContext<NgHttp2Request, NgHttp2Response>& http_context) noexcept;
+
   /**
    * @brief Is called when the http connection/stream is closed.
    *
@@ -185,14 +306,23 @@ class Http2Server : public HttpServerInterface {
    * @param error_code The error code that the connection/stream was closed
    * with.
    */
-  virtual void OnHttp2Cleanup(const Http2SynchronizationContext& sync_context,
+  virtual void OnHttp2Cleanup(Http2SynchronizationContext& sync_context,
                               uint32_t error_code) noexcept;
 
   /**
-   * @brief Handles the processing of an HTTP2 request. This function retrieves
-   * the synchronization context adds details to it. It also creates an
-   * authorization context to manage request authorization (dispatching
-   * asynchronously).
+   * @brief Releases the state of the stream of the sync context once both the
+   * stream is closed and no callback is pending on it anymore.
+   *
+   * @param sync_context The sync context associated with the http operation.
+   */
+  void ReleaseStreamStateIfUnused(
+      Http2SynchronizationContext& sync_context) noexcept;
+
+  /**
+   * @brief Handles the processing of an HTTP2 request. This function adds the
+   * request details to the synchronization context of the stream. It also
+   * creates an authorization context to manage request authorization
+   * (dispatching asynchronously).
    *
    * Additionally, this function sets up key callbacks:
    * - `SetOnRequestBodyDataReceivedCallback` triggers `OnHttp2PendingCallback`
@@ -201,25 +331,29 @@ class Http2Server : public HttpServerInterface {
    * request and sending the response back to the client (closing
    * connection/stream).
    *
+   * The stream callbacks own the synchronization context, tying its lifetime
+   * to the stream rather than to a registry of active requests.
+   *
    * @param http2_context The context of the ng http2 operation.
    * @param http_handler The http handler to handle the request.
+   * @param sync_context The sync context of the stream.
    */
   virtual void HandleHttp2Request(
       AsyncContext<NgHttp2Request, NgHttp2Response>& http2_context,
-      HttpHandler& http_handler) noexcept;
+      HttpHandler& http_handler,
+      const std::shared_ptr<Http2SynchronizationContext>&
+          sync_context) noexcept;
 
   /**
    * @brief The callback that is called after authorization proxy evaluates
    * the http context authorization.
    *
    * @param authorization_context The authorization context of the operation.
-   * @param request_id The id of the request.
    * @param sync_context The sync context associated with the http operation.
    */
   virtual void OnAuthorizationCallback(
       AsyncContext<AuthorizationProxyRequest, AuthorizationProxyResponse>&
           authorization_context,
-      Uuid& request_id,
       const std::shared_ptr<Http2SynchronizationContext>&
           sync_context) noexcept;
 
@@ -234,10 +368,12 @@ class Http2Server : public HttpServerInterface {
    * (e.g., budget consumption) and initializes the `OnHttp2Response` callback
    * to handle the final response.
    * @param execution_result The execution result of the callback.
-   * @param request_id The request id associated with the operation.
+   * @param sync_context The sync context associated with the http operation.
    */
-  virtual void OnHttp2PendingCallback(ExecutionResult execution_result,
-                                      const Uuid& request_id) noexcept;
+  virtual void OnHttp2PendingCallback(
+      ExecutionResult execution_result,
+      const std::shared_ptr<Http2SynchronizationContext>&
+          sync_context) noexcept;
 
   // The host address to run the http server on.
   std::string host_address_;
@@ -245,24 +381,27 @@ class Http2Server : public HttpServerInterface {
   // The port of the http server.
   std::string port_;
 
-  // The ngHttp2 http server instance.
-  nghttp2::asio_http2::server::http2 http2_server_;
+  // The ngHttp2 http server instances, one per listener. Created on Run.
+  std::vector<std::unique_ptr<nghttp2::asio_http2::server::http2>>
+      http2_servers_;
+
+  // Number of requests received by each listener, same order as
+  // http2_servers_.
+  std::vector<std::unique_ptr<std::atomic<int64_t>>> listener_request_counts_;
 
   // The total http server thread pool size.
   size_t thread_pool_size_;
 
-  // Registry of all the paths and handlers.
-  ConcurrentMap<std::string,
-                std::shared_ptr<ConcurrentMap<HttpMethod, HttpHandler>>>
-      resource_handlers_;
-
-  // Registry of all the active requests.
-  ConcurrentMap<Uuid, std::shared_ptr<Http2SynchronizationContext>, UuidCompare>
-      active_requests_;
+  // Routing table of all the paths and handlers. It is only modified while the
+  // server is not running, so requests look it up without locking.
+  Http2Router router_;
 
   // Indicates whether the http server is running.
   std::atomic<bool> is_running_;
 
+  // Number of requests whose stream has not been closed yet.
+  std::atomic<int64_t> active_requests_count_;
+
   // An instance to the authorization proxy.
   std::shared_ptr<AuthorizationProxyInterface> authorization_proxy_;
 
@@ -271,6 +410,10 @@ class Http2Server : public HttpServerInterface {
   // An instance of the config provider.
   std::shared_ptr<ConfigProviderInterface> config_provider_;
 
+  // Whether requests carrying an AWS token are authorized by the AWS
+  // authorization proxy. Resolved once from the config provider.
+  const bool dns_routing_enabled_;
+
   // Feature flag for otel server metrics
   bool otel_server_metrics_enabled_;
 
@@ -280,9 +423,38 @@ class Http2Server : public HttpServerInterface {
   // An instance of the operation dispatcher.
   OperationDispatcher operation_dispatcher_;
 
+  // Minimum size of the response bodies to compress, 0 if disabled.
+  size_t response_compression_min_size_;
+
+  // Number of SO_REUSEPORT listeners, a single shared listener if 0 or 1.
+  size_t reuse_port_listeners_;
+
+  // Age after which connections are drained, 0 if unlimited.
+  size_t max_connection_age_seconds_;
+
+  // Number of requests after which connections are drained, 0 if unlimited.
+  size_t max_connection_requests_;
+
+  // How long Stop waits for the in-flight requests of the drained
+  // connections, 0 to close them right away.
+  size_t drain_timeout_ms_;
+
+  // Caps the requests in flight on the server.
+  Http2AdmissionController admission_controller_;
+
+  // Caps of the requests in flight per route path.
+  absl::flat_hash_map<std::string, size_t> route_max_concurrent_requests_;
+
+  // Value of the Retry-After header of rejected requests.
+  std::string rejected_request_retry_after_;
+
   // Whether to use TLS.
   bool use_tls_;
 
+  // The rotation interval of the TLS session ticket keys, 0 when the server
+  // does not issue session tickets.
+  size_t tls_session_ticket_key_rotation_seconds_;
+
   // The path and filename to the server private key file.
   std::string private_key_file_;
 
@@ -300,7 +472,48 @@ class Http2Server : public HttpServerInterface {
    * @brief Returns the port the server is listening. Use this in tests when the
    * server was initialized with port "0" and OS finds a free port.
    */
-  int PortInUse() { return http2_server_.ports()[0]; }
+  int PortInUse() { return http2_servers_[0]->ports()[0]; }
+
+  /**
+   * @brief Starts serving on the given port with a new nghttp2 server owning
+   * thread_count io threads.
+   *
+   * @param port The port to listen on.
+   * @param thread_count The number of io threads of the listener.
+   * @param cpu_affinity The core to pin the io thread of the listener to, if
+   * any.
+   */
+  ExecutionResult StartListener(
+      const std::string& port, size_t thread_count,
+      std::optional<size_t> cpu_affinity = std::nullopt) noexcept;
+
+  /**
+   * @brief Stops accepting connections, sends a graceful GOAWAY on every
+   * accepted one, and waits for the in-flight requests to complete or the
+   * drain timeout to elapse.
+   */
+  void DrainConnections() noexcept;
+
+  /**
+   * @brief Admits a request on the server and on its route.
+   *
+   * @return SC_HTTP2_SERVER_OVERLOADED or SC_HTTP2_SERVER_ROUTE_OVERLOADED if
+   * the request is over a limit, in which case nothing is left admitted.
+   */
+  ExecutionResult AdmitHttp2Request(
+      const Http2ResourceHandler& resource_handler) noexcept;
+
+  /// Releases a request admitted by AdmitHttp2Request which did not run.
+  void CancelHttp2RequestAdmission(
+      const Http2ResourceHandler& resource_handler) noexcept;
+
+  /**
+   * @brief Completes a request rejected by admission control, asking the
+   * client to retry later.
+   */
+  void RejectHttp2Request(
+      AsyncContext<NgHttp2Request, NgHttp2Response>& http2_context,
+      const ExecutionResult& result) noexcept;
 
   /**
    * Initializes the OpenTelemetry metrics collection system. This function
@@ -324,7 +537,8 @@ class Http2Server : public HttpServerInterface {
   void RecordServerLatency(const Http2SynchronizationContext& sync_context);
 
   /**
-   * Records the size of the request body (uncompressed) sent by the client.
+   * Records the size of the request body (uncompressed) sent by the client,
+   * once the body is received, whether a response follows or not.
    *
    * @param http_context The http context containing the request and response
    * objects.
@@ -359,16 +573,43 @@ class Http2Server : public HttpServerInterface {
       Http2Server* self_ptr);
 
   /**
-   * Sets the OpenTelemetry labels
+   * Sets the OpenTelemetry labels. The labels are built on the first call for
+   * a request and cached on the request; later calls only update the response
+   * status code and the authorized domain.
+   *
+   * They cannot be precomputed per route, method and status code, since the
+   * claimed identity, the client version and the authorized domain labels
+   * come from each request.
    *
    * @param http_context The http context containing the request and response
    * objects.
    *
    * @return OpenTelemetry labels.
    */
-  absl::flat_hash_map<absl::string_view, std::string> GetOtelMetricLabels(
+  const absl::flat_hash_map<absl::string_view, std::string>&
+  GetOtelMetricLabels(
       const AsyncContext<NgHttp2Request, NgHttp2Response>& http_context);
 
+  /**
+   * Gets the OpenTelemetry attribute set of the labels of GetOtelMetricLabels
+   * for a metric. It is looked up once per metric and cached on the request
+   * until the labels change.
+   *
+   * @param http_context The http context containing the request and response
+   * objects.
+   * @param metric_name The metric the attributes are recorded with, whose
+   * attribute set cap they count against.
+   *
+   * @return OpenTelemetry attributes.
+   */
+  const MetricAttributes& GetOtelMetricAttributes(
+      const AsyncContext<NgHttp2Request, NgHttp2Response>& http_context,
+      absl::string_view metric_name);
+
+  /// Reads kHttpServerDnsRoutingEnabled, false if it is not set.
+  static bool IsDnsRoutingEnabled(
+      const std::shared_ptr<ConfigProviderInterface>& config_provider);
+
   // An instance of metric router which will provide APIs to create metrics.
   MetricRouter* metric_router_;
 
@@ -390,6 +631,11 @@ class Http2Server : public HttpServerInterface {
   // OpenTelemetry Instrument for measuring response body size (uncompressed).
   std::shared_ptr<opentelemetry::metrics::Histogram<uint64_t>>
       server_response_body_size_;
+
+  // OpenTelemetry Instrument counting the requests rejected by admission
+  // control.
+  std::shared_ptr<opentelemetry::metrics::Counter<uint64_t>>
+      server_rejected_requests_;
 };
 
 }  // namespace privacy_sandbox::pbs_common
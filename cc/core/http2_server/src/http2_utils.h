@@ -17,8 +17,10 @@
 #pragma once
 
 #include <algorithm>
-#include <memory>
-#include <string>
+#include <charconv>
+#include <optional>
+#include <string_view>
+#include <system_error>
 
 #include "cc/core/http2_server/src/error_codes.h"
 #include "cc/core/interface/http_types.h"
@@ -29,7 +31,8 @@ class Http2Utils {
   /**
    * @brief Parses the content-length value in the http headers.
    *
-   * @param headers The map of all the headers.
+   * @param content_length_value The value of the content-length header, if
+   * any.
    * @param content_length The content length to be set if the operation was
    * successful.
    * @return ExecutionResult The execution result of the operation.
@@ -38,20 +41,20 @@ class Http2Utils {
       // TODO: In HTTP2, content-length header is not required anymore,
       // see https://datatracker.ietf.org/doc/html/rfc7540#section-8.1.2.6
       // We should not rely on this header at all.
-      std::shared_ptr<HttpHeaders>& headers, size_t& content_length) noexcept {
-    auto header_iter = headers->find("content-length");
-    if (header_iter == headers->end()) {
+      std::optional<std::string_view> content_length_value,
+      size_t& content_length) noexcept {
+    if (!content_length_value) {
       return FailureExecutionResult(SC_HTTP2_SERVER_BAD_REQUEST);
     }
-    const auto& content_length_val = header_iter->second;
 
-    if (!IsNumber(content_length_val)) {
+    if (!IsNumber(*content_length_value)) {
       return FailureExecutionResult(SC_HTTP2_SERVER_INVALID_HEADER);
     }
 
-    try {
-      content_length = strtoul(content_length_val.c_str(), NULL, 0);
-    } catch (...) {
+    const char* end =
+        content_length_value->data() + content_length_value->size();
+    if (std::from_chars(content_length_value->data(), end, content_length)
+            .ec != std::errc()) {
       return FailureExecutionResult(SC_HTTP2_SERVER_INVALID_HEADER);
     }
 
@@ -66,7 +69,7 @@ class Http2Utils {
    * @return true If the value is a number.
    * @return false If the value is not a number.
    */
-  static bool IsNumber(const std::string& input) {
+  static bool IsNumber(std::string_view input) {
     return !input.empty() && std::all_of(input.begin(), input.end(), ::isdigit);
   }
 };
@@ -0,0 +1,127 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cc/core/http2_server/src/http2_admission_controller.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+
+namespace privacy_sandbox::pbs_common {
+namespace {
+
+constexpr std::chrono::milliseconds kFast = std::chrono::milliseconds(1);
+constexpr std::chrono::milliseconds kSlow = std::chrono::seconds(10);
+
+TEST(Http2AdmissionControllerTest, AdmitsEverythingWhenDisabled) {
+  Http2AdmissionController controller({});
+  EXPECT_FALSE(controller.IsEnabled());
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_TRUE(controller.TryAdmit());
+  }
+  EXPECT_EQ(controller.GetInFlight(), 0);
+}
+
+TEST(Http2AdmissionControllerTest, RejectsRequestsOverTheLimit) {
+  Http2AdmissionControllerOptions options;
+  options.max_concurrent_requests = 2;
+  Http2AdmissionController controller(options);
+
+  EXPECT_TRUE(controller.TryAdmit());
+  EXPECT_TRUE(controller.TryAdmit());
+  EXPECT_FALSE(controller.TryAdmit());
+  EXPECT_EQ(controller.GetInFlight(), 2);
+
+  controller.Release(kFast);
+  EXPECT_TRUE(controller.TryAdmit());
+  EXPECT_FALSE(controller.TryAdmit());
+
+  controller.Cancel();
+  controller.Cancel();
+  EXPECT_EQ(controller.GetInFlight(), 0);
+  // A fixed limit does not adapt.
+  EXPECT_EQ(controller.GetLimit(), 2);
+}
+
+TEST(Http2AdmissionControllerTest, AdaptiveLimitDecreasesOnSlowRequests) {
+  Http2AdmissionControllerOptions options;
+  options.max_concurrent_requests = 100;
+  options.min_concurrent_requests = 10;
+  options.adaptive = true;
+  options.latency_threshold = std::chrono::milliseconds(100);
+  options.backoff_ratio = 0.5;
+  Http2AdmissionController controller(options);
+
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_TRUE(controller.TryAdmit());
+  }
+  controller.Release(kSlow);
+  EXPECT_EQ(controller.GetLimit(), 50);
+  // Requests slowed down by the same overload do not decrease it again.
+  controller.Release(kSlow);
+  EXPECT_EQ(controller.GetLimit(), 50);
+
+  std::this_thread::sleep_for(options.latency_threshold);
+  controller.Release(kSlow);
+  EXPECT_EQ(controller.GetLimit(), 25);
+}
+
+TEST(Http2AdmissionControllerTest, AdaptiveLimitStaysWithinBounds) {
+  Http2AdmissionControllerOptions options;
+  options.max_concurrent_requests = 4;
+  options.min_concurrent_requests = 2;
+  options.adaptive = true;
+  options.latency_threshold = std::chrono::milliseconds(1);
+  options.backoff_ratio = 0.1;
+  Http2AdmissionController controller(options);
+
+  EXPECT_TRUE(controller.TryAdmit());
+  controller.Release(kSlow);
+  EXPECT_EQ(controller.GetLimit(), 2);
+
+  // Fast requests using the limit increase it, up to the maximum.
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_TRUE(controller.TryAdmit());
+    EXPECT_TRUE(controller.TryAdmit());
+    controller.Release(std::chrono::microseconds(10));
+    controller.Release(std::chrono::microseconds(10));
+  }
+  EXPECT_EQ(controller.GetLimit(), 4);
+}
+
+TEST(Http2AdmissionControllerTest, AdaptiveLimitOnlyGrowsWhenUsed) {
+  Http2AdmissionControllerOptions options;
+  options.max_concurrent_requests = 100;
+  options.min_concurrent_requests = 10;
+  options.adaptive = true;
+  options.backoff_ratio = 0.5;
+  Http2AdmissionController controller(options);
+
+  EXPECT_TRUE(controller.TryAdmit());
+  controller.Release(kSlow);
+  EXPECT_EQ(controller.GetLimit(), 50);
+
+  // A single request at a time does not use half of the limit.
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_TRUE(controller.TryAdmit());
+    controller.Release(kFast);
+  }
+  EXPECT_EQ(controller.GetLimit(), 50);
+}
+
+}  // namespace
+}  // namespace privacy_sandbox::pbs_common
@@ -0,0 +1,115 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "cc/core/common/concurrent_map/src/concurrent_map.h"
+#include "cc/core/http2_server/src/http2_router.h"
+
+namespace privacy_sandbox::pbs_common {
+namespace {
+
+// The routes PBS registers, see cc/pbs/interface/type_def.h.
+const std::vector<std::pair<HttpMethod, std::string>>& PbsRoutes() {
+  static const auto* routes =
+      new std::vector<std::pair<HttpMethod, std::string>>({
+          {HttpMethod::POST, "/v1/transactions:health-check"},
+          {HttpMethod::POST, "/v1/transactions:consume-budget"},
+          {HttpMethod::POST, "/v1/transactions:begin"},
+          {HttpMethod::POST, "/v1/transactions:prepare"},
+          {HttpMethod::POST, "/v1/transactions:commit"},
+          {HttpMethod::POST, "/v1/transactions:notify"},
+          {HttpMethod::POST, "/v1/transactions:abort"},
+          {HttpMethod::POST, "/v1/transactions:end"},
+          {HttpMethod::GET, "/v1/transactions:status"},
+          {HttpMethod::GET, "/health"},
+      });
+  return *routes;
+}
+
+HttpHandler MakeHandler() {
+  return [](AsyncContext<HttpRequest, HttpResponse>&) {
+    return SuccessExecutionResult();
+  };
+}
+
+// Lookups through the nested ConcurrentMap registry Http2Server used before,
+// as a baseline.
+void BM_NestedConcurrentMapLookup(benchmark::State& state) {
+  ConcurrentMap<std::string,
+                std::shared_ptr<ConcurrentMap<HttpMethod, HttpHandler>>>
+      resource_handlers;
+  for (const auto& [method, path] : PbsRoutes()) {
+    auto method_handlers =
+        std::make_shared<ConcurrentMap<HttpMethod, HttpHandler>>();
+    resource_handlers.Insert(std::make_pair(path, method_handlers),
+                             method_handlers);
+    HttpHandler handler = MakeHandler();
+    method_handlers->Insert(std::make_pair(method, handler), handler);
+  }
+
+  size_t i = 0;
+  for (auto _ : state) {
+    const auto& [method, path] = PbsRoutes()[i++ % PbsRoutes().size()];
+    std::shared_ptr<ConcurrentMap<HttpMethod, HttpHandler>> method_handlers;
+    resource_handlers.Find(path, method_handlers);
+    HttpHandler handler;
+    benchmark::DoNotOptimize(method_handlers->Find(method, handler));
+  }
+}
+
+void BM_RouterLookup(benchmark::State& state) {
+  Http2Router router;
+  for (const auto& [method, path] : PbsRoutes()) {
+    Http2ResourceHandler resource_handler;
+    resource_handler.handler = MakeHandler();
+    router.AddRoute(method, path, std::move(resource_handler));
+  }
+
+  size_t i = 0;
+  for (auto _ : state) {
+    const auto& [method, path] = PbsRoutes()[i++ % PbsRoutes().size()];
+    benchmark::DoNotOptimize(router.Find(path, method));
+  }
+}
+
+// Requests for unknown paths are rejected without a handler lookup.
+void BM_RouterLookupNotFound(benchmark::State& state) {
+  Http2Router router;
+  for (const auto& [method, path] : PbsRoutes()) {
+    Http2ResourceHandler resource_handler;
+    resource_handler.handler = MakeHandler();
+    router.AddRoute(method, path, std::move(resource_handler));
+  }
+
+  const std::string path = "/v1/transactions:unknown";
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(router.Find(path, HttpMethod::POST));
+  }
+}
+
+BENCHMARK(BM_NestedConcurrentMapLookup)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_RouterLookup)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_RouterLookupNotFound);
+
+}  // namespace
+}  // namespace privacy_sandbox::pbs_common
+
+// Run the benchmark.
+BENCHMARK_MAIN();
@@ -0,0 +1,107 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cc/core/http2_server/src/http2_router.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cc/core/http2_server/src/error_codes.h"
+#include "cc/public/core/test/interface/execution_result_matchers.h"
+
+namespace privacy_sandbox::pbs_common {
+namespace {
+
+Http2ResourceHandler MakeHandler(HttpStatusCode code) {
+  Http2ResourceHandler resource_handler;
+  resource_handler.handler =
+      [code](AsyncContext<HttpRequest, HttpResponse>& context) {
+        context.response = std::make_shared<HttpResponse>();
+        context.response->code = code;
+        return SuccessExecutionResult();
+      };
+  return resource_handler;
+}
+
+HttpStatusCode Invoke(const Http2ResourceHandler& resource_handler) {
+  AsyncContext<HttpRequest, HttpResponse> context;
+  resource_handler.handler(context);
+  return context.response->code;
+}
+
+TEST(Http2RouterTest, FindsHandlerOfPathAndMethod) {
+  Http2Router router;
+  EXPECT_SUCCESS(router.AddRoute(HttpMethod::POST, "/v1/transactions:prepare",
+                                 MakeHandler(HttpStatusCode::OK)));
+  EXPECT_SUCCESS(router.AddRoute(HttpMethod::POST, "/v1/transactions:begin",
+                                 MakeHandler(HttpStatusCode::CREATED)));
+  EXPECT_SUCCESS(router.AddRoute(HttpMethod::GET, "/v1/transactions:begin",
+                                 MakeHandler(HttpStatusCode::ACCEPTED)));
+
+  auto prepare = router.Find("/v1/transactions:prepare", HttpMethod::POST);
+  ASSERT_SUCCESS(prepare);
+  EXPECT_EQ(Invoke(**prepare), HttpStatusCode::OK);
+
+  auto begin_post = router.Find("/v1/transactions:begin", HttpMethod::POST);
+  ASSERT_SUCCESS(begin_post);
+  EXPECT_EQ(Invoke(**begin_post), HttpStatusCode::CREATED);
+
+  auto begin_get = router.Find("/v1/transactions:begin", HttpMethod::GET);
+  ASSERT_SUCCESS(begin_get);
+  EXPECT_EQ(Invoke(**begin_get), HttpStatusCode::ACCEPTED);
+
+  EXPECT_EQ(router.GetPaths(),
+            std::vector<std::string>(
+                {"/v1/transactions:begin", "/v1/transactions:prepare"}));
+}
+
+TEST(Http2RouterTest, FindFailsForUnknownPathOrMethod) {
+  Http2Router router;
+  EXPECT_SUCCESS(router.AddRoute(HttpMethod::POST, "/v1/transactions:prepare",
+                                 MakeHandler(HttpStatusCode::OK)));
+
+  EXPECT_THAT(
+      router.Find("/v1/transactions:commit", HttpMethod::POST),
+      ResultIs(FailureExecutionResult(SC_HTTP2_SERVER_ROUTE_NOT_FOUND)));
+  // Prefixes of a path are not routed to it.
+  EXPECT_THAT(
+      router.Find("/v1/transactions", HttpMethod::POST),
+      ResultIs(FailureExecutionResult(SC_HTTP2_SERVER_ROUTE_NOT_FOUND)));
+  EXPECT_THAT(router.Find("/v1/transactions:prepare", HttpMethod::GET),
+              ResultIs(FailureExecutionResult(SC_HTTP2_SERVER_INVALID_METHOD)));
+  EXPECT_THAT(router.Find("/v1/transactions:prepare", HttpMethod::UNKNOWN),
+              ResultIs(FailureExecutionResult(SC_HTTP2_SERVER_INVALID_METHOD)));
+}
+
+TEST(Http2RouterTest, AddRouteFailsForDuplicateRouteOrUnknownMethod) {
+  Http2Router router;
+  EXPECT_SUCCESS(router.AddRoute(HttpMethod::POST, "/v1/transactions:prepare",
+                                 MakeHandler(HttpStatusCode::OK)));
+
+  EXPECT_THAT(router.AddRoute(HttpMethod::POST, "/v1/transactions:prepare",
+                              MakeHandler(HttpStatusCode::OK)),
+              ResultIs(FailureExecutionResult(
+                  SC_HTTP2_SERVER_HANDLER_ALREADY_REGISTERED)));
+  EXPECT_THAT(router.AddRoute(HttpMethod::UNKNOWN, "/v1/transactions:prepare",
+                              MakeHandler(HttpStatusCode::OK)),
+              ResultIs(FailureExecutionResult(SC_HTTP2_SERVER_INVALID_METHOD)));
+}
+
+}  // namespace
+}  // namespace privacy_sandbox::pbs_common
@@ -16,36 +16,51 @@
 
 #include "cc/core/http2_server/src/http2_server.h"
 
+#include <arpa/inet.h>
+#include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
 
 #include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
 #include <future>
 #include <map>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <utility>
 #include <vector>
 
+#include <nghttp2/nghttp2.h>
+
 #include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
 #include "absl/synchronization/blocking_counter.h"
 #include "cc/core/async_executor/mock/mock_async_executor.h"
 #include "cc/core/async_executor/src/async_executor.h"
 #include "cc/core/authorization_proxy/mock/mock_authorization_proxy.h"
 #include "cc/core/authorization_proxy/src/pass_thru_authorization_proxy.h"
-#include "cc/core/common/concurrent_map/src/error_codes.h"
 #include "cc/core/common/uuid/src/uuid.h"
 #include "cc/core/config_provider/mock/mock_config_provider.h"
 #include "cc/core/config_provider/src/env_config_provider.h"
+#include "cc/core/http2_client/src/error_codes.h"
 #include "cc/core/http2_client/src/http2_client.h"
 #include "cc/core/http2_server/mock/mock_http2_request_with_overrides.h"
 #include "cc/core/http2_server/mock/mock_http2_response_with_overrides.h"
 #include "cc/core/http2_server/mock/mock_http2_server_with_overrides.h"
 #include "cc/core/http2_server/src/error_codes.h"
+#include "cc/core/http2_server/src/http2_object_pool.h"
 #include "cc/core/telemetry/mock/in_memory_metric_router.h"
 #include "cc/core/telemetry/src/common/metric_utils.h"
 #include "cc/core/test/utils/conditional_wait.h"
 #include "cc/core/utils/src/base64.h"
+#include "cc/core/utils/src/compression.h"
+#include "cc/core/utils/src/error_codes.h"
 #include "cc/public/core/interface/execution_result.h"
 #include "cc/public/core/test/interface/execution_result_matchers.h"
 #include "nlohmann/json.hpp"
@@ -63,6 +78,8 @@ class Http2ServerPeer {
 namespace {
 using ::opentelemetry::sdk::resource::SemanticConventions::
     kHttpResponseStatusCode;
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
 using ::testing::Return;
 
 class Http2ServerTest : public testing::Test {
@@ -109,6 +126,24 @@ std::shared_ptr<MockNgHttp2RequestWithOverrides> CreateMockRequest(
   return mock_http2_request;
 }
 
+class FakeBodyConsumer : public HttpRequestBodyConsumerInterface {
+ public:
+  ExecutionResult OnBodyChunk(std::string_view chunk) noexcept override {
+    chunks.emplace_back(chunk);
+    return chunk_result;
+  }
+
+  ExecutionResult OnBodyComplete(
+      AsyncContext<HttpRequest, HttpResponse>& http_context) noexcept override {
+    completed = true;
+    return SuccessExecutionResult();
+  }
+
+  std::vector<std::string> chunks;
+  ExecutionResult chunk_result = SuccessExecutionResult();
+  bool completed = false;
+};
+
 TEST_F(Http2ServerTest, Run) {
   std::string host_address("localhost");
   std::string port("0");
@@ -159,7 +194,20 @@ TEST_F(Http2ServerTest, RegisterHandlers) {
 
   EXPECT_THAT(
       http_server.RegisterResourceHandler(HttpMethod::GET, path, callback),
-      ResultIs(FailureExecutionResult(SC_CONCURRENT_MAP_ENTRY_ALREADY_EXISTS)));
+      ResultIs(
+          FailureExecutionResult(SC_HTTP2_SERVER_HANDLER_ALREADY_REGISTERED)));
+
+  HttpStreamingHandler streaming_callback = [](const HttpRequest&) {
+    return std::make_shared<FakeBodyConsumer>();
+  };
+  EXPECT_SUCCESS(http_server.RegisterStreamingResourceHandler(
+      HttpMethod::POST, path, streaming_callback,
+      1024 /* max request body size */));
+  EXPECT_THAT(http_server.RegisterStreamingResourceHandler(
+                  HttpMethod::POST, path, streaming_callback,
+                  1024 /* max request body size */),
+              ResultIs(FailureExecutionResult(
+                  SC_HTTP2_SERVER_HANDLER_ALREADY_REGISTERED)));
 }
 
 TEST_F(Http2ServerTest, HandleHttp2Request) {
@@ -194,17 +242,79 @@ TEST_F(Http2ServerTest, HandleHttp2Request) {
       [](AsyncContext<NgHttp2Request, NgHttp2Response>&) {});
   ng_http2_context.response = mock_http2_response;
 
-  http_server.HandleHttp2Request(ng_http2_context, callback);
-  std::shared_ptr<MockHttp2ServerWithOverrides::Http2SynchronizationContext>
-      sync_context;
-  EXPECT_EQ(http_server.GetActiveRequests().Find(ng_http2_context.request->id,
-                                                 sync_context),
-            SuccessExecutionResult());
+  auto sync_context = std::make_shared<
+      MockHttp2ServerWithOverrides::Http2SynchronizationContext>();
+  http_server.HandleHttp2Request(ng_http2_context, callback, sync_context);
+  EXPECT_EQ(http_server.GetActiveRequestsCount(), 1);
+  EXPECT_EQ(sync_context->http2_context.request, ng_http2_context.request);
   EXPECT_EQ(sync_context->failed.load(), false);
   EXPECT_EQ(sync_context->pending_callbacks.load(), 2);
   EXPECT_TRUE(mock_http2_request->IsOnRequestBodyDataReceivedCallbackSet());
 }
 
+TEST_F(Http2ServerTest, OnHttp2CleanupReleasesTheRequestAndItsBody) {
+  std::string host_address("localhost");
+  std::string port("0");
+
+  auto mock_authorization_proxy = std::make_shared<MockAuthorizationProxy>();
+  std::shared_ptr<AuthorizationProxyInterface> authorization_proxy =
+      mock_authorization_proxy;
+  EXPECT_CALL(*mock_authorization_proxy, Authorize)
+      .WillOnce(Return(SuccessExecutionResult()));
+  std::shared_ptr<AuthorizationProxyInterface> mock_aws_authorization_proxy =
+      std::make_shared<MockAuthorizationProxy>();
+  std::shared_ptr<AsyncExecutorInterface> async_executor =
+      std::make_shared<MockAsyncExecutor>();
+  MockHttp2ServerWithOverrides http_server(
+      host_address, port, async_executor, authorization_proxy,
+      mock_aws_authorization_proxy, mock_config_provider_,
+      metric_router_.get());
+
+  HttpHandler callback = [](AsyncContext<HttpRequest, HttpResponse>&) {
+    return SuccessExecutionResult();
+  };
+
+  nghttp2::asio_http2::server::request request;
+  nghttp2::asio_http2::server::response response;
+  using RequestPool = Http2ObjectPool<MockNgHttp2RequestWithOverrides>;
+  auto pooled_request = RequestPool::Acquire(request);
+  MockNgHttp2RequestWithOverrides* pooled_request_address =
+      pooled_request.get();
+  pooled_request->headers = CreateMockRequest()->headers;
+  std::shared_ptr<std::vector<Byte>> body = pooled_request->body.bytes;
+  {
+    AsyncContext<NgHttp2Request, NgHttp2Response> ng_http2_context(
+        std::move(pooled_request),
+        [](AsyncContext<NgHttp2Request, NgHttp2Response>&) {});
+    ng_http2_context.response =
+        std::make_shared<MockNgHttp2ResponseWithOverrides>(response);
+    auto sync_context = std::make_shared<
+        MockHttp2ServerWithOverrides::Http2SynchronizationContext>();
+    http_server.HandleHttp2Request(ng_http2_context, callback, sync_context);
+    ng_http2_context.request.reset();
+    ng_http2_context.response.reset();
+    body.reset();
+
+    // The authorization and the body are received, then the stream closes.
+    http_server.OnHttp2PendingCallback(SuccessExecutionResult(), sync_context);
+    http_server.OnHttp2PendingCallback(SuccessExecutionResult(), sync_context);
+    EXPECT_NE(sync_context->http2_context.request, nullptr);
+    http_server.OnHttp2Cleanup(*sync_context, /*error_code=*/0);
+
+    EXPECT_EQ(sync_context->http2_context.request, nullptr);
+    EXPECT_EQ(sync_context->http2_context.response, nullptr);
+    EXPECT_EQ(sync_context->http_handler, nullptr);
+  }
+  // The request went back to its pool, which released its data.
+  pooled_request = RequestPool::Acquire(request);
+  EXPECT_EQ(pooled_request.get(), pooled_request_address);
+  EXPECT_EQ(pooled_request->headers, nullptr);
+  EXPECT_THAT(pooled_request->metric_labels, IsEmpty());
+  EXPECT_EQ(pooled_request->body.length, 0);
+  ASSERT_NE(pooled_request->body.bytes, nullptr);
+  EXPECT_THAT(*pooled_request->body.bytes, IsEmpty());
+}
+
 TEST_F(Http2ServerTest, HandleHttp2RequestWithAwsProxy) {
   std::string host_address("localhost");
   std::string port("0");
@@ -238,17 +348,61 @@ TEST_F(Http2ServerTest, HandleHttp2RequestWithAwsProxy) {
       [](AsyncContext<NgHttp2Request, NgHttp2Response>&) {});
   ng_http2_context.response = mock_http2_response;
 
-  http_server.HandleHttp2Request(ng_http2_context, callback);
-  std::shared_ptr<MockHttp2ServerWithOverrides::Http2SynchronizationContext>
-      sync_context;
-  EXPECT_EQ(http_server.GetActiveRequests().Find(ng_http2_context.request->id,
-                                                 sync_context),
-            SuccessExecutionResult());
+  auto sync_context = std::make_shared<
+      MockHttp2ServerWithOverrides::Http2SynchronizationContext>();
+  http_server.HandleHttp2Request(ng_http2_context, callback, sync_context);
+  EXPECT_EQ(http_server.GetActiveRequestsCount(), 1);
+  EXPECT_EQ(sync_context->http2_context.request, ng_http2_context.request);
   EXPECT_EQ(sync_context->failed.load(), false);
   EXPECT_EQ(sync_context->pending_callbacks.load(), 2);
   EXPECT_TRUE(mock_http2_request->IsOnRequestBodyDataReceivedCallbackSet());
 }
 
+TEST_F(Http2ServerTest, HandleHttp2RequestWithJwtUsesGcpProxy) {
+  std::string host_address("localhost");
+  std::string port("0");
+
+  std::shared_ptr<MockAuthorizationProxy> mock_gcp_authorization_proxy =
+      std::make_shared<MockAuthorizationProxy>();
+  EXPECT_CALL(*mock_gcp_authorization_proxy, Authorize)
+      .WillOnce(Return(SuccessExecutionResult()));
+  std::shared_ptr<MockAuthorizationProxy> mock_aws_authorization_proxy =
+      std::make_shared<MockAuthorizationProxy>();
+  EXPECT_CALL(*mock_aws_authorization_proxy, Authorize).Times(0);
+  std::shared_ptr<AsyncExecutorInterface> async_executor =
+      std::make_shared<MockAsyncExecutor>();
+  MockHttp2ServerWithOverrides http_server(
+      host_address, port, async_executor, mock_gcp_authorization_proxy,
+      mock_aws_authorization_proxy, mock_config_provider_,
+      metric_router_.get());
+
+  HttpHandler callback = [](AsyncContext<HttpRequest, HttpResponse>&) {
+    return SuccessExecutionResult();
+  };
+
+  // A JWT is never routed to the AWS proxy, even if its payload has the field
+  // of AWS tokens.
+  std::string encoded_payload;
+  Base64Encode(R"({"amz_date":"hello_date_value"})", encoded_payload);
+  auto mock_http2_request = CreateMockRequest();
+  mock_http2_request->headers->erase(kAuthHeader);
+  mock_http2_request->headers->insert(
+      {kAuthHeader, absl::StrCat("eyJhbGciOiJSUzI1NiJ9.", encoded_payload,
+                                 ".c2lnbmF0dXJl")});
+
+  nghttp2::asio_http2::server::response response;
+  AsyncContext<NgHttp2Request, NgHttp2Response> ng_http2_context(
+      mock_http2_request,
+      [](AsyncContext<NgHttp2Request, NgHttp2Response>&) {});
+  ng_http2_context.response =
+      std::make_shared<MockNgHttp2ResponseWithOverrides>(response);
+
+  auto sync_context = std::make_shared<
+      MockHttp2ServerWithOverrides::Http2SynchronizationContext>();
+  http_server.HandleHttp2Request(ng_http2_context, callback, sync_context);
+  EXPECT_EQ(sync_context->pending_callbacks.load(), 2);
+}
+
 TEST_F(Http2ServerTest, HandleHttp2RequestWithAwsProxyAndGcpProxy) {
   std::string host_address("localhost");
   std::string port("0");
@@ -284,28 +438,27 @@ TEST_F(Http2ServerTest, HandleHttp2RequestWithAwsProxyAndGcpProxy) {
       [](AsyncContext<NgHttp2Request, NgHttp2Response>&) {});
   ng_http2_gcp_context.response = mock_http2_response;
 
+  auto aws_sync_context = std::make_shared<
+      MockHttp2ServerWithOverrides::Http2SynchronizationContext>();
   EXPECT_CALL(*mock_aws_authorization_proxy, Authorize)
       .WillOnce(Return(SuccessExecutionResult()));
-  http_server.HandleHttp2Request(ng_http2_aws_context, callback);
+  http_server.HandleHttp2Request(ng_http2_aws_context, callback,
+                                 aws_sync_context);
 
+  auto gcp_sync_context = std::make_shared<
+      MockHttp2ServerWithOverrides::Http2SynchronizationContext>();
   EXPECT_CALL(*mock_gcp_authorization_proxy, Authorize)
       .WillOnce(Return(SuccessExecutionResult()));
-  http_server.HandleHttp2Request(ng_http2_gcp_context, callback);
+  http_server.HandleHttp2Request(ng_http2_gcp_context, callback,
+                                 gcp_sync_context);
 
-  std::shared_ptr<MockHttp2ServerWithOverrides::Http2SynchronizationContext>
-      sync_context;
-  EXPECT_EQ(http_server.GetActiveRequests().Find(
-                ng_http2_aws_context.request->id, sync_context),
-            SuccessExecutionResult());
-  EXPECT_EQ(sync_context->failed.load(), false);
-  EXPECT_EQ(sync_context->pending_callbacks.load(), 2);
+  EXPECT_EQ(http_server.GetActiveRequestsCount(), 2);
+  EXPECT_EQ(aws_sync_context->failed.load(), false);
+  EXPECT_EQ(aws_sync_context->pending_callbacks.load(), 2);
   EXPECT_TRUE(mock_http2_aws_request->IsOnRequestBodyDataReceivedCallbackSet());
 
-  EXPECT_EQ(http_server.GetActiveRequests().Find(
-                ng_http2_gcp_context.request->id, sync_context),
-            SuccessExecutionResult());
-  EXPECT_EQ(sync_context->failed.load(), false);
-  EXPECT_EQ(sync_context->pending_callbacks.load(), 2);
+  EXPECT_EQ(gcp_sync_context->failed.load(), false);
+  EXPECT_EQ(gcp_sync_context->pending_callbacks.load(), 2);
   EXPECT_TRUE(mock_http2_gcp_request->IsOnRequestBodyDataReceivedCallbackSet());
 }
 
@@ -355,12 +508,9 @@ TEST_F(Http2ServerTest,
       [](AsyncContext<NgHttp2Request, NgHttp2Response>&) {});
   ng_http2_context.response = mock_http2_response;
 
-  http_server.HandleHttp2Request(ng_http2_context, callback);
-  std::shared_ptr<MockHttp2ServerWithOverrides::Http2SynchronizationContext>
-      sync_context;
-  EXPECT_EQ(http_server.GetActiveRequests().Find(ng_http2_context.request->id,
-                                                 sync_context),
-            SuccessExecutionResult());
+  auto sync_context = std::make_shared<
+      MockHttp2ServerWithOverrides::Http2SynchronizationContext>();
+  http_server.HandleHttp2Request(ng_http2_context, callback, sync_context);
   EXPECT_EQ(sync_context->failed.load(), false);
   EXPECT_EQ(
       *sync_context->http2_context.request->auth_context.authorized_domain,
@@ -403,17 +553,11 @@ TEST_F(Http2ServerTest, HandleHttp2RequestFailed) {
 
   auto sync_context = std::make_shared<
       MockHttp2ServerWithOverrides::Http2SynchronizationContext>();
-  sync_context->failed = false;
-  sync_context->pending_callbacks = 1;
-  sync_context->http2_context = ng_http2_context;
-  sync_context->http_handler = callback;
 
-  http_server.HandleHttp2Request(ng_http2_context, callback);
+  http_server.HandleHttp2Request(ng_http2_context, callback, sync_context);
+  EXPECT_EQ(http_server.GetActiveRequestsCount(), 1);
   http_server.OnHttp2Cleanup(*sync_context, /*error_code=*/0);
-
-  EXPECT_EQ(http_server.GetActiveRequests().Find(ng_http2_context.request->id,
-                                                 sync_context),
-            FailureExecutionResult(SC_CONCURRENT_MAP_ENTRY_DOES_NOT_EXIST));
+  EXPECT_EQ(http_server.GetActiveRequestsCount(), 0);
 
   WaitUntil([&]() { return should_continue; });
 }
@@ -746,23 +890,19 @@ TEST_F(Http2ServerTest, OnHttp2PendingCallbackFailure) {
   sync_context->http2_context = ng_http2_context;
   sync_context->http_handler = callback;
 
-  auto pair = make_pair(ng_http2_context.request->id, sync_context);
-  EXPECT_SUCCESS(http_server.GetActiveRequests().Insert(pair, sync_context));
-
   auto callback_execution_result = FailureExecutionResult(1234);
-  auto request_id = ng_http2_context.request->id;
-  http_server.OnHttp2PendingCallback(callback_execution_result, request_id);
+  http_server.OnHttp2PendingCallback(callback_execution_result, sync_context);
   WaitUntil([&]() { return should_continue; });
 
-  EXPECT_SUCCESS(
-      http_server.GetActiveRequests().Find(request_id, sync_context));
   EXPECT_EQ(sync_context->failed.load(), true);
-
-  http_server.OnHttp2PendingCallback(callback_execution_result, request_id);
-  http_server.OnHttp2Cleanup(*sync_context, /*error_code=*/0);
-  EXPECT_THAT(
-      http_server.GetActiveRequests().Find(request_id, sync_context),
-      ResultIs(FailureExecutionResult(SC_CONCURRENT_MAP_ENTRY_DOES_NOT_EXIST)));
+  EXPECT_EQ(sync_context->pending_callbacks.load(), 1);
+
+  // The second failure neither finishes the context again nor runs the
+  // handler.
+  should_continue = false;
+  http_server.OnHttp2PendingCallback(callback_execution_result, sync_context);
+  EXPECT_EQ(sync_context->pending_callbacks.load(), 0);
+  EXPECT_FALSE(should_continue);
 }
 
 TEST_F(Http2ServerTest, OnHttp2PendingCallbackHttpHandlerFailure) {
@@ -807,12 +947,8 @@ TEST_F(Http2ServerTest, OnHttp2PendingCallbackHttpHandlerFailure) {
   sync_context->http2_context = ng_http2_context;
   sync_context->http_handler = callback;
 
-  auto pair = make_pair(ng_http2_context.request->id, sync_context);
-  EXPECT_SUCCESS(http_server.GetActiveRequests().Insert(pair, sync_context));
-
   auto callback_execution_result = SuccessExecutionResult();
-  auto request_id = ng_http2_context.request->id;
-  http_server.OnHttp2PendingCallback(callback_execution_result, request_id);
+  http_server.OnHttp2PendingCallback(callback_execution_result, sync_context);
   WaitUntil([&]() { return should_continue; });
 
   std::vector<opentelemetry::sdk::metrics::ResourceMetrics> data =
@@ -1075,6 +1211,530 @@ TEST_F(Http2ServerTest, ShouldHandleRequestProperlyWhenTlsIsEnabled) {
   async_executor->Stop();
 }
 
+TEST_F(Http2ServerTest, ShouldServeRequestsOnAllReusePortListeners) {
+  std::string host_address("localhost");
+  std::string port("0");
+
+  std::shared_ptr<MockAuthorizationProxy> mock_authorization_proxy =
+      std::make_shared<MockAuthorizationProxy>();
+  std::shared_ptr<AuthorizationProxyInterface> mock_aws_authorization_proxy =
+      std::make_shared<MockAuthorizationProxy>();
+  EXPECT_CALL(*mock_authorization_proxy, Authorize)
+      .WillRepeatedly([](auto& context) {
+        context.response = std::make_shared<AuthorizationProxyResponse>();
+        context.response->authorized_metadata.authorized_domain =
+            std::make_shared<std::string>(
+                context.request->authorization_metadata.claimed_identity);
+        context.result = SuccessExecutionResult();
+        context.Finish();
+        return SuccessExecutionResult();
+      });
+  std::shared_ptr<AuthorizationProxyInterface> authorization_proxy =
+      mock_authorization_proxy;
+  std::shared_ptr<AsyncExecutorInterface> async_executor =
+      std::make_shared<AsyncExecutor>(8, 100, true);
+
+  Http2ServerOptions http2_server_options;
+  http2_server_options.reuse_port_listeners = 4;
+  Http2Server http_server(host_address, port, 2 /* thread_pool_size */,
+                          async_executor, authorization_proxy,
+                          mock_aws_authorization_proxy, mock_config_provider_,
+                          http2_server_options, metric_router_.get());
+
+  std::string test_path("/test");
+  HttpHandler handler_callback =
+      [](AsyncContext<HttpRequest, HttpResponse>& context) {
+        context.result = SuccessExecutionResult();
+        context.response->body = BytesBuffer("hello, world\r\n");
+        context.Finish();
+        return SuccessExecutionResult();
+      };
+  http_server.RegisterResourceHandler(HttpMethod::GET, test_path,
+                                      handler_callback);
+
+  EXPECT_SUCCESS(http_server.Init());
+  EXPECT_SUCCESS(http_server.Run());
+  EXPECT_EQ(http_server.GetRequestCountPerListener().size(), 4);
+
+  port = std::to_string(Http2ServerPeer::PortInUse(http_server));
+
+  // Every connection of the client is accepted by one of the listeners.
+  HttpClientOptions client_options(
+      RetryStrategyOptions(RetryStrategyType::Linear,
+                           /* delay in ms */ 100, /* num retries */ 5),
+      /* max connections per host */ 8, /* read timeout in sec */ 5);
+  HttpClient http_client(async_executor, client_options);
+  http_client.Init();
+  http_client.Run();
+  async_executor->Init();
+  async_executor->Run();
+
+  constexpr int kRequestCount = 16;
+  absl::BlockingCounter blocking(kRequestCount);
+  for (int i = 0; i < kRequestCount; ++i) {
+    auto request = std::make_shared<HttpRequest>();
+    request->method = HttpMethod::GET;
+    request->path =
+        std::make_shared<std::string>("http://localhost:" + port + test_path);
+    std::string encoded_token;
+    Base64Encode(nlohmann::json().dump(), encoded_token);
+    request->headers = std::make_shared<HttpHeaders>();
+    request->headers->insert({kAuthHeader, encoded_token});
+
+    AsyncContext<HttpRequest, HttpResponse> context(
+        std::move(request),
+        [&](AsyncContext<HttpRequest, HttpResponse>& context) {
+          EXPECT_SUCCESS(context.result);
+          blocking.DecrementCount();
+        });
+    SubmitUntilSuccess(http_client, context);
+  }
+  blocking.Wait();
+
+  int64_t total_request_count = 0;
+  for (int64_t request_count : http_server.GetRequestCountPerListener()) {
+    total_request_count += request_count;
+  }
+  EXPECT_EQ(total_request_count, kRequestCount);
+
+  http_client.Stop();
+  EXPECT_SUCCESS(http_server.Stop());
+  async_executor->Stop();
+}
+
+TEST_F(Http2ServerTest, HandlersSeeTheRequestHeaders) {
+  std::string host_address("localhost");
+  std::string port("0");
+
+  std::shared_ptr<MockAuthorizationProxy> mock_authorization_proxy =
+      std::make_shared<MockAuthorizationProxy>();
+  std::shared_ptr<AuthorizationProxyInterface> mock_aws_authorization_proxy =
+      std::make_shared<MockAuthorizationProxy>();
+  EXPECT_CALL(*mock_authorization_proxy, Authorize)
+      .WillOnce([](auto& context) {
+        EXPECT_FALSE(
+            context.request->authorization_metadata.authorization_token
+                .empty());
+        context.response = std::make_shared<AuthorizationProxyResponse>();
+        context.response->authorized_metadata.authorized_domain =
+            std::make_shared<std::string>(
+                context.request->authorization_metadata.claimed_identity);
+        context.result = SuccessExecutionResult();
+        context.Finish();
+        return SuccessExecutionResult();
+      });
+  std::shared_ptr<AuthorizationProxyInterface> authorization_proxy =
+      mock_authorization_proxy;
+  std::shared_ptr<AsyncExecutorInterface> async_executor =
+      std::make_shared<AsyncExecutor>(8, 100, true);
+
+  Http2Server http_server(host_address, port, 2 /* thread_pool_size */,
+                          async_executor, authorization_proxy,
+                          mock_aws_authorization_proxy, mock_config_provider_,
+                          Http2ServerOptions(), metric_router_.get());
+
+  std::string test_path("/test");
+  HttpHandler handler_callback =
+      [](AsyncContext<HttpRequest, HttpResponse>& context) {
+        const auto& headers = *context.request->headers;
+        auto test_header = headers.find("x-test-header");
+        EXPECT_NE(test_header, headers.end());
+        EXPECT_EQ(test_header->second, "test value");
+        EXPECT_EQ(headers.count(kClaimedIdentityHeader), 1);
+        // The Content-Encoding is consumed by the server.
+        EXPECT_FALSE(headers.contains(kContentEncodingHeader));
+        EXPECT_EQ(*context.request->auth_context.authorized_domain,
+                  "https://origin.site.com");
+        context.result = SuccessExecutionResult();
+        context.Finish();
+        return SuccessExecutionResult();
+      };
+  http_server.RegisterResourceHandler(HttpMethod::GET, test_path,
+                                      handler_callback);
+
+  EXPECT_SUCCESS(http_server.Init());
+  EXPECT_SUCCESS(http_server.Run());
+  port = std::to_string(Http2ServerPeer::PortInUse(http_server));
+
+  HttpClient http_client(async_executor);
+  http_client.Init();
+  http_client.Run();
+  async_executor->Init();
+  async_executor->Run();
+
+  auto request = std::make_shared<HttpRequest>();
+  request->method = HttpMethod::GET;
+  request->path =
+      std::make_shared<std::string>("http://localhost:" + port + test_path);
+  std::string encoded_token;
+  Base64Encode(nlohmann::json().dump(), encoded_token);
+  request->headers = std::make_shared<HttpHeaders>();
+  request->headers->insert({kAuthHeader, encoded_token});
+  request->headers->insert({kClaimedIdentityHeader, "https://origin.site.com"});
+  request->headers->insert({"x-test-header", "test value"});
+  request->headers->insert({kContentEncodingHeader, "identity"});
+
+  std::promise<void> done;
+  AsyncContext<HttpRequest, HttpResponse> context(
+      std::move(request),
+      [&](AsyncContext<HttpRequest, HttpResponse>& context) {
+        EXPECT_SUCCESS(context.result);
+        done.set_value();
+      });
+  SubmitUntilSuccess(http_client, context);
+  done.get_future().get();
+
+  http_client.Stop();
+  EXPECT_SUCCESS(http_server.Stop());
+  async_executor->Stop();
+}
+
+TEST_F(Http2ServerTest, StopLetsInFlightRequestsCompleteWhenDraining) {
+  std::string host_address("localhost");
+  std::string port("0");
+
+  std::shared_ptr<MockAuthorizationProxy> mock_authorization_proxy =
+      std::make_shared<MockAuthorizationProxy>();
+  std::shared_ptr<AuthorizationProxyInterface> mock_aws_authorization_proxy =
+      std::make_shared<MockAuthorizationProxy>();
+  EXPECT_CALL(*mock_authorization_proxy, Authorize).WillOnce([](auto& context) {
+    context.response = std::make_shared<AuthorizationProxyResponse>();
+    context.response->authorized_metadata.authorized_domain =
+        std::make_shared<std::string>(
+            context.request->authorization_metadata.claimed_identity);
+    context.result = SuccessExecutionResult();
+    context.Finish();
+    return SuccessExecutionResult();
+  });
+  std::shared_ptr<AuthorizationProxyInterface> authorization_proxy =
+      mock_authorization_proxy;
+  std::shared_ptr<AsyncExecutorInterface> async_executor =
+      std::make_shared<AsyncExecutor>(8, 100, true);
+
+  Http2ServerOptions http2_server_options;
+  http2_server_options.drain_timeout_ms = 10000;
+  Http2Server http_server(host_address, port, 2 /* thread_pool_size */,
+                          async_executor, authorization_proxy,
+                          mock_aws_authorization_proxy, mock_config_provider_,
+                          http2_server_options, metric_router_.get());
+
+  // Completes the request from another thread once the server is stopping.
+  std::promise<void> request_received;
+  std::thread responder;
+  std::string test_path("/test");
+  HttpHandler handler_callback =
+      [&](AsyncContext<HttpRequest, HttpResponse>& context) {
+        responder = std::thread([context]() mutable {
+          std::this_thread::sleep_for(std::chrono::milliseconds(500));
+          context.result = SuccessExecutionResult();
+          context.response->body = BytesBuffer("drained");
+          context.Finish();
+        });
+        request_received.set_value();
+        return SuccessExecutionResult();
+      };
+  http_server.RegisterResourceHandler(HttpMethod::GET, test_path,
+                                      handler_callback);
+
+  EXPECT_SUCCESS(http_server.Init());
+  EXPECT_SUCCESS(http_server.Run());
+  port = std::to_string(Http2ServerPeer::PortInUse(http_server));
+
+  HttpClient http_client(async_executor);
+  http_client.Init();
+  http_client.Run();
+  async_executor->Init();
+  async_executor->Run();
+
+  auto request = std::make_shared<HttpRequest>();
+  request->method = HttpMethod::GET;
+  request->path =
+      std::make_shared<std::string>("http://localhost:" + port + test_path);
+  std::string encoded_token;
+  Base64Encode(nlohmann::json().dump(), encoded_token);
+  request->headers = std::make_shared<HttpHeaders>();
+  request->headers->insert({kAuthHeader, encoded_token});
+
+  std::promise<void> done;
+  AsyncContext<HttpRequest, HttpResponse> context(
+      std::move(request),
+      [&](AsyncContext<HttpRequest, HttpResponse>& context) {
+        EXPECT_SUCCESS(context.result);
+        const auto& bytes = *context.response->body.bytes;
+        EXPECT_EQ(std::string(bytes.begin(), bytes.end()), "drained");
+        done.set_value();
+      });
+  SubmitUntilSuccess(http_client, context);
+
+  // The request is in flight while the server stops.
+  request_received.get_future().get();
+  EXPECT_SUCCESS(http_server.Stop());
+  done.get_future().get();
+  responder.join();
+
+  http_client.Stop();
+  async_executor->Stop();
+}
+
+// The frames received by a raw HTTP/2 client, to check the frame order.
+struct ReceivedFrames {
+  bool response_received = false;
+  std::vector<int32_t> goaway_last_stream_ids;
+};
+
+int OnClientFrameReceived(nghttp2_session* session, const nghttp2_frame* frame,
+                          void* user_data) {
+  auto* frames = static_cast<ReceivedFrames*>(user_data);
+  if (frame->hd.type == NGHTTP2_HEADERS && frame->hd.stream_id == 1) {
+    frames->response_received = true;
+  } else if (frame->hd.type == NGHTTP2_GOAWAY) {
+    frames->goaway_last_stream_ids.push_back(frame->goaway.last_stream_id);
+  }
+  return 0;
+}
+
+nghttp2_nv MakeHeader(const char* name, const char* value) {
+  return {reinterpret_cast<uint8_t*>(const_cast<char*>(name)),
+          reinterpret_cast<uint8_t*>(const_cast<char*>(value)), strlen(name),
+          strlen(value), NGHTTP2_NV_FLAG_NONE};
+}
+
+// Writes the pending frames of the session to the socket.
+bool SendFrames(nghttp2_session* session, int fd) {
+  const uint8_t* data;
+  ssize_t length;
+  while ((length = nghttp2_session_mem_send(session, &data)) > 0) {
+    if (send(fd, data, length, MSG_NOSIGNAL) != length) {
+      return false;
+    }
+  }
+  return length == 0;
+}
+
+// Reads frames from the socket until done returns true or the connection
+// closes.
+template <typename Done>
+void ReceiveFrames(nghttp2_session* session, int fd, Done done) {
+  std::array<uint8_t, 16384> buffer;
+  while (!done()) {
+    ssize_t length = recv(fd, buffer.data(), buffer.size(), 0);
+    if (length <= 0 ||
+        nghttp2_session_mem_recv(session, buffer.data(), length) < 0 ||
+        !SendFrames(session, fd)) {
+      return;
+    }
+  }
+}
+
+TEST_F(Http2ServerTest, StopSendsTheFinalGoAwayBeforeClosingConnections) {
+  std::string host_address("127.0.0.1");
+  std::string port("0");
+
+  std::shared_ptr<AuthorizationProxyInterface> mock_authorization_proxy =
+      std::make_shared<MockAuthorizationProxy>();
+  std::shared_ptr<AuthorizationProxyInterface> mock_aws_authorization_proxy =
+      std::make_shared<MockAuthorizationProxy>();
+  std::shared_ptr<AsyncExecutorInterface> async_executor =
+      std::make_shared<MockAsyncExecutor>();
+
+  Http2ServerOptions http2_server_options;
+  http2_server_options.drain_timeout_ms = 10000;
+  Http2Server http_server(host_address, port, 2 /* thread_pool_size */,
+                          async_executor, mock_authorization_proxy,
+                          mock_aws_authorization_proxy, mock_config_provider_,
+                          http2_server_options, metric_router_.get());
+  EXPECT_SUCCESS(http_server.Init());
+  EXPECT_SUCCESS(http_server.Run());
+
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  ASSERT_GE(fd, 0);
+  sockaddr_in address = {};
+  address.sin_family = AF_INET;
+  address.sin_port = htons(Http2ServerPeer::PortInUse(http_server));
+  inet_pton(AF_INET, host_address.c_str(), &address.sin_addr);
+  ASSERT_EQ(
+      connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)), 0);
+  // Fails the test rather than hanging it if a frame never comes.
+  timeval timeout = {.tv_sec = 10, .tv_usec = 0};
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+  ReceivedFrames frames;
+  nghttp2_session_callbacks* callbacks;
+  nghttp2_session_callbacks_new(&callbacks);
+  nghttp2_session_callbacks_set_on_frame_recv_callback(callbacks,
+                                                       OnClientFrameReceived);
+  nghttp2_session* session;
+  nghttp2_session_client_new(&session, callbacks, &frames);
+  nghttp2_session_callbacks_del(callbacks);
+
+  // Any request is processed, an unknown path is answered right away.
+  nghttp2_submit_settings(session, NGHTTP2_FLAG_NONE, nullptr, 0);
+  std::string authority = absl::StrCat(host_address, ":",
+                                       Http2ServerPeer::PortInUse(http_server));
+  std::array<nghttp2_nv, 4> headers = {
+      MakeHeader(":method", "GET"), MakeHeader(":scheme", "http"),
+      MakeHeader(":authority", authority.c_str()),
+      MakeHeader(":path", "/unknown")};
+  EXPECT_EQ(nghttp2_submit_request(session, nullptr, headers.data(),
+                                   headers.size(), nullptr, nullptr),
+            1);
+  EXPECT_TRUE(SendFrames(session, fd));
+  ReceiveFrames(session, fd, [&]() { return frames.response_received; });
+  EXPECT_TRUE(frames.response_received);
+
+  std::thread stopper([&]() { EXPECT_SUCCESS(http_server.Stop()); });
+  ReceiveFrames(session, fd,
+                [&]() { return frames.goaway_last_stream_ids.size() == 2; });
+  // The server stopped accepting before draining the connections.
+  int new_fd = socket(AF_INET, SOCK_STREAM, 0);
+  EXPECT_NE(
+      connect(new_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)),
+      0);
+  close(new_fd);
+  stopper.join();
+  nghttp2_session_del(session);
+  close(fd);
+
+  // The shutdown notice, then the final GOAWAY with the last stream served,
+  // both before the server stopped.
+  constexpr int32_t kMaxStreamId = (1u << 31) - 1;
+  EXPECT_THAT(frames.goaway_last_stream_ids,
+              ElementsAre(kMaxStreamId, 1));
+}
+
+TEST_F(Http2ServerTest, RejectsRequestsOverTheRouteLimit) {
+  std::string host_address("localhost");
+  std::string port("0");
+
+  std::shared_ptr<MockAuthorizationProxy> mock_authorization_proxy =
+      std::make_shared<MockAuthorizationProxy>();
+  std::shared_ptr<AuthorizationProxyInterface> mock_aws_authorization_proxy =
+      std::make_shared<MockAuthorizationProxy>();
+  EXPECT_CALL(*mock_authorization_proxy, Authorize)
+      .WillRepeatedly([](auto& context) {
+        context.response = std::make_shared<AuthorizationProxyResponse>();
+        context.response->authorized_metadata.authorized_domain =
+            std::make_shared<std::string>(
+                context.request->authorization_metadata.claimed_identity);
+        context.result = SuccessExecutionResult();
+        context.Finish();
+        return SuccessExecutionResult();
+      });
+  std::shared_ptr<AuthorizationProxyInterface> authorization_proxy =
+      mock_authorization_proxy;
+  std::shared_ptr<AsyncExecutorInterface> async_executor =
+      std::make_shared<AsyncExecutor>(8, 100, true);
+
+  std::string test_path("/test");
+  Http2ServerOptions http2_server_options;
+  http2_server_options.route_max_concurrent_requests[test_path] = 1;
+  http2_server_options.rejected_request_retry_after_seconds = 5;
+  Http2Server http_server(host_address, port, 2 /* thread_pool_size */,
+                          async_executor, authorization_proxy,
+                          mock_aws_authorization_proxy, mock_config_provider_,
+                          http2_server_options, metric_router_.get());
+
+  // Holds the first request in flight until it is completed below.
+  std::promise<AsyncContext<HttpRequest, HttpResponse>> held_request;
+  std::atomic<int> handled_requests = 0;
+  HttpHandler handler_callback =
+      [&](AsyncContext<HttpRequest, HttpResponse>& context) {
+        if (handled_requests++ == 0) {
+          held_request.set_value(context);
+          return SuccessExecutionResult();
+        }
+        context.result = SuccessExecutionResult();
+        context.Finish();
+        return SuccessExecutionResult();
+      };
+  http_server.RegisterResourceHandler(HttpMethod::GET, test_path,
+                                      handler_callback);
+
+  EXPECT_SUCCESS(http_server.Init());
+  EXPECT_SUCCESS(http_server.Run());
+  port = std::to_string(Http2ServerPeer::PortInUse(http_server));
+
+  HttpClient http_client(async_executor);
+  http_client.Init();
+  http_client.Run();
+  async_executor->Init();
+  async_executor->Run();
+
+  auto send_request = [&](std::promise<void>& done,
+                          std::function<void(AsyncContext<HttpRequest,
+                                                          HttpResponse>&)>
+                              check) {
+    auto request = std::make_shared<HttpRequest>();
+    request->method = HttpMethod::GET;
+    request->path =
+        std::make_shared<std::string>("http://localhost:" + port + test_path);
+    std::string encoded_token;
+    Base64Encode(nlohmann::json().dump(), encoded_token);
+    request->headers = std::make_shared<HttpHeaders>();
+    request->headers->insert({kAuthHeader, encoded_token});
+    request->headers->insert(
+        {kClaimedIdentityHeader, "https://origin.site.com"});
+    request->headers->insert({kUserAgentHeader, "aggregation-service/2.8.7"});
+    AsyncContext<HttpRequest, HttpResponse> context(
+        std::move(request),
+        [&done, check](AsyncContext<HttpRequest, HttpResponse>& context) {
+          check(context);
+          done.set_value();
+        });
+    SubmitUntilSuccess(http_client, context);
+  };
+
+  std::promise<void> first_done;
+  send_request(first_done, [](auto& context) {
+    EXPECT_SUCCESS(context.result);
+  });
+  auto first_context = held_request.get_future().get();
+
+  // The route is at its limit, the request is rejected before being handled.
+  std::promise<void> second_done;
+  send_request(second_done, [](auto& context) {
+    EXPECT_THAT(context.result,
+                ResultIs(FailureExecutionResult(
+                    SC_HTTP2_CLIENT_HTTP_STATUS_TOO_MANY_REQUESTS)));
+    auto retry_after = context.response->headers->find("retry-after");
+    ASSERT_NE(retry_after, context.response->headers->end());
+    EXPECT_EQ(retry_after->second, "5");
+  });
+  second_done.get_future().get();
+  EXPECT_EQ(handled_requests.load(), 1);
+
+  // The labels of the rejected request are read from its headers, which are
+  // never copied.
+  auto rejected_attributes = GetMetricAttributes(
+      kServerRejectedRequestsMetric, metric_router_->GetExportedData());
+  ASSERT_TRUE(rejected_attributes.has_value());
+  EXPECT_EQ(std::get<std::string>(
+                rejected_attributes->at(std::string(kPbsClaimedIdentityLabel))),
+            "https://origin.site.com");
+  EXPECT_EQ(std::get<std::string>(rejected_attributes->at(
+                std::string(kScpHttpRequestClientVersionLabel))),
+            "aggregation-service/2.8.7");
+  EXPECT_EQ(std::get<std::string>(
+                rejected_attributes->at(std::string(kScpAdmissionLimitLabel))),
+            "route");
+
+  first_context.result = SuccessExecutionResult();
+  first_context.Finish();
+  first_done.get_future().get();
+
+  // Completing the first request frees the route.
+  std::promise<void> third_done;
+  send_request(third_done, [](auto& context) {
+    EXPECT_SUCCESS(context.result);
+  });
+  third_done.get_future().get();
+  EXPECT_EQ(handled_requests.load(), 2);
+
+  http_client.Stop();
+  EXPECT_SUCCESS(http_server.Stop());
+  async_executor->Stop();
+}
+
 TEST_F(Http2ServerTest,
        OnBodyDataReceivedWithExtraDataReturnsPartialDataError) {
   {
@@ -1160,5 +1820,281 @@ TEST_F(Http2ServerTest, OnBodyDataReceivedWithLessDataReturnsPartialDataError) {
   }
 }
 
+TEST_F(Http2ServerTest, OnBodyDataReceivedStreamsChunksToBodyConsumer) {
+  nghttp2::asio_http2::server::request ng_request;
+  MockNgHttp2RequestWithOverrides request(ng_request, 6 /* body length */);
+  auto body_consumer = std::make_shared<FakeBodyConsumer>();
+  EXPECT_SUCCESS(request.StreamRequestBody(body_consumer));
+
+  bool callback_called = false;
+  request.SetOnRequestBodyDataReceivedCallback([&](ExecutionResult result) {
+    EXPECT_SUCCESS(result);
+    callback_called = true;
+  });
+  request.SimulateOnRequestBodyDataReceived(
+      reinterpret_cast<const uint8_t*>("abc"), 3);
+  EXPECT_FALSE(callback_called);
+  request.SimulateOnRequestBodyDataReceived(
+      reinterpret_cast<const uint8_t*>("def"), 3);
+  request.SimulateOnRequestBodyDataReceived(nullptr, 0);
+
+  EXPECT_TRUE(callback_called);
+  EXPECT_EQ(body_consumer->chunks, std::vector<std::string>({"abc", "def"}));
+  EXPECT_EQ(request.GetReceivedBodyLength(), 6);
+  // The streamed body is not buffered.
+  EXPECT_EQ(request.body.capacity, 0);
+  EXPECT_EQ(request.body.length, 0);
+}
+
+TEST_F(Http2ServerTest, OnBodyDataReceivedStopsStreamingOnConsumerFailure) {
+  nghttp2::asio_http2::server::request ng_request;
+  MockNgHttp2RequestWithOverrides request(ng_request, 6 /* body length */);
+  auto body_consumer = std::make_shared<FakeBodyConsumer>();
+  body_consumer->chunk_result = FailureExecutionResult(SC_UNKNOWN);
+  EXPECT_SUCCESS(request.StreamRequestBody(body_consumer));
+
+  size_t callback_count = 0;
+  request.SetOnRequestBodyDataReceivedCallback([&](ExecutionResult result) {
+    EXPECT_THAT(result, ResultIs(FailureExecutionResult(SC_UNKNOWN)));
+    callback_count++;
+  });
+  request.SimulateOnRequestBodyDataReceived(
+      reinterpret_cast<const uint8_t*>("abc"), 3);
+  request.SimulateOnRequestBodyDataReceived(
+      reinterpret_cast<const uint8_t*>("def"), 3);
+  request.SimulateOnRequestBodyDataReceived(nullptr, 0);
+
+  EXPECT_EQ(callback_count, 1);
+  EXPECT_EQ(body_consumer->chunks, std::vector<std::string>({"abc"}));
+}
+
+TEST_F(Http2ServerTest, StreamRequestBodyRejectsBodiesLargerThanRouteLimit) {
+  nghttp2::asio_http2::server::request ng_request;
+  MockNgHttp2RequestWithOverrides request(ng_request, 6 /* body length */);
+
+  EXPECT_THAT(request.StreamRequestBody(std::make_shared<FakeBodyConsumer>(),
+                                        5 /* max request body size */),
+              ResultIs(FailureExecutionResult(
+                  SC_HTTP2_SERVER_REQUEST_BODY_TOO_LARGE)));
+}
+
+TEST_F(Http2ServerTest, OnBodyDataReceivedDecompressesGzipBody) {
+  std::string data(10000, 'a');
+  std::string compressed;
+  ASSERT_SUCCESS(GzipCompress(data, compressed));
+
+  nghttp2::asio_http2::server::request ng_request;
+  MockNgHttp2RequestWithOverrides request(ng_request);
+  EXPECT_SUCCESS(request.PrepareGzipRequestBody(compressed.size()));
+
+  bool callback_called = false;
+  request.SetOnRequestBodyDataReceivedCallback([&](ExecutionResult result) {
+    EXPECT_SUCCESS(result);
+    callback_called = true;
+  });
+  const auto* compressed_data =
+      reinterpret_cast<const uint8_t*>(compressed.data());
+  size_t half = compressed.size() / 2;
+  request.SimulateOnRequestBodyDataReceived(compressed_data, half);
+  request.SimulateOnRequestBodyDataReceived(compressed_data + half,
+                                            compressed.size() - half);
+  request.SimulateOnRequestBodyDataReceived(nullptr, 0);
+
+  EXPECT_TRUE(callback_called);
+  EXPECT_EQ(request.body.ToString(), data);
+  EXPECT_EQ(request.GetReceivedBodyLength(), data.size());
+}
+
+TEST_F(Http2ServerTest, OnBodyDataReceivedStreamsDecompressedGzipBody) {
+  std::string data(10000, 'a');
+  std::string compressed;
+  ASSERT_SUCCESS(GzipCompress(data, compressed));
+
+  nghttp2::asio_http2::server::request ng_request;
+  MockNgHttp2RequestWithOverrides request(ng_request);
+  auto body_consumer = std::make_shared<FakeBodyConsumer>();
+  EXPECT_SUCCESS(request.PrepareGzipRequestBody(
+      compressed.size(), kDefaultMaxRequestBodySize, body_consumer));
+
+  bool callback_called = false;
+  request.SetOnRequestBodyDataReceivedCallback([&](ExecutionResult result) {
+    EXPECT_SUCCESS(result);
+    callback_called = true;
+  });
+  request.SimulateOnRequestBodyDataReceived(
+      reinterpret_cast<const uint8_t*>(compressed.data()), compressed.size());
+  request.SimulateOnRequestBodyDataReceived(nullptr, 0);
+
+  EXPECT_TRUE(callback_called);
+  EXPECT_EQ(absl::StrJoin(body_consumer->chunks, ""), data);
+  EXPECT_EQ(request.GetReceivedBodyLength(), data.size());
+  EXPECT_EQ(request.body.length, 0);
+}
+
+TEST_F(Http2ServerTest, OnBodyDataReceivedRejectsGzipBodyOverRouteLimit) {
+  // A small body decompressing to more than the limit of the route.
+  std::string compressed;
+  ASSERT_SUCCESS(GzipCompress(std::string(1024 * 1024, 0), compressed));
+  ASSERT_LT(compressed.size(), 10000);
+
+  nghttp2::asio_http2::server::request ng_request;
+  MockNgHttp2RequestWithOverrides request(ng_request);
+  EXPECT_SUCCESS(request.PrepareGzipRequestBody(
+      compressed.size(), 10000 /* max request body size */));
+
+  size_t callback_count = 0;
+  request.SetOnRequestBodyDataReceivedCallback([&](ExecutionResult result) {
+    EXPECT_THAT(result, ResultIs(FailureExecutionResult(
+                            SC_CORE_UTILS_DECOMPRESSED_SIZE_TOO_LARGE)));
+    callback_count++;
+  });
+  request.SimulateOnRequestBodyDataReceived(
+      reinterpret_cast<const uint8_t*>(compressed.data()), compressed.size());
+  request.SimulateOnRequestBodyDataReceived(nullptr, 0);
+
+  EXPECT_EQ(callback_count, 1);
+  EXPECT_LE(request.body.length, 10000);
+}
+
+TEST_F(Http2ServerTest, OnBodyDataReceivedRejectsTruncatedGzipBody) {
+  std::string compressed;
+  ASSERT_SUCCESS(GzipCompress(std::string(1000, 'a'), compressed));
+  compressed.resize(compressed.size() - 4);
+
+  nghttp2::asio_http2::server::request ng_request;
+  MockNgHttp2RequestWithOverrides request(ng_request);
+  EXPECT_SUCCESS(request.PrepareGzipRequestBody(compressed.size()));
+
+  bool callback_called = false;
+  request.SetOnRequestBodyDataReceivedCallback([&](ExecutionResult result) {
+    EXPECT_THAT(result, ResultIs(FailureExecutionResult(
+                            SC_CORE_UTILS_INVALID_COMPRESSED_DATA)));
+    callback_called = true;
+  });
+  request.SimulateOnRequestBodyDataReceived(
+      reinterpret_cast<const uint8_t*>(compressed.data()), compressed.size());
+  request.SimulateOnRequestBodyDataReceived(nullptr, 0);
+
+  EXPECT_TRUE(callback_called);
+}
+
+TEST_F(Http2ServerTest, CompressResponseBodyOnlyForLargeAcceptedResponses) {
+  std::string host_address("localhost");
+  std::string port("0");
+  std::shared_ptr<AsyncExecutorInterface> async_executor =
+      std::make_shared<MockAsyncExecutor>();
+  Http2ServerOptions options;
+  options.response_compression_min_size = 100;
+  MockHttp2ServerWithOverrides http_server(
+      host_address, port, async_executor,
+      std::make_shared<PassThruAuthorizationProxy>(),
+      std::make_shared<PassThruAuthorizationProxy>(), mock_config_provider_,
+      metric_router_.get(), options);
+
+  nghttp2::asio_http2::server::response ng_response;
+  auto make_context = [&](const std::string& body,
+                          const std::string& accept_encoding) {
+    AsyncContext<NgHttp2Request, NgHttp2Response> http_context;
+    auto request = CreateMockRequest();
+    request->SimulateAcceptEncoding(accept_encoding);
+    http_context.request = std::move(request);
+    http_context.response = std::make_shared<NgHttp2Response>(ng_response);
+    http_context.response->headers = std::make_shared<HttpHeaders>();
+    http_context.response->body = BytesBuffer(body);
+    return http_context;
+  };
+  std::string large_body(1000, 'a');
+
+  auto http_context = make_context(large_body, "br, gzip");
+  http_server.CompressResponseBody(http_context);
+  auto content_encoding =
+      http_context.response->headers->find(kContentEncodingHeader);
+  ASSERT_NE(content_encoding, http_context.response->headers->end());
+  EXPECT_EQ(content_encoding->second, kGzipContentEncoding);
+  std::string decompressed;
+  EXPECT_SUCCESS(GzipDecompress(http_context.response->body.ToString(),
+                                large_body.size(), decompressed));
+  EXPECT_EQ(decompressed, large_body);
+  EXPECT_EQ(http_context.response->headers->count(kVaryHeader), 1);
+
+  // Small, not accepted or already encoded bodies are left as is, but still
+  // vary on the accepted encodings.
+  for (auto& [body, accept_encoding] :
+       std::vector<std::pair<std::string, std::string>>{
+           {std::string(99, 'a'), "gzip"},
+           {large_body, ""},
+           {large_body, "gzip;q=0, br"}}) {
+    http_context = make_context(body, accept_encoding);
+    http_server.CompressResponseBody(http_context);
+    EXPECT_FALSE(
+        http_context.response->headers->contains(kContentEncodingHeader));
+    EXPECT_EQ(http_context.response->body.ToString(), body);
+    auto vary = http_context.response->headers->find(kVaryHeader);
+    ASSERT_NE(vary, http_context.response->headers->end());
+    EXPECT_EQ(vary->second, kAcceptEncodingHeader);
+  }
+  http_context = make_context(large_body, "gzip");
+  http_context.response->headers->insert({kContentEncodingHeader, "br"});
+  http_context.response->headers->insert({kVaryHeader, kAcceptEncodingHeader});
+  http_server.CompressResponseBody(http_context);
+  EXPECT_EQ(http_context.response->body.ToString(), large_body);
+  EXPECT_EQ(http_context.response->headers->count(kVaryHeader), 1);
+}
+
+struct PooledObject {
+  explicit PooledObject(int value) : value(value) {}
+
+  void Reset(int new_value) {
+    value = new_value;
+    resets++;
+  }
+
+  void Release() { releases++; }
+
+  int value;
+  int resets = 0;
+  int releases = 0;
+};
+
+TEST(Http2ObjectPoolTest, RecyclesReleasedObjectsOnly) {
+  using Pool = Http2ObjectPool<PooledObject, 2>;
+
+  auto first = Pool::Acquire(1);
+  PooledObject* first_address = first.get();
+  auto second = Pool::Acquire(2);
+  EXPECT_NE(second.get(), first_address);
+  EXPECT_EQ(Pool::Size(), 2);
+
+  // The pool is full, so this object is not pooled.
+  auto third = Pool::Acquire(3);
+  EXPECT_EQ(Pool::Size(), 2);
+  third.reset();
+
+  first.reset();
+  auto recycled = Pool::Acquire(4);
+  EXPECT_EQ(recycled.get(), first_address);
+  EXPECT_EQ(recycled->value, 4);
+  EXPECT_EQ(recycled->resets, 1);
+  EXPECT_EQ(recycled->releases, 1);
+  EXPECT_EQ(second->value, 2);
+  EXPECT_EQ(Pool::Size(), 2);
+}
+
+TEST(Http2ObjectPoolTest, RecyclesObjectsReleasedOnOtherThreads) {
+  // Another capacity than above, so that the pool starts empty.
+  using Pool = Http2ObjectPool<PooledObject, 1>;
+
+  auto object = Pool::Acquire(1);
+  PooledObject* address = object.get();
+  std::thread([object = std::move(object)]() mutable {
+    object.reset();
+  }).join();
+
+  auto recycled = Pool::Acquire(2);
+  EXPECT_EQ(recycled.get(), address);
+  EXPECT_EQ(recycled->value, 2);
+  EXPECT_EQ(recycled->releases, 1);
+}
+
 }  // namespace
 }  // namespace privacy_sandbox::pbs_common
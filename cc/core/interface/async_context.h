@@ -129,9 +129,13 @@ struct AsyncContext {
         // typeid(TRequest).name() is an approximation of the context's template
         // types mangled in compiler defined format, mainly for debugging
         // purposes.
-        if (!result.Retryable()) {
-          SCP_ERROR_CONTEXT(
+        // Retries and expected outcomes are counted by the metrics of the
+        // requests rather than logged as errors, and errors are rate limited,
+        // so that a storm of failures does not turn into a storm of logs.
+        if (!result.Retryable() && !IsExpectedOutcome(result.status_code)) {
+          SCP_ERROR_CONTEXT_RATE_LIMITED(
               "AsyncContext", (*this), result,
+              kAsyncContextMaxErrorLogsPerSecond,
               absl::StrFormat(
                   "AsyncContext Finished. Mangled RequestType: '%s', "
                   "Mangled ResponseType: '%s'",
@@ -17,6 +17,7 @@
 #include "cc/core/interface/errors.h"
 
 #include <map>
+#include <set>
 #include <string>
 
 namespace privacy_sandbox::pbs_common {
@@ -33,6 +34,13 @@ std::map<uint64_t, uint64_t>& GetPublicErrorCodesMap() {
   return public_error_codes_map;
 }
 
+std::set<uint64_t>& GetExpectedOutcomeErrorCodes() {
+  /// Defines expected_outcome_error_codes to store the error codes which are
+  /// expected outcomes.
+  static std::set<uint64_t> expected_outcome_error_codes;
+  return expected_outcome_error_codes;
+}
+
 std::string HttpStatusCodeToString(HttpStatusCode status) {
   switch (status) {
     // 2xx
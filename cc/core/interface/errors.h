@@ -17,6 +17,7 @@
 #pragma once
 
 #include <map>
+#include <set>
 #include <string>
 
 #include "absl/strings/string_view.h"
@@ -97,6 +98,9 @@ std::map<uint64_t, std::map<uint64_t, SCPError>>& GetGlobalErrorCodes();
 /// @brief The global map of error_code and associated public error code.
 std::map<uint64_t, uint64_t>& GetPublicErrorCodesMap();
 
+/// @brief The global set of error codes which are expected outcomes.
+std::set<uint64_t>& GetExpectedOutcomeErrorCodes();
+
 /// Returns the string representation of an HttpStatusCode.
 std::string HttpStatusCodeToString(HttpStatusCode status);
 
@@ -166,6 +170,29 @@ inline uint64_t MakeErrorCode(uint64_t component, uint64_t error) {
     return true;                                                   \
   }();
 
+/**
+ * @brief Marks an error code as an expected outcome of a request, such as a
+ * budget being exhausted, rather than a fault. Expected outcomes are counted by
+ * the metrics of the requests, and are not logged as errors.
+ *
+ * @param error_code The global error code.
+ */
+#define MARK_AS_EXPECTED_OUTCOME(error_code)                             \
+  static bool expected_outcome_##error_code = []() {                     \
+    privacy_sandbox::pbs_common::GetExpectedOutcomeErrorCodes().emplace( \
+        error_code);                                                     \
+    return true;                                                         \
+  }();
+
+/**
+ * @brief Whether the error code is an expected outcome.
+ *
+ * @param error_code the global error code.
+ */
+inline bool IsExpectedOutcome(uint64_t error_code) {
+  return GetExpectedOutcomeErrorCodes().contains(error_code);
+}
+
 /**
  * @brief Extracts component code object.
  *
@@ -17,11 +17,14 @@
 #pragma once
 
 #include <functional>
+#include <memory>
 #include <string>
+#include <string_view>
 
 #include "cc/core/interface/async_context.h"
 #include "cc/core/interface/http_types.h"
 #include "cc/core/interface/service_interface.h"
+#include "cc/public/core/interface/execution_result.h"
 
 namespace privacy_sandbox::pbs_common {
 
@@ -29,6 +32,44 @@ namespace privacy_sandbox::pbs_common {
 using HttpHandler =
     std::function<ExecutionResult(AsyncContext<HttpRequest, HttpResponse>&)>;
 
+/**
+ * @brief Consumes the body of a streamed request incrementally, as the chunks
+ * are received, instead of having the whole body buffered first.
+ *
+ * Chunks are delivered in order on the io thread of the request and may
+ * arrive before the request is authorized, so consumers should only parse
+ * them and defer any side effect to OnBodyComplete.
+ */
+class HttpRequestBodyConsumerInterface {
+ public:
+  virtual ~HttpRequestBodyConsumerInterface() = default;
+
+  /**
+   * @brief Is called for every chunk of the request body.
+   *
+   * @param chunk The received bytes, only valid for the duration of the call.
+   * @return ExecutionResult A failure stops the request with that result.
+   */
+  virtual ExecutionResult OnBodyChunk(std::string_view chunk) noexcept = 0;
+
+  /**
+   * @brief Is called once the whole body is received and the request is
+   * authorized. Completes the request the same way an HttpHandler does.
+   *
+   * @param http_context The context of the request. Its request body is empty.
+   * @return ExecutionResult
+   */
+  virtual ExecutionResult OnBodyComplete(
+      AsyncContext<HttpRequest, HttpResponse>& http_context) noexcept = 0;
+};
+
+/// Type definition for the resource handler of streamed requests. It creates
+/// the body consumer of a request from its method, path and headers, before
+/// any of the body is received.
+using HttpStreamingHandler = std::function<
+    ExecutionResultOr<std::shared_ptr<HttpRequestBodyConsumerInterface>>(
+        const HttpRequest&)>;
+
 /// Provides HTTP(S) server functionality.
 class HttpServerInterface : public ServiceInterface {
  public:
@@ -45,5 +86,20 @@ class HttpServerInterface : public ServiceInterface {
   virtual ExecutionResult RegisterResourceHandler(
       HttpMethod http_method, std::string& resource_path,
       HttpHandler& handler) noexcept = 0;
+
+  /**
+   * @brief Registers resource handler for http operations whose request body
+   * is streamed to the handler rather than buffered.
+   *
+   * @param http_method The method of the operation.
+   * @param resource_path The resource path in REST format.
+   * @param handler The handler creating the body consumer of each request.
+   * @param max_request_body_size Requests whose body is larger are rejected.
+   * @return ExecutionResult
+   */
+  virtual ExecutionResult RegisterStreamingResourceHandler(
+      HttpMethod http_method, std::string& resource_path,
+      HttpStreamingHandler& handler,
+      size_t max_request_body_size) noexcept = 0;
 };
 }  // namespace privacy_sandbox::pbs_common
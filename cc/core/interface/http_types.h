@@ -61,6 +61,9 @@ struct HttpRequest {
   BytesBuffer body;
   /// Represents the context of authentication and/or authorization.
   AuthContext auth_context;
+  /// Whether sending the request more than once has the same effect as sending
+  /// it once, which allows the client to hedge it.
+  bool is_idempotent = false;
 };
 
 /// Http response object.
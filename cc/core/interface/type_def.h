@@ -132,6 +132,9 @@ struct LoadableObject {
 
 static constexpr TimeDuration kAsyncContextExpirationDurationInSeconds = 90;
 
+// The errors logged per second when async contexts of a given type finish.
+static constexpr size_t kAsyncContextMaxErrorLogsPerSecond = 10;
+
 // The default config value for RetryStrategyOptions
 static constexpr size_t kDefaultRetryStrategyMaxRetries = 12;
 static constexpr TimeDuration kDefaultRetryStrategyDelayInMs = 101;
@@ -139,6 +142,8 @@ static constexpr TimeDuration kDefaultRetryStrategyDelayInMs = 101;
 // The default config value for HttpClientOptions
 static constexpr size_t kDefaultMaxConnectionsPerHost = 2;
 static constexpr TimeDuration kDefaultHttp2ReadTimeoutInSeconds = 60;
+static constexpr size_t kDefaultConnectionGrowthStreams = 80;
+static constexpr TimeDuration kDefaultIdleConnectionTimeoutInSeconds = 60;
 
 // Meter
 inline constexpr absl::string_view kHttp2ServerMeter = "Http2 Server";
@@ -151,6 +156,8 @@ static constexpr char kServerRequestBodySizeMetric[] =
     "http.server.request.body.size";
 static constexpr char kServerResponseBodySizeMetric[] =
     "http.server.response.body.size";
+static constexpr char kServerRejectedRequestsMetric[] =
+    "http.server.rejected_requests";
 static constexpr char kPbsRequestsMetric[] = "google.scp.pbs.requests";
 
 // Labels
@@ -159,6 +166,8 @@ inline constexpr absl::string_view kPbsClaimedIdentityLabel =
     "pbs.claimed_identity";
 inline constexpr absl::string_view kScpHttpRequestClientVersionLabel =
     "scp.http.request.client_version";
+inline constexpr absl::string_view kScpAdmissionLimitLabel =
+    "scp.admission_limit";
 
 // Default Value
 inline constexpr absl::string_view kUnknownValue = "unknown";
@@ -0,0 +1,117 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cc/core/logger/src/log_formatter.h"
+
+#include <array>
+#include <string>
+#include <string_view>
+
+#include "cc/core/common/uuid/src/uuid.h"
+#include "cc/core/interface/logger_interface.h"
+
+namespace privacy_sandbox::pbs_common {
+namespace {
+
+constexpr char kSeparator = '|';
+constexpr size_t kSeparatorCount = 8;
+constexpr size_t kFormattedUuidCacheSize = 16;
+// A thread which logged an unusually long line gives the memory back rather
+// than holding on to it for the rest of its life.
+constexpr size_t kMaxRetainedBufferCapacity = 64 * 1024;
+
+struct FormattedUuid {
+  FormattedUuid() { ToString(uuid, formatted); }
+
+  Uuid uuid = kZeroUuid;
+  char formatted[kUuidStringLength];
+};
+
+std::string_view GetSeverity(const LogLevel& level) noexcept {
+  switch (level) {
+    case LogLevel::kEmergency:
+      return "EMERGENCY";
+    case LogLevel::kAlert:
+      return "ALERT";
+    case LogLevel::kCritical:
+      return "CRITICAL";
+    case LogLevel::kDebug:
+      return "DEBUG";
+    case LogLevel::kInfo:
+      return "INFO";
+    case LogLevel::kWarning:
+      return "WARNING";
+    case LogLevel::kError:
+      return "ERROR";
+    case LogLevel::kNone:
+      return "NONE";
+  }
+  return "UNKNOWN";
+}
+
+/// Appends the formatted uuid, formatting it only if it is not cached.
+void AppendUuid(const Uuid& uuid, std::string& output) noexcept {
+  thread_local std::array<FormattedUuid, kFormattedUuidCacheSize> cache;
+  FormattedUuid& entry = cache[UuidHash()(uuid) % kFormattedUuidCacheSize];
+  if (entry.uuid != uuid) {
+    entry.uuid = uuid;
+    ToString(uuid, entry.formatted);
+  }
+  output.append(entry.formatted, kUuidStringLength);
+}
+
+}  // namespace
+
+const std::string& FormatLogLine(
+    const LogLevel& level, const Uuid& correlation_id,
+    const Uuid& parent_activity_id, const Uuid& activity_id,
+    std::string_view component_name, std::string_view machine_name,
+    std::string_view cluster_name, std::string_view location,
+    std::string_view message) noexcept {
+  thread_local std::string buffer;
+
+  std::string_view severity = GetSeverity(level);
+  size_t size = severity.size() + cluster_name.size() + machine_name.size() +
+                component_name.size() + 3 * kUuidStringLength +
+                location.size() + message.size() + kSeparatorCount;
+  if (buffer.capacity() > kMaxRetainedBufferCapacity &&
+      size <= kMaxRetainedBufferCapacity) {
+    buffer = std::string();
+  }
+  buffer.clear();
+  buffer.reserve(size);
+
+  buffer.append(severity);
+  buffer += kSeparator;
+  buffer.append(cluster_name);
+  buffer += kSeparator;
+  buffer.append(machine_name);
+  buffer += kSeparator;
+  buffer.append(component_name);
+  buffer += kSeparator;
+  AppendUuid(correlation_id, buffer);
+  buffer += kSeparator;
+  AppendUuid(parent_activity_id, buffer);
+  buffer += kSeparator;
+  AppendUuid(activity_id, buffer);
+  buffer += kSeparator;
+  buffer.append(location);
+  buffer += kSeparator;
+  buffer.append(message);
+  return buffer;
+}
+
+}  // namespace privacy_sandbox::pbs_common
@@ -0,0 +1,47 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "cc/core/common/uuid/src/uuid.h"
+#include "cc/core/interface/logger_interface.h"
+
+namespace privacy_sandbox::pbs_common {
+
+/**
+ * @brief Formats a log line as
+ * SEVERITY|cluster|machine|component|correlation_id|parent_activity_id|
+ * activity_id|location|message in a single pass.
+ *
+ * The line is written to a buffer reused by every call on the calling thread,
+ * and the ids of the last contexts which logged on the thread are formatted
+ * once and cached, so that formatting does not allocate once the buffer has
+ * grown to the size of the lines.
+ *
+ * @return const std::string& The formatted line, valid until the next call on
+ * the same thread.
+ */
+const std::string& FormatLogLine(
+    const LogLevel& level, const Uuid& correlation_id,
+    const Uuid& parent_activity_id, const Uuid& activity_id,
+    std::string_view component_name, std::string_view machine_name,
+    std::string_view cluster_name, std::string_view location,
+    std::string_view message) noexcept;
+
+}  // namespace privacy_sandbox::pbs_common
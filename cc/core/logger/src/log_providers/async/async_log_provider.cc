@@ -0,0 +1,229 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cc/core/logger/src/log_providers/async/async_log_provider.h"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <utility>
+
+#include "cc/core/logger/src/log_providers/async/error_codes.h"
+
+namespace privacy_sandbox::pbs_common {
+namespace {
+// How long the writer thread sleeps at most when it missed a wake up.
+constexpr std::chrono::milliseconds kWriterWaitTimeout =
+    std::chrono::milliseconds(10);
+}  // namespace
+
+template <size_t Capacity>
+void AsyncLogProvider::FixedString<Capacity>::Assign(
+    std::string_view value) noexcept {
+  length = std::min(value.size(), Capacity);
+  std::memcpy(data, value.data(), length);
+}
+
+AsyncLogProvider::AsyncLogProvider(
+    std::unique_ptr<LogProviderInterface> log_provider,
+    AsyncLogProviderOptions options)
+    : log_provider_(std::move(log_provider)),
+      overflow_policy_(options.overflow_policy),
+      capacity_(options.capacity == 0 ? 0 : std::bit_ceil(options.capacity)),
+      mask_(capacity_ == 0 ? 0 : capacity_ - 1),
+      enqueue_position_(0),
+      dequeue_position_(0),
+      is_running_(false),
+      active_producers_(0),
+      is_stopping_(false),
+      dropped_count_(0),
+      is_writer_waiting_(false) {}
+
+AsyncLogProvider::~AsyncLogProvider() {
+  if (writer_thread_) {
+    Stop();
+  }
+}
+
+ExecutionResult AsyncLogProvider::Init() noexcept {
+  if (capacity_ == 0) {
+    return FailureExecutionResult(SC_ASYNC_LOG_PROVIDER_INVALID_CAPACITY);
+  }
+
+  slots_ = std::make_unique<Slot[]>(capacity_);
+  for (size_t i = 0; i < capacity_; ++i) {
+    slots_[i].sequence.store(i);
+  }
+  return log_provider_->Init();
+}
+
+ExecutionResult AsyncLogProvider::Run() noexcept {
+  auto execution_result = log_provider_->Run();
+  if (!execution_result.Successful()) {
+    return execution_result;
+  }
+
+  is_stopping_ = false;
+  is_running_ = true;
+  try {
+    writer_thread_ = std::make_unique<std::thread>([this]() { WriteLines(); });
+  } catch (...) {
+    is_running_ = false;
+    return FailureExecutionResult(SC_ASYNC_LOG_PROVIDER_CANNOT_START_THREAD);
+  }
+  return SuccessExecutionResult();
+}
+
+ExecutionResult AsyncLogProvider::Stop() noexcept {
+  if (writer_thread_) {
+    is_running_ = false;
+    // The records of the callers which saw the provider running are written
+    // before the writer thread stops.
+    while (active_producers_.load() > 0) {
+      std::this_thread::yield();
+    }
+    is_stopping_ = true;
+    {
+      std::lock_guard lock(writer_lock_);
+      writer_condition_.notify_one();
+    }
+    writer_thread_->join();
+    writer_thread_.reset();
+  }
+  return log_provider_->Stop();
+}
+
+void AsyncLogProvider::Log(const LogLevel& level,
+                           const Uuid& parent_activity_id,
+                           const Uuid& activity_id, const Uuid& correlation_id,
+                           const std::string_view& component_name,
+                           const std::string_view& machine_name,
+                           const std::string_view& cluster_name,
+                           const std::string_view& location,
+                           const std::string_view& message) noexcept {
+  active_producers_++;
+  if (!is_running_.load()) {
+    active_producers_--;
+    log_provider_->Log(level, parent_activity_id, activity_id, correlation_id,
+                       component_name, machine_name, cluster_name, location,
+                       message);
+    return;
+  }
+
+  size_t position;
+  Slot* slot;
+  while ((slot = TryClaim(position)) == nullptr) {
+    if (overflow_policy_ == AsyncLogOverflowPolicy::kDrop) {
+      dropped_count_++;
+      active_producers_--;
+      return;
+    }
+    NotifyWriter();
+    std::this_thread::yield();
+  }
+
+  auto& record = slot->record;
+  record.level = level;
+  record.parent_activity_id = parent_activity_id;
+  record.activity_id = activity_id;
+  record.correlation_id = correlation_id;
+  record.component_name.Assign(component_name);
+  record.machine_name.Assign(machine_name);
+  record.cluster_name.Assign(cluster_name);
+  record.location.Assign(location);
+  record.message.Assign(message);
+  slot->sequence.store(position + 1);
+  active_producers_--;
+
+  NotifyWriter();
+}
+
+AsyncLogProvider::Slot* AsyncLogProvider::TryClaim(size_t& position) noexcept {
+  position = enqueue_position_.load(std::memory_order_relaxed);
+  while (true) {
+    Slot& slot = slots_[position & mask_];
+    auto sequence = slot.sequence.load(std::memory_order_acquire);
+    auto difference =
+        static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+    if (difference == 0) {
+      if (enqueue_position_.compare_exchange_weak(position, position + 1,
+                                                  std::memory_order_relaxed)) {
+        return &slot;
+      }
+    } else if (difference < 0) {
+      // The slot still holds the record of the previous lap.
+      return nullptr;
+    } else {
+      position = enqueue_position_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+bool AsyncLogProvider::HasLine() const noexcept {
+  return slots_[dequeue_position_ & mask_].sequence.load() ==
+         dequeue_position_ + 1;
+}
+
+bool AsyncLogProvider::TryWriteLine() noexcept {
+  if (!HasLine()) {
+    return false;
+  }
+
+  Slot& slot = slots_[dequeue_position_ & mask_];
+  const auto& record = slot.record;
+  log_provider_->Log(record.level, record.parent_activity_id,
+                     record.activity_id, record.correlation_id,
+                     record.component_name.View(), record.machine_name.View(),
+                     record.cluster_name.View(), record.location.View(),
+                     record.message.View());
+  slot.sequence.store(dequeue_position_ + capacity_,
+                      std::memory_order_release);
+  dequeue_position_++;
+  return true;
+}
+
+void AsyncLogProvider::WriteLines() noexcept {
+  while (true) {
+    if (TryWriteLine()) {
+      continue;
+    }
+    if (is_stopping_.load()) {
+      return;
+    }
+
+    std::unique_lock lock(writer_lock_);
+    is_writer_waiting_ = true;
+    // A record committed before the flag was set would not wake us up.
+    if (!HasLine() && !is_stopping_.load()) {
+      writer_condition_.wait_for(lock, kWriterWaitTimeout);
+    }
+    is_writer_waiting_ = false;
+  }
+}
+
+void AsyncLogProvider::NotifyWriter() noexcept {
+  if (is_writer_waiting_.load()) {
+    std::lock_guard lock(writer_lock_);
+    writer_condition_.notify_one();
+  }
+}
+
+}  // namespace privacy_sandbox::pbs_common
@@ -0,0 +1,174 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "cc/core/common/uuid/src/uuid.h"
+#include "cc/core/logger/interface/log_provider_interface.h"
+#include "cc/core/logger/src/log_providers/async/error_codes.h"
+
+namespace privacy_sandbox::pbs_common {
+
+/// What AsyncLogProvider does with a log line when its ring buffer is full.
+enum class AsyncLogOverflowPolicy {
+  /// The line is dropped and counted.
+  kDrop = 0,
+  /// The caller waits for the writer thread to make room.
+  kBlock = 1,
+};
+
+/// Options of AsyncLogProvider.
+struct AsyncLogProviderOptions {
+  /// Number of log lines the ring buffer holds, rounded up to a power of 2.
+  size_t capacity = 1024;
+  AsyncLogOverflowPolicy overflow_policy = AsyncLogOverflowPolicy::kDrop;
+};
+
+/**
+ * @brief A LogProvider which hands the log lines to another provider on a
+ * background thread, so that callers do not pay for formatting them nor for
+ * the I/O of the other provider, e.g. the syslog lock and socket write.
+ *
+ * Callers copy each line into a fixed size record of a bounded lock free
+ * multi producer ring buffer. The strings of a line are truncated to the size
+ * of the record. Lines logged before Run or after Stop are written directly.
+ */
+class AsyncLogProvider : public LogProviderInterface {
+ public:
+  /// Max bytes of the component, machine and cluster names kept per line.
+  static constexpr size_t kMaxNameLength = 64;
+  /// Max bytes of the location kept per line.
+  static constexpr size_t kMaxLocationLength = 256;
+  /// Max bytes of the message kept per line.
+  static constexpr size_t kMaxMessageLength = 2048;
+
+  /**
+   * @brief Constructs a new Async Log Provider object.
+   *
+   * @param log_provider The provider the lines are written to, from the
+   * background thread.
+   * @param options The size of the ring buffer and what to do when it is full.
+   */
+  explicit AsyncLogProvider(std::unique_ptr<LogProviderInterface> log_provider,
+                            AsyncLogProviderOptions options = {});
+
+  ~AsyncLogProvider() override;
+
+  ExecutionResult Init() noexcept override;
+
+  ExecutionResult Run() noexcept override;
+
+  /// Writes the lines still in the ring buffer before stopping.
+  ExecutionResult Stop() noexcept override;
+
+  void Log(const LogLevel& level, const Uuid& parent_activity_id,
+           const Uuid& activity_id, const Uuid& correlation_id,
+           const std::string_view& component_name,
+           const std::string_view& machine_name,
+           const std::string_view& cluster_name,
+           const std::string_view& location,
+           const std::string_view& message) noexcept override;
+
+  /// The number of lines dropped because the ring buffer was full.
+  uint64_t GetDroppedCount() const noexcept { return dropped_count_.load(); }
+
+ private:
+  /// A string truncated to a fixed capacity.
+  template <size_t Capacity>
+  struct FixedString {
+    void Assign(std::string_view value) noexcept;
+
+    std::string_view View() const noexcept { return {data, length}; }
+
+    char data[Capacity];
+    size_t length = 0;
+  };
+
+  /// A log line, copied into the ring buffer.
+  struct Record {
+    LogLevel level;
+    Uuid parent_activity_id;
+    Uuid activity_id;
+    Uuid correlation_id;
+    FixedString<kMaxNameLength> component_name;
+    FixedString<kMaxNameLength> machine_name;
+    FixedString<kMaxNameLength> cluster_name;
+    FixedString<kMaxLocationLength> location;
+    FixedString<kMaxMessageLength> message;
+  };
+
+  /**
+   * A slot of the ring buffer. Its sequence tells whether the slot is free
+   * for the producer of a position or holds the record of a position for the
+   * consumer, as in the bounded MPMC queue of Dmitry Vyukov.
+   */
+  struct alignas(64) Slot {
+    std::atomic<size_t> sequence;
+    Record record;
+  };
+
+  /// Claims the free slot of the next position, or returns null if the ring
+  /// buffer is full.
+  Slot* TryClaim(size_t& position) noexcept;
+
+  /// Whether the next line of the ring buffer is committed.
+  bool HasLine() const noexcept;
+
+  /// Writes the next line of the ring buffer, if any.
+  bool TryWriteLine() noexcept;
+
+  /// Writes the lines of the ring buffer until it is stopped and drained.
+  void WriteLines() noexcept;
+
+  /// Wakes the writer thread up if it waits for lines.
+  void NotifyWriter() noexcept;
+
+  const std::unique_ptr<LogProviderInterface> log_provider_;
+  const AsyncLogOverflowPolicy overflow_policy_;
+  const size_t capacity_;
+  const size_t mask_;
+  std::unique_ptr<Slot[]> slots_;
+
+  /// Next position to produce, shared by the callers.
+  alignas(64) std::atomic<size_t> enqueue_position_;
+  /// Next position to consume, owned by the writer thread.
+  alignas(64) size_t dequeue_position_;
+
+  std::atomic<bool> is_running_;
+  /// The callers between their is_running_ check and their record commit,
+  /// which Stop waits for before draining the ring buffer.
+  std::atomic<size_t> active_producers_;
+  std::atomic<bool> is_stopping_;
+  std::atomic<uint64_t> dropped_count_;
+  std::unique_ptr<std::thread> writer_thread_;
+
+  /// The writer thread sleeps on it while the ring buffer is empty.
+  std::mutex writer_lock_;
+  std::condition_variable writer_condition_;
+  std::atomic<bool> is_writer_waiting_;
+};
+
+}  // namespace privacy_sandbox::pbs_common
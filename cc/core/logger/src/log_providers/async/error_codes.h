@@ -0,0 +1,37 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "cc/core/interface/errors.h"
+
+namespace privacy_sandbox::pbs_common {
+
+/// Registers component code as 0x0025 for AsyncLogProvider.
+REGISTER_COMPONENT_CODE(SC_ASYNC_LOG_PROVIDER, 0x0025)
+
+/// Defines the error code as 0x0001 when the capacity of the ring buffer is 0.
+DEFINE_ERROR_CODE(SC_ASYNC_LOG_PROVIDER_INVALID_CAPACITY, SC_ASYNC_LOG_PROVIDER,
+                  0x0001, "The capacity of the log ring buffer is invalid",
+                  HttpStatusCode::INTERNAL_SERVER_ERROR)
+
+/// Defines the error code as 0x0002 when the background thread cannot start.
+DEFINE_ERROR_CODE(SC_ASYNC_LOG_PROVIDER_CANNOT_START_THREAD,
+                  SC_ASYNC_LOG_PROVIDER, 0x0002,
+                  "Cannot start the log writer thread",
+                  HttpStatusCode::INTERNAL_SERVER_ERROR)
+
+}  // namespace privacy_sandbox::pbs_common
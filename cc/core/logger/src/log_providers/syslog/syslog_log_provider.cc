@@ -25,15 +25,12 @@
 #include <string>
 #include <string_view>
 
-#include "absl/strings/ascii.h"
-#include "absl/strings/str_cat.h"
 #include "cc/core/common/uuid/src/uuid.h"
+#include "cc/core/logger/src/log_formatter.h"
 #include "cc/core/logger/src/log_providers/syslog/error_codes.h"
-#include "cc/core/logger/src/log_utils.h"
 
 namespace privacy_sandbox::pbs_common {
 
-using ::absl::StrCat;
 using ::std::cerr;
 using ::std::string;
 using ::std::string_view;
@@ -69,12 +66,10 @@ void SyslogLogProvider::Log(const LogLevel& level, const Uuid& correlation_id,
                             const string_view& cluster_name,
                             const string_view& location,
                             const string_view& message) noexcept {
-  std::string severity = absl::AsciiStrToUpper(LogLevelToString(level));
-
-  auto formatted_message = StrCat(
-      severity, "|", cluster_name, "|", machine_name, "|", component_name, "|",
-      ToString(correlation_id), "|", ToString(parent_activity_id), "|",
-      ToString(activity_id), "|", location, "|", message);
+  const string& formatted_message =
+      FormatLogLine(level, correlation_id, parent_activity_id, activity_id,
+                    component_name, machine_name, cluster_name, location,
+                    message);
 
   try {
     switch (level) {
@@ -0,0 +1,156 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#include "absl/strings/str_cat.h"
+#include "cc/core/common/uuid/src/uuid.h"
+#include "cc/core/logger/src/log_providers/async/async_log_provider.h"
+#include "cc/core/logger/src/log_utils.h"
+
+namespace privacy_sandbox::pbs_common {
+namespace {
+
+// Formats the lines like SyslogLogProvider and writes them to /dev/null under
+// a lock, like syslog() does, without flooding the syslog of the machine.
+class DevNullLogProvider : public LogProviderInterface {
+ public:
+  ExecutionResult Init() noexcept override {
+    fd_ = open("/dev/null", O_WRONLY);
+    return SuccessExecutionResult();
+  }
+
+  ExecutionResult Run() noexcept override { return SuccessExecutionResult(); }
+
+  ExecutionResult Stop() noexcept override {
+    close(fd_);
+    return SuccessExecutionResult();
+  }
+
+  void Log(const LogLevel& level, const Uuid& parent_activity_id,
+           const Uuid& activity_id, const Uuid& correlation_id,
+           const std::string_view& component_name,
+           const std::string_view& machine_name,
+           const std::string_view& cluster_name,
+           const std::string_view& location,
+           const std::string_view& message) noexcept override {
+    auto formatted_message = absl::StrCat(
+        LogLevelToString(level), "|", cluster_name, "|", machine_name, "|",
+        component_name, "|", ToString(correlation_id), "|",
+        ToString(parent_activity_id), "|", ToString(activity_id), "|",
+        location, "|", message);
+    std::lock_guard lock(lock_);
+    benchmark::DoNotOptimize(
+        write(fd_, formatted_message.data(), formatted_message.size()));
+  }
+
+ private:
+  std::mutex lock_;
+  int fd_ = -1;
+};
+
+std::unique_ptr<LogProviderInterface> log_provider;
+
+void LogLines(benchmark::State& state) {
+  auto activity_id = Uuid::GenerateUuid();
+  auto message = std::string(128, 'm');
+  for (auto _ : state) {
+    log_provider->Log(LogLevel::kError, activity_id, activity_id, activity_id,
+                      "AsyncLogProviderBenchmark", "", "",
+                      "cc/core/logger/test/"
+                      "async_log_provider_benchmark_test.cc:LogLines:70",
+                      message);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// The callers format and write the lines themselves.
+void BM_SyncLogProvider(benchmark::State& state) {
+  if (state.thread_index() == 0) {
+    log_provider = std::make_unique<DevNullLogProvider>();
+    log_provider->Init();
+    log_provider->Run();
+  }
+  LogLines(state);
+  if (state.thread_index() == 0) {
+    log_provider->Stop();
+    log_provider.reset();
+  }
+}
+
+// The callers copy the lines into the ring buffer of range(0) lines, and drop
+// the lines which do not fit.
+void BM_AsyncLogProvider(benchmark::State& state) {
+  if (state.thread_index() == 0) {
+    AsyncLogProviderOptions options;
+    options.capacity = state.range(0);
+    log_provider = std::make_unique<AsyncLogProvider>(
+        std::make_unique<DevNullLogProvider>(), options);
+    log_provider->Init();
+    log_provider->Run();
+  }
+  LogLines(state);
+  if (state.thread_index() == 0) {
+    auto* async_log_provider =
+        static_cast<AsyncLogProvider*>(log_provider.get());
+    state.counters["dropped"] = async_log_provider->GetDroppedCount();
+    log_provider->Stop();
+    log_provider.reset();
+  }
+}
+
+// The callers wait for room in the ring buffer of range(0) lines, so that the
+// throughput is the one of the writer thread.
+void BM_AsyncLogProviderBlocking(benchmark::State& state) {
+  if (state.thread_index() == 0) {
+    AsyncLogProviderOptions options;
+    options.capacity = state.range(0);
+    options.overflow_policy = AsyncLogOverflowPolicy::kBlock;
+    log_provider = std::make_unique<AsyncLogProvider>(
+        std::make_unique<DevNullLogProvider>(), options);
+    log_provider->Init();
+    log_provider->Run();
+  }
+  LogLines(state);
+  if (state.thread_index() == 0) {
+    log_provider->Stop();
+    log_provider.reset();
+  }
+}
+
+BENCHMARK(BM_SyncLogProvider)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK(BM_AsyncLogProvider)
+    ->Arg(1024)
+    ->Arg(16384)
+    ->ThreadRange(1, 16)
+    ->UseRealTime();
+BENCHMARK(BM_AsyncLogProviderBlocking)
+    ->Arg(1024)
+    ->ThreadRange(1, 16)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace privacy_sandbox::pbs_common
+
+// Run the benchmark.
+BENCHMARK_MAIN();
@@ -0,0 +1,211 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cc/core/logger/src/log_providers/async/async_log_provider.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "cc/core/common/uuid/src/uuid.h"
+#include "cc/public/core/test/interface/execution_result_matchers.h"
+
+namespace privacy_sandbox::pbs_common {
+namespace {
+
+// Records the messages it is given, optionally holding the writer until the
+// test releases it.
+class RecordingLogProvider : public LogProviderInterface {
+ public:
+  ExecutionResult Init() noexcept override { return SuccessExecutionResult(); }
+
+  ExecutionResult Run() noexcept override { return SuccessExecutionResult(); }
+
+  ExecutionResult Stop() noexcept override { return SuccessExecutionResult(); }
+
+  void Log(const LogLevel& level, const Uuid& parent_activity_id,
+           const Uuid& activity_id, const Uuid& correlation_id,
+           const std::string_view& component_name,
+           const std::string_view& machine_name,
+           const std::string_view& cluster_name,
+           const std::string_view& location,
+           const std::string_view& message) noexcept override {
+    is_writing = true;
+    while (is_held) {
+      std::this_thread::yield();
+    }
+    std::lock_guard lock(messages_lock);
+    messages.emplace_back(message);
+    thread_ids.push_back(std::this_thread::get_id());
+    activity_ids.push_back(activity_id);
+  }
+
+  std::atomic<bool> is_held = false;
+  std::atomic<bool> is_writing = false;
+  std::mutex messages_lock;
+  std::vector<std::string> messages;
+  std::vector<std::thread::id> thread_ids;
+  std::vector<Uuid> activity_ids;
+};
+
+void LogMessage(AsyncLogProvider& log_provider, std::string_view message,
+                const Uuid& activity_id = kZeroUuid) {
+  log_provider.Log(LogLevel::kError, kZeroUuid, activity_id, kZeroUuid,
+                   "AsyncLogProviderTest", "", "", "location", message);
+}
+
+TEST(AsyncLogProviderTest, WritesTheLinesInOrderOnAnotherThread) {
+  auto recording_provider = std::make_unique<RecordingLogProvider>();
+  auto* recording = recording_provider.get();
+  AsyncLogProvider log_provider(std::move(recording_provider));
+  ASSERT_SUCCESS(log_provider.Init());
+  ASSERT_SUCCESS(log_provider.Run());
+
+  auto activity_id = Uuid::GenerateUuid();
+  for (int i = 0; i < 100; ++i) {
+    LogMessage(log_provider, std::to_string(i), activity_id);
+  }
+  ASSERT_SUCCESS(log_provider.Stop());
+
+  ASSERT_EQ(recording->messages.size(), 100);
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(recording->messages[i], std::to_string(i));
+    EXPECT_NE(recording->thread_ids[i], std::this_thread::get_id());
+    EXPECT_EQ(recording->activity_ids[i], activity_id);
+  }
+  EXPECT_EQ(log_provider.GetDroppedCount(), 0);
+}
+
+TEST(AsyncLogProviderTest, WritesDirectlyWhenNotRunning) {
+  auto recording_provider = std::make_unique<RecordingLogProvider>();
+  auto* recording = recording_provider.get();
+  AsyncLogProvider log_provider(std::move(recording_provider));
+  ASSERT_SUCCESS(log_provider.Init());
+
+  LogMessage(log_provider, "before run");
+  ASSERT_EQ(recording->messages.size(), 1);
+  EXPECT_EQ(recording->thread_ids[0], std::this_thread::get_id());
+}
+
+TEST(AsyncLogProviderTest, DropsTheLinesWhenFull) {
+  auto recording_provider = std::make_unique<RecordingLogProvider>();
+  auto* recording = recording_provider.get();
+  recording->is_held = true;
+  AsyncLogProviderOptions options;
+  options.capacity = 4;
+  AsyncLogProvider log_provider(std::move(recording_provider), options);
+  ASSERT_SUCCESS(log_provider.Init());
+  ASSERT_SUCCESS(log_provider.Run());
+
+  // The first line is held by the writer in its slot, the next 3 fill the
+  // ring buffer.
+  LogMessage(log_provider, "0");
+  while (!recording->is_writing) {
+    std::this_thread::yield();
+  }
+  for (int i = 1; i < 8; ++i) {
+    LogMessage(log_provider, std::to_string(i));
+  }
+  EXPECT_EQ(log_provider.GetDroppedCount(), 4);
+
+  recording->is_held = false;
+  ASSERT_SUCCESS(log_provider.Stop());
+  EXPECT_EQ(recording->messages,
+            std::vector<std::string>({"0", "1", "2", "3"}));
+}
+
+TEST(AsyncLogProviderTest, BlocksTheCallersWhenFull) {
+  auto recording_provider = std::make_unique<RecordingLogProvider>();
+  auto* recording = recording_provider.get();
+  recording->is_held = true;
+  AsyncLogProviderOptions options;
+  options.capacity = 2;
+  options.overflow_policy = AsyncLogOverflowPolicy::kBlock;
+  AsyncLogProvider log_provider(std::move(recording_provider), options);
+  ASSERT_SUCCESS(log_provider.Init());
+  ASSERT_SUCCESS(log_provider.Run());
+
+  std::atomic<int> logged = 0;
+  std::thread caller([&]() {
+    for (int i = 0; i < 10; ++i) {
+      LogMessage(log_provider, std::to_string(i));
+      logged++;
+    }
+  });
+  while (logged < 2) {
+    std::this_thread::yield();
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  // One line is held by the writer in its slot and one fills the ring buffer.
+  EXPECT_EQ(logged, 2);
+
+  recording->is_held = false;
+  caller.join();
+  ASSERT_SUCCESS(log_provider.Stop());
+  EXPECT_EQ(recording->messages.size(), 10);
+  EXPECT_EQ(log_provider.GetDroppedCount(), 0);
+}
+
+TEST(AsyncLogProviderTest, TruncatesLongMessages) {
+  auto recording_provider = std::make_unique<RecordingLogProvider>();
+  auto* recording = recording_provider.get();
+  AsyncLogProvider log_provider(std::move(recording_provider));
+  ASSERT_SUCCESS(log_provider.Init());
+  ASSERT_SUCCESS(log_provider.Run());
+
+  LogMessage(log_provider,
+             std::string(AsyncLogProvider::kMaxMessageLength + 10, 'a'));
+  ASSERT_SUCCESS(log_provider.Stop());
+
+  ASSERT_EQ(recording->messages.size(), 1);
+  EXPECT_EQ(recording->messages[0],
+            std::string(AsyncLogProvider::kMaxMessageLength, 'a'));
+}
+
+TEST(AsyncLogProviderTest, LosesNoLinesOfConcurrentCallers) {
+  auto recording_provider = std::make_unique<RecordingLogProvider>();
+  auto* recording = recording_provider.get();
+  AsyncLogProviderOptions options;
+  options.capacity = 16;
+  options.overflow_policy = AsyncLogOverflowPolicy::kBlock;
+  AsyncLogProvider log_provider(std::move(recording_provider), options);
+  ASSERT_SUCCESS(log_provider.Init());
+  ASSERT_SUCCESS(log_provider.Run());
+
+  std::vector<std::thread> callers;
+  for (int i = 0; i < 8; ++i) {
+    callers.emplace_back([&]() {
+      for (int j = 0; j < 1000; ++j) {
+        LogMessage(log_provider, "message");
+      }
+    });
+  }
+  for (auto& caller : callers) {
+    caller.join();
+  }
+  ASSERT_SUCCESS(log_provider.Stop());
+  EXPECT_EQ(recording->messages.size(), 8000);
+}
+
+}  // namespace
+}  // namespace privacy_sandbox::pbs_common
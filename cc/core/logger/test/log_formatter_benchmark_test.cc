@@ -0,0 +1,132 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "absl/strings/ascii.h"
+#include "absl/strings/str_cat.h"
+#include "cc/core/common/global_logger/src/global_logger.h"
+#include "cc/core/common/uuid/src/uuid.h"
+#include "cc/core/interface/errors.h"
+#include "cc/core/logger/src/log_formatter.h"
+#include "cc/core/logger/src/log_utils.h"
+#include "cc/core/logger/src/logger.h"
+#include "cc/public/core/interface/execution_result.h"
+
+namespace privacy_sandbox::pbs_common {
+namespace {
+
+// Formats the lines the way SyslogLogProvider used to, converting the ids and
+// concatenating the fields into a new string for each line.
+class StrCatLogProvider : public LogProviderInterface {
+ public:
+  ExecutionResult Init() noexcept override { return SuccessExecutionResult(); }
+
+  ExecutionResult Run() noexcept override { return SuccessExecutionResult(); }
+
+  ExecutionResult Stop() noexcept override { return SuccessExecutionResult(); }
+
+  void Log(const LogLevel& level, const Uuid& correlation_id,
+           const Uuid& parent_activity_id, const Uuid& activity_id,
+           const std::string_view& component_name,
+           const std::string_view& machine_name,
+           const std::string_view& cluster_name,
+           const std::string_view& location,
+           const std::string_view& message) noexcept override {
+    std::string severity = absl::AsciiStrToUpper(LogLevelToString(level));
+    auto formatted_message = absl::StrCat(
+        severity, "|", cluster_name, "|", machine_name, "|", component_name,
+        "|", ToString(correlation_id), "|", ToString(parent_activity_id), "|",
+        ToString(activity_id), "|", location, "|", message);
+    benchmark::DoNotOptimize(formatted_message.data());
+  }
+};
+
+// Formats the lines the way SyslogLogProvider does.
+class FormatLogLineLogProvider : public LogProviderInterface {
+ public:
+  ExecutionResult Init() noexcept override { return SuccessExecutionResult(); }
+
+  ExecutionResult Run() noexcept override { return SuccessExecutionResult(); }
+
+  ExecutionResult Stop() noexcept override { return SuccessExecutionResult(); }
+
+  void Log(const LogLevel& level, const Uuid& correlation_id,
+           const Uuid& parent_activity_id, const Uuid& activity_id,
+           const std::string_view& component_name,
+           const std::string_view& machine_name,
+           const std::string_view& cluster_name,
+           const std::string_view& location,
+           const std::string_view& message) noexcept override {
+    const std::string& formatted_message =
+        FormatLogLine(level, correlation_id, parent_activity_id, activity_id,
+                      component_name, machine_name, cluster_name, location,
+                      message);
+    benchmark::DoNotOptimize(formatted_message.data());
+  }
+};
+
+// The ids of a request, as logged by SCP_*_CONTEXT.
+struct Context {
+  Uuid correlation_id = Uuid::GenerateUuid();
+  Uuid parent_activity_id = Uuid::GenerateUuid();
+  Uuid activity_id = Uuid::GenerateUuid();
+};
+
+constexpr char kComponentName[] = "LogFormatterBenchmark";
+
+template <class LogProvider>
+void SetGlobalLogger() {
+  GlobalLogger::SetGlobalLogger(
+      std::make_unique<Logger>(std::make_unique<LogProvider>()));
+}
+
+template <class LogProvider>
+void BM_ScpInfo(benchmark::State& state) {
+  SetGlobalLogger<LogProvider>();
+  Context context;
+  for (auto _ : state) {
+    SCP_INFO_CONTEXT(kComponentName, context, "Request received.");
+  }
+  GlobalLogger::SetGlobalLogger(nullptr);
+}
+
+template <class LogProvider>
+void BM_ScpError(benchmark::State& state) {
+  SetGlobalLogger<LogProvider>();
+  Context context;
+  ExecutionResult execution_result = FailureExecutionResult(SC_UNKNOWN);
+  for (auto _ : state) {
+    SCP_ERROR_CONTEXT(kComponentName, context, execution_result,
+                      "Request failed.");
+  }
+  GlobalLogger::SetGlobalLogger(nullptr);
+}
+
+BENCHMARK_TEMPLATE(BM_ScpInfo, StrCatLogProvider);
+BENCHMARK_TEMPLATE(BM_ScpInfo, FormatLogLineLogProvider);
+BENCHMARK_TEMPLATE(BM_ScpError, StrCatLogProvider);
+BENCHMARK_TEMPLATE(BM_ScpError, FormatLogLineLogProvider);
+
+}  // namespace
+}  // namespace privacy_sandbox::pbs_common
+
+// Run the benchmark.
+BENCHMARK_MAIN();
@@ -0,0 +1,83 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cc/core/logger/src/log_formatter.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "cc/core/common/uuid/src/uuid.h"
+#include "cc/core/interface/logger_interface.h"
+
+namespace privacy_sandbox::pbs_common {
+namespace {
+
+TEST(LogFormatterTest, FormatsAllFields) {
+  Uuid correlation_id = Uuid::GenerateUuid();
+  Uuid parent_activity_id = Uuid::GenerateUuid();
+  Uuid activity_id = Uuid::GenerateUuid();
+
+  EXPECT_EQ(FormatLogLine(LogLevel::kWarning, correlation_id,
+                          parent_activity_id, activity_id, "Component",
+                          "machine", "cluster", "file.cc:Function:10",
+                          "Message"),
+            "WARNING|cluster|machine|Component|" + ToString(correlation_id) +
+                "|" + ToString(parent_activity_id) + "|" +
+                ToString(activity_id) + "|file.cc:Function:10|Message");
+
+  EXPECT_EQ(
+      FormatLogLine(LogLevel::kError, kZeroUuid, kZeroUuid, activity_id,
+                    "Component", "", "", "file.cc:Function:20", ""),
+      "ERROR|||Component|00000000-0000-0000-0000-000000000000|"
+      "00000000-0000-0000-0000-000000000000|" +
+          ToString(activity_id) + "|file.cc:Function:20|");
+}
+
+TEST(LogFormatterTest, FormatsIdsSharingACacheEntry) {
+  // The ids hash to the same cache entry.
+  Uuid first{.high = 1, .low = 0};
+  Uuid second{.high = 0, .low = 1};
+  Uuid third{.high = 17, .low = 0};
+
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_EQ(FormatLogLine(LogLevel::kInfo, first, second, third, "", "", "",
+                            "", ""),
+              "INFO||||00000000-0000-0001-0000-000000000000|"
+              "00000000-0000-0000-0000-000000000001|"
+              "00000000-0000-0011-0000-000000000000||");
+    EXPECT_EQ(FormatLogLine(LogLevel::kInfo, third, first, second, "", "", "",
+                            "", ""),
+              "INFO||||00000000-0000-0011-0000-000000000000|"
+              "00000000-0000-0001-0000-000000000000|"
+              "00000000-0000-0000-0000-000000000001||");
+  }
+}
+
+TEST(LogFormatterTest, ReusesTheBuffer) {
+  const std::string& first_line =
+      FormatLogLine(LogLevel::kDebug, kZeroUuid, kZeroUuid, kZeroUuid,
+                    "Component", "", "", "", "First");
+  const std::string& second_line =
+      FormatLogLine(LogLevel::kDebug, kZeroUuid, kZeroUuid, kZeroUuid,
+                    "Component", "", "", "", "Second");
+
+  EXPECT_EQ(&first_line, &second_line);
+  EXPECT_TRUE(second_line.ends_with("|Second"));
+}
+
+}  // namespace
+}  // namespace privacy_sandbox::pbs_common
@@ -26,7 +26,6 @@
 namespace privacy_sandbox::pbs_common {
 
 using ::google::cloud::MakeExternalAccountCredentials;
-using ::google::cloud::Options;
 using ::google::cloud::UnifiedCredentialsOption;
 using ::google::cloud::iam_credentials_v1::IAMCredentialsClient;
 using ::google::cloud::iam_credentials_v1::IAMCredentialsConnection;
@@ -58,11 +57,13 @@ void AwsTokenFetcher::CreateIamClient(const GrpcAuthConfig& auth_config) {
   std::shared_ptr<IAMCredentialsConnection> credentials_connection;
 
   if (auth_config.cred_config().empty()) {
-    credentials_connection = MakeIAMCredentialsConnection(Options());
+    credentials_connection =
+        MakeIAMCredentialsConnection(MakeIdTokenFetchOptions());
   } else {
     credentials_connection = MakeIAMCredentialsConnection(
-        Options().set<UnifiedCredentialsOption>(MakeExternalAccountCredentials(
-            std::string(auth_config.cred_config()))));
+        MakeIdTokenFetchOptions().set<UnifiedCredentialsOption>(
+            MakeExternalAccountCredentials(
+                std::string(auth_config.cred_config()))));
   }
 
   iam_client_ = std::make_unique<IAMCredentialsClient>(credentials_connection);
@@ -42,7 +42,8 @@ ExecutionResultOr<std::string> GcpTokenFetcher::FetchIdToken(
 void GcpTokenFetcher::CreateIamClient() {
   std::shared_ptr<google::cloud::iam_credentials_v1::IAMCredentialsConnection>
       credentials_connection =
-          google::cloud::iam_credentials_v1::MakeIAMCredentialsConnection();
+          google::cloud::iam_credentials_v1::MakeIAMCredentialsConnection(
+              MakeIdTokenFetchOptions());
   iam_client_ =
       std::make_unique<google::cloud::iam_credentials_v1::IAMCredentialsClient>(
           credentials_connection);
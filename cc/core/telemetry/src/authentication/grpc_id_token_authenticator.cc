@@ -16,10 +16,13 @@
 
 #include <map>
 #include <memory>
-#include <mutex>
+#include <random>
 #include <string>
 #include <utility>
 
+#include "absl/strings/str_cat.h"
+#include "cc/core/common/global_logger/src/global_logger.h"
+#include "cc/core/common/uuid/src/uuid.h"
 #include "cc/core/telemetry/src/authentication/gcp_token_fetcher.h"
 
 namespace privacy_sandbox::pbs_common {
@@ -32,6 +35,9 @@ namespace privacy_sandbox::pbs_common {
 // See: https://cloud.google.com/docs/authentication/token-types#id-lifetime
 inline constexpr std::int32_t kIdTokenValidity = 3000;
 
+inline constexpr absl::string_view kGrpcIdTokenAuthenticator =
+    "GrpcIdTokenAuthenticator";
+
 /**
  * @brief Periodically refreshes authentication tokens for gRPC metadata.
  *
@@ -44,55 +50,106 @@ inline constexpr std::int32_t kIdTokenValidity = 3000;
  */
 GrpcIdTokenAuthenticator::GrpcIdTokenAuthenticator(
     std::unique_ptr<GrpcAuthConfig> auth_config,
-    std::unique_ptr<TokenFetcher> token_fetcher)
+    std::unique_ptr<TokenFetcher> token_fetcher,
+    IdTokenRefreshOptions refresh_options)
     : auth_config_(std::move(auth_config)),
       token_fetcher_(std::move(token_fetcher)),
-      expiry_time_(std::chrono::system_clock::now()) {}
+      refresh_options_(refresh_options),
+      expiry_time_(std::chrono::system_clock::now()),
+      refresh_time_(expiry_time_),
+      random_generator_(std::random_device()()),
+      token_refresher_(std::make_unique<PeriodicClosure>(
+          refresh_options_.check_interval, [this] { RefreshTokenIfNeeded(); })) {
+  if (auto status = token_refresher_->Start(); !status.ok()) {
+    SCP_WARNING(kGrpcIdTokenAuthenticator, kZeroUuid,
+                absl::StrCat("Failed to start the ID token refresher: ",
+                             status.ToString()));
+  }
+}
+
+GrpcIdTokenAuthenticator::~GrpcIdTokenAuthenticator() {
+  if (token_refresher_) {
+    token_refresher_->Stop();
+  }
+}
 
 grpc::Status GrpcIdTokenAuthenticator::GetMetadata(
     grpc::string_ref service_url, grpc::string_ref method_name,
     const grpc::AuthContext& channel_auth_context,
     std::multimap<grpc::string, grpc::string>* metadata) {
-  // handling token expiry
-  if (IsExpired()) {
-    ExecutionResultOr<std::string> token =
-        token_fetcher_->FetchIdToken(*auth_config_);
-    if (!token.Successful()) {
-      return grpc::Status(grpc::StatusCode::UNKNOWN,
-                          "token_fetcher_->FetchIdToken() failed");
+  std::string id_token;
+  {
+    absl::MutexLock lock(&mutex_);
+    // The token is fetched on the background thread. Never wait for it here.
+    if (id_token_.empty() || std::chrono::system_clock::now() >= expiry_time_) {
+      return grpc::Status(grpc::StatusCode::UNAVAILABLE,
+                          "No valid ID token is available yet.");
     }
-    id_token_ = *token;
-    expiry_time_ = std::chrono::system_clock::now() +
-                   std::chrono::seconds(kIdTokenValidity);
+    id_token = id_token_;
   }
 
-  metadata->insert(std::make_pair("authorization", "Bearer " + id_token_));
+  metadata->insert(std::make_pair("authorization", "Bearer " + id_token));
   return grpc::Status::OK;
 }
 
+void GrpcIdTokenAuthenticator::RefreshTokenIfNeeded() {
+  auto now = std::chrono::system_clock::now();
+  if (now < refresh_time_) {
+    return;
+  }
+
+  ExecutionResultOr<std::string> token =
+      token_fetcher_->FetchIdToken(*auth_config_);
+  if (!token.Successful()) {
+    // Retried on the next check while the current token, if any, is still
+    // served until it expires.
+    SCP_WARNING(kGrpcIdTokenAuthenticator, kZeroUuid,
+                "Failed to refresh the ID token, keeping the current one.");
+    return;
+  }
+
+  now = std::chrono::system_clock::now();
+  const auto validity = std::chrono::seconds(kIdTokenValidity);
+  std::uniform_real_distribution<double> jitter(
+      0, refresh_options_.jitter_fraction);
+  refresh_time_ =
+      now + std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                validity * (refresh_options_.refresh_after_fraction +
+                            jitter(random_generator_)));
+
+  absl::MutexLock lock(&mutex_);
+  id_token_ = std::move(*token);
+  expiry_time_ = now + validity;
+}
+
 GrpcAuthConfig* GrpcIdTokenAuthenticator::auth_config() const {
   return auth_config_.get();
 }
 
 void GrpcIdTokenAuthenticator::set_id_token(absl::string_view token) {
+  absl::MutexLock lock(&mutex_);
   id_token_ = token;
 }
 
-const std::string& GrpcIdTokenAuthenticator::id_token() const {
+std::string GrpcIdTokenAuthenticator::id_token() const {
+  absl::MutexLock lock(&mutex_);
   return id_token_;
 }
 
 void GrpcIdTokenAuthenticator::set_expiry_time_for_testing(
     const std::chrono::system_clock::time_point& expiry_time) {
+  absl::MutexLock lock(&mutex_);
   expiry_time_ = expiry_time;
 }
 
-const std::chrono::system_clock::time_point&
-GrpcIdTokenAuthenticator::expiry_time() const {
+std::chrono::system_clock::time_point GrpcIdTokenAuthenticator::expiry_time()
+    const {
+  absl::MutexLock lock(&mutex_);
   return expiry_time_;
 }
 
 bool GrpcIdTokenAuthenticator::IsExpired() const {
+  absl::MutexLock lock(&mutex_);
   return std::chrono::system_clock::now() >= expiry_time_;
 }
 }  // namespace privacy_sandbox::pbs_common
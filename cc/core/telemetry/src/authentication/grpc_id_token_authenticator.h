@@ -17,13 +17,29 @@
 #include <chrono>
 #include <map>
 #include <memory>
+#include <random>
 #include <string>
 
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
 #include "cc/core/telemetry/src/authentication/grpc_auth_config.h"
 #include "cc/core/telemetry/src/authentication/token_fetcher.h"
+#include "cc/core/thread/periodic_closure.h"
 #include "grpcpp/security/credentials.h"
 
 namespace privacy_sandbox::pbs_common {
+
+struct IdTokenRefreshOptions {
+  // How often the background thread checks whether the token is due for a
+  // refresh. This is also the retry interval after a failed fetch.
+  absl::Duration check_interval = absl::Seconds(10);
+  // Fraction of the token validity after which the token is refreshed.
+  double refresh_after_fraction = 0.5;
+  // Upper bound of the random delay added to each refresh, as a fraction of
+  // the token validity, so that a fleet does not refresh in lockstep.
+  double jitter_fraction = 0.1;
+};
+
 /**
  * @brief Periodically refreshes authentication tokens for gRPC metadata.
  *
@@ -35,6 +51,14 @@ namespace privacy_sandbox::pbs_common {
  * and grpc auth config and will be managing the id token for a particular
  * exporter.
  *
+ * Tokens are fetched on a background thread well ahead of their expiry, so
+ * GetMetadata() never waits for the token fetcher. A failed refresh is
+ * retried while the previous token keeps being served until it expires.
+ *
+ * Destruction stops the background thread and waits for a fetch in flight,
+ * if any. Token fetchers must therefore bound their fetches, as the IAM
+ * credentials ones do with kIdTokenFetchTimeout.
+ *
  * @note
  * https://grpc.io/docs/guides/auth/#extending-grpc-to-support-other-authentication-mechanisms
  */
@@ -44,7 +68,10 @@ class GrpcIdTokenAuthenticator : public grpc::MetadataCredentialsPlugin {
 
   explicit GrpcIdTokenAuthenticator(
       std::unique_ptr<GrpcAuthConfig> auth_config,
-      std::unique_ptr<TokenFetcher> token_fetcher);
+      std::unique_ptr<TokenFetcher> token_fetcher,
+      IdTokenRefreshOptions refresh_options = IdTokenRefreshOptions());
+
+  ~GrpcIdTokenAuthenticator() override;
 
   grpc::Status GetMetadata(
       grpc::string_ref service_url, grpc::string_ref method_name,
@@ -55,21 +82,36 @@ class GrpcIdTokenAuthenticator : public grpc::MetadataCredentialsPlugin {
 
   // Expiry time of the ID token (for testing purposes)
   void set_expiry_time_for_testing(
-      const std::chrono::system_clock::time_point& expiry_time);
-  const std::chrono::system_clock::time_point& expiry_time() const;
+      const std::chrono::system_clock::time_point& expiry_time)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+  std::chrono::system_clock::time_point expiry_time() const
+      ABSL_LOCKS_EXCLUDED(mutex_);
 
   // Checks if the token has expired based on the given duration
-  bool IsExpired() const;
+  bool IsExpired() const ABSL_LOCKS_EXCLUDED(mutex_);
 
-  const std::string& id_token() const;
+  std::string id_token() const ABSL_LOCKS_EXCLUDED(mutex_);
 
   // For testing or storing a generated ID token
-  void set_id_token(absl::string_view token);
+  void set_id_token(absl::string_view token) ABSL_LOCKS_EXCLUDED(mutex_);
 
  private:
+  // Fetches a new token if the current one is due for a refresh. Runs on the
+  // background thread.
+  void RefreshTokenIfNeeded() ABSL_LOCKS_EXCLUDED(mutex_);
+
   std::unique_ptr<GrpcAuthConfig> auth_config_;
   std::unique_ptr<TokenFetcher> token_fetcher_;
-  std::string id_token_;
-  std::chrono::system_clock::time_point expiry_time_;
+  IdTokenRefreshOptions refresh_options_;
+  mutable absl::Mutex mutex_;
+  std::string id_token_ ABSL_GUARDED_BY(mutex_);
+  std::chrono::system_clock::time_point expiry_time_ ABSL_GUARDED_BY(mutex_);
+  // Time after which the background thread fetches a new token. Only accessed
+  // by the background thread.
+  std::chrono::system_clock::time_point refresh_time_;
+  std::mt19937 random_generator_;
+  // Declared last so that the background thread is stopped before the state
+  // it uses is destroyed.
+  std::unique_ptr<PeriodicClosure> token_refresher_;
 };
 }  // namespace privacy_sandbox::pbs_common
@@ -14,6 +14,7 @@
 
 #include "cc/core/telemetry/src/authentication/token_fetcher_utils.h"
 
+#include <chrono>
 #include <string>
 #include <vector>
 
@@ -22,12 +23,27 @@
 #include "cc/core/common/uuid/src/uuid.h"
 #include "cc/core/telemetry/src/authentication/error_codes.h"
 #include "cc/core/telemetry/src/authentication/grpc_auth_config.h"
+#include "google/cloud/grpc_options.h"
+#include "grpcpp/client_context.h"
 
 namespace privacy_sandbox::pbs_common {
 
 inline constexpr absl::string_view kFetchIdTokenInternal =
     "FetchIdTokenInternal";
 
+google::cloud::Options MakeIdTokenFetchOptions() {
+  return google::cloud::Options()
+      .set<google::cloud::iam_credentials_v1::IAMCredentialsRetryPolicyOption>(
+          google::cloud::iam_credentials_v1::
+              IAMCredentialsLimitedTimeRetryPolicy(kIdTokenFetchTimeout)
+                  .clone())
+      // The retry policy does not interrupt an attempt, the deadline does.
+      .set<google::cloud::GrpcSetupOption>([](grpc::ClientContext& context) {
+        context.set_deadline(std::chrono::system_clock::now() +
+                             kIdTokenFetchTimeout);
+      });
+}
+
 /*
  * The resource name of the service account for which the credentials are
  * requested, in the following format:
@@ -15,15 +15,26 @@
 #ifndef CC_CORE_TELEMETRY_SRC_AUTHENTICATION_TOKEN_FETCHER_UTILS_H_
 #define CC_CORE_TELEMETRY_SRC_AUTHENTICATION_TOKEN_FETCHER_UTILS_H_
 
+#include <chrono>
 #include <string>
 
 #include "cc/core/telemetry/src/authentication/grpc_auth_config.h"
 #include "cc/core/telemetry/src/authentication/token_fetcher.h"
 #include "cc/public/core/interface/execution_result.h"
 #include "google/cloud/iam/credentials/v1/iam_credentials_client.h"
+#include "google/cloud/options.h"
 
 namespace privacy_sandbox::pbs_common {
 
+// Upper bound of an ID token fetch, retries included, so that an unresponsive
+// IAM credentials service cannot hang the thread fetching the token.
+inline constexpr std::chrono::seconds kIdTokenFetchTimeout =
+    std::chrono::seconds(10);
+
+// Returns the options of the IAM credentials connections fetching ID tokens,
+// which give up on a fetch after kIdTokenFetchTimeout.
+google::cloud::Options MakeIdTokenFetchOptions();
+
 ExecutionResultOr<std::string> FetchIdTokenInternal(
     google::cloud::iam_credentials_v1::IAMCredentialsClient& iam_client,
     const GrpcAuthConfig& auth_config);
@@ -55,6 +55,47 @@ inline constexpr absl::string_view kOtelMetricExportTimeoutMsecKey =
     "google_scp_otel_metric_export_timeout_msec";
 inline constexpr int32_t kOtelMetricExportTimeoutMsecValue = 20000;
 
+// Maximum number of distinct attribute sets recorded per instrument. Further
+// attribute sets are recorded with the otel.metric.overflow attribute instead.
+// Defaults to 2000
+inline constexpr absl::string_view kOtelMetricMaxAttributeSetsPerInstrumentKey =
+    "google_scp_otel_metric_max_attribute_sets_per_instrument";
+inline constexpr int32_t kOtelMetricMaxAttributeSetsPerInstrumentValue = 2000;
+
+// Metric aggregation temporality
+//
+// Supported values are:
+// - "cumulative": every export carries the totals since the start
+// - "delta": every export only carries the series updated since the last one
+// - "lowmemory": delta for the synchronous counters and histograms
+inline constexpr absl::string_view kOtelMetricAggregationTemporalityKey =
+    "google_scp_otel_metric_aggregation_temporality";
+inline constexpr absl::string_view kOtelMetricAggregationTemporalityValue =
+    "cumulative";
+
+// Compression of the OTLP export requests, "gzip", or none when empty or
+// "none"
+inline constexpr absl::string_view kOtelExporterOtlpCompressionKey =
+    "google_scp_otel_exporter_otlp_compression";
+inline constexpr absl::string_view kOtelExporterOtlpCompressionValue = "";
+
+// Maximum number of data points per metric export request. The data collected
+// at an interval is split in as many requests as needed.
+// Defaults to 0, which sends all of it in a single request
+inline constexpr absl::string_view kOtelMetricMaxExportBatchSizeKey =
+    "google_scp_otel_metric_max_export_batch_size";
+inline constexpr int32_t kOtelMetricMaxExportBatchSizeValue = 0;
+
+// Maximum number of data points exported at an interval. The data points over
+// it are dropped and counted. They are cut in the order the SDK collects them,
+// so the ones dropped are the same at every interval: those of the instruments
+// collected last. The limit is a safety net against a cardinality explosion,
+// to be set above the expected number of data points.
+// Defaults to 0, which exports every data point
+inline constexpr absl::string_view kOtelMetricMaxExportDataPointsKey =
+    "google_scp_otel_metric_max_export_data_points";
+inline constexpr int32_t kOtelMetricMaxExportDataPointsValue = 0;
+
 // Service Account
 inline constexpr absl::string_view kOtelServiceAccountKey =
     "google_scp_otel_service_account";
@@ -91,6 +132,42 @@ inline constexpr absl::string_view kOtelTraceSamplingRatioKey =
     "google_scp_otel_trace_sampling_ratio";
 inline constexpr double kOtelTraceSamplingRatioValue = 0.1;
 
+// Tail-based trace sampling. Every span is recorded and the spans of a request
+// are buffered until its root span ends, then the request is kept if it was
+// slow, errored or is in the baseline. The sampling ratio is then unused.
+// A request errors when a span status is set to StatusCode::kError, which no
+// span of the tree sets yet.
+// Default value: false.
+inline constexpr absl::string_view kOtelTraceTailSamplingEnabledKey =
+    "google_scp_otel_trace_tail_sampling_enabled";
+inline constexpr bool kOtelTraceTailSamplingEnabledValue = false;
+
+// Minimum duration of the root span of a request kept by the tail sampling.
+// Default value: 1000 milliseconds.
+inline constexpr absl::string_view kOtelTraceTailSamplingLatencyMsecKey =
+    "google_scp_otel_trace_tail_sampling_latency_threshold_msec";
+inline constexpr int32_t kOtelTraceTailSamplingLatencyMsecValue = 1000;
+
+// Ratio of the requests kept by the tail sampling regardless of their latency.
+// Default value: 0.01 (1%).
+inline constexpr absl::string_view kOtelTraceTailSamplingBaselineRatioKey =
+    "google_scp_otel_trace_tail_sampling_baseline_ratio";
+inline constexpr double kOtelTraceTailSamplingBaselineRatioValue = 0.01;
+
+// The maximum number of spans buffered by the tail sampling, split by trace id
+// across up to 16 shards. After the share of a shard is reached, its oldest
+// undecided requests are dropped.
+// Default value: 8192.
+inline constexpr absl::string_view kOtelTraceTailSamplingMaxBufferedSpansKey =
+    "google_scp_otel_trace_tail_sampling_max_buffered_spans";
+inline constexpr int32_t kOtelTraceTailSamplingMaxBufferedSpansValue = 8192;
+
+// The maximum number of spans buffered for a single request.
+// Default value: 512.
+inline constexpr absl::string_view kOtelTraceTailSamplingMaxSpansPerTraceKey =
+    "google_scp_otel_trace_tail_sampling_max_spans_per_trace";
+inline constexpr int32_t kOtelTraceTailSamplingMaxSpansPerTraceValue = 512;
+
 // Cred config path
 // defaults to empty string for local and gcp cases, non-empty in the case of
 // AWS
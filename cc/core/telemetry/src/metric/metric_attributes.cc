@@ -0,0 +1,70 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cc/core/telemetry/src/metric/metric_attributes.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace privacy_sandbox::pbs_common {
+namespace {
+
+std::vector<std::pair<std::string, std::string>> SortLabels(
+    const absl::flat_hash_map<absl::string_view, std::string>& labels) {
+  std::vector<std::pair<std::string, std::string>> sorted_labels;
+  sorted_labels.reserve(labels.size());
+  for (const auto& [key, value] : labels) {
+    sorted_labels.emplace_back(std::string(key), value);
+  }
+  std::sort(sorted_labels.begin(), sorted_labels.end());
+  return sorted_labels;
+}
+
+std::vector<std::pair<opentelemetry::nostd::string_view,
+                      opentelemetry::common::AttributeValue>>
+ToAttributes(const std::vector<std::pair<std::string, std::string>>& labels) {
+  std::vector<std::pair<opentelemetry::nostd::string_view,
+                        opentelemetry::common::AttributeValue>>
+      attributes;
+  attributes.reserve(labels.size());
+  for (const auto& [key, value] : labels) {
+    attributes.emplace_back(
+        opentelemetry::nostd::string_view(key.data(), key.size()),
+        opentelemetry::nostd::string_view(value.data(), value.size()));
+  }
+  return attributes;
+}
+
+}  // namespace
+
+MetricAttributes::MetricAttributes(
+    const absl::flat_hash_map<absl::string_view, std::string>& labels)
+    : labels_(SortLabels(labels)),
+      attributes_(ToAttributes(labels_)),
+      view_(attributes_) {}
+
+const std::shared_ptr<const MetricAttributes>& MetricAttributes::Overflow() {
+  static const auto* overflow = new std::shared_ptr<const MetricAttributes>(
+      std::make_shared<const MetricAttributes>(
+          absl::flat_hash_map<absl::string_view, std::string>{
+              {kOtelMetricOverflowAttribute, "true"}}));
+  return *overflow;
+}
+
+}  // namespace privacy_sandbox::pbs_common
@@ -0,0 +1,128 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "opentelemetry/common/attribute_value.h"
+#include "opentelemetry/common/key_value_iterable_view.h"
+#include "opentelemetry/context/context.h"
+#include "opentelemetry/metrics/sync_instruments.h"
+#include "opentelemetry/nostd/string_view.h"
+
+namespace privacy_sandbox::pbs_common {
+
+/// The attribute the attribute sets over the cardinality limit of an
+/// instrument are recorded with.
+inline constexpr absl::string_view kOtelMetricOverflowAttribute =
+    "otel.metric.overflow";
+
+/**
+ * @brief An immutable set of metric attributes, sorted by key, which can be
+ * recorded with any number of measurements without being converted again.
+ *
+ * Instances are interned by MetricRouter::GetOrCreateAttributes, or built once
+ * for attributes which never change, and shared by the recording threads.
+ */
+class MetricAttributes {
+ public:
+  explicit MetricAttributes(
+      const absl::flat_hash_map<absl::string_view, std::string>& labels);
+
+  MetricAttributes(const MetricAttributes&) = delete;
+  MetricAttributes& operator=(const MetricAttributes&) = delete;
+
+  /// The attributes, to pass to Counter::Add or Histogram::Record.
+  const opentelemetry::common::KeyValueIterable& Get() const noexcept {
+    return view_;
+  }
+
+  /// The attributes, sorted by key.
+  const std::vector<std::pair<std::string, std::string>>& GetLabels()
+      const noexcept {
+    return labels_;
+  }
+
+  /// The attribute set recorded in place of the attribute sets over the
+  /// cardinality limit of an instrument.
+  static const std::shared_ptr<const MetricAttributes>& Overflow();
+
+ private:
+  using AttributeVector =
+      std::vector<std::pair<opentelemetry::nostd::string_view,
+                            opentelemetry::common::AttributeValue>>;
+
+  const std::vector<std::pair<std::string, std::string>> labels_;
+  /// Views of labels_, in the form the SDK iterates over.
+  const AttributeVector attributes_;
+  const opentelemetry::common::KeyValueIterableView<AttributeVector> view_;
+};
+
+/// A counter bound to an attribute set.
+template <typename T>
+class BoundCounter {
+ public:
+  BoundCounter() = default;
+
+  BoundCounter(std::shared_ptr<opentelemetry::metrics::Counter<T>> counter,
+               std::shared_ptr<const MetricAttributes> attributes)
+      : counter_(std::move(counter)), attributes_(std::move(attributes)) {}
+
+  /// Whether the counter records anything.
+  explicit operator bool() const noexcept {
+    return counter_ != nullptr && attributes_ != nullptr;
+  }
+
+  void Add(T value) const noexcept { counter_->Add(value, attributes_->Get()); }
+
+ private:
+  std::shared_ptr<opentelemetry::metrics::Counter<T>> counter_;
+  std::shared_ptr<const MetricAttributes> attributes_;
+};
+
+/// A histogram bound to an attribute set.
+template <typename T>
+class BoundHistogram {
+ public:
+  BoundHistogram() = default;
+
+  BoundHistogram(
+      std::shared_ptr<opentelemetry::metrics::Histogram<T>> histogram,
+      std::shared_ptr<const MetricAttributes> attributes)
+      : histogram_(std::move(histogram)), attributes_(std::move(attributes)) {}
+
+  /// Whether the histogram records anything.
+  explicit operator bool() const noexcept {
+    return histogram_ != nullptr && attributes_ != nullptr;
+  }
+
+  void Record(T value) const noexcept {
+    histogram_->Record(value, attributes_->Get(),
+                       opentelemetry::context::Context());
+  }
+
+ private:
+  std::shared_ptr<opentelemetry::metrics::Histogram<T>> histogram_;
+  std::shared_ptr<const MetricAttributes> attributes_;
+};
+
+}  // namespace privacy_sandbox::pbs_common
@@ -14,11 +14,13 @@
 
 #include "cc/core/telemetry/src/metric/metric_router.h"
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/span.h"
 #include "cc/core/common/uuid/src/uuid.h"
@@ -37,10 +39,41 @@ namespace privacy_sandbox::pbs_common {
 
 inline constexpr absl::string_view kMetricRouter = "MetricRouter";
 
+namespace {
+
+/**
+ * Builds a key identifying the labels whatever their order, in a buffer reused
+ * by the calling thread. The raw bytes of their lengths prefix the keys and
+ * values so that no separator needs escaping, and no number is formatted.
+ */
+absl::string_view MakeAttributesKey(
+    const absl::flat_hash_map<absl::string_view, std::string>& labels) {
+  thread_local std::vector<std::pair<absl::string_view, absl::string_view>>
+      sorted_labels;
+  thread_local std::string key;
+  sorted_labels.assign(labels.begin(), labels.end());
+  std::sort(sorted_labels.begin(), sorted_labels.end());
+  key.clear();
+  for (const auto& [label_key, label_value] : sorted_labels) {
+    for (absl::string_view part : {label_key, label_value}) {
+      const size_t size = part.size();
+      key.append(reinterpret_cast<const char*>(&size), sizeof(size));
+      key.append(part.data(), part.size());
+    }
+  }
+  return key;
+}
+
+}  // namespace
+
 MetricRouter::MetricRouter(
     std::shared_ptr<ConfigProviderInterface> config_provider,
     opentelemetry::sdk::resource::Resource resource,
     std::unique_ptr<opentelemetry::sdk::metrics::PushMetricExporter> exporter) {
+  max_attribute_sets_per_instrument_ = static_cast<size_t>(
+      GetConfigValue(std::string(kOtelMetricMaxAttributeSetsPerInstrumentKey),
+                     kOtelMetricMaxAttributeSetsPerInstrumentValue,
+                     *config_provider));
   SetupMetricRouter(std::move(resource),
                     CreatePeriodicReader(config_provider, std::move(exporter)));
 }
@@ -88,6 +121,13 @@ MetricRouter::CreatePeriodicReader(
 std::shared_ptr<opentelemetry::metrics::Meter> MetricRouter::GetOrCreateMeter(
     absl::string_view service_name, absl::string_view version,
     absl::string_view schema_url) {
+  {
+    absl::ReaderMutexLock lock(&metric_mutex_);
+    if (auto it = meters_.find(service_name); it != meters_.end()) {
+      return it->second;
+    }
+  }
+
   absl::MutexLock lock(&metric_mutex_);
   std::string service(service_name);
   auto [it, inserted] = meters_.insert(
@@ -105,6 +145,14 @@ MetricRouter::GetOrCreateSyncInstrument(
     absl::AnyInvocable<
         std::shared_ptr<opentelemetry::metrics::SynchronousInstrument>()>
         instrument_factory) {
+  {
+    absl::ReaderMutexLock lock(&metric_mutex_);
+    if (auto it = synchronous_instruments_.find(metric_name);
+        it != synchronous_instruments_.end()) {
+      return it->second;
+    }
+  }
+
   absl::MutexLock lock(&metric_mutex_);
   std::string metric(metric_name);
   auto [it, inserted] = synchronous_instruments_.insert(
@@ -122,6 +170,14 @@ MetricRouter::GetOrCreateObservableInstrument(
     absl::AnyInvocable<
         std::shared_ptr<opentelemetry::metrics::ObservableInstrument>()>
         instrument_factory) {
+  {
+    absl::ReaderMutexLock lock(&metric_mutex_);
+    if (auto it = asynchronous_instruments_.find(metric_name);
+        it != asynchronous_instruments_.end()) {
+      return it->second;
+    }
+  }
+
   absl::MutexLock lock(&metric_mutex_);
   std::string metric(metric_name);
   auto [it, inserted] = asynchronous_instruments_.insert(
@@ -133,6 +189,52 @@ MetricRouter::GetOrCreateObservableInstrument(
   return it->second;
 }
 
+std::shared_ptr<const MetricAttributes> MetricRouter::GetOrCreateAttributes(
+    absl::string_view metric_name,
+    const absl::flat_hash_map<absl::string_view, std::string>& labels) {
+  absl::string_view key = MakeAttributesKey(labels);
+  {
+    absl::ReaderMutexLock lock(&attributes_mutex_);
+    if (auto sets = attribute_sets_.find(metric_name);
+        sets != attribute_sets_.end()) {
+      if (auto it = sets->second.attribute_sets.find(key);
+          it != sets->second.attribute_sets.end()) {
+        return it->second;
+      }
+    }
+  }
+
+  absl::MutexLock lock(&attributes_mutex_);
+  auto sets = attribute_sets_.find(metric_name);
+  if (sets == attribute_sets_.end()) {
+    sets = attribute_sets_.emplace(std::string(metric_name),
+                                   MetricAttributeSets())
+               .first;
+  }
+  MetricAttributeSets& metric_sets = sets->second;
+  if (auto it = metric_sets.attribute_sets.find(key);
+      it != metric_sets.attribute_sets.end()) {
+    return it->second;
+  }
+
+  if (metric_sets.attribute_sets.size() >= max_attribute_sets_per_instrument_) {
+    if (!metric_sets.overflowed) {
+      metric_sets.overflowed = true;
+      SCP_WARNING(
+          kMetricRouter, kZeroUuid,
+          absl::StrFormat("[OTLP Metric Router] Metric %s exceeded %d "
+                          "attribute sets. Further ones are recorded as %s.",
+                          metric_name, max_attribute_sets_per_instrument_,
+                          kOtelMetricOverflowAttribute));
+    }
+    return MetricAttributes::Overflow();
+  }
+
+  auto attributes = std::make_shared<const MetricAttributes>(labels);
+  metric_sets.attribute_sets.emplace(std::string(key), attributes);
+  return attributes;
+}
+
 ExecutionResult MetricRouter::CreateViewForInstrument(
     absl::string_view meter_name, absl::string_view instrument_name,
     opentelemetry::sdk::metrics::InstrumentType instrument_type,
@@ -26,7 +26,9 @@
 #include "cc/core/common/global_logger/src/global_logger.h"
 #include "cc/core/common/uuid/src/uuid.h"
 #include "cc/core/interface/config_provider_interface.h"
+#include "cc/core/telemetry/src/common/telemetry_configuration.h"
 #include "cc/core/telemetry/src/metric/error_codes.h"
+#include "cc/core/telemetry/src/metric/metric_attributes.h"
 #include "opentelemetry/metrics/async_instruments.h"
 #include "opentelemetry/metrics/meter.h"
 #include "opentelemetry/metrics/meter_provider.h"
@@ -119,6 +121,30 @@ class MetricRouter {
           std::shared_ptr<opentelemetry::metrics::ObservableInstrument>()>
           instrument_factory);
 
+  /**
+   * Gets the interned attribute set of the given labels for a metric, or
+   * creates it if it doesn't exist.
+   *
+   * The number of attribute sets of a metric is capped by
+   * kOtelMetricMaxAttributeSetsPerInstrumentKey, so that a label with
+   * unbounded values, e.g. an origin or a path, cannot explode the number of
+   * series exported. The labels over the cap get MetricAttributes::Overflow()
+   * instead, and a warning is logged once for the metric.
+   *
+   * This function is thread-safe. Looking up an existing attribute set only
+   * takes a shared lock; callers whose labels never change should keep the
+   * attribute set, e.g. in a BoundCounter or BoundHistogram, rather than look
+   * it up for each measurement.
+   *
+   * @param metric_name The name of the metric the labels are recorded with
+   * @param labels The labels of the measurement
+   * @return A shared pointer to the attribute set to record the measurement
+   * with
+   */
+  std::shared_ptr<const MetricAttributes> GetOrCreateAttributes(
+      absl::string_view metric_name,
+      const absl::flat_hash_map<absl::string_view, std::string>& labels);
+
   /**
    * @brief Creates a view for an instrument, defining how data from the
    * instrument will be aggregated and viewed. View for instrument should be
@@ -206,6 +232,14 @@ class MetricRouter {
       std::unique_ptr<opentelemetry::sdk::metrics::PushMetricExporter>
           exporter);
 
+  /// The interned attribute sets of a metric.
+  struct MetricAttributeSets {
+    absl::flat_hash_map<std::string, std::shared_ptr<const MetricAttributes>>
+        attribute_sets;
+    /// Whether labels were sent to the overflow attribute set.
+    bool overflowed = false;
+  };
+
   absl::flat_hash_map<std::string,
                       std::shared_ptr<opentelemetry::metrics::Meter>>
       meters_;
@@ -219,6 +253,13 @@ class MetricRouter {
       asynchronous_instruments_;
 
   mutable absl::Mutex metric_mutex_;
+
+  // Maximum number of attribute sets per metric.
+  size_t max_attribute_sets_per_instrument_ =
+      kOtelMetricMaxAttributeSetsPerInstrumentValue;
+  mutable absl::Mutex attributes_mutex_;
+  absl::flat_hash_map<std::string, MetricAttributeSets> attribute_sets_
+      ABSL_GUARDED_BY(attributes_mutex_);
 };
 
 }  // namespace privacy_sandbox::pbs_common
@@ -14,15 +14,19 @@
 
 #include "cc/core/telemetry/src/metric/otlp_grpc_authed_metric_exporter.h"
 
+#include <algorithm>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <utility>
+#include <variant>
 
+#include "absl/functional/function_ref.h"
 #include "absl/strings/str_cat.h"
 #include "cc/core/common/global_logger/src/global_logger.h"
 #include "cc/core/common/uuid/src/uuid.h"
 #include "cc/core/telemetry/src/authentication/gcp_token_fetcher.h"
+#include "cc/core/telemetry/src/common/telemetry_configuration.h"
 #include "cc/core/telemetry/src/metric/error_codes.h"
 #include "opentelemetry/exporters/otlp/otlp_grpc_client.h"
 #include "opentelemetry/exporters/otlp/otlp_metric_utils.h"
@@ -32,6 +36,143 @@ namespace privacy_sandbox::pbs_common {
 inline constexpr absl::string_view kOtlpGrpcAuthedExporter =
     "OtlpGrpcAuthedExporter";
 
+inline constexpr absl::string_view kOtlpExporterMeter = "OtlpExporter";
+inline constexpr absl::string_view kExportedDataPointsMetric =
+    "otel.exporter.exported_data_points";
+inline constexpr absl::string_view kDroppedDataPointsMetric =
+    "otel.exporter.dropped_data_points";
+inline constexpr absl::string_view kFailedRequestsMetric =
+    "otel.exporter.failed_requests";
+inline constexpr absl::string_view kRequestSizeMetric =
+    "otel.exporter.request.size";
+inline constexpr absl::string_view kExportDurationMetric =
+    "otel.exporter.export.duration";
+
+namespace {
+
+/**
+ * Calls export_batch with the data split in batches of at most
+ * limits.max_export_batch_size data points, up to
+ * limits.max_export_data_points data points in total. The data points over it
+ * are the trailing ones, in the order of data.
+ *
+ * @return The number of data points dropped.
+ */
+size_t ForEachBatch(
+    const opentelemetry::sdk::metrics::ResourceMetrics& data,
+    const OtlpMetricExportLimits& limits,
+    absl::FunctionRef<void(const opentelemetry::sdk::metrics::ResourceMetrics&)>
+        export_batch) {
+  opentelemetry::sdk::metrics::ResourceMetrics batch;
+  batch.resource_ = data.resource_;
+  size_t batch_size = 0;
+  size_t total_size = 0;
+  size_t dropped = 0;
+
+  for (const opentelemetry::sdk::metrics::ScopeMetrics& scope_metrics :
+       data.scope_metric_data_) {
+    for (const opentelemetry::sdk::metrics::MetricData& metric :
+         scope_metrics.metric_data_) {
+      const auto& points = metric.point_data_attr_;
+      size_t begin = 0;
+      while (begin < points.size()) {
+        size_t count = points.size() - begin;
+        if (limits.max_export_data_points > 0) {
+          if (total_size >= limits.max_export_data_points) {
+            dropped += count;
+            break;
+          }
+          count = std::min(count, limits.max_export_data_points - total_size);
+        }
+        if (limits.max_export_batch_size > 0) {
+          count = std::min(count, limits.max_export_batch_size - batch_size);
+        }
+
+        if (batch.scope_metric_data_.empty() ||
+            batch.scope_metric_data_.back().scope_ != scope_metrics.scope_) {
+          batch.scope_metric_data_.emplace_back();
+          batch.scope_metric_data_.back().scope_ = scope_metrics.scope_;
+        }
+        opentelemetry::sdk::metrics::MetricData& slice =
+            batch.scope_metric_data_.back().metric_data_.emplace_back();
+        slice.instrument_descriptor = metric.instrument_descriptor;
+        slice.aggregation_temporality = metric.aggregation_temporality;
+        slice.start_ts = metric.start_ts;
+        slice.end_ts = metric.end_ts;
+        slice.point_data_attr_.assign(points.begin() + begin,
+                                      points.begin() + begin + count);
+
+        begin += count;
+        batch_size += count;
+        total_size += count;
+        if (batch_size == limits.max_export_batch_size) {
+          export_batch(batch);
+          batch.scope_metric_data_.clear();
+          batch_size = 0;
+        }
+      }
+    }
+  }
+
+  if (batch_size > 0) {
+    export_batch(batch);
+  }
+  return dropped;
+}
+
+opentelemetry::exporter::otlp::PreferredAggregationTemporality
+ParseAggregationTemporality(absl::string_view temporality) {
+  if (temporality == "delta") {
+    return opentelemetry::exporter::otlp::PreferredAggregationTemporality::
+        kDelta;
+  }
+  if (temporality == "lowmemory") {
+    return opentelemetry::exporter::otlp::PreferredAggregationTemporality::
+        kLowMemory;
+  }
+  if (temporality != "cumulative") {
+    SCP_WARNING(kOtlpGrpcAuthedExporter, kZeroUuid,
+                absl::StrFormat("Invalid config value: %s for option %s, "
+                                "using cumulative.",
+                                temporality,
+                                kOtelMetricAggregationTemporalityKey));
+  }
+  return opentelemetry::exporter::otlp::PreferredAggregationTemporality::
+      kCumulative;
+}
+
+}  // namespace
+
+opentelemetry::exporter::otlp::OtlpGrpcMetricExporterOptions
+GetOtlpGrpcMetricExporterOptions(ConfigProviderInterface& config_provider) {
+  opentelemetry::exporter::otlp::OtlpGrpcMetricExporterOptions options;
+  options.endpoint =
+      GetConfigValue(std::string(kOtelExporterOtlpEndpointKey),
+                     std::string(kOtelExporterOtlpEndpointValue),
+                     config_provider);
+  options.aggregation_temporality = ParseAggregationTemporality(
+      GetConfigValue(std::string(kOtelMetricAggregationTemporalityKey),
+                     std::string(kOtelMetricAggregationTemporalityValue),
+                     config_provider));
+  options.compression =
+      GetConfigValue(std::string(kOtelExporterOtlpCompressionKey),
+                     std::string(kOtelExporterOtlpCompressionValue),
+                     config_provider);
+  return options;
+}
+
+OtlpMetricExportLimits GetOtlpMetricExportLimits(
+    ConfigProviderInterface& config_provider) {
+  OtlpMetricExportLimits limits;
+  limits.max_export_batch_size = static_cast<size_t>(std::max(
+      0, GetConfigValue(std::string(kOtelMetricMaxExportBatchSizeKey),
+                        kOtelMetricMaxExportBatchSizeValue, config_provider)));
+  limits.max_export_data_points = static_cast<size_t>(std::max(
+      0, GetConfigValue(std::string(kOtelMetricMaxExportDataPointsKey),
+                        kOtelMetricMaxExportDataPointsValue, config_provider)));
+  return limits;
+}
+
 /**
  * Creates a gRPC channel using the provided OTLP gRPC client options and a
  * configuration provider.
@@ -62,6 +203,15 @@ OtlpGrpcAuthedMetricExporter::MakeChannel(
       absl::StrCat(url.host_, ":", static_cast<int>(url.port_));
   grpc::ChannelArguments grpc_arguments;
   grpc_arguments.SetUserAgentPrefix(options.user_agent);
+  if (options.compression == "gzip") {
+    grpc_arguments.SetCompressionAlgorithm(GRPC_COMPRESS_GZIP);
+  } else if (!options.compression.empty() && options.compression != "none") {
+    SCP_WARNING(kOtlpGrpcAuthedExporter, kZeroUuid,
+                absl::StrFormat("Invalid config value: %s for option %s, "
+                                "using no compression.",
+                                options.compression,
+                                kOtelExporterOtlpCompressionKey));
+  }
 
   std::shared_ptr<grpc::ChannelCredentials> channel_credentials =
       grpc::InsecureChannelCredentials();
@@ -112,12 +262,19 @@ OtlpGrpcAuthedMetricExporter::MakeMetricsServiceStub(
 
 OtlpGrpcAuthedMetricExporter::OtlpGrpcAuthedMetricExporter(
     const opentelemetry::exporter::otlp::OtlpGrpcMetricExporterOptions& options,
-    std::unique_ptr<GrpcIdTokenAuthenticator> grpc_id_token_authenticator)
+    std::unique_ptr<GrpcIdTokenAuthenticator> grpc_id_token_authenticator,
+    OtlpMetricExportLimits limits)
     : options_(options),
       aggregation_temporality_selector_{
           opentelemetry::exporter::otlp::OtlpMetricUtils::
               ChooseTemporalitySelector(options_.aggregation_temporality)},
-      is_shutdown_(false) {
+      limits_(limits),
+      is_shutdown_(false),
+      exported_data_points_(0),
+      dropped_data_points_(0),
+      failed_requests_(0),
+      request_bytes_(0),
+      last_export_duration_us_(0) {
   auto metrics_service_stub =
       MakeMetricsServiceStub(options_, std::move(grpc_id_token_authenticator));
   if (metrics_service_stub.Successful()) {
@@ -152,10 +309,44 @@ opentelemetry::sdk::common::ExportResult OtlpGrpcAuthedMetricExporter::Export(
     return opentelemetry::sdk::common::ExportResult::kSuccess;
   }
 
+  auto start = std::chrono::steady_clock::now();
+  opentelemetry::sdk::common::ExportResult result =
+      opentelemetry::sdk::common::ExportResult::kSuccess;
+  if (limits_.max_export_batch_size == 0 &&
+      limits_.max_export_data_points == 0) {
+    result = ExportBatch(data);
+  } else {
+    size_t dropped = ForEachBatch(
+        data, limits_,
+        [&](const opentelemetry::sdk::metrics::ResourceMetrics& batch) {
+          if (ExportBatch(batch) !=
+              opentelemetry::sdk::common::ExportResult::kSuccess) {
+            result = opentelemetry::sdk::common::ExportResult::kFailure;
+          }
+        });
+    dropped_data_points_.fetch_add(dropped);
+  }
+  last_export_duration_us_.store(
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::steady_clock::now() - start)
+          .count());
+  return result;
+}
+
+opentelemetry::sdk::common::ExportResult
+OtlpGrpcAuthedMetricExporter::ExportBatch(
+    const opentelemetry::sdk::metrics::ResourceMetrics& data) noexcept {
   opentelemetry::proto::collector::metrics::v1::ExportMetricsServiceRequest
       request;
   opentelemetry::exporter::otlp::OtlpMetricUtils::PopulateRequest(data,
                                                                   &request);
+  int64_t request_bytes = static_cast<int64_t>(request.ByteSizeLong());
+  int64_t data_points = 0;
+  for (const auto& scope_metrics : data.scope_metric_data_) {
+    for (const auto& metric : scope_metrics.metric_data_) {
+      data_points += static_cast<int64_t>(metric.point_data_attr_.size());
+    }
+  }
 
   auto context =
       opentelemetry::exporter::otlp::OtlpGrpcClient::MakeClientContext(
@@ -169,6 +360,7 @@ opentelemetry::sdk::common::ExportResult OtlpGrpcAuthedMetricExporter::Export(
               "[OTLP METRIC GRPC Exporter] Export() failed because metric "
               "service stub is not properly set");
 
+    failed_requests_.fetch_add(1);
     return opentelemetry::sdk::common::ExportResult::kFailure;
   }
 
@@ -193,8 +385,11 @@ opentelemetry::sdk::common::ExportResult OtlpGrpcAuthedMetricExporter::Export(
               absl::StrFormat("[OTLP METRIC GRPC Exporter] Export() failed: %s",
                               status.error_message().c_str()));
 
+    failed_requests_.fetch_add(1);
     return opentelemetry::sdk::common::ExportResult::kFailure;
   }
+  exported_data_points_.fetch_add(data_points);
+  request_bytes_.fetch_add(request_bytes);
   return opentelemetry::sdk::common::ExportResult::kSuccess;
 }
 
@@ -223,4 +418,87 @@ OtlpGrpcAuthedMetricExporter::GetOptions() const {
   return options_;
 }
 
+OtlpMetricExportStats OtlpGrpcAuthedMetricExporter::GetExportStats()
+    const noexcept {
+  OtlpMetricExportStats stats;
+  stats.exported_data_points = exported_data_points_.load();
+  stats.dropped_data_points = dropped_data_points_.load();
+  stats.failed_requests = failed_requests_.load();
+  stats.request_bytes = request_bytes_.load();
+  return stats;
+}
+
+void OtlpGrpcAuthedMetricExporter::RegisterMetrics(
+    MetricRouter& metric_router) {
+  std::shared_ptr<opentelemetry::metrics::Meter> meter =
+      metric_router.GetOrCreateMeter(kOtlpExporterMeter);
+
+  auto observe_counter = [&](absl::string_view name,
+                             absl::string_view description,
+                             absl::string_view unit,
+                             std::atomic<int64_t>& counter) {
+    std::shared_ptr<opentelemetry::metrics::ObservableInstrument> instrument =
+        metric_router.GetOrCreateObservableInstrument(
+            name,
+            [&]() -> std::shared_ptr<
+                      opentelemetry::metrics::ObservableInstrument> {
+              return meter->CreateInt64ObservableCounter(name, description,
+                                                         unit);
+            });
+    observed_instruments_.push_back(
+        {instrument, &OtlpGrpcAuthedMetricExporter::ObserveCounter, &counter});
+  };
+
+  observe_counter(kExportedDataPointsMetric, "Number of data points exported.",
+                  "", exported_data_points_);
+  observe_counter(kDroppedDataPointsMetric,
+                  "Number of data points dropped over the export limit.", "",
+                  dropped_data_points_);
+  observe_counter(kFailedRequestsMetric, "Number of failed export requests.",
+                  "", failed_requests_);
+  observe_counter(kRequestSizeMetric,
+                  "Size of the export requests in Bytes - uncompressed.", "By",
+                  request_bytes_);
+
+  std::shared_ptr<opentelemetry::metrics::ObservableInstrument>
+      export_duration = metric_router.GetOrCreateObservableInstrument(
+          kExportDurationMetric,
+          [&]() -> std::shared_ptr<
+                    opentelemetry::metrics::ObservableInstrument> {
+            return meter->CreateDoubleObservableGauge(
+                kExportDurationMetric, "Duration of the last metric export.",
+                "s");
+          });
+  observed_instruments_.push_back(
+      {export_duration, &OtlpGrpcAuthedMetricExporter::ObserveExportDuration,
+       &last_export_duration_us_});
+
+  for (const ObservedInstrument& observed : observed_instruments_) {
+    observed.instrument->AddCallback(observed.callback, observed.state);
+  }
+}
+
+OtlpGrpcAuthedMetricExporter::~OtlpGrpcAuthedMetricExporter() {
+  for (const ObservedInstrument& observed : observed_instruments_) {
+    observed.instrument->RemoveCallback(observed.callback, observed.state);
+  }
+}
+
+void OtlpGrpcAuthedMetricExporter::ObserveCounter(
+    opentelemetry::metrics::ObserverResult observer_result, void* counter) {
+  std::get<std::shared_ptr<opentelemetry::metrics::ObserverResultT<int64_t>>>(
+      observer_result)
+      ->Observe(static_cast<std::atomic<int64_t>*>(counter)->load());
+}
+
+void OtlpGrpcAuthedMetricExporter::ObserveExportDuration(
+    opentelemetry::metrics::ObserverResult observer_result,
+    void* duration_us) {
+  std::get<std::shared_ptr<opentelemetry::metrics::ObserverResultT<double>>>(
+      observer_result)
+      ->Observe(static_cast<double>(
+                    static_cast<std::atomic<int64_t>*>(duration_us)->load()) /
+                1e6);
+}
+
 }  // namespace privacy_sandbox::pbs_common
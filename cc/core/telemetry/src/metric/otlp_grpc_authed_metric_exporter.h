@@ -14,13 +14,18 @@
 
 #pragma once
 
+#include <atomic>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <vector>
 
 #include "cc/core/interface/config_provider_interface.h"
 #include "cc/core/telemetry/src/authentication/grpc_auth_config.h"
 #include "cc/core/telemetry/src/authentication/grpc_id_token_authenticator.h"
 #include "cc/core/telemetry/src/authentication/token_fetcher.h"
+#include "cc/core/telemetry/src/metric/metric_router.h"
 #include "opentelemetry/common/spin_lock_mutex.h"
 #include "opentelemetry/exporters/otlp/otlp_environment.h"
 #include "opentelemetry/exporters/otlp/otlp_grpc_metric_exporter_options.h"
@@ -31,6 +36,36 @@
 
 namespace privacy_sandbox::pbs_common {
 
+/// Limits of the data sent by OtlpGrpcAuthedMetricExporter.
+struct OtlpMetricExportLimits {
+  /// Maximum number of data points per export request. The data of an export
+  /// is split in as many requests as needed. Unlimited when 0.
+  size_t max_export_batch_size = 0;
+  /// Maximum number of data points per export. The trailing data points over
+  /// it are dropped. Unlimited when 0.
+  size_t max_export_data_points = 0;
+};
+
+/// Totals of the data sent by OtlpGrpcAuthedMetricExporter.
+struct OtlpMetricExportStats {
+  int64_t exported_data_points = 0;
+  int64_t dropped_data_points = 0;
+  int64_t failed_requests = 0;
+  /// Serialized size of the requests, before compression.
+  int64_t request_bytes = 0;
+};
+
+/**
+ * Reads the endpoint, aggregation temporality and compression of the exporter
+ * from the configuration.
+ */
+opentelemetry::exporter::otlp::OtlpGrpcMetricExporterOptions
+GetOtlpGrpcMetricExporterOptions(ConfigProviderInterface& config_provider);
+
+/// Reads the limits of the exporter from the configuration.
+OtlpMetricExportLimits GetOtlpMetricExportLimits(
+    ConfigProviderInterface& config_provider);
+
 /**
  * The OtlpGrpcAuthedMetricExporter is largely copied from
  OtlpGrpcMetricExporter,
@@ -46,7 +81,10 @@ class OtlpGrpcAuthedMetricExporter
   explicit OtlpGrpcAuthedMetricExporter(
       const opentelemetry::exporter::otlp::OtlpGrpcMetricExporterOptions&
           options,
-      std::unique_ptr<GrpcIdTokenAuthenticator> grpc_id_token_authenticator);
+      std::unique_ptr<GrpcIdTokenAuthenticator> grpc_id_token_authenticator,
+      OtlpMetricExportLimits limits = {});
+
+  ~OtlpGrpcAuthedMetricExporter() override;
 
   opentelemetry::sdk::metrics::AggregationTemporality GetAggregationTemporality(
       opentelemetry::sdk::metrics::InstrumentType instrument_type)
@@ -65,9 +103,35 @@ class OtlpGrpcAuthedMetricExporter
   const opentelemetry::exporter::otlp::OtlpGrpcMetricExporterOptions&
   GetOptions() const;
 
+  OtlpMetricExportStats GetExportStats() const noexcept;
+
+  /**
+   * Creates the metrics of the exporter itself: the data points exported and
+   * dropped, the failed requests, the size of the requests and the duration
+   * of the last export. They are observed at collection time, so that
+   * exporting them does not record anything.
+   *
+   * @param metric_router The router of the meter provider the exporter exports
+   * from.
+   */
+  void RegisterMetrics(MetricRouter& metric_router);
+
  private:
   bool IsShutdown() const noexcept;
 
+  /// Sends one export request holding the given data.
+  opentelemetry::sdk::common::ExportResult ExportBatch(
+      const opentelemetry::sdk::metrics::ResourceMetrics& data) noexcept;
+
+  /// Observes one of the counters of the exporter.
+  static void ObserveCounter(
+      opentelemetry::metrics::ObserverResult observer_result, void* counter);
+
+  /// Observes the duration of the last export, in seconds.
+  static void ObserveExportDuration(
+      opentelemetry::metrics::ObserverResult observer_result,
+      void* duration_us);
+
   ExecutionResultOr<std::shared_ptr<grpc::Channel>> MakeChannel(
       const opentelemetry::exporter::otlp::OtlpGrpcClientOptions& options,
       std::unique_ptr<GrpcIdTokenAuthenticator> grpc_id_token_authenticator);
@@ -84,7 +148,22 @@ class OtlpGrpcAuthedMetricExporter
   std::unique_ptr<opentelemetry::proto::collector::metrics::v1::MetricsService::
                       StubInterface>
       metrics_service_stub_;
+  const OtlpMetricExportLimits limits_;
   bool is_shutdown_;
   mutable std::mutex mutex_;
+
+  std::atomic<int64_t> exported_data_points_;
+  std::atomic<int64_t> dropped_data_points_;
+  std::atomic<int64_t> failed_requests_;
+  std::atomic<int64_t> request_bytes_;
+  std::atomic<int64_t> last_export_duration_us_;
+
+  /// An observable instrument of the exporter, with its callback.
+  struct ObservedInstrument {
+    std::shared_ptr<opentelemetry::metrics::ObservableInstrument> instrument;
+    opentelemetry::metrics::ObservableCallbackPtr callback;
+    void* state;
+  };
+  std::vector<ObservedInstrument> observed_instruments_;
 };
 }  // namespace privacy_sandbox::pbs_common
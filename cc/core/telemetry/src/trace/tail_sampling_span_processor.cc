@@ -0,0 +1,344 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cc/core/telemetry/src/trace/tail_sampling_span_processor.h"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "opentelemetry/common/key_value_iterable.h"
+#include "opentelemetry/sdk/trace/sampler.h"
+#include "opentelemetry/trace/span_context_kv_iterable.h"
+
+namespace privacy_sandbox::pbs_common {
+namespace {
+
+using ::opentelemetry::sdk::trace::Recordable;
+
+/**
+ * @brief Recordable forwarding to the recordable of the delegate processor,
+ * which also keeps what the sampling decision is taken on.
+ */
+class TailSamplingRecordable : public Recordable {
+ public:
+  explicit TailSamplingRecordable(std::unique_ptr<Recordable> recordable)
+      : recordable_(std::move(recordable)) {}
+
+  void SetIdentity(const opentelemetry::trace::SpanContext& span_context,
+                   opentelemetry::trace::SpanId parent_span_id) noexcept
+      override {
+    trace_id_ = span_context.trace_id();
+    recordable_->SetIdentity(span_context, parent_span_id);
+  }
+
+  void SetAttribute(
+      opentelemetry::nostd::string_view key,
+      const opentelemetry::common::AttributeValue& value) noexcept override {
+    recordable_->SetAttribute(key, value);
+  }
+
+  void AddEvent(opentelemetry::nostd::string_view name,
+                opentelemetry::common::SystemTimestamp timestamp,
+                const opentelemetry::common::KeyValueIterable&
+                    attributes) noexcept override {
+    recordable_->AddEvent(name, timestamp, attributes);
+  }
+
+  void AddLink(const opentelemetry::trace::SpanContext& span_context,
+               const opentelemetry::common::KeyValueIterable&
+                   attributes) noexcept override {
+    recordable_->AddLink(span_context, attributes);
+  }
+
+  void SetStatus(opentelemetry::trace::StatusCode code,
+                 opentelemetry::nostd::string_view description) noexcept
+      override {
+    is_error_ = code == opentelemetry::trace::StatusCode::kError;
+    recordable_->SetStatus(code, description);
+  }
+
+  void SetName(opentelemetry::nostd::string_view name) noexcept override {
+    recordable_->SetName(name);
+  }
+
+  void SetTraceFlags(opentelemetry::trace::TraceFlags flags) noexcept override {
+    recordable_->SetTraceFlags(flags);
+  }
+
+  void SetSpanKind(opentelemetry::trace::SpanKind span_kind) noexcept override {
+    recordable_->SetSpanKind(span_kind);
+  }
+
+  void SetResource(
+      const opentelemetry::sdk::resource::Resource& resource) noexcept
+      override {
+    recordable_->SetResource(resource);
+  }
+
+  void SetStartTime(
+      opentelemetry::common::SystemTimestamp start_time) noexcept override {
+    recordable_->SetStartTime(start_time);
+  }
+
+  void SetDuration(std::chrono::nanoseconds duration) noexcept override {
+    duration_ = duration;
+    recordable_->SetDuration(duration);
+  }
+
+  void SetInstrumentationScope(
+      const opentelemetry::sdk::instrumentationscope::InstrumentationScope&
+          instrumentation_scope) noexcept override {
+    recordable_->SetInstrumentationScope(instrumentation_scope);
+  }
+
+  Recordable& Get() noexcept { return *recordable_; }
+
+  /// Gives back the recordable of the delegate processor.
+  std::unique_ptr<Recordable> Release() noexcept {
+    return std::move(recordable_);
+  }
+
+  void SetIsLocalRoot(bool is_local_root) noexcept {
+    is_local_root_ = is_local_root;
+  }
+
+  const opentelemetry::trace::TraceId& GetTraceId() const noexcept {
+    return trace_id_;
+  }
+
+  bool IsLocalRoot() const noexcept { return is_local_root_; }
+
+  bool IsError() const noexcept { return is_error_; }
+
+  std::chrono::nanoseconds GetDuration() const noexcept { return duration_; }
+
+ private:
+  std::unique_ptr<Recordable> recordable_;
+  opentelemetry::trace::TraceId trace_id_;
+  bool is_local_root_ = false;
+  bool is_error_ = false;
+  std::chrono::nanoseconds duration_{0};
+};
+
+/// As many shards as full traces fit in the buffer, between 1 and max_shards.
+size_t GetShardCount(const TailSamplingOptions& options, size_t max_shards) {
+  if (options.max_spans_per_trace == 0) {
+    return max_shards;
+  }
+  return std::clamp<size_t>(
+      options.max_buffered_spans / options.max_spans_per_trace, 1, max_shards);
+}
+
+}  // namespace
+
+TailSamplingSpanProcessor::TailSamplingSpanProcessor(
+    std::unique_ptr<opentelemetry::sdk::trace::SpanProcessor> delegate,
+    const TailSamplingOptions& options) noexcept
+    : delegate_(std::move(delegate)),
+      options_(options),
+      baseline_sampler_(options.baseline_ratio),
+      shard_count_(GetShardCount(options, kMaxShards)),
+      max_buffered_spans_per_shard_(options.max_buffered_spans / shard_count_),
+      max_decided_traces_per_shard_(
+          (options.max_decided_traces + shard_count_ - 1) / shard_count_),
+      shards_(std::make_unique<Shard[]>(shard_count_)) {}
+
+TailSamplingSpanProcessor::~TailSamplingSpanProcessor() {
+  Shutdown();
+}
+
+std::unique_ptr<Recordable>
+TailSamplingSpanProcessor::MakeRecordable() noexcept {
+  return std::make_unique<TailSamplingRecordable>(delegate_->MakeRecordable());
+}
+
+void TailSamplingSpanProcessor::OnStart(
+    Recordable& span,
+    const opentelemetry::trace::SpanContext& parent_context) noexcept {
+  auto& recordable = static_cast<TailSamplingRecordable&>(span);
+  recordable.SetIsLocalRoot(!parent_context.IsValid() ||
+                            parent_context.IsRemote());
+  delegate_->OnStart(recordable.Get(), parent_context);
+}
+
+void TailSamplingSpanProcessor::OnEnd(
+    std::unique_ptr<Recordable>&& span) noexcept {
+  if (span == nullptr) {
+    return;
+  }
+  // Only the recordables made by MakeRecordable are given back here.
+  auto& recordable = static_cast<TailSamplingRecordable&>(*span);
+  if (IsInBaseline(recordable.GetTraceId())) {
+    if (recordable.IsLocalRoot()) {
+      kept_traces_.fetch_add(1, std::memory_order_relaxed);
+    }
+    delegate_->OnEnd(recordable.Release());
+    return;
+  }
+
+  TraceKey trace_key;
+  std::copy(recordable.GetTraceId().Id().begin(),
+            recordable.GetTraceId().Id().end(), trace_key.begin());
+  Shard& shard = GetShard(trace_key);
+  std::vector<std::unique_ptr<Recordable>> kept_spans;
+  {
+    absl::MutexLock lock(&shard.mutex);
+    if (auto it = shard.decisions.find(trace_key);
+        it != shard.decisions.end()) {
+      // A span ending after the decision on its trace.
+      if (it->second) {
+        kept_spans.push_back(recordable.Release());
+      }
+    } else if (recordable.IsError() ||
+               (recordable.IsLocalRoot() &&
+                recordable.GetDuration() >= options_.latency_threshold)) {
+      kept_spans = TakePendingTrace(shard, trace_key);
+      kept_spans.push_back(recordable.Release());
+      RememberDecision(shard, trace_key, /*keep=*/true);
+      kept_traces_.fetch_add(1, std::memory_order_relaxed);
+    } else if (recordable.IsLocalRoot()) {
+      TakePendingTrace(shard, trace_key);
+      RememberDecision(shard, trace_key, /*keep=*/false);
+      dropped_traces_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+      EvictPendingTraces(shard);
+      auto pending = shard.pending_traces.find(trace_key);
+      const size_t trace_spans = pending == shard.pending_traces.end()
+                                     ? 0
+                                     : pending->second.spans.size();
+      // The trace itself may just have been evicted.
+      if (shard.decisions.contains(trace_key) ||
+          shard.buffered_spans >= max_buffered_spans_per_shard_ ||
+          trace_spans >= options_.max_spans_per_trace) {
+        overflow_dropped_spans_.fetch_add(1, std::memory_order_relaxed);
+      } else {
+        if (pending == shard.pending_traces.end()) {
+          pending = shard.pending_traces.try_emplace(trace_key).first;
+          pending->second.order = shard.pending_order.insert(
+              shard.pending_order.end(), trace_key);
+        }
+        pending->second.spans.push_back(recordable.Release());
+        ++shard.buffered_spans;
+      }
+    }
+  }
+  // The delegate is called without holding the lock.
+  Forward(std::move(kept_spans));
+}
+
+bool TailSamplingSpanProcessor::ForceFlush(
+    std::chrono::microseconds timeout) noexcept {
+  return delegate_->ForceFlush(timeout);
+}
+
+bool TailSamplingSpanProcessor::Shutdown(
+    std::chrono::microseconds timeout) noexcept {
+  if (shutdown_latch_.test_and_set(std::memory_order_acquire)) {
+    return true;
+  }
+  for (size_t i = 0; i < shard_count_; ++i) {
+    absl::MutexLock lock(&shards_[i].mutex);
+    shards_[i].pending_traces.clear();
+    shards_[i].pending_order.clear();
+    shards_[i].buffered_spans = 0;
+  }
+  return delegate_->Shutdown(timeout);
+}
+
+TailSamplingStats TailSamplingSpanProcessor::GetStats() const noexcept {
+  return {
+      .kept_traces = kept_traces_.load(std::memory_order_relaxed),
+      .dropped_traces = dropped_traces_.load(std::memory_order_relaxed),
+      .overflow_dropped_spans =
+          overflow_dropped_spans_.load(std::memory_order_relaxed),
+  };
+}
+
+bool TailSamplingSpanProcessor::IsInBaseline(
+    const opentelemetry::trace::TraceId& trace_id) noexcept {
+  // The same trace ids are kept as by the head sampler with the same ratio.
+  return baseline_sampler_
+             .ShouldSample(opentelemetry::trace::SpanContext::GetInvalid(),
+                           trace_id, /*name=*/"",
+                           opentelemetry::trace::SpanKind::kInternal,
+                           opentelemetry::common::NoopKeyValueIterable(),
+                           opentelemetry::trace::NullSpanContext())
+             .decision ==
+         opentelemetry::sdk::trace::Decision::RECORD_AND_SAMPLE;
+}
+
+TailSamplingSpanProcessor::Shard& TailSamplingSpanProcessor::GetShard(
+    const TraceKey& trace_key) noexcept {
+  // The trailing bytes of a trace id are random, even for the ids which are
+  // not entirely random.
+  return shards_[trace_key.back() % shard_count_];
+}
+
+void TailSamplingSpanProcessor::RememberDecision(Shard& shard,
+                                                 const TraceKey& trace_key,
+                                                 bool keep) {
+  if (max_decided_traces_per_shard_ == 0) {
+    return;
+  }
+  if (shard.decision_ring.size() < max_decided_traces_per_shard_) {
+    shard.decision_ring.push_back(trace_key);
+  } else {
+    shard.decisions.erase(shard.decision_ring[shard.decision_ring_next]);
+    shard.decision_ring[shard.decision_ring_next] = trace_key;
+    shard.decision_ring_next =
+        (shard.decision_ring_next + 1) % max_decided_traces_per_shard_;
+  }
+  shard.decisions[trace_key] = keep;
+}
+
+std::vector<std::unique_ptr<Recordable>>
+TailSamplingSpanProcessor::TakePendingTrace(Shard& shard,
+                                            const TraceKey& trace_key) {
+  auto it = shard.pending_traces.find(trace_key);
+  if (it == shard.pending_traces.end()) {
+    return {};
+  }
+  std::vector<std::unique_ptr<Recordable>> spans =
+      std::move(it->second.spans);
+  shard.pending_order.erase(it->second.order);
+  shard.pending_traces.erase(it);
+  shard.buffered_spans -= spans.size();
+  return spans;
+}
+
+void TailSamplingSpanProcessor::EvictPendingTraces(Shard& shard) {
+  while (shard.buffered_spans >= max_buffered_spans_per_shard_ &&
+         !shard.pending_order.empty()) {
+    // Copied, since taking the trace erases it from pending_order.
+    const TraceKey trace_key = shard.pending_order.front();
+    const size_t evicted_spans = TakePendingTrace(shard, trace_key).size();
+    RememberDecision(shard, trace_key, /*keep=*/false);
+    dropped_traces_.fetch_add(1, std::memory_order_relaxed);
+    overflow_dropped_spans_.fetch_add(evicted_spans,
+                                      std::memory_order_relaxed);
+  }
+}
+
+void TailSamplingSpanProcessor::Forward(
+    std::vector<std::unique_ptr<Recordable>> spans) noexcept {
+  for (std::unique_ptr<Recordable>& span : spans) {
+    delegate_->OnEnd(std::move(span));
+  }
+}
+
+}  // namespace privacy_sandbox::pbs_common
@@ -0,0 +1,187 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "cc/core/telemetry/src/trace/trace_sampler.h"
+#include "opentelemetry/sdk/trace/processor.h"
+#include "opentelemetry/sdk/trace/recordable.h"
+#include "opentelemetry/trace/span_context.h"
+#include "opentelemetry/trace/trace_id.h"
+
+namespace privacy_sandbox::pbs_common {
+
+/// When a trace is kept by the tail sampler.
+struct TailSamplingOptions {
+  /// Traces whose local root span lasts at least this long are kept.
+  std::chrono::milliseconds latency_threshold{1000};
+  /// Ratio of the other traces kept regardless of their latency, chosen by
+  /// trace id the same way as the head sampler.
+  double baseline_ratio = 0.01;
+  /// Maximum number of spans buffered across all the undecided traces, split
+  /// across the shards of the processor. Over the share of a shard, the oldest
+  /// undecided trace of the shard is dropped.
+  size_t max_buffered_spans = 8192;
+  /// Maximum number of spans buffered for a single undecided trace. Further
+  /// spans of the trace are dropped.
+  size_t max_spans_per_trace = 512;
+  /// Number of decided traces whose decision is remembered, for the spans
+  /// which end after the local root span.
+  size_t max_decided_traces = 1024;
+};
+
+/// Counters of the tail sampler, for tests and monitoring.
+struct TailSamplingStats {
+  uint64_t kept_traces = 0;
+  uint64_t dropped_traces = 0;
+  /// Spans dropped because the buffer of undecided spans was full.
+  uint64_t overflow_dropped_spans = 0;
+};
+
+/**
+ * @brief SpanProcessor which decides whether to export a trace once its local
+ * root span ends, and forwards the spans of the kept traces to a delegate
+ * processor.
+ *
+ * The spans of a trace are buffered in memory until the local root span, the
+ * one without a parent or with a remote parent, ends. The trace is then kept
+ * if the root span lasted at least `latency_threshold`, and dropped otherwise.
+ * The spans of a trace which errored, or which is in the baseline, are
+ * forwarded right away without being buffered, since the decision to keep it
+ * is already known. A span errors when its status is set to
+ * StatusCode::kError, which nothing in the tree does yet, so the traces are
+ * only kept for their latency or the baseline until then.
+ *
+ * The traces are split by trace id across shards, each with its own lock and
+ * its share of the buffer and of the remembered decisions, so that the spans
+ * of different requests rarely contend. There are as many shards as full
+ * traces fit in the buffer, up to kMaxShards. When the buffer of a shard is
+ * full, the oldest undecided trace of the shard is dropped.
+ *
+ * Every span must be recorded for the decision to be taken here, so the
+ * tracer provider is expected to use a sampler which records every span.
+ */
+class TailSamplingSpanProcessor
+    : public opentelemetry::sdk::trace::SpanProcessor {
+ public:
+  TailSamplingSpanProcessor(
+      std::unique_ptr<opentelemetry::sdk::trace::SpanProcessor> delegate,
+      const TailSamplingOptions& options) noexcept;
+
+  ~TailSamplingSpanProcessor() override;
+
+  std::unique_ptr<opentelemetry::sdk::trace::Recordable>
+  MakeRecordable() noexcept override;
+
+  void OnStart(
+      opentelemetry::sdk::trace::Recordable& span,
+      const opentelemetry::trace::SpanContext& parent_context) noexcept
+      override;
+
+  void OnEnd(std::unique_ptr<opentelemetry::sdk::trace::Recordable>&& span)
+      noexcept override;
+
+  /// Flushes the delegate. The undecided traces stay buffered.
+  bool ForceFlush(std::chrono::microseconds timeout =
+                      (std::chrono::microseconds::max)()) noexcept override;
+
+  /// Drops the undecided traces and shuts the delegate down.
+  bool Shutdown(std::chrono::microseconds timeout =
+                    (std::chrono::microseconds::max)()) noexcept override;
+
+  [[nodiscard]] TailSamplingStats GetStats() const noexcept;
+
+ private:
+  /// The bytes of a trace id.
+  using TraceKey = std::array<uint8_t, opentelemetry::trace::TraceId::kSize>;
+
+  /// The spans of a trace whose local root span has not ended yet.
+  struct PendingTrace {
+    std::vector<std::unique_ptr<opentelemetry::sdk::trace::Recordable>> spans;
+    /// Position of the trace in Shard::pending_order.
+    std::list<TraceKey>::iterator order;
+  };
+
+  /// The traces of a subset of the trace ids.
+  struct Shard {
+    absl::Mutex mutex;
+    absl::flat_hash_map<TraceKey, PendingTrace> pending_traces
+        ABSL_GUARDED_BY(mutex);
+    /// Trace keys of pending_traces, oldest first.
+    std::list<TraceKey> pending_order ABSL_GUARDED_BY(mutex);
+    size_t buffered_spans ABSL_GUARDED_BY(mutex) = 0;
+    absl::flat_hash_map<TraceKey, bool> decisions ABSL_GUARDED_BY(mutex);
+    /// Trace keys of decisions, in a ring of max_decided_traces entries.
+    std::vector<TraceKey> decision_ring ABSL_GUARDED_BY(mutex);
+    size_t decision_ring_next ABSL_GUARDED_BY(mutex) = 0;
+  };
+
+  /// Maximum number of shards the traces are split across.
+  static constexpr size_t kMaxShards = 16;
+
+  bool IsInBaseline(const opentelemetry::trace::TraceId& trace_id) noexcept;
+
+  Shard& GetShard(const TraceKey& trace_key) noexcept;
+
+  /// Remembers the decision of a trace, forgetting the oldest one of the shard
+  /// if needed.
+  void RememberDecision(Shard& shard, const TraceKey& trace_key, bool keep)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(shard.mutex);
+
+  /// Removes a pending trace and returns its spans.
+  std::vector<std::unique_ptr<opentelemetry::sdk::trace::Recordable>>
+  TakePendingTrace(Shard& shard, const TraceKey& trace_key)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(shard.mutex);
+
+  /// Drops the oldest pending traces of the shard until a span fits in its
+  /// buffer.
+  void EvictPendingTraces(Shard& shard)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(shard.mutex);
+
+  void Forward(
+      std::vector<std::unique_ptr<opentelemetry::sdk::trace::Recordable>>
+          spans) noexcept;
+
+  std::unique_ptr<opentelemetry::sdk::trace::SpanProcessor> delegate_;
+  const TailSamplingOptions options_;
+  TraceSampler baseline_sampler_;
+
+  const size_t shard_count_;
+  /// The limits of the options, split across the shards.
+  const size_t max_buffered_spans_per_shard_;
+  const size_t max_decided_traces_per_shard_;
+  std::unique_ptr<Shard[]> shards_;
+
+  std::atomic<uint64_t> kept_traces_{0};
+  std::atomic<uint64_t> dropped_traces_{0};
+  std::atomic<uint64_t> overflow_dropped_spans_{0};
+  std::atomic_flag shutdown_latch_ = ATOMIC_FLAG_INIT;
+};
+
+}  // namespace privacy_sandbox::pbs_common
@@ -14,12 +14,15 @@
 
 #include "cc/core/telemetry/src/trace/trace_router.h"
 
+#include <algorithm>
+#include <chrono>
 #include <memory>
 #include <string>
 #include <utility>
 
 #include "cc/core/interface/config_provider_interface.h"
 #include "cc/core/telemetry/src/common/telemetry_configuration.h"
+#include "cc/core/telemetry/src/trace/tail_sampling_span_processor.h"
 #include "cc/core/telemetry/src/trace/trace_sampler.h"
 #include "opentelemetry/sdk/resource/resource.h"
 #include "opentelemetry/sdk/trace/batch_span_processor_factory.h"
@@ -31,6 +34,44 @@
 namespace privacy_sandbox::pbs_common {
 namespace {
 
+/**
+ * @brief Whether the traces are sampled once their root span ends rather
+ * than when it starts.
+ *
+ * @param config_provider A reference to the configuration provider.
+ * @return True if tail-based sampling is enabled.
+ */
+bool IsTailSamplingEnabled(ConfigProviderInterface& config_provider) {
+  return GetConfigValue(std::string(kOtelTraceTailSamplingEnabledKey),
+                        kOtelTraceTailSamplingEnabledValue, config_provider);
+}
+
+/**
+ * @brief Creates the TailSamplingOptions from the configuration.
+ *
+ * @param config_provider A reference to the configuration provider.
+ * @return The TailSamplingOptions.
+ */
+TailSamplingOptions CreateTailSamplingOptions(
+    ConfigProviderInterface& config_provider) {
+  TailSamplingOptions options;
+  options.latency_threshold = std::chrono::milliseconds(
+      GetConfigValue(std::string(kOtelTraceTailSamplingLatencyMsecKey),
+                     kOtelTraceTailSamplingLatencyMsecValue, config_provider));
+  options.baseline_ratio =
+      GetConfigValue(std::string(kOtelTraceTailSamplingBaselineRatioKey),
+                     kOtelTraceTailSamplingBaselineRatioValue, config_provider);
+  options.max_buffered_spans = std::max(
+      0, GetConfigValue(std::string(kOtelTraceTailSamplingMaxBufferedSpansKey),
+                        kOtelTraceTailSamplingMaxBufferedSpansValue,
+                        config_provider));
+  options.max_spans_per_trace = std::max(
+      0, GetConfigValue(std::string(kOtelTraceTailSamplingMaxSpansPerTraceKey),
+                        kOtelTraceTailSamplingMaxSpansPerTraceValue,
+                        config_provider));
+  return options;
+}
+
 /**
  * @brief Creates a SpanProcessor based on configuration and SpanExporter.
  *
@@ -65,8 +106,15 @@ std::unique_ptr<opentelemetry::sdk::trace::SpanProcessor> CreateSpanProcessor(
       std::chrono::milliseconds(export_interval_millis);
   options.max_export_batch_size = max_export_batch_size;
 
-  return opentelemetry::sdk::trace::BatchSpanProcessorFactory::Create(
-      std::move(exporter), options);
+  std::unique_ptr<opentelemetry::sdk::trace::SpanProcessor> span_processor =
+      opentelemetry::sdk::trace::BatchSpanProcessorFactory::Create(
+          std::move(exporter), options);
+  if (IsTailSamplingEnabled(config_provider)) {
+    // The kept traces are exported in batches as well.
+    return std::make_unique<TailSamplingSpanProcessor>(
+        std::move(span_processor), CreateTailSamplingOptions(config_provider));
+  }
+  return span_processor;
 }
 
 /**
@@ -81,6 +129,12 @@ std::unique_ptr<opentelemetry::sdk::trace::SpanProcessor> CreateSpanProcessor(
  */
 std::unique_ptr<opentelemetry::sdk::trace::Sampler> CreateSpanSampler(
     ConfigProviderInterface& config_provider) {
+  // With tail-based sampling, every span is recorded and the
+  // TailSamplingSpanProcessor decides which traces are exported.
+  if (IsTailSamplingEnabled(config_provider)) {
+    return std::make_unique<TraceSampler>(/*sampling_ratio=*/1.0);
+  }
+
   // Fetch the sampling ratio from the config provider.
   double sampling_ratio =
       GetConfigValue(std::string(kOtelTraceSamplingRatioKey),
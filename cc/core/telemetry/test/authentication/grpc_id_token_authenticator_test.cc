@@ -17,12 +17,21 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <limits>
 #include <map>
 #include <memory>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
+#include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "cc/core/test/utils/conditional_wait.h"
+#include "cc/public/core/interface/execution_result.h"
+
 namespace privacy_sandbox::pbs_common {
 namespace {
 inline constexpr std::string_view kExpectedToken = "default_token";
@@ -69,6 +78,43 @@ class FakeAuthContext : public grpc::AuthContext {
   }
 };
 
+// Hands out "token-1", "token-2", ... Fetches can be made to block or fail.
+class FakeTokenFetcher : public TokenFetcher {
+ public:
+  ExecutionResultOr<std::string> FetchIdToken(GrpcAuthConfig&) override {
+    int fetch = ++fetches_;
+    if (fetch > block_after_) {
+      absl::MutexLock lock(&mutex_);
+      mutex_.Await(absl::Condition(
+          +[](bool* unblocked) { return *unblocked; }, &unblocked_));
+    }
+    if (fetch > fail_after_) {
+      return FailureExecutionResult(SC_UNKNOWN);
+    }
+    return absl::StrCat("token-", fetch);
+  }
+
+  // Blocks every fetch after the first `fetches` ones until Unblock().
+  void BlockAfter(int fetches) { block_after_ = fetches; }
+
+  void Unblock() {
+    absl::MutexLock lock(&mutex_);
+    unblocked_ = true;
+  }
+
+  // Fails every fetch after the first `fetches` ones.
+  void FailAfter(int fetches) { fail_after_ = fetches; }
+
+  int fetches() const { return fetches_; }
+
+ private:
+  absl::Mutex mutex_;
+  bool unblocked_ ABSL_GUARDED_BY(mutex_) = false;
+  std::atomic<int> fetches_ = 0;
+  std::atomic<int> block_after_ = std::numeric_limits<int>::max();
+  std::atomic<int> fail_after_ = std::numeric_limits<int>::max();
+};
+
 class GrpcIdTokenAuthenticatorTest : public ::testing::Test {
  protected:
   std::unique_ptr<GrpcAuthConfig> auth_config;
@@ -81,12 +127,33 @@ class GrpcIdTokenAuthenticatorTest : public ::testing::Test {
     token_fetcher = std::make_unique<MockTokenFetcher>();
     authenticator = std::make_unique<GrpcIdTokenAuthenticator>(
         std::move(auth_config), std::move(token_fetcher));
+    WaitUntil([this]() { return !authenticator->id_token().empty(); });
   }
-};
 
-TEST_F(GrpcIdTokenAuthenticatorTest, GetMetadata_ExpiredToken_RefreshesToken) {
-  authenticator->set_expiry_time_for_testing(std::chrono::system_clock::now());
+  // Creates an authenticator that checks for a due refresh every millisecond.
+  std::unique_ptr<GrpcIdTokenAuthenticator> CreateFastRefreshingAuthenticator(
+      std::unique_ptr<TokenFetcher> fetcher, double refresh_after_fraction) {
+    IdTokenRefreshOptions refresh_options;
+    refresh_options.check_interval = absl::Milliseconds(1);
+    refresh_options.refresh_after_fraction = refresh_after_fraction;
+    refresh_options.jitter_fraction = 0;
+    return std::make_unique<GrpcIdTokenAuthenticator>(
+        std::make_unique<GrpcAuthConfig>("service_account", "audience",
+                                         "cred_config"),
+        std::move(fetcher), refresh_options);
+  }
+
+  static std::string GetAuthorizationMetadata(
+      GrpcIdTokenAuthenticator& authenticator, grpc::Status& status) {
+    FakeAuthContext channel_auth_context;
+    std::multimap<grpc::string, grpc::string> metadata;
+    status = authenticator.GetMetadata("", "", channel_auth_context, &metadata);
+    auto it = metadata.find("authorization");
+    return it == metadata.end() ? "" : it->second;
+  }
+};
 
+TEST_F(GrpcIdTokenAuthenticatorTest, GetMetadata_UsesTokenFetchedInBackground) {
   grpc::string_ref service_url = "";
   grpc::string_ref method_name = "";
   FakeAuthContext channel_auth_context;
@@ -126,6 +193,92 @@ TEST_F(GrpcIdTokenAuthenticatorTest,
   testing::Mock::VerifyAndClearExpectations(token_fetcher.get());
 }
 
+TEST_F(GrpcIdTokenAuthenticatorTest, GetMetadata_ExpiredToken_IsNotServed) {
+  authenticator->set_expiry_time_for_testing(std::chrono::system_clock::now());
+
+  grpc::Status status;
+  EXPECT_EQ(GetAuthorizationMetadata(*authenticator, status), "");
+  EXPECT_EQ(status.error_code(), grpc::StatusCode::UNAVAILABLE);
+}
+
+TEST_F(GrpcIdTokenAuthenticatorTest, GetMetadata_DoesNotBlockOnTokenFetch) {
+  auto fetcher = std::make_unique<FakeTokenFetcher>();
+  auto* fake_fetcher = fetcher.get();
+  fake_fetcher->BlockAfter(1);
+  auto authenticator =
+      CreateFastRefreshingAuthenticator(std::move(fetcher), 0.0);
+
+  // The second fetch hangs until it is unblocked.
+  WaitUntil([&]() { return fake_fetcher->fetches() == 2; });
+  for (int i = 0; i < 100; ++i) {
+    grpc::Status status;
+    EXPECT_EQ(GetAuthorizationMetadata(*authenticator, status),
+              "Bearer token-1");
+    EXPECT_TRUE(status.ok());
+  }
+
+  fake_fetcher->Unblock();
+  WaitUntil([&]() { return authenticator->id_token() != "token-1"; });
+}
+
+TEST_F(GrpcIdTokenAuthenticatorTest, RefreshesTokenBeforeExpiry) {
+  auto fetcher = std::make_unique<FakeTokenFetcher>();
+  auto* fake_fetcher = fetcher.get();
+  auto authenticator =
+      CreateFastRefreshingAuthenticator(std::move(fetcher), 0.0);
+  WaitUntil([&]() {
+    return fake_fetcher->fetches() >= 3 &&
+           authenticator->id_token() != "token-1";
+  });
+  EXPECT_FALSE(authenticator->IsExpired());
+}
+
+TEST_F(GrpcIdTokenAuthenticatorTest, FailedRefresh_KeepsServingValidToken) {
+  auto fetcher = std::make_unique<FakeTokenFetcher>();
+  auto* fake_fetcher = fetcher.get();
+  fake_fetcher->FailAfter(1);
+  auto authenticator =
+      CreateFastRefreshingAuthenticator(std::move(fetcher), 0.0);
+
+  WaitUntil([&]() { return fake_fetcher->fetches() >= 5; });
+  grpc::Status status;
+  EXPECT_EQ(GetAuthorizationMetadata(*authenticator, status), "Bearer token-1");
+  EXPECT_TRUE(status.ok());
+}
+
+TEST_F(GrpcIdTokenAuthenticatorTest, DoesNotRefreshBeforeRefreshTime) {
+  auto fetcher = std::make_unique<FakeTokenFetcher>();
+  auto* fake_fetcher = fetcher.get();
+  auto authenticator =
+      CreateFastRefreshingAuthenticator(std::move(fetcher), 0.5);
+  WaitUntil([&]() { return authenticator->id_token() == "token-1"; });
+
+  absl::SleepFor(absl::Milliseconds(50));
+  EXPECT_EQ(fake_fetcher->fetches(), 1);
+}
+
+TEST_F(GrpcIdTokenAuthenticatorTest, Destructor_WaitsForTheFetchInFlight) {
+  auto fetcher = std::make_unique<FakeTokenFetcher>();
+  auto* fake_fetcher = fetcher.get();
+  fake_fetcher->BlockAfter(0);
+  auto authenticator =
+      CreateFastRefreshingAuthenticator(std::move(fetcher), 0.0);
+  WaitUntil([&]() { return fake_fetcher->fetches() == 1; });
+
+  std::atomic<bool> destroyed(false);
+  std::thread destroyer([&]() {
+    authenticator.reset();
+    destroyed = true;
+  });
+  absl::SleepFor(absl::Milliseconds(50));
+  // Shutdown is held up by the fetch, which the token fetchers bound.
+  EXPECT_FALSE(destroyed.load());
+
+  fake_fetcher->Unblock();
+  destroyer.join();
+  EXPECT_TRUE(destroyed.load());
+}
+
 TEST_F(GrpcIdTokenAuthenticatorTest, IsExpired_ChecksTokenExpiryCorrectly) {
   // Set token to expire in the future
   authenticator->set_expiry_time_for_testing(std::chrono::system_clock::now() +
@@ -18,7 +18,10 @@
 
 #include <benchmark/benchmark.h>
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
 #include "cc/core/async_executor/src/async_executor.h"
+#include "cc/core/telemetry/src/metric/metric_attributes.h"
 #include "cc/core/telemetry/mock/in_memory_metric_router.h"
 #include "opentelemetry/metrics/provider.h"
 #include "opentelemetry/sdk/metrics/view/view_registry_factory.h"
@@ -104,11 +107,79 @@ void BM_OTelCounterAsyncIncrement(benchmark::State& state) {
   async_executor->Stop();
 }
 
+InMemoryMetricRouter& GetMetricRouter() {
+  static auto* metric_router = new InMemoryMetricRouter();
+  return *metric_router;
+}
+
+std::shared_ptr<opentelemetry::metrics::Histogram<double>>
+CreateOtelHistogram() {
+  return std::static_pointer_cast<opentelemetry::metrics::Histogram<double>>(
+      GetMetricRouter().GetOrCreateSyncInstrument(
+          "test_histogram",
+          []() -> std::shared_ptr<
+                   opentelemetry::metrics::SynchronousInstrument> {
+            return GetMetricRouter()
+                .GetOrCreateMeter("test_meter")
+                ->CreateDoubleHistogram("test_histogram");
+          }));
+}
+
+// Labels similar to the ones of the server request metrics.
+absl::flat_hash_map<absl::string_view, std::string> MakeLabels() {
+  return {{"server.address", "0.0.0.0"},
+          {"server.port", "8080"},
+          {"http.route", "/v1/transactions:prepare"},
+          {"http.request.method", "POST"},
+          {"http.response.status_code", "200"},
+          {"pbs.claimed_identity", "https://www.example.com"}};
+}
+
+// Benchmarking 5: Otel Histogram record with labels built for each record.
+void BM_OtelHistogramRecordWithLabelMap(benchmark::State& state) {
+  static auto histogram = CreateOtelHistogram();
+  opentelemetry::context::Context context;
+
+  for (auto _ : state) {
+    histogram->Record(1.0, MakeLabels(), context);
+  }
+}
+
+// Benchmarking 6: Otel Histogram record with labels built and interned by the
+// MetricRouter for each record.
+void BM_OtelHistogramRecordWithInternedAttributes(benchmark::State& state) {
+  static auto histogram = CreateOtelHistogram();
+  opentelemetry::context::Context context;
+
+  for (auto _ : state) {
+    histogram->Record(
+        1.0,
+        GetMetricRouter()
+            .GetOrCreateAttributes("test_histogram", MakeLabels())
+            ->Get(),
+        context);
+  }
+}
+
+// Benchmarking 7: Otel Histogram record bound to its attributes.
+void BM_OtelHistogramRecordWithBoundHistogram(benchmark::State& state) {
+  static const BoundHistogram<double> histogram(
+      CreateOtelHistogram(),
+      GetMetricRouter().GetOrCreateAttributes("test_histogram", MakeLabels()));
+
+  for (auto _ : state) {
+    histogram.Record(1.0);
+  }
+}
+
 // Register the benchmarks.
 BENCHMARK(BM_SpinLockIncrement)->ThreadRange(1, 64);
 BENCHMARK(BM_AtomicIncrement)->ThreadRange(1, 64);
 BENCHMARK(BM_OtelCounterIncrement)->ThreadRange(1, 64);
 BENCHMARK(BM_OTelCounterAsyncIncrement)->ThreadRange(1, 64);
+BENCHMARK(BM_OtelHistogramRecordWithLabelMap)->ThreadRange(1, 64);
+BENCHMARK(BM_OtelHistogramRecordWithInternedAttributes)->ThreadRange(1, 64);
+BENCHMARK(BM_OtelHistogramRecordWithBoundHistogram)->ThreadRange(1, 64);
 
 }  // namespace
 }  // namespace privacy_sandbox::pbs_common
@@ -399,6 +399,64 @@ TEST_F(MetricRouterTest, HandlesInvalidObservableInstrumentType) {
   EXPECT_EQ(result, nullptr);
 }
 
+TEST_F(MetricRouterTest, GetOrCreateAttributesInternsLabels) {
+  absl::flat_hash_map<absl::string_view, std::string> labels = {
+      {"label1", "value1"}, {"label2", "value2"}};
+  absl::flat_hash_map<absl::string_view, std::string> same_labels = {
+      {"label2", "value2"}, {"label1", "value1"}};
+  absl::flat_hash_map<absl::string_view, std::string> other_labels = {
+      {"label1", "value1"}, {"label2", "value3"}};
+
+  auto attributes = metric_router_->GetOrCreateAttributes("metric", labels);
+  EXPECT_EQ(attributes,
+            metric_router_->GetOrCreateAttributes("metric", same_labels));
+  EXPECT_NE(attributes,
+            metric_router_->GetOrCreateAttributes("metric", other_labels));
+  // Attribute sets are interned per metric.
+  EXPECT_NE(attributes,
+            metric_router_->GetOrCreateAttributes("other_metric", labels));
+
+  std::vector<std::pair<std::string, std::string>> expected_labels = {
+      {"label1", "value1"}, {"label2", "value2"}};
+  EXPECT_EQ(attributes->GetLabels(), expected_labels);
+  EXPECT_EQ(attributes->Get().size(), 2);
+}
+
+TEST_F(MetricRouterTest, GetOrCreateAttributesOverflowsOverTheLimit) {
+  mock_config_provider_->SetInt32(
+      std::string(kOtelMetricMaxAttributeSetsPerInstrumentKey), 2);
+  metric_router_ = std::make_unique<MetricRouter>(
+      mock_config_provider_,
+      opentelemetry::sdk::resource::Resource::GetDefault(),
+      std::make_unique<InMemoryMetricExporter>());
+
+  auto labels = [](absl::string_view origin) {
+    return absl::flat_hash_map<absl::string_view, std::string>{
+        {"origin", std::string(origin)}};
+  };
+  auto attributes1 =
+      metric_router_->GetOrCreateAttributes("metric", labels("a"));
+  auto attributes2 =
+      metric_router_->GetOrCreateAttributes("metric", labels("b"));
+  EXPECT_NE(attributes1, MetricAttributes::Overflow());
+  EXPECT_NE(attributes2, MetricAttributes::Overflow());
+
+  EXPECT_EQ(metric_router_->GetOrCreateAttributes("metric", labels("c")),
+            MetricAttributes::Overflow());
+  EXPECT_EQ(metric_router_->GetOrCreateAttributes("metric", labels("d")),
+            MetricAttributes::Overflow());
+  // The attribute sets within the limit are still recorded as is.
+  EXPECT_EQ(metric_router_->GetOrCreateAttributes("metric", labels("a")),
+            attributes1);
+  // The limit applies to each metric.
+  EXPECT_NE(metric_router_->GetOrCreateAttributes("other_metric", labels("c")),
+            MetricAttributes::Overflow());
+
+  std::vector<std::pair<std::string, std::string>> overflow_labels = {
+      {std::string(kOtelMetricOverflowAttribute), "true"}};
+  EXPECT_EQ(MetricAttributes::Overflow()->GetLabels(), overflow_labels);
+}
+
 TEST_F(MetricRouterTest, CreateHistogramViewForInstrumentReturnsSuccess) {
   std::string meter_name = "test_metric";
   std::string instrument_name = "test_instrument";
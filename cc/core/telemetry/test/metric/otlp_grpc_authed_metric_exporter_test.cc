@@ -17,15 +17,117 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
+#include <grpcpp/security/server_credentials.h>
+#include <grpcpp/server.h>
+#include <grpcpp/server_builder.h>
+
+#include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
 #include "cc/core/config_provider/mock/mock_config_provider.h"
 #include "cc/core/telemetry/src/common/telemetry_configuration.h"
 #include "include/gtest/gtest.h"
+#include "opentelemetry/proto/collector/metrics/v1/metrics_service.grpc.pb.h"
+#include "opentelemetry/sdk/instrumentationscope/instrumentation_scope.h"
 #include "opentelemetry/sdk/metrics/export/metric_producer.h"
+#include "opentelemetry/sdk/resource/resource.h"
 
 namespace privacy_sandbox::pbs_common {
 namespace {
 
+using ::opentelemetry::proto::collector::metrics::v1::
+    ExportMetricsServiceRequest;
+using ::opentelemetry::proto::collector::metrics::v1::
+    ExportMetricsServiceResponse;
+using ::opentelemetry::proto::collector::metrics::v1::MetricsService;
+
+// An in-process OTLP collector which records the number of data points and the
+// size of the requests it receives. A collector which does not accept gzip
+// fails the gzip compressed requests before they reach Export.
+class FakeOtlpCollector final : public MetricsService::Service {
+ public:
+  explicit FakeOtlpCollector(bool accept_gzip = true) {
+    grpc::ServerBuilder builder;
+    builder.AddListeningPort("localhost:0", grpc::InsecureServerCredentials(),
+                             &port_);
+    builder.SetCompressionAlgorithmSupportStatus(GRPC_COMPRESS_GZIP,
+                                                 accept_gzip);
+    builder.RegisterService(this);
+    server_ = builder.BuildAndStart();
+  }
+
+  ~FakeOtlpCollector() override { server_->Shutdown(); }
+
+  std::string GetEndpoint() const { return absl::StrCat("localhost:", port_); }
+
+  grpc::Status Export(grpc::ServerContext*,
+                      const ExportMetricsServiceRequest* request,
+                      ExportMetricsServiceResponse*) override {
+    size_t data_points = 0;
+    for (const auto& resource_metrics : request->resource_metrics()) {
+      for (const auto& scope_metrics : resource_metrics.scope_metrics()) {
+        for (const auto& metric : scope_metrics.metrics()) {
+          data_points += metric.sum().data_points_size();
+        }
+      }
+    }
+    absl::MutexLock lock(&mutex_);
+    request_data_points_.push_back(data_points);
+    request_bytes_.push_back(request->ByteSizeLong());
+    return grpc::Status::OK;
+  }
+
+  std::vector<size_t> GetRequestDataPoints() {
+    absl::MutexLock lock(&mutex_);
+    return request_data_points_;
+  }
+
+  int64_t GetRequestBytes() {
+    absl::MutexLock lock(&mutex_);
+    int64_t total = 0;
+    for (size_t bytes : request_bytes_) {
+      total += static_cast<int64_t>(bytes);
+    }
+    return total;
+  }
+
+ private:
+  int port_ = 0;
+  std::unique_ptr<grpc::Server> server_;
+  absl::Mutex mutex_;
+  std::vector<size_t> request_data_points_;
+  std::vector<size_t> request_bytes_;
+};
+
+// Creates the data of a counter with the given number of series.
+opentelemetry::sdk::metrics::ResourceMetrics CreateCounterData(
+    const opentelemetry::sdk::instrumentationscope::InstrumentationScope& scope,
+    int series) {
+  opentelemetry::sdk::metrics::MetricData metric;
+  metric.instrument_descriptor = {
+      "test_counter", "", "",
+      opentelemetry::sdk::metrics::InstrumentType::kCounter,
+      opentelemetry::sdk::metrics::InstrumentValueType::kLong};
+  metric.aggregation_temporality =
+      opentelemetry::sdk::metrics::AggregationTemporality::kCumulative;
+  for (int i = 0; i < series; ++i) {
+    opentelemetry::sdk::metrics::SumPointData point;
+    point.value_ = static_cast<int64_t>(i);
+    metric.point_data_attr_.push_back(
+        {opentelemetry::sdk::metrics::PointAttributes(
+             {{"origin", absl::StrCat("https://origin", i, ".com")}}),
+         point});
+  }
+
+  opentelemetry::sdk::metrics::ResourceMetrics data;
+  data.resource_ = &opentelemetry::sdk::resource::Resource::GetDefault();
+  data.scope_metric_data_.emplace_back();
+  data.scope_metric_data_.back().scope_ = &scope;
+  data.scope_metric_data_.back().metric_data_.push_back(std::move(metric));
+  return data;
+}
+
 class OtlpGrpcAuthedExporterMetricTest : public testing::Test {
  protected:
   inline static constexpr absl::string_view kDefaultEndpoint =
@@ -55,17 +157,23 @@ class OtlpGrpcAuthedExporterMetricTest : public testing::Test {
   }
 
   std::unique_ptr<OtlpGrpcAuthedMetricExporter> CreateExporter(
-      const std::string& endpoint) {
+      const std::string& endpoint, OtlpMetricExportLimits limits = {},
+      const std::string& compression = "") {
     opentelemetry::exporter::otlp::OtlpGrpcMetricExporterOptions options;
     options.aggregation_temporality = opentelemetry::exporter::otlp::
         PreferredAggregationTemporality::kUnspecified;
     options.endpoint = endpoint;
+    options.compression = compression;
     return std::make_unique<OtlpGrpcAuthedMetricExporter>(
-        options, std::move(grpc_id_token_authenticator_));
+        options, std::move(grpc_id_token_authenticator_), limits);
   }
 
   std::shared_ptr<MockConfigProvider> mock_config_provider_;
   std::unique_ptr<GrpcIdTokenAuthenticator> grpc_id_token_authenticator_;
+  std::unique_ptr<
+      opentelemetry::sdk::instrumentationscope::InstrumentationScope>
+      scope_ = opentelemetry::sdk::instrumentationscope::InstrumentationScope::
+          Create("test_meter");
 };
 
 TEST_F(OtlpGrpcAuthedExporterMetricTest, ConfigTest) {
@@ -92,5 +200,149 @@ TEST_F(OtlpGrpcAuthedExporterMetricTest, ForceFlushShouldAlwaysReturnTrue) {
       CreateExporter(std::string(kDefaultEndpoint));
   EXPECT_TRUE(exporter->ForceFlush(std::chrono::microseconds::max()));
 }
+
+TEST_F(OtlpGrpcAuthedExporterMetricTest, ExportSendsOneRequestByDefault) {
+  FakeOtlpCollector collector;
+  std::unique_ptr<OtlpGrpcAuthedMetricExporter> exporter =
+      CreateExporter(collector.GetEndpoint());
+
+  EXPECT_EQ(exporter->Export(CreateCounterData(*scope_, 10)),
+            opentelemetry::sdk::common::ExportResult::kSuccess);
+
+  EXPECT_EQ(collector.GetRequestDataPoints(), std::vector<size_t>({10}));
+  OtlpMetricExportStats stats = exporter->GetExportStats();
+  EXPECT_EQ(stats.exported_data_points, 10);
+  EXPECT_EQ(stats.dropped_data_points, 0);
+  EXPECT_EQ(stats.failed_requests, 0);
+  EXPECT_EQ(stats.request_bytes, collector.GetRequestBytes());
+}
+
+TEST_F(OtlpGrpcAuthedExporterMetricTest, ExportSplitsDataPointsInBatches) {
+  FakeOtlpCollector collector;
+  OtlpMetricExportLimits limits;
+  limits.max_export_batch_size = 4;
+  std::unique_ptr<OtlpGrpcAuthedMetricExporter> exporter =
+      CreateExporter(collector.GetEndpoint(), limits);
+
+  EXPECT_EQ(exporter->Export(CreateCounterData(*scope_, 10)),
+            opentelemetry::sdk::common::ExportResult::kSuccess);
+
+  EXPECT_EQ(collector.GetRequestDataPoints(), std::vector<size_t>({4, 4, 2}));
+  OtlpMetricExportStats stats = exporter->GetExportStats();
+  EXPECT_EQ(stats.exported_data_points, 10);
+  EXPECT_EQ(stats.request_bytes, collector.GetRequestBytes());
+}
+
+TEST_F(OtlpGrpcAuthedExporterMetricTest, ExportDropsDataPointsOverTheLimit) {
+  FakeOtlpCollector collector;
+  OtlpMetricExportLimits limits;
+  limits.max_export_batch_size = 4;
+  limits.max_export_data_points = 6;
+  std::unique_ptr<OtlpGrpcAuthedMetricExporter> exporter =
+      CreateExporter(collector.GetEndpoint(), limits);
+
+  EXPECT_EQ(exporter->Export(CreateCounterData(*scope_, 10)),
+            opentelemetry::sdk::common::ExportResult::kSuccess);
+
+  EXPECT_EQ(collector.GetRequestDataPoints(), std::vector<size_t>({4, 2}));
+  OtlpMetricExportStats stats = exporter->GetExportStats();
+  EXPECT_EQ(stats.exported_data_points, 6);
+  EXPECT_EQ(stats.dropped_data_points, 4);
+}
+
+TEST_F(OtlpGrpcAuthedExporterMetricTest, ExportWithGzipCompression) {
+  FakeOtlpCollector collector;
+  std::unique_ptr<OtlpGrpcAuthedMetricExporter> exporter =
+      CreateExporter(collector.GetEndpoint(), {}, "gzip");
+
+  EXPECT_EQ(exporter->Export(CreateCounterData(*scope_, 100)),
+            opentelemetry::sdk::common::ExportResult::kSuccess);
+
+  // The collector receives the decompressed request.
+  EXPECT_EQ(collector.GetRequestDataPoints(), std::vector<size_t>({100}));
+  EXPECT_EQ(exporter->GetExportStats().request_bytes,
+            collector.GetRequestBytes());
+}
+
+TEST_F(OtlpGrpcAuthedExporterMetricTest, ExportIsGzipCompressedOnTheWire) {
+  FakeOtlpCollector collector(/*accept_gzip=*/false);
+  std::unique_ptr<OtlpGrpcAuthedMetricExporter> uncompressed_exporter =
+      CreateExporter(collector.GetEndpoint());
+  std::unique_ptr<OtlpGrpcAuthedMetricExporter> gzip_exporter =
+      CreateExporter(collector.GetEndpoint(), {}, "gzip");
+
+  EXPECT_EQ(uncompressed_exporter->Export(CreateCounterData(*scope_, 10)),
+            opentelemetry::sdk::common::ExportResult::kSuccess);
+  // Only a gzip compressed request is refused by the collector.
+  EXPECT_EQ(gzip_exporter->Export(CreateCounterData(*scope_, 10)),
+            opentelemetry::sdk::common::ExportResult::kFailure);
+
+  EXPECT_EQ(collector.GetRequestDataPoints(), std::vector<size_t>({10}));
+  EXPECT_EQ(gzip_exporter->GetExportStats().failed_requests, 1);
+}
+
+TEST_F(OtlpGrpcAuthedExporterMetricTest, ExportFailuresAreCounted) {
+  std::string endpoint;
+  {
+    // The collector is gone by the time of the export.
+    FakeOtlpCollector collector;
+    endpoint = collector.GetEndpoint();
+  }
+  std::unique_ptr<OtlpGrpcAuthedMetricExporter> exporter =
+      CreateExporter(endpoint);
+
+  EXPECT_EQ(exporter->Export(CreateCounterData(*scope_, 10)),
+            opentelemetry::sdk::common::ExportResult::kFailure);
+
+  OtlpMetricExportStats stats = exporter->GetExportStats();
+  EXPECT_EQ(stats.exported_data_points, 0);
+  EXPECT_EQ(stats.failed_requests, 1);
+}
+
+TEST_F(OtlpGrpcAuthedExporterMetricTest, GetOptionsFromConfig) {
+  mock_config_provider_->Set(std::string(kOtelExporterOtlpEndpointKey),
+                             std::string(kDefaultEndpoint));
+  mock_config_provider_->Set(std::string(kOtelMetricAggregationTemporalityKey),
+                             std::string("delta"));
+  mock_config_provider_->Set(std::string(kOtelExporterOtlpCompressionKey),
+                             std::string("gzip"));
+  mock_config_provider_->SetInt32(
+      std::string(kOtelMetricMaxExportBatchSizeKey), 500);
+  mock_config_provider_->SetInt32(
+      std::string(kOtelMetricMaxExportDataPointsKey), 10000);
+
+  opentelemetry::exporter::otlp::OtlpGrpcMetricExporterOptions options =
+      GetOtlpGrpcMetricExporterOptions(*mock_config_provider_);
+  EXPECT_EQ(options.endpoint, kDefaultEndpoint);
+  EXPECT_EQ(
+      options.aggregation_temporality,
+      opentelemetry::exporter::otlp::PreferredAggregationTemporality::kDelta);
+  EXPECT_EQ(options.compression, "gzip");
+
+  OtlpMetricExportLimits limits =
+      GetOtlpMetricExportLimits(*mock_config_provider_);
+  EXPECT_EQ(limits.max_export_batch_size, 500);
+  EXPECT_EQ(limits.max_export_data_points, 10000);
+
+  OtlpGrpcAuthedMetricExporter exporter(options, nullptr, limits);
+  EXPECT_EQ(exporter.GetAggregationTemporality(
+                opentelemetry::sdk::metrics::InstrumentType::kCounter),
+            opentelemetry::sdk::metrics::AggregationTemporality::kDelta);
+}
+
+TEST_F(OtlpGrpcAuthedExporterMetricTest, GetDefaultOptions) {
+  opentelemetry::exporter::otlp::OtlpGrpcMetricExporterOptions options =
+      GetOtlpGrpcMetricExporterOptions(*mock_config_provider_);
+  EXPECT_EQ(options.endpoint, kOtelExporterOtlpEndpointValue);
+  EXPECT_EQ(options.aggregation_temporality,
+            opentelemetry::exporter::otlp::PreferredAggregationTemporality::
+                kCumulative);
+  EXPECT_EQ(options.compression, "");
+
+  OtlpMetricExportLimits limits =
+      GetOtlpMetricExportLimits(*mock_config_provider_);
+  EXPECT_EQ(limits.max_export_batch_size, 0);
+  EXPECT_EQ(limits.max_export_data_points, 0);
+}
 }  // namespace
 }  // namespace privacy_sandbox::pbs_common
@@ -0,0 +1,236 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cc/core/telemetry/src/trace/tail_sampling_span_processor.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "cc/core/telemetry/mock/trace/span_exporter_fake.h"
+#include "cc/core/telemetry/mock/trace/span_processor_fake.h"
+#include "cc/core/telemetry/src/common/trace/trace_utils.h"
+#include "cc/core/telemetry/src/trace/trace_sampler.h"
+#include "opentelemetry/sdk/resource/resource.h"
+#include "opentelemetry/sdk/trace/tracer_provider.h"
+#include "opentelemetry/sdk/trace/tracer_provider_factory.h"
+#include "opentelemetry/trace/span_context.h"
+#include "opentelemetry/trace/span_startoptions.h"
+#include "opentelemetry/trace/tracer.h"
+
+namespace privacy_sandbox::pbs_common {
+namespace {
+
+using ::opentelemetry::common::SteadyTimestamp;
+using ::opentelemetry::trace::EndSpanOptions;
+using ::opentelemetry::trace::Span;
+using ::opentelemetry::trace::SpanContext;
+using ::opentelemetry::trace::StartSpanOptions;
+using ::opentelemetry::trace::StatusCode;
+using ::opentelemetry::trace::TraceFlags;
+using ::opentelemetry::trace::Tracer;
+using ::testing::IsEmpty;
+using ::testing::SizeIs;
+
+constexpr absl::string_view kTracerName = "test_tracer";
+constexpr absl::string_view kRootSpanName = "root_span";
+constexpr absl::string_view kChildSpanName = "child_span";
+
+constexpr std::chrono::milliseconds kFast(10);
+constexpr std::chrono::milliseconds kSlow(2000);
+
+class TailSamplingSpanProcessorTest : public testing::Test {
+ protected:
+  void CreateTracer(const TailSamplingOptions& options) {
+    exporter_ = std::make_shared<SpanExporterFake>();
+    auto processor = std::make_unique<TailSamplingSpanProcessor>(
+        std::make_unique<SpanProcessorFake>(exporter_), options);
+    processor_ = processor.get();
+    // As in tail sampling mode, every span is recorded.
+    tracer_provider_ = opentelemetry::sdk::trace::TracerProviderFactory::Create(
+        std::move(processor),
+        opentelemetry::sdk::resource::Resource::GetDefault(),
+        std::make_unique<TraceSampler>(/*sampling_ratio=*/1.0));
+    tracer_ = tracer_provider_->GetTracer(kTracerName);
+  }
+
+  static TailSamplingOptions DefaultOptions() {
+    TailSamplingOptions options;
+    options.latency_threshold = std::chrono::milliseconds(1000);
+    options.baseline_ratio = 0.0;
+    return options;
+  }
+
+  std::shared_ptr<Span> StartSpan(absl::string_view name,
+                                  const Span* parent = nullptr) {
+    StartSpanOptions options;
+    options.start_steady_time = SteadyTimestamp(start_time_);
+    if (parent != nullptr) {
+      options.parent = parent->GetContext();
+    }
+    return tracer_->StartSpan(name, options);
+  }
+
+  void EndSpan(Span& span, std::chrono::milliseconds duration) {
+    EndSpanOptions options;
+    options.end_steady_time = SteadyTimestamp(start_time_ + duration);
+    span.End(options);
+  }
+
+  std::vector<const opentelemetry::sdk::trace::SpanData*> GetExportedSpans(
+      const Span& span) {
+    return exporter_->GetSpansForTraceId(
+        GetTraceIdString(span.GetContext().trace_id()));
+  }
+
+  const std::chrono::steady_clock::time_point start_time_ =
+      std::chrono::steady_clock::now();
+  std::shared_ptr<SpanExporterFake> exporter_;
+  TailSamplingSpanProcessor* processor_ = nullptr;
+  std::unique_ptr<opentelemetry::sdk::trace::TracerProvider> tracer_provider_;
+  std::shared_ptr<Tracer> tracer_;
+};
+
+TEST_F(TailSamplingSpanProcessorTest, DropsFastTrace) {
+  CreateTracer(DefaultOptions());
+  auto root = StartSpan(kRootSpanName);
+  auto child = StartSpan(kChildSpanName, root.get());
+  EndSpan(*child, kFast);
+  EndSpan(*root, kFast);
+
+  EXPECT_THAT(GetExportedSpans(*root), IsEmpty());
+  EXPECT_EQ(processor_->GetStats().kept_traces, 0);
+  EXPECT_EQ(processor_->GetStats().dropped_traces, 1);
+}
+
+TEST_F(TailSamplingSpanProcessorTest, KeepsSlowTrace) {
+  CreateTracer(DefaultOptions());
+  auto root = StartSpan(kRootSpanName);
+  auto child = StartSpan(kChildSpanName, root.get());
+  EndSpan(*child, kFast);
+  // The child is buffered until the root span ends.
+  EXPECT_THAT(GetExportedSpans(*root), IsEmpty());
+  EndSpan(*root, kSlow);
+
+  EXPECT_THAT(GetExportedSpans(*root), SizeIs(2));
+  EXPECT_EQ(processor_->GetStats().kept_traces, 1);
+  EXPECT_EQ(processor_->GetStats().dropped_traces, 0);
+}
+
+TEST_F(TailSamplingSpanProcessorTest, KeepsErroredTrace) {
+  CreateTracer(DefaultOptions());
+  auto root = StartSpan(kRootSpanName);
+  auto first_child = StartSpan(kChildSpanName, root.get());
+  auto second_child = StartSpan(kChildSpanName, root.get());
+  EndSpan(*first_child, kFast);
+  second_child->SetStatus(StatusCode::kError, "failed");
+  EndSpan(*second_child, kFast);
+  // The trace is kept as soon as a span errors.
+  EXPECT_THAT(GetExportedSpans(*root), SizeIs(2));
+  EndSpan(*root, kFast);
+
+  EXPECT_THAT(GetExportedSpans(*root), SizeIs(3));
+  EXPECT_EQ(processor_->GetStats().kept_traces, 1);
+}
+
+TEST_F(TailSamplingSpanProcessorTest, KeepsBaselineTrace) {
+  TailSamplingOptions options = DefaultOptions();
+  options.baseline_ratio = 1.0;
+  CreateTracer(options);
+  auto root = StartSpan(kRootSpanName);
+  auto child = StartSpan(kChildSpanName, root.get());
+  EndSpan(*child, kFast);
+  // Baseline traces are not buffered.
+  EXPECT_THAT(GetExportedSpans(*root), SizeIs(1));
+  EndSpan(*root, kFast);
+
+  EXPECT_THAT(GetExportedSpans(*root), SizeIs(2));
+  EXPECT_EQ(processor_->GetStats().kept_traces, 1);
+}
+
+TEST_F(TailSamplingSpanProcessorTest, TreatsSpanWithRemoteParentAsRoot) {
+  CreateTracer(DefaultOptions());
+  StartSpanOptions start_options;
+  start_options.start_steady_time = SteadyTimestamp(start_time_);
+  constexpr uint8_t kTraceId[opentelemetry::trace::TraceId::kSize] = {1, 2};
+  constexpr uint8_t kSpanId[opentelemetry::trace::SpanId::kSize] = {3, 4};
+  start_options.parent =
+      SpanContext(opentelemetry::trace::TraceId(kTraceId),
+                  opentelemetry::trace::SpanId(kSpanId),
+                  TraceFlags(TraceFlags::kIsSampled), /*is_remote=*/true);
+  auto root = tracer_->StartSpan(kRootSpanName, start_options);
+  EndSpan(*root, kSlow);
+
+  EXPECT_THAT(GetExportedSpans(*root), SizeIs(1));
+  EXPECT_EQ(processor_->GetStats().kept_traces, 1);
+}
+
+TEST_F(TailSamplingSpanProcessorTest, DropsOldestTraceWhenBufferIsFull) {
+  TailSamplingOptions options = DefaultOptions();
+  options.max_buffered_spans = 2;
+  CreateTracer(options);
+  auto first_root = StartSpan(kRootSpanName);
+  auto second_root = StartSpan(kRootSpanName);
+  for (int i = 0; i < 2; ++i) {
+    EndSpan(*StartSpan(kChildSpanName, first_root.get()), kFast);
+  }
+  // Makes room for the span by dropping the first trace.
+  EndSpan(*StartSpan(kChildSpanName, second_root.get()), kFast);
+  EXPECT_EQ(processor_->GetStats().dropped_traces, 1);
+  EXPECT_EQ(processor_->GetStats().overflow_dropped_spans, 2);
+
+  // The first trace stays dropped however slow.
+  EndSpan(*first_root, kSlow);
+  EndSpan(*second_root, kSlow);
+
+  EXPECT_THAT(GetExportedSpans(*first_root), IsEmpty());
+  EXPECT_THAT(GetExportedSpans(*second_root), SizeIs(2));
+  EXPECT_EQ(processor_->GetStats().kept_traces, 1);
+  EXPECT_EQ(processor_->GetStats().dropped_traces, 1);
+}
+
+TEST_F(TailSamplingSpanProcessorTest, LimitsSpansPerTrace) {
+  TailSamplingOptions options = DefaultOptions();
+  options.max_spans_per_trace = 1;
+  CreateTracer(options);
+  auto root = StartSpan(kRootSpanName);
+  for (int i = 0; i < 3; ++i) {
+    EndSpan(*StartSpan(kChildSpanName, root.get()), kFast);
+  }
+  EndSpan(*root, kSlow);
+
+  EXPECT_THAT(GetExportedSpans(*root), SizeIs(2));
+  EXPECT_EQ(processor_->GetStats().overflow_dropped_spans, 2);
+}
+
+TEST_F(TailSamplingSpanProcessorTest, FollowsDecisionForSpansEndingLate) {
+  CreateTracer(DefaultOptions());
+  auto root = StartSpan(kRootSpanName);
+  auto child = StartSpan(kChildSpanName, root.get());
+  EndSpan(*root, kSlow);
+  EndSpan(*child, kSlow);
+
+  EXPECT_THAT(GetExportedSpans(*root), SizeIs(2));
+  EXPECT_EQ(processor_->GetStats().kept_traces, 1);
+}
+
+}  // namespace
+}  // namespace privacy_sandbox::pbs_common
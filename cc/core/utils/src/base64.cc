@@ -32,16 +32,18 @@ ExecutionResult Base64Decode(const std::string& encoded, std::string& decoded) {
   if (EVP_DecodedLength(&required_len, encoded.length()) == 0) {
     return FailureExecutionResult(SC_CORE_UTILS_INVALID_INPUT);
   }
-  auto buffer = std::make_unique<uint8_t[]>(required_len);
-
+  // Decode straight into the output rather than through a temporary buffer.
+  decoded.resize(required_len);
   size_t output_len = 0;
-  int ret = EVP_DecodeBase64(buffer.get(), &output_len, required_len,
+  int ret = EVP_DecodeBase64(reinterpret_cast<uint8_t*>(decoded.data()),
+                             &output_len, required_len,
                              reinterpret_cast<const uint8_t*>(encoded.data()),
                              encoded.length());
   if (ret == 0) {
+    decoded.clear();
     return FailureExecutionResult(SC_CORE_UTILS_INVALID_INPUT);
   }
-  decoded = std::string(reinterpret_cast<char*>(buffer.get()), output_len);
+  decoded.resize(output_len);
   return SuccessExecutionResult();
 }
 
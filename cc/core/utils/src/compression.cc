@@ -0,0 +1,186 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cc/core/utils/src/compression.h"
+
+#include <zlib.h>
+
+#include <array>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/strip.h"
+#include "cc/core/utils/src/error_codes.h"
+
+namespace privacy_sandbox::pbs_common {
+namespace {
+// Window bits selecting the gzip wrapper instead of the zlib one.
+constexpr int kGzipWindowBits = 16 + MAX_WBITS;
+constexpr int kDeflateMemoryLevel = 8;
+// Size of the pieces the decompressed output is handed out in.
+constexpr size_t kDecompressionChunkSize = 16 * 1024;
+}  // namespace
+
+ExecutionResult GzipCompress(std::string_view input, std::string& compressed,
+                             int level) noexcept {
+  if (input.size() > std::numeric_limits<uInt>::max()) {
+    return FailureExecutionResult(SC_CORE_UTILS_INVALID_INPUT);
+  }
+  z_stream stream{};
+  if (deflateInit2(&stream, level, Z_DEFLATED, kGzipWindowBits,
+                   kDeflateMemoryLevel, Z_DEFAULT_STRATEGY) != Z_OK) {
+    return FailureExecutionResult(SC_CORE_UTILS_COMPRESSION_ERROR);
+  }
+  // The bound guarantees that a single deflate call finishes the stream.
+  compressed.resize(deflateBound(&stream, input.size()));
+  stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+  stream.avail_in = input.size();
+  stream.next_out = reinterpret_cast<Bytef*>(compressed.data());
+  stream.avail_out = compressed.size();
+  int status = deflate(&stream, Z_FINISH);
+  compressed.resize(stream.total_out);
+  deflateEnd(&stream);
+  if (status != Z_STREAM_END) {
+    compressed.clear();
+    return FailureExecutionResult(SC_CORE_UTILS_COMPRESSION_ERROR);
+  }
+  return SuccessExecutionResult();
+}
+
+ExecutionResult GzipDecompress(std::string_view compressed,
+                               size_t max_decompressed_size,
+                               std::string& decompressed) noexcept {
+  decompressed.clear();
+  GzipDecompressor decompressor(max_decompressed_size);
+  auto execution_result = decompressor.Decompress(
+      compressed, [&decompressed](std::string_view piece) {
+        decompressed.append(piece);
+        return SuccessExecutionResult();
+      });
+  if (!execution_result.Successful()) {
+    return execution_result;
+  }
+  return decompressor.Finish();
+}
+
+bool IsGzipAccepted(std::string_view accept_encoding) noexcept {
+  std::optional<bool> is_gzip_accepted;
+  std::optional<bool> is_any_accepted;
+  for (absl::string_view coding : absl::StrSplit(accept_encoding, ',')) {
+    std::pair<absl::string_view, absl::string_view> name_and_params =
+        absl::StrSplit(coding, absl::MaxSplits(';', 1));
+    bool is_accepted = true;
+    for (absl::string_view param :
+         absl::StrSplit(name_and_params.second, ';', absl::SkipEmpty())) {
+      param = absl::StripAsciiWhitespace(param);
+      if (absl::ConsumePrefix(&param, "q=") ||
+          absl::ConsumePrefix(&param, "Q=")) {
+        double quality = 0;
+        is_accepted = absl::SimpleAtod(param, &quality) && quality > 0;
+      }
+    }
+    absl::string_view name = absl::StripAsciiWhitespace(name_and_params.first);
+    if (absl::EqualsIgnoreCase(name, kGzipContentEncoding) ||
+        absl::EqualsIgnoreCase(name, "x-gzip")) {
+      is_gzip_accepted = is_accepted;
+    } else if (name == "*") {
+      is_any_accepted = is_accepted;
+    }
+  }
+  // An explicit gzip entry takes precedence over the wildcard.
+  return is_gzip_accepted.value_or(is_any_accepted.value_or(false));
+}
+
+GzipDecompressor::~GzipDecompressor() {
+  if (is_initialized_) {
+    inflateEnd(&stream_);
+  }
+}
+
+void GzipDecompressor::Reset(size_t max_decompressed_size) noexcept {
+  if (is_initialized_ && inflateReset(&stream_) != Z_OK) {
+    inflateEnd(&stream_);
+    is_initialized_ = false;
+  }
+  is_finished_ = false;
+  max_decompressed_size_ = max_decompressed_size;
+  decompressed_size_ = 0;
+}
+
+ExecutionResult GzipDecompressor::Decompress(std::string_view chunk,
+                                             OutputCallback output) noexcept {
+  if (chunk.empty()) {
+    return SuccessExecutionResult();
+  }
+  if (is_finished_ || chunk.size() > std::numeric_limits<uInt>::max()) {
+    return FailureExecutionResult(SC_CORE_UTILS_INVALID_COMPRESSED_DATA);
+  }
+  if (!is_initialized_) {
+    stream_ = z_stream{};
+    if (inflateInit2(&stream_, kGzipWindowBits) != Z_OK) {
+      return FailureExecutionResult(SC_CORE_UTILS_COMPRESSION_ERROR);
+    }
+    is_initialized_ = true;
+  }
+
+  std::array<char, kDecompressionChunkSize> buffer;
+  stream_.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(chunk.data()));
+  stream_.avail_in = chunk.size();
+  do {
+    stream_.next_out = reinterpret_cast<Bytef*>(buffer.data());
+    stream_.avail_out = buffer.size();
+    int status = inflate(&stream_, Z_NO_FLUSH);
+    if (status == Z_STREAM_END) {
+      is_finished_ = true;
+    } else if (status != Z_OK && status != Z_BUF_ERROR) {
+      return FailureExecutionResult(SC_CORE_UTILS_INVALID_COMPRESSED_DATA);
+    }
+
+    size_t piece_size = buffer.size() - stream_.avail_out;
+    if (piece_size > max_decompressed_size_ - decompressed_size_) {
+      return FailureExecutionResult(SC_CORE_UTILS_DECOMPRESSED_SIZE_TOO_LARGE);
+    }
+    decompressed_size_ += piece_size;
+    if (piece_size > 0) {
+      auto execution_result =
+          output(std::string_view(buffer.data(), piece_size));
+      if (!execution_result.Successful()) {
+        return execution_result;
+      }
+    }
+
+    if (is_finished_ && stream_.avail_in > 0) {
+      return FailureExecutionResult(SC_CORE_UTILS_INVALID_COMPRESSED_DATA);
+    }
+    // A full output buffer may leave more output pending in zlib.
+  } while (!is_finished_ && (stream_.avail_in > 0 || stream_.avail_out == 0));
+  return SuccessExecutionResult();
+}
+
+ExecutionResult GzipDecompressor::Finish() const noexcept {
+  if (!is_finished_) {
+    return FailureExecutionResult(SC_CORE_UTILS_INVALID_COMPRESSED_DATA);
+  }
+  return SuccessExecutionResult();
+}
+
+}  // namespace privacy_sandbox::pbs_common
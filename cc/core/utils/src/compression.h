@@ -0,0 +1,138 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <zlib.h>
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include "absl/functional/function_ref.h"
+#include "cc/public/core/interface/execution_result.h"
+
+namespace privacy_sandbox::pbs_common {
+
+inline constexpr char kContentEncodingHeader[] = "content-encoding";
+inline constexpr char kAcceptEncodingHeader[] = "accept-encoding";
+inline constexpr char kVaryHeader[] = "vary";
+
+/// The HTTP content coding of gzip compressed bodies.
+inline constexpr char kGzipContentEncoding[] = "gzip";
+
+/// Trades some compression ratio for speed, bodies being compressed inline.
+inline constexpr int kDefaultGzipCompressionLevel = 1;
+
+/**
+ * @brief Compresses \a input as a single gzip member, replacing the content of
+ * \a compressed.
+ *
+ * @param input The data to compress.
+ * @param compressed The output gzip stream.
+ * @param level The zlib compression level, from 1 (fastest) to 9 (smallest).
+ * @return ExecutionResult The execution result of the operation.
+ */
+ExecutionResult GzipCompress(
+    std::string_view input, std::string& compressed,
+    int level = kDefaultGzipCompressionLevel) noexcept;
+
+/**
+ * @brief Decompresses the gzip stream \a compressed at once, replacing the
+ * content of \a decompressed.
+ *
+ * @param compressed The complete gzip stream.
+ * @param max_decompressed_size Upper bound of the decompressed size.
+ * @param decompressed The output data.
+ * @return ExecutionResult SC_CORE_UTILS_DECOMPRESSED_SIZE_TOO_LARGE if the
+ * data decompresses to more than the limit.
+ */
+ExecutionResult GzipDecompress(std::string_view compressed,
+                               size_t max_decompressed_size,
+                               std::string& decompressed) noexcept;
+
+/**
+ * @brief Whether an Accept-Encoding header value allows gzip, i.e. lists gzip
+ * or * without a zero quality value.
+ *
+ * @param accept_encoding The value of the Accept-Encoding header.
+ */
+bool IsGzipAccepted(std::string_view accept_encoding) noexcept;
+
+/**
+ * @brief Decompresses a gzip stream incrementally, as its chunks arrive.
+ *
+ * The output is handed out in pieces of bounded size and decompression stops
+ * as soon as the decompressed size exceeds the limit, so a small stream
+ * inflating to a huge output (a zip bomb) is neither buffered nor fully
+ * decompressed. The zlib state is allocated on first use and kept by Reset,
+ * which makes decompressors cheap to reuse.
+ */
+class GzipDecompressor {
+ public:
+  using OutputCallback = absl::FunctionRef<ExecutionResult(std::string_view)>;
+
+  explicit GzipDecompressor(size_t max_decompressed_size) noexcept
+      : max_decompressed_size_(max_decompressed_size) {}
+
+  ~GzipDecompressor();
+
+  GzipDecompressor(const GzipDecompressor&) = delete;
+  GzipDecompressor& operator=(const GzipDecompressor&) = delete;
+
+  /**
+   * @brief Prepares the decompressor for a new stream.
+   *
+   * @param max_decompressed_size Upper bound of the decompressed size of the
+   * new stream.
+   */
+  void Reset(size_t max_decompressed_size) noexcept;
+
+  /**
+   * @brief Decompresses the next chunk of the stream.
+   *
+   * @param chunk The compressed chunk.
+   * @param output Invoked with each piece of decompressed data. A failure
+   * stops the decompression and is returned.
+   * @return ExecutionResult SC_CORE_UTILS_INVALID_COMPRESSED_DATA if the
+   * stream is malformed or has data after its end,
+   * SC_CORE_UTILS_DECOMPRESSED_SIZE_TOO_LARGE if the decompressed size exceeds
+   * the limit.
+   */
+  ExecutionResult Decompress(std::string_view chunk,
+                             OutputCallback output) noexcept;
+
+  /**
+   * @brief Checks that the whole stream has been decompressed.
+   *
+   * @return ExecutionResult SC_CORE_UTILS_INVALID_COMPRESSED_DATA if the
+   * stream is truncated.
+   */
+  ExecutionResult Finish() const noexcept;
+
+  /// Number of bytes decompressed so far.
+  size_t GetDecompressedSize() const noexcept { return decompressed_size_; }
+
+ private:
+  z_stream stream_{};
+  bool is_initialized_ = false;
+  bool is_finished_ = false;
+  size_t max_decompressed_size_;
+  size_t decompressed_size_ = 0;
+};
+
+}  // namespace privacy_sandbox::pbs_common
@@ -36,4 +36,20 @@ DEFINE_ERROR_CODE(SC_CORE_UTILS_CURL_INIT_ERROR, SC_CORE_UTILS, 0x0003,
 DEFINE_ERROR_CODE(SC_CORE_REQUEST_HEADER_NOT_FOUND, SC_CORE_UTILS, 0x0004,
                   "Request header not found.", HttpStatusCode::BAD_REQUEST)
 
+DEFINE_ERROR_CODE(SC_CORE_UTILS_COMPRESSION_ERROR, SC_CORE_UTILS, 0x0005,
+                  "The data cannot be compressed.",
+                  HttpStatusCode::INTERNAL_SERVER_ERROR)
+
+DEFINE_ERROR_CODE(SC_CORE_UTILS_INVALID_COMPRESSED_DATA, SC_CORE_UTILS, 0x0006,
+                  "The compressed data is invalid or truncated.",
+                  HttpStatusCode::BAD_REQUEST)
+
+DEFINE_ERROR_CODE(SC_CORE_UTILS_DECOMPRESSED_SIZE_TOO_LARGE, SC_CORE_UTILS,
+                  0x0007, "The decompressed data exceeds the size limit.",
+                  HttpStatusCode::REQUEST_ENTITY_TOO_LARGE)
+
+DEFINE_ERROR_CODE(SC_CORE_UTILS_TLS_CONTEXT_ERROR, SC_CORE_UTILS, 0x0008,
+                  "The TLS context cannot be configured.",
+                  HttpStatusCode::INTERNAL_SERVER_ERROR)
+
 }  // namespace privacy_sandbox::pbs_common
@@ -15,13 +15,16 @@
  */
 #include "cc/core/utils/src/http.h"
 
+#include <memory>
 #include <string>
+#include <string_view>
 #include <utility>
 
 #include <curl/curl.h>
 
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_split.h"
+#include "cc/core/utils/src/compression.h"
 #include "cc/core/utils/src/error_codes.h"
 #include "cc/public/core/interface/execution_result.h"
 #include "re2/re2.h"
@@ -82,20 +85,43 @@ ExecutionResultOr<std::string> ExtractUserAgent(
     return FailureExecutionResult(SC_CORE_REQUEST_HEADER_NOT_FOUND);
   }
 
-  const std::string& user_agent = header_iter->second;
+  return ExtractClientVersion(header_iter->second);
+}
+
+std::string ExtractClientVersion(std::string_view user_agent) noexcept {
   if (user_agent.empty() || !absl::StartsWith(user_agent, kUserAgentPrefix)) {
     return std::string(kUnknownValue);
   }
 
   // Search for the regex pattern in the User-Agent string.
   std::string_view match;
-  if (!RE2::PartialMatch(std::string_view(&user_agent[kUserAgentPrefix.size()]),
+  if (!RE2::PartialMatch(user_agent.substr(kUserAgentPrefix.size()),
                          *kVersionRegex, &match)) {
     return std::string(kUnknownValue);
   }
   return absl::StrCat(kUserAgentPrefix, match);
 }
 
+ExecutionResult GzipCompressRequestBody(HttpRequest& request) noexcept {
+  if (request.body.length == 0) {
+    return SuccessExecutionResult();
+  }
+  std::string compressed;
+  auto execution_result = GzipCompress(
+      std::string_view(request.body.bytes->data(), request.body.length),
+      compressed);
+  if (!execution_result.Successful()) {
+    return execution_result;
+  }
+  request.body = BytesBuffer(compressed);
+  if (!request.headers) {
+    request.headers = std::make_shared<HttpHeaders>();
+  }
+  request.headers->erase(kContentEncodingHeader);
+  request.headers->insert({kContentEncodingHeader, kGzipContentEncoding});
+  return SuccessExecutionResult();
+}
+
 std::string HttpMethodToString(HttpMethod method) {
   switch (method) {
     case HttpMethod::GET:
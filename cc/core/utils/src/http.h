@@ -18,6 +18,7 @@
 
 #include <array>
 #include <string>
+#include <string_view>
 
 #include "cc/core/interface/async_context.h"
 #include "cc/core/interface/http_types.h"
@@ -73,7 +74,18 @@ ExecutionResultOr<std::string> ExtractRequestClaimedIdentity(
 template <typename RequestType, typename ResponseType>
 std::string GetClaimedIdentityOrUnknownValue(
     const AsyncContext<RequestType, ResponseType>& http_context) {
-  if (http_context.request && http_context.request->headers) {
+  // NgHttp2Request only copies its headers on demand, so they are looked up
+  // in place.
+  if constexpr (requires(const RequestType& request) {
+                  request.FindHeader(kClaimedIdentityHeader);
+                }) {
+    if (http_context.request) {
+      if (auto claimed_identity =
+              http_context.request->FindHeader(kClaimedIdentityHeader)) {
+        return std::string(*claimed_identity);
+      }
+    }
+  } else if (http_context.request && http_context.request->headers) {
     ExecutionResultOr<std::string> claimed_identity_extraction_result =
         ExtractRequestClaimedIdentity(*http_context.request->headers);
 
@@ -100,6 +112,16 @@ std::string GetClaimedIdentityOrUnknownValue(
 ExecutionResultOr<std::string> ExtractUserAgent(
     const HttpHeaders& request_headers) noexcept;
 
+/**
+ * Extracts the client version from the value of a User-Agent header.
+ *
+ * @param user_agent The value of the User-Agent header.
+ *
+ * @return std::string The client version, or kUnknownValue if the User-Agent
+ * is not one of a known client.
+ */
+std::string ExtractClientVersion(std::string_view user_agent) noexcept;
+
 /**
  * Extracts the client version from the User-Agent header in the
  * HTTP request, if available. This function works with both NgHttp2Request and
@@ -126,7 +148,16 @@ ExecutionResultOr<std::string> ExtractUserAgent(
 template <typename RequestType, typename ResponseType>
 std::string GetUserAgentOrUnknownValue(
     const AsyncContext<RequestType, ResponseType>& http_context) {
-  if (http_context.request && http_context.request->headers) {
+  if constexpr (requires(const RequestType& request) {
+                  request.FindHeader(kUserAgentHeader);
+                }) {
+    if (http_context.request) {
+      if (auto user_agent =
+              http_context.request->FindHeader(kUserAgentHeader)) {
+        return ExtractClientVersion(*user_agent);
+      }
+    }
+  } else if (http_context.request && http_context.request->headers) {
     ExecutionResultOr<std::string> trusted_client_version_extraction_result =
         ExtractUserAgent(*http_context.request->headers);
 
@@ -140,6 +171,15 @@ std::string GetUserAgentOrUnknownValue(
   return std::string(kUnknownValue);
 }
 
+/**
+ * Gzip compresses the body of an outgoing request and sets its
+ * Content-Encoding header accordingly. Empty bodies are left as is.
+ *
+ * @param request The request to compress the body of.
+ * @return ExecutionResult The execution result of the operation.
+ */
+ExecutionResult GzipCompressRequestBody(HttpRequest& request) noexcept;
+
 // Function to convert HttpMethod enum to a string representation
 std::string HttpMethodToString(HttpMethod method);
 
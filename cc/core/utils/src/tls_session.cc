@@ -0,0 +1,268 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cc/core/utils/src/tls_session.h"
+
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <openssl/rand.h>
+#include <openssl/ssl.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "cc/core/utils/src/error_codes.h"
+
+namespace privacy_sandbox::pbs_common {
+namespace {
+// Sizes of the ticket key name, which identifies the key of a ticket, and of
+// the AES-256-CBC and HMAC-SHA256 keys protecting the ticket.
+constexpr size_t kTicketKeyNameSize = 16;
+constexpr size_t kTicketAesKeySize = 32;
+constexpr size_t kTicketHmacKeySize = 32;
+constexpr size_t kTicketIvSize = 16;
+
+struct TicketKey {
+  std::array<uint8_t, kTicketKeyNameSize> name;
+  std::array<uint8_t, kTicketAesKeySize> aes_key;
+  std::array<uint8_t, kTicketHmacKeySize> hmac_key;
+};
+
+bool GenerateTicketKey(TicketKey& key) {
+  return RAND_bytes(key.name.data(), key.name.size()) == 1 &&
+         RAND_bytes(key.aes_key.data(), key.aes_key.size()) == 1 &&
+         RAND_bytes(key.hmac_key.data(), key.hmac_key.size()) == 1;
+}
+
+/// The current and previous ticket keys of a server context.
+class TicketKeys {
+ public:
+  explicit TicketKeys(std::chrono::seconds rotation_interval)
+      : rotation_interval_(rotation_interval) {}
+
+  /// Generates the first key.
+  bool Init() {
+    rotated_at_ = std::chrono::steady_clock::now();
+    return GenerateTicketKey(current_);
+  }
+
+  /// The key encrypting new tickets, rotated first if it is due.
+  bool GetEncryptionKey(TicketKey& key) {
+    std::lock_guard lock(mutex_);
+    auto now = std::chrono::steady_clock::now();
+    if (now - rotated_at_ >= rotation_interval_) {
+      TicketKey next_key;
+      if (!GenerateTicketKey(next_key)) {
+        return false;
+      }
+      previous_ = current_;
+      current_ = next_key;
+      rotated_at_ = now;
+    }
+    key = current_;
+    return true;
+  }
+
+  /**
+   * @brief Finds the key of a ticket by name.
+   *
+   * @return std::optional<bool> Whether the ticket should be renewed, i.e. it
+   * was encrypted with the previous key, or nullopt if the key is unknown.
+   */
+  std::optional<bool> FindDecryptionKey(const uint8_t* name, TicketKey& key) {
+    std::lock_guard lock(mutex_);
+    if (std::memcmp(name, current_.name.data(), kTicketKeyNameSize) == 0) {
+      key = current_;
+      return false;
+    }
+    if (previous_ &&
+        std::memcmp(name, previous_->name.data(), kTicketKeyNameSize) == 0) {
+      key = *previous_;
+      return true;
+    }
+    return std::nullopt;
+  }
+
+ private:
+  const std::chrono::seconds rotation_interval_;
+  std::mutex mutex_;
+  TicketKey current_;
+  std::optional<TicketKey> previous_;
+  std::chrono::steady_clock::time_point rotated_at_;
+};
+
+/// The last session issued to a client context.
+class ClientSession {
+ public:
+  /**
+   * @brief Keeps a serialized copy of a new session. The session itself is
+   * marked as not resumable when its connection is not shut down cleanly,
+   * which is the common case of connections being reestablished.
+   */
+  void Set(const SSL_SESSION* session) {
+    int size = i2d_SSL_SESSION(const_cast<SSL_SESSION*>(session), nullptr);
+    if (size <= 0) {
+      return;
+    }
+    std::vector<uint8_t> serialized_session(size);
+    uint8_t* output = serialized_session.data();
+    if (i2d_SSL_SESSION(const_cast<SSL_SESSION*>(session), &output) != size) {
+      return;
+    }
+    std::lock_guard lock(mutex_);
+    serialized_session_ = std::move(serialized_session);
+  }
+
+  /// Offers the session, if any, on the handshake of ssl.
+  void Offer(SSL* ssl) {
+    SSL_SESSION* session = nullptr;
+    {
+      std::lock_guard lock(mutex_);
+      if (serialized_session_.empty()) {
+        return;
+      }
+      const uint8_t* input = serialized_session_.data();
+      session =
+          d2i_SSL_SESSION(nullptr, &input, serialized_session_.size());
+    }
+    if (session) {
+      SSL_set_session(ssl, session);
+      SSL_SESSION_free(session);
+    }
+  }
+
+ private:
+  std::mutex mutex_;
+  std::vector<uint8_t> serialized_session_;
+};
+
+/// Index of the T object owned by the contexts, freed along with them.
+template <typename T>
+int GetExDataIndex() {
+  static const int index = SSL_CTX_get_ex_new_index(
+      0, nullptr, nullptr, nullptr,
+      [](void* parent, void* ptr, CRYPTO_EX_DATA* ex_data, int index,
+         long argl, void* argp) { delete static_cast<T*>(ptr); });
+  return index;
+}
+
+template <typename T>
+T* GetExData(const SSL* ssl) {
+  return static_cast<T*>(
+      SSL_CTX_get_ex_data(SSL_get_SSL_CTX(ssl), GetExDataIndex<T>()));
+}
+
+int OnTicketKey(SSL* ssl, uint8_t* key_name, uint8_t* iv,
+                EVP_CIPHER_CTX* cipher_context, HMAC_CTX* hmac_context,
+                int encrypt) {
+  auto* ticket_keys = GetExData<TicketKeys>(ssl);
+  TicketKey key;
+  if (encrypt) {
+    if (!ticket_keys->GetEncryptionKey(key) ||
+        RAND_bytes(iv, kTicketIvSize) != 1) {
+      return -1;
+    }
+    std::memcpy(key_name, key.name.data(), kTicketKeyNameSize);
+    if (EVP_EncryptInit_ex(cipher_context, EVP_aes_256_cbc(), nullptr,
+                           key.aes_key.data(), iv) != 1 ||
+        HMAC_Init_ex(hmac_context, key.hmac_key.data(), key.hmac_key.size(),
+                     EVP_sha256(), nullptr) != 1) {
+      return -1;
+    }
+    return 1;
+  }
+
+  auto renew = ticket_keys->FindDecryptionKey(key_name, key);
+  if (!renew) {
+    // Unknown or expired key, the client does a full handshake.
+    return 0;
+  }
+  if (HMAC_Init_ex(hmac_context, key.hmac_key.data(), key.hmac_key.size(),
+                   EVP_sha256(), nullptr) != 1 ||
+      EVP_DecryptInit_ex(cipher_context, EVP_aes_256_cbc(), nullptr,
+                         key.aes_key.data(), iv) != 1) {
+    return -1;
+  }
+  return *renew ? 2 : 1;
+}
+
+int OnNewClientSession(SSL* ssl, SSL_SESSION* session) {
+  GetExData<ClientSession>(ssl)->Set(session);
+  // The library keeps ownership of the session.
+  return 0;
+}
+
+void OnClientInfo(const SSL* ssl, int where, int ret) {
+  // The session must be set before the ClientHello is written, and only on
+  // the initial handshake of the connection.
+  if ((where & SSL_CB_HANDSHAKE_START) == 0 || SSL_is_server(ssl) ||
+      SSL_get_session(ssl) != nullptr) {
+    return;
+  }
+  GetExData<ClientSession>(ssl)->Offer(const_cast<SSL*>(ssl));
+}
+}  // namespace
+
+ExecutionResult EnableTlsSessionTickets(
+    SSL_CTX* tls_context, std::chrono::seconds rotation_interval) noexcept {
+  if (SSL_CTX_get_ex_data(tls_context, GetExDataIndex<TicketKeys>())) {
+    return SuccessExecutionResult();
+  }
+  auto ticket_keys = std::make_unique<TicketKeys>(rotation_interval);
+  if (rotation_interval.count() <= 0 || !ticket_keys->Init() ||
+      SSL_CTX_set_ex_data(tls_context, GetExDataIndex<TicketKeys>(),
+                          ticket_keys.get()) != 1) {
+    return FailureExecutionResult(SC_CORE_UTILS_TLS_CONTEXT_ERROR);
+  }
+  ticket_keys.release();
+
+  SSL_CTX_clear_options(tls_context, SSL_OP_NO_TICKET);
+  // Tickets of the previous key are accepted for up to two intervals.
+  SSL_CTX_set_timeout(tls_context, 2 * rotation_interval.count());
+  SSL_CTX_set_tlsext_ticket_key_cb(tls_context, OnTicketKey);
+  return SuccessExecutionResult();
+}
+
+ExecutionResult EnableTlsClientSessionResumption(
+    SSL_CTX* tls_context) noexcept {
+  if (SSL_CTX_get_ex_data(tls_context, GetExDataIndex<ClientSession>())) {
+    return SuccessExecutionResult();
+  }
+  auto client_session = std::make_unique<ClientSession>();
+  if (SSL_CTX_set_ex_data(tls_context, GetExDataIndex<ClientSession>(),
+                          client_session.get()) != 1) {
+    return FailureExecutionResult(SC_CORE_UTILS_TLS_CONTEXT_ERROR);
+  }
+  client_session.release();
+
+  SSL_CTX_clear_options(tls_context, SSL_OP_NO_TICKET);
+  // Sessions are handed to OnNewClientSession rather than stored by the
+  // library, which does not offer them by itself on client connections.
+  SSL_CTX_set_session_cache_mode(
+      tls_context, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+  SSL_CTX_sess_set_new_cb(tls_context, OnNewClientSession);
+  SSL_CTX_set_info_callback(tls_context, OnClientInfo);
+  return SuccessExecutionResult();
+}
+
+}  // namespace privacy_sandbox::pbs_common
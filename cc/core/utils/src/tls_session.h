@@ -0,0 +1,65 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <openssl/ssl.h>
+
+#include <chrono>
+
+#include "cc/public/core/interface/execution_result.h"
+
+namespace privacy_sandbox::pbs_common {
+
+/**
+ * @brief Enables stateless session tickets on a server TLS context, so that
+ * reconnecting clients resume their session with an abbreviated handshake
+ * instead of a full one.
+ *
+ * Tickets are encrypted with keys generated in memory and rotated every
+ * rotation_interval. Tickets of the previous key are still accepted and get
+ * replaced with a ticket of the current key, so a ticket is valid for one to
+ * two rotation intervals. The keys are not shared with other processes, so
+ * sessions only resume on the server which issued them.
+ *
+ * Calling it again on the same context has no effect.
+ *
+ * @param tls_context The server TLS context.
+ * @param rotation_interval How long a key encrypts new tickets.
+ * @return ExecutionResult SC_CORE_UTILS_TLS_CONTEXT_ERROR if the context
+ * cannot be configured.
+ */
+ExecutionResult EnableTlsSessionTickets(
+    SSL_CTX* tls_context, std::chrono::seconds rotation_interval) noexcept;
+
+/**
+ * @brief Makes a client TLS context keep the last session the server issued
+ * and offer it on the next handshakes, so that reconnecting resumes the
+ * session with an abbreviated handshake instead of a full one.
+ *
+ * The session is offered to whichever server the context connects to next, so
+ * the context is meant to connect to a single server. A server which cannot
+ * resume the session falls back to a full handshake.
+ *
+ * Calling it again on the same context has no effect.
+ *
+ * @param tls_context The client TLS context.
+ * @return ExecutionResult SC_CORE_UTILS_TLS_CONTEXT_ERROR if the context
+ * cannot be configured.
+ */
+ExecutionResult EnableTlsClientSessionResumption(SSL_CTX* tls_context) noexcept;
+
+}  // namespace privacy_sandbox::pbs_common
@@ -0,0 +1,93 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <string>
+#include <string_view>
+
+#include <benchmark/benchmark.h>
+
+#include "cc/core/utils/src/compression.h"
+
+namespace privacy_sandbox::pbs_common {
+namespace {
+
+// A consume budget request body with state.range(0) budget keys, i.e. the
+// kind of payload Http2Server receives and sends.
+std::string MakeRequestBody(size_t keys) {
+  std::string body = R"({"v":"2","data":[{"reporting_origin":"https://a.test",)"
+                     R"("keys":[)";
+  for (size_t i = 0; i < keys; ++i) {
+    body += (i == 0 ? "" : ",");
+    body += R"({"key":"budget_key_)" + std::to_string(i) +
+            R"(","token":1,"reporting_time":"2025-01-01T)" +
+            std::to_string(i % 24) + R"(:00:00Z"})";
+  }
+  body += "]}]}";
+  return body;
+}
+
+// Compression cost and the bytes it saves on the wire, per compression level
+// given by state.range(1).
+void BM_GzipCompress(benchmark::State& state) {
+  std::string body = MakeRequestBody(state.range(0));
+  std::string compressed;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        GzipCompress(body, compressed, /*level=*/state.range(1)));
+  }
+  state.SetBytesProcessed(state.iterations() * body.size());
+  state.counters["body_bytes"] = body.size();
+  state.counters["wire_bytes"] = compressed.size();
+  state.counters["ratio"] = static_cast<double>(body.size()) / compressed.size();
+}
+
+// Decompression cost of the same bodies, chunked as they arrive from the wire.
+void BM_GzipDecompress(benchmark::State& state) {
+  std::string body = MakeRequestBody(state.range(0));
+  std::string compressed;
+  GzipCompress(body, compressed);
+  GzipDecompressor decompressor(body.size());
+  constexpr size_t kFrameSize = 16 * 1024;
+  for (auto _ : state) {
+    decompressor.Reset(body.size());
+    for (size_t offset = 0; offset < compressed.size(); offset += kFrameSize) {
+      benchmark::DoNotOptimize(decompressor.Decompress(
+          std::string_view(compressed).substr(offset, kFrameSize),
+          [](std::string_view piece) {
+            benchmark::DoNotOptimize(piece.data());
+            return SuccessExecutionResult();
+          }));
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * body.size());
+  state.counters["wire_bytes"] = compressed.size();
+}
+
+BENCHMARK(BM_GzipCompress)
+    ->ArgsProduct({{1, 10, 100, 1000, 10000}, {1, 6, 9}})
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_GzipDecompress)
+    ->Arg(1)
+    ->Arg(10)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace
+}  // namespace privacy_sandbox::pbs_common
+
+// Run the benchmark.
+BENCHMARK_MAIN();
@@ -0,0 +1,144 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cc/core/utils/src/compression.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "cc/core/utils/src/error_codes.h"
+#include "cc/public/core/interface/execution_result.h"
+#include "cc/public/core/test/interface/execution_result_matchers.h"
+
+namespace privacy_sandbox::pbs_common {
+namespace {
+
+std::string MakeCompressibleData(size_t size) {
+  std::string data;
+  while (data.size() < size) {
+    data +=
+        "{\"key\":\"budget_key_" + std::to_string(data.size() % 97) + "\"},";
+  }
+  data.resize(size);
+  return data;
+}
+
+}  // namespace
+
+TEST(CompressionTest, GzipRoundTrip) {
+  std::string data = MakeCompressibleData(100000);
+  std::string compressed;
+  EXPECT_SUCCESS(GzipCompress(data, compressed));
+  EXPECT_LT(compressed.size(), data.size() / 4);
+
+  std::string decompressed;
+  EXPECT_SUCCESS(GzipDecompress(compressed, data.size(), decompressed));
+  EXPECT_EQ(decompressed, data);
+}
+
+TEST(CompressionTest, GzipRoundTripEmptyInput) {
+  std::string compressed;
+  EXPECT_SUCCESS(GzipCompress("", compressed));
+  std::string decompressed = "stale";
+  EXPECT_SUCCESS(GzipDecompress(compressed, 0, decompressed));
+  EXPECT_EQ(decompressed, "");
+}
+
+TEST(CompressionTest, GzipDecompressRejectsInvalidOrTruncatedData) {
+  std::string decompressed;
+  EXPECT_THAT(
+      GzipDecompress("not gzip", 1000, decompressed),
+      ResultIs(FailureExecutionResult(SC_CORE_UTILS_INVALID_COMPRESSED_DATA)));
+
+  std::string compressed;
+  EXPECT_SUCCESS(GzipCompress(MakeCompressibleData(1000), compressed));
+  EXPECT_THAT(
+      GzipDecompress(std::string_view(compressed).substr(
+                         0, compressed.size() - 4),
+                     1000, decompressed),
+      ResultIs(FailureExecutionResult(SC_CORE_UTILS_INVALID_COMPRESSED_DATA)));
+  EXPECT_THAT(
+      GzipDecompress(compressed + "trailing", 1000, decompressed),
+      ResultIs(FailureExecutionResult(SC_CORE_UTILS_INVALID_COMPRESSED_DATA)));
+}
+
+TEST(CompressionTest, GzipDecompressorStopsAtSizeLimit) {
+  // 16MB of zeros compress to a few KB.
+  std::string compressed;
+  EXPECT_SUCCESS(GzipCompress(std::string(16 * 1024 * 1024, 0), compressed));
+
+  GzipDecompressor decompressor(/*max_decompressed_size=*/1024 * 1024);
+  size_t output_size = 0;
+  EXPECT_THAT(decompressor.Decompress(compressed,
+                                      [&](std::string_view piece) {
+                                        output_size += piece.size();
+                                        return SuccessExecutionResult();
+                                      }),
+              ResultIs(FailureExecutionResult(
+                  SC_CORE_UTILS_DECOMPRESSED_SIZE_TOO_LARGE)));
+  EXPECT_LE(output_size, 1024 * 1024);
+  EXPECT_LE(decompressor.GetDecompressedSize(), 1024 * 1024);
+}
+
+TEST(CompressionTest, GzipDecompressorHandlesChunksAndReset) {
+  std::string data = MakeCompressibleData(50000);
+  std::string compressed;
+  EXPECT_SUCCESS(GzipCompress(data, compressed));
+
+  GzipDecompressor decompressor(data.size());
+  for (int round = 0; round < 2; ++round) {
+    decompressor.Reset(data.size());
+    std::string decompressed;
+    for (size_t offset = 0; offset < compressed.size(); offset += 7) {
+      EXPECT_SUCCESS(decompressor.Decompress(
+          std::string_view(compressed).substr(offset, 7),
+          [&](std::string_view piece) {
+            decompressed.append(piece);
+            return SuccessExecutionResult();
+          }));
+    }
+    EXPECT_SUCCESS(decompressor.Finish());
+    EXPECT_EQ(decompressed, data);
+    EXPECT_EQ(decompressor.GetDecompressedSize(), data.size());
+  }
+}
+
+TEST(CompressionTest, GzipDecompressorPropagatesOutputFailure) {
+  std::string compressed;
+  EXPECT_SUCCESS(GzipCompress(MakeCompressibleData(1000), compressed));
+  GzipDecompressor decompressor(1000);
+  EXPECT_THAT(decompressor.Decompress(compressed,
+                                      [](std::string_view) {
+                                        return FailureExecutionResult(
+                                            SC_CORE_UTILS_INVALID_INPUT);
+                                      }),
+              ResultIs(FailureExecutionResult(SC_CORE_UTILS_INVALID_INPUT)));
+}
+
+TEST(CompressionTest, IsGzipAccepted) {
+  EXPECT_TRUE(IsGzipAccepted("gzip"));
+  EXPECT_TRUE(IsGzipAccepted("deflate, GZIP;q=0.5, br"));
+  EXPECT_TRUE(IsGzipAccepted("*"));
+  EXPECT_TRUE(IsGzipAccepted("x-gzip"));
+  EXPECT_FALSE(IsGzipAccepted(""));
+  EXPECT_FALSE(IsGzipAccepted("identity"));
+  EXPECT_FALSE(IsGzipAccepted("gzip;q=0"));
+  EXPECT_FALSE(IsGzipAccepted("*, gzip; q=0.0"));
+  EXPECT_FALSE(IsGzipAccepted("br, *;q=0"));
+}
+
+}  // namespace privacy_sandbox::pbs_common
@@ -14,8 +14,10 @@
 
 #include "cc/core/utils/src/http.h"
 
+#include <memory>
 #include <string>
 
+#include "cc/core/utils/src/compression.h"
 #include "cc/core/utils/src/error_codes.h"
 #include "gtest/gtest.h"
 
@@ -154,5 +156,33 @@ TEST(HttpTest, EmptyUserAgentString) {
   EXPECT_EQ(*extraction_result, kUnknownValue);
 }
 
+TEST(HttpTest, GzipCompressRequestBody) {
+  std::string body(1000, 'a');
+  HttpRequest request;
+  request.body = BytesBuffer(body);
+
+  EXPECT_TRUE(GzipCompressRequestBody(request).Successful());
+
+  ASSERT_NE(request.headers, nullptr);
+  auto content_encoding = request.headers->find(kContentEncodingHeader);
+  ASSERT_NE(content_encoding, request.headers->end());
+  EXPECT_EQ(content_encoding->second, kGzipContentEncoding);
+  EXPECT_LT(request.body.length, body.size());
+  std::string decompressed;
+  EXPECT_TRUE(
+      GzipDecompress(request.body.ToString(), body.size(), decompressed)
+          .Successful());
+  EXPECT_EQ(decompressed, body);
+}
+
+TEST(HttpTest, GzipCompressRequestBodyLeavesEmptyBody) {
+  HttpRequest request;
+
+  EXPECT_TRUE(GzipCompressRequestBody(request).Successful());
+
+  EXPECT_EQ(request.headers, nullptr);
+  EXPECT_EQ(request.body.length, 0);
+}
+
 }  // namespace
 }  // namespace privacy_sandbox::pbs_common
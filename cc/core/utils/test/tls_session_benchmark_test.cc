@@ -0,0 +1,86 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+#include <openssl/ssl.h>
+
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "cc/core/utils/src/tls_session.h"
+#include "cc/core/utils/test/tls_test_utils.h"
+
+namespace privacy_sandbox::pbs_common {
+namespace {
+
+// Handshakes over in-memory buffers between a client and a server with a
+// self-signed certificate. With state.range(0), the client resumes the session
+// of the previous connection instead of doing a full handshake.
+void BM_TlsHandshake(benchmark::State& state) {
+  const bool resume = state.range(0) == 1;
+  auto server_context = CreateSelfSignedServerContext();
+  auto client_context = CreateClientContext();
+  if (resume) {
+    EnableTlsSessionTickets(server_context.get(), std::chrono::seconds(3600));
+    EnableTlsClientSessionResumption(client_context.get());
+  }
+
+  int64_t resumed = 0;
+  for (auto _ : state) {
+    TlsConnectionPair connection(client_context.get(), server_context.get());
+    if (!connection.Handshake() || !connection.SendToClient("ping")) {
+      state.SkipWithError("The handshake failed.");
+      break;
+    }
+    resumed += SSL_session_reused(connection.client.get());
+  }
+  state.counters["handshakes"] =
+      benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+  state.counters["resumed"] = static_cast<double>(resumed) / state.iterations();
+}
+
+// Record encryption and decryption throughput for writes of state.range(0)
+// bytes, i.e. the user space cost of TLS on the io threads.
+void BM_TlsRecordThroughput(benchmark::State& state) {
+  auto server_context = CreateSelfSignedServerContext();
+  auto client_context = CreateClientContext();
+  TlsConnectionPair connection(client_context.get(), server_context.get());
+  if (!connection.Handshake()) {
+    state.SkipWithError("The handshake failed.");
+    return;
+  }
+  std::string data(state.range(0), 'x');
+  for (auto _ : state) {
+    if (!connection.SendToClient(data)) {
+      state.SkipWithError("The transfer failed.");
+      break;
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * data.size());
+}
+
+BENCHMARK(BM_TlsHandshake)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_TlsRecordThroughput)
+    ->Arg(1024)
+    ->Arg(16 * 1024)
+    ->Arg(64 * 1024)
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace
+}  // namespace privacy_sandbox::pbs_common
+
+// Run the benchmark.
+BENCHMARK_MAIN();
@@ -0,0 +1,134 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cc/core/utils/src/tls_session.h"
+
+#include <gtest/gtest.h>
+
+#include <openssl/ssl.h>
+
+#include <chrono>
+#include <thread>
+
+#include "cc/core/utils/src/error_codes.h"
+#include "cc/core/utils/test/tls_test_utils.h"
+#include "cc/public/core/test/interface/execution_result_matchers.h"
+
+namespace privacy_sandbox::pbs_common {
+namespace {
+
+// Connects once, so that the client receives a session ticket, and returns
+// whether a second connection resumes the session.
+bool ReconnectResumesSession(SSL_CTX* client_context,
+                             SSL_CTX* first_server_context,
+                             SSL_CTX* second_server_context) {
+  {
+    // Closed without a TLS shutdown, as dropped connections are.
+    TlsConnectionPair first(client_context, first_server_context);
+    EXPECT_TRUE(first.Handshake());
+    EXPECT_FALSE(SSL_session_reused(first.client.get()));
+    EXPECT_TRUE(first.SendToClient("hello"));
+  }
+
+  TlsConnectionPair second(client_context, second_server_context);
+  EXPECT_TRUE(second.Handshake());
+  EXPECT_TRUE(second.SendToClient("hello"));
+  return SSL_session_reused(second.client.get()) == 1;
+}
+
+TEST(TlsSessionTest, ClientResumesTheSessionIssuedByTheServer) {
+  auto server_context = CreateSelfSignedServerContext();
+  auto client_context = CreateClientContext();
+  // As set by nghttp2 on the contexts of its servers.
+  SSL_CTX_set_options(server_context.get(), SSL_OP_NO_TICKET);
+  EXPECT_SUCCESS(EnableTlsSessionTickets(server_context.get(),
+                                         std::chrono::seconds(3600)));
+  EXPECT_SUCCESS(EnableTlsClientSessionResumption(client_context.get()));
+  // Enabling twice has no effect.
+  EXPECT_SUCCESS(EnableTlsSessionTickets(server_context.get(),
+                                         std::chrono::seconds(3600)));
+  EXPECT_SUCCESS(EnableTlsClientSessionResumption(client_context.get()));
+
+  EXPECT_TRUE(ReconnectResumesSession(
+      client_context.get(), server_context.get(), server_context.get()));
+}
+
+TEST(TlsSessionTest, ClientResumesTls12Sessions) {
+  auto server_context = CreateSelfSignedServerContext();
+  auto client_context = CreateClientContext();
+  SSL_CTX_set_max_proto_version(client_context.get(), TLS1_2_VERSION);
+  EXPECT_SUCCESS(EnableTlsSessionTickets(server_context.get(),
+                                         std::chrono::seconds(3600)));
+  EXPECT_SUCCESS(EnableTlsClientSessionResumption(client_context.get()));
+
+  EXPECT_TRUE(ReconnectResumesSession(
+      client_context.get(), server_context.get(), server_context.get()));
+}
+
+TEST(TlsSessionTest, ClientDoesNotResumeWithoutSessionResumption) {
+  auto server_context = CreateSelfSignedServerContext();
+  auto client_context = CreateClientContext();
+  EXPECT_SUCCESS(EnableTlsSessionTickets(server_context.get(),
+                                         std::chrono::seconds(3600)));
+
+  EXPECT_FALSE(ReconnectResumesSession(
+      client_context.get(), server_context.get(), server_context.get()));
+}
+
+TEST(TlsSessionTest, OtherServersDoFullHandshakes) {
+  auto server_context = CreateSelfSignedServerContext();
+  auto other_server_context = CreateSelfSignedServerContext();
+  auto client_context = CreateClientContext();
+  EXPECT_SUCCESS(EnableTlsSessionTickets(server_context.get(),
+                                         std::chrono::seconds(3600)));
+  EXPECT_SUCCESS(EnableTlsSessionTickets(other_server_context.get(),
+                                         std::chrono::seconds(3600)));
+  EXPECT_SUCCESS(EnableTlsClientSessionResumption(client_context.get()));
+
+  EXPECT_FALSE(ReconnectResumesSession(
+      client_context.get(), server_context.get(), other_server_context.get()));
+}
+
+TEST(TlsSessionTest, TicketsOfThePreviousKeyAreStillAccepted) {
+  auto server_context = CreateSelfSignedServerContext();
+  auto client_context = CreateClientContext();
+  EXPECT_SUCCESS(EnableTlsSessionTickets(server_context.get(),
+                                         std::chrono::seconds(2)));
+  EXPECT_SUCCESS(EnableTlsClientSessionResumption(client_context.get()));
+
+  {
+    TlsConnectionPair first(client_context.get(), server_context.get());
+    EXPECT_TRUE(first.Handshake());
+    EXPECT_TRUE(first.SendToClient("hello"));
+  }
+
+  // The next ticket rotates the key.
+  std::this_thread::sleep_for(std::chrono::milliseconds(2100));
+  TlsConnectionPair second(client_context.get(), server_context.get());
+  EXPECT_TRUE(second.Handshake());
+  EXPECT_TRUE(second.SendToClient("hello"));
+  EXPECT_TRUE(SSL_session_reused(second.client.get()));
+}
+
+TEST(TlsSessionTest, InvalidRotationIntervalFails) {
+  auto server_context = CreateSelfSignedServerContext();
+  EXPECT_THAT(
+      EnableTlsSessionTickets(server_context.get(), std::chrono::seconds(0)),
+      ResultIs(FailureExecutionResult(SC_CORE_UTILS_TLS_CONTEXT_ERROR)));
+}
+
+}  // namespace
+}  // namespace privacy_sandbox::pbs_common
@@ -0,0 +1,148 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <openssl/bio.h>
+#include <openssl/ec.h>
+#include <openssl/evp.h>
+#include <openssl/obj_mac.h>
+#include <openssl/ssl.h>
+#include <openssl/x509.h>
+
+#include <algorithm>
+#include <memory>
+#include <string_view>
+
+namespace privacy_sandbox::pbs_common {
+
+struct SslCtxDeleter {
+  void operator()(SSL_CTX* tls_context) const { SSL_CTX_free(tls_context); }
+};
+struct SslDeleter {
+  void operator()(SSL* ssl) const { SSL_free(ssl); }
+};
+using UniqueSslCtx = std::unique_ptr<SSL_CTX, SslCtxDeleter>;
+using UniqueSsl = std::unique_ptr<SSL, SslDeleter>;
+
+/// Creates a server TLS context with a self-signed P-256 certificate.
+inline UniqueSslCtx CreateSelfSignedServerContext() {
+  UniqueSslCtx tls_context(SSL_CTX_new(TLS_method()));
+  EC_KEY* ec_key = EC_KEY_new_by_curve_name(NID_X9_62_prime256v1);
+  EC_KEY_generate_key(ec_key);
+  EVP_PKEY* key = EVP_PKEY_new();
+  EVP_PKEY_assign_EC_KEY(key, ec_key);
+
+  X509* certificate = X509_new();
+  X509_set_version(certificate, 2);
+  ASN1_INTEGER_set(X509_get_serialNumber(certificate), 1);
+  X509_gmtime_adj(X509_getm_notBefore(certificate), 0);
+  X509_gmtime_adj(X509_getm_notAfter(certificate), 24 * 60 * 60);
+  X509_set_pubkey(certificate, key);
+  X509_NAME* name = X509_get_subject_name(certificate);
+  X509_NAME_add_entry_by_txt(
+      name, "CN", MBSTRING_ASC,
+      reinterpret_cast<const unsigned char*>("localhost"), -1, -1, 0);
+  X509_set_issuer_name(certificate, name);
+  X509_sign(certificate, key, EVP_sha256());
+
+  SSL_CTX_use_certificate(tls_context.get(), certificate);
+  SSL_CTX_use_PrivateKey(tls_context.get(), key);
+  X509_free(certificate);
+  EVP_PKEY_free(key);
+  return tls_context;
+}
+
+/// Creates a client TLS context, which does not verify the server.
+inline UniqueSslCtx CreateClientContext() {
+  return UniqueSslCtx(SSL_CTX_new(TLS_method()));
+}
+
+/// A client and a server TLS connection linked by in-memory buffers.
+struct TlsConnectionPair {
+  TlsConnectionPair(SSL_CTX* client_context, SSL_CTX* server_context)
+      : client(SSL_new(client_context)), server(SSL_new(server_context)) {
+    BIO* client_bio;
+    BIO* server_bio;
+    BIO_new_bio_pair(&client_bio, 0, &server_bio, 0);
+    SSL_set_bio(client.get(), client_bio, client_bio);
+    SSL_set_bio(server.get(), server_bio, server_bio);
+    SSL_set_connect_state(client.get());
+    SSL_set_accept_state(server.get());
+  }
+
+  /// Runs the handshake on both ends, returns whether it completed.
+  bool Handshake() {
+    bool client_done = false;
+    bool server_done = false;
+    for (int i = 0; i < 100 && !(client_done && server_done); ++i) {
+      if (!client_done && !Step(client.get(), client_done)) {
+        return false;
+      }
+      if (!server_done && !Step(server.get(), server_done)) {
+        return false;
+      }
+    }
+    return client_done && server_done;
+  }
+
+  /// Sends data from the server to the client, which also delivers the
+  /// session tickets the server sends after the handshake.
+  bool SendToClient(std::string_view data) {
+    // The buffers between the ends hold about one record, so writing and
+    // reading alternate.
+    constexpr size_t kMaxRecordSize = 16 * 1024;
+    char buffer[kMaxRecordSize];
+    size_t sent = 0;
+    size_t received = 0;
+    while (received < data.size()) {
+      if (sent < data.size()) {
+        int written =
+            SSL_write(server.get(), data.data() + sent,
+                      std::min(kMaxRecordSize, data.size() - sent));
+        if (written > 0) {
+          sent += written;
+        } else if (SSL_get_error(server.get(), written) !=
+                   SSL_ERROR_WANT_WRITE) {
+          return false;
+        }
+      }
+      int read = SSL_read(client.get(), buffer, sizeof(buffer));
+      if (read > 0) {
+        received += read;
+      } else if (SSL_get_error(client.get(), read) != SSL_ERROR_WANT_READ) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  UniqueSsl client;
+  UniqueSsl server;
+
+ private:
+  static bool Step(SSL* ssl, bool& done) {
+    int result = SSL_do_handshake(ssl);
+    if (result == 1) {
+      done = true;
+      return true;
+    }
+    int error = SSL_get_error(ssl, result);
+    return error == SSL_ERROR_WANT_READ || error == SSL_ERROR_WANT_WRITE;
+  }
+};
+
+}  // namespace privacy_sandbox::pbs_common
@@ -16,15 +16,14 @@
 
 #include "cc/pbs/authorization/src/aws/aws_http_request_response_auth_interceptor.h"
 
-#include <array>
-#include <iterator>
-#include <map>
+#include <cstddef>
 #include <memory>
 #include <string>
-#include <vector>
+#include <string_view>
 
 #include <nlohmann/json.hpp>
 
+#include "absl/types/span.h"
 #include "cc/core/authorization_service/src/error_codes.h"
 #include "cc/core/http2_client/src/aws/aws_v4_signer.h"
 #include "cc/core/interface/type_def.h"
@@ -37,12 +36,10 @@ namespace {
 using ::privacy_sandbox::pbs_common::AuthorizationMetadata;
 using ::privacy_sandbox::pbs_common::AuthorizedDomain;
 using ::privacy_sandbox::pbs_common::AuthorizedMetadata;
-using ::privacy_sandbox::pbs_common::AwsV4Signer;
 using ::privacy_sandbox::pbs_common::Base64Decode;
 using ::privacy_sandbox::pbs_common::ExecutionResult;
 using ::privacy_sandbox::pbs_common::ExecutionResultOr;
 using ::privacy_sandbox::pbs_common::FailureExecutionResult;
-using ::privacy_sandbox::pbs_common::HttpHeaders;
 using ::privacy_sandbox::pbs_common::HttpRequest;
 using ::privacy_sandbox::pbs_common::HttpResponse;
 using ::privacy_sandbox::pbs_common::kClaimedIdentityHeader;
@@ -55,83 +52,214 @@ constexpr char kSignature[] = "signature";
 constexpr char kAmzDate[] = "amz_date";
 constexpr char kAuthorizedDomain[] = "authorized_domain";
 constexpr char kSecurityToken[] = "security_token";
-constexpr std::array kSignedHeaders = {"Host", "X-Amz-Date"};
+// The lower case, sorted and ';' delimited headers covered by the signature.
+constexpr char kSignedHeaders[] = "host;x-amz-date";
 
-}  // namespace
+// A string member of a JSON object to extract.
+struct StringField {
+  std::string_view name;
+  std::string* value;
+  bool found = false;
+};
 
-ExecutionResult AwsHttpRequestResponseAuthInterceptor::PrepareRequest(
-    const AuthorizationMetadata& authorization_metadata,
-    HttpRequest& http_request) {
-  if (authorization_metadata.authorization_token.length() == 0) {
-    return FailureExecutionResult(SC_AUTHORIZATION_SERVICE_BAD_TOKEN);
+/**
+ * @brief SAX handler extracting the top level string members named by the
+ * given fields straight into their destinations, without building a JSON
+ * document. Other members are skipped. The parse fails if the document is not
+ * an object, or if a named member is not a string.
+ */
+class StringFieldsSaxHandler : public json::json_sax_t {
+ public:
+  explicit StringFieldsSaxHandler(absl::Span<StringField> fields)
+      : fields_(fields) {}
+
+  bool null() override { return AcceptNonString(); }
+
+  bool boolean(bool) override { return AcceptNonString(); }
+
+  bool number_integer(number_integer_t) override { return AcceptNonString(); }
+
+  bool number_unsigned(number_unsigned_t) override {
+    return AcceptNonString();
   }
 
-  if (authorization_metadata.claimed_identity.length() == 0) {
-    return FailureExecutionResult(SC_AUTHORIZATION_SERVICE_BAD_TOKEN);
+  bool number_float(number_float_t, const string_t&) override {
+    return AcceptNonString();
+  }
+
+  bool binary(binary_t&) override { return AcceptNonString(); }
+
+  bool string(string_t& value) override {
+    if (depth_ == 0) {
+      return false;
+    }
+    if (depth_ == 1 && current_field_ != nullptr) {
+      *current_field_->value = std::move(value);
+      current_field_->found = true;
+      current_field_ = nullptr;
+    }
+    return true;
   }
 
-  // Padding (if needed) is done so that decode works
-  auto padded_token_or =
-      PadBase64Encoding(authorization_metadata.authorization_token);
-  if (!padded_token_or.Successful()) {
-    return padded_token_or.result();
+  bool start_object(std::size_t) override {
+    if (!AcceptNonString()) {
+      return false;
+    }
+    ++depth_;
+    return true;
   }
 
-  std::string token;
-  auto execution_result = Base64Decode(*padded_token_or, token);
-  if (!execution_result) {
-    return FailureExecutionResult(SC_AUTHORIZATION_SERVICE_BAD_TOKEN);
+  bool end_object() override {
+    --depth_;
+    return true;
+  }
+
+  bool start_array(std::size_t) override {
+    if (depth_ == 0 || !AcceptNonString()) {
+      return false;
+    }
+    ++depth_;
+    return true;
+  }
+
+  bool end_array() override {
+    --depth_;
+    return true;
+  }
+
+  bool key(string_t& key) override {
+    if (depth_ == 1) {
+      current_field_ = nullptr;
+      for (auto& field : fields_) {
+        if (field.name == key) {
+          current_field_ = &field;
+          break;
+        }
+      }
+    }
+    return true;
+  }
+
+  bool parse_error(std::size_t, const std::string&,
+                   const nlohmann::detail::exception&) override {
+    return false;
+  }
+
+ private:
+  /// A value other than a string is only accepted for members which are not
+  /// extracted. The root value is accepted as long as it is an object.
+  bool AcceptNonString() const {
+    return depth_ != 1 || current_field_ == nullptr;
   }
 
-  json json_token;
+  absl::Span<StringField> fields_;
+  StringField* current_field_ = nullptr;
+  size_t depth_ = 0;
+};
+
+/**
+ * @brief Extracts \a fields from the JSON object in [\a begin, \a end).
+ *
+ * @return false if the input is not a JSON object or a field is not a string.
+ */
+template <typename Iterator>
+bool ParseStringFields(Iterator begin, Iterator end,
+                       absl::Span<StringField> fields) {
+  StringFieldsSaxHandler handler(fields);
   try {
-    json_token = json::parse(token);
+    return json::sax_parse(begin, end, &handler);
   } catch (...) {
+    return false;
+  }
+}
+
+/// The fields of a decoded authorization token.
+struct AwsAuthorizationToken {
+  std::string access_key;
+  std::string signature;
+  std::string amz_date;
+  std::string security_token;
+};
+
+/// Decodes and parses the base64 encoded JSON authorization token in one pass.
+ExecutionResultOr<AwsAuthorizationToken> ParseAuthorizationToken(
+    const std::string& encoded_token) {
+  std::string decoded_token;
+  if (encoded_token.length() % 4 == 0) {
+    if (!Base64Decode(encoded_token, decoded_token).Successful()) {
+      return FailureExecutionResult(SC_AUTHORIZATION_SERVICE_BAD_TOKEN);
+    }
+  } else {
+    // Padding is done so that decode works
+    auto padded_token_or = PadBase64Encoding(encoded_token);
+    if (!padded_token_or.Successful()) {
+      return padded_token_or.result();
+    }
+    if (!Base64Decode(*padded_token_or, decoded_token).Successful()) {
+      return FailureExecutionResult(SC_AUTHORIZATION_SERVICE_BAD_TOKEN);
+    }
+  }
+
+  AwsAuthorizationToken token;
+  StringField fields[] = {{kAccessKey, &token.access_key},
+                          {kSignature, &token.signature},
+                          {kAmzDate, &token.amz_date},
+                          {kSecurityToken, &token.security_token}};
+  if (!ParseStringFields(decoded_token.begin(), decoded_token.end(),
+                         absl::MakeSpan(fields))) {
     return FailureExecutionResult(SC_AUTHORIZATION_SERVICE_BAD_TOKEN);
   }
-  // Check if all the required fields are present
-  if (!json_token.contains(kAccessKey) || !json_token.contains(kSignature) ||
-      !json_token.contains(kAmzDate)) {
+  // Check if all the required fields are present. The security token is
+  // optional.
+  if (!fields[0].found || !fields[1].found || !fields[2].found) {
     return FailureExecutionResult(SC_AUTHORIZATION_SERVICE_BAD_TOKEN);
   }
-  const std::string& access_key = json_token[kAccessKey].get<std::string>();
-  const std::string& signature = json_token[kSignature].get<std::string>();
-  const std::string& amz_date = json_token[kAmzDate].get<std::string>();
-  const std::string& security_token = [&json_token]() {
-    if (json_token.contains(kSecurityToken)) {
-      return json_token[kSecurityToken].get<std::string>();
-    }
-    return std::string();
-  }();
+  return token;
+}
+
+}  // namespace
+
+ExecutionResult AwsHttpRequestResponseAuthInterceptor::PrepareRequest(
+    const AuthorizationMetadata& authorization_metadata,
+    HttpRequest& http_request) {
+  if (authorization_metadata.authorization_token.length() == 0) {
+    return FailureExecutionResult(SC_AUTHORIZATION_SERVICE_BAD_TOKEN);
+  }
+
+  if (authorization_metadata.claimed_identity.length() == 0) {
+    return FailureExecutionResult(SC_AUTHORIZATION_SERVICE_BAD_TOKEN);
+  }
+
+  auto token_or =
+      ParseAuthorizationToken(authorization_metadata.authorization_token);
+  if (!token_or.Successful()) {
+    return token_or.result();
+  }
 
   http_request.headers->insert({std::string(kClaimedIdentityHeader),
                                 authorization_metadata.claimed_identity});
 
-  AwsV4Signer signer(access_key, "", security_token, "execute-api",
-                     aws_region_);
-  std::vector<std::string> headers_to_sign{std::begin(kSignedHeaders),
-                                           std::end(kSignedHeaders)};
-  return signer.SignRequestWithSignature(http_request, headers_to_sign,
-                                         amz_date, signature);
+  return signer_->SignRequestWithSignature(
+      http_request, token_or->access_key, token_or->security_token,
+      kSignedHeaders, token_or->amz_date, token_or->signature);
 }
 
 ExecutionResultOr<AuthorizedMetadata>
 AwsHttpRequestResponseAuthInterceptor::ObtainAuthorizedMetadataFromResponse(
     const AuthorizationMetadata&, const HttpResponse& http_response) {
-  std::string body_str = http_response.body.ToString();
-  json body_json;
-  bool parse_fail = true;
-  try {
-    body_json = json::parse(body_str);
-    parse_fail = false;
-  } catch (...) {}
-  if (parse_fail || !body_json.contains(kAuthorizedDomain)) {
+  if (!http_response.body.bytes) {
+    return FailureExecutionResult(SC_AUTHORIZATION_SERVICE_BAD_TOKEN);
+  }
+  auto authorized_domain = std::make_shared<AuthorizedDomain>();
+  StringField fields[] = {{kAuthorizedDomain, authorized_domain.get()}};
+  const auto body_begin = http_response.body.bytes->begin();
+  if (!ParseStringFields(body_begin, body_begin + http_response.body.length,
+                         absl::MakeSpan(fields)) ||
+      !fields[0].found) {
     return FailureExecutionResult(SC_AUTHORIZATION_SERVICE_BAD_TOKEN);
   }
 
-  return AuthorizedMetadata{
-      .authorized_domain = std::make_shared<AuthorizedDomain>(
-          body_json[kAuthorizedDomain].get<std::string>())};
+  return AuthorizedMetadata{.authorized_domain = std::move(authorized_domain)};
 }
 
 }  // namespace privacy_sandbox::pbs
@@ -19,6 +19,7 @@
 #include <memory>
 #include <string>
 
+#include "cc/core/http2_client/src/aws/aws_v4_signer.h"
 #include "cc/core/interface/authorization_proxy_interface.h"
 #include "cc/core/interface/config_provider_interface.h"
 #include "cc/core/interface/http_request_response_auth_interceptor_interface.h"
@@ -27,16 +28,21 @@
 
 namespace privacy_sandbox::pbs {
 
+// The AWS service the authorization requests are signed for.
+inline constexpr char kAwsAuthorizationServiceName[] = "execute-api";
+
 class AwsHttpRequestResponseAuthInterceptor
     : public pbs_common::HttpRequestResponseAuthInterceptorInterface {
  public:
   explicit AwsHttpRequestResponseAuthInterceptor(const std::string& aws_region)
-      : aws_region_(aws_region) {}
+      : aws_region_(aws_region),
+        signer_(std::make_shared<const pbs_common::AwsV4Signer>(
+            "", "", "", kAwsAuthorizationServiceName, aws_region)) {}
 
   AwsHttpRequestResponseAuthInterceptor(
       const std::string& aws_region,
       std::shared_ptr<pbs_common::ConfigProviderInterface> config_provider)
-      : aws_region_(aws_region) {}
+      : AwsHttpRequestResponseAuthInterceptor(aws_region) {}
 
   pbs_common::ExecutionResult PrepareRequest(
       const pbs_common::AuthorizationMetadata& authorization_metadata,
@@ -49,6 +55,9 @@ class AwsHttpRequestResponseAuthInterceptor
 
  private:
   std::string aws_region_;
+  /// Signs the requests of every caller, whose credentials are carried in
+  /// their tokens, so that it is only created once per region.
+  std::shared_ptr<const pbs_common::AwsV4Signer> signer_;
 };
 
 }  // namespace privacy_sandbox::pbs
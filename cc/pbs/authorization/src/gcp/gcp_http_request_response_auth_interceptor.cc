@@ -52,6 +52,8 @@ using ::privacy_sandbox::pbs_common::kClaimedIdentityHeader;
 using ::privacy_sandbox::pbs_common::PadBase64Encoding;
 using ::privacy_sandbox::pbs_common::RetryExecutionResult;
 using ::privacy_sandbox::pbs_common::SC_AUTHORIZATION_SERVICE_BAD_TOKEN;
+using ::privacy_sandbox::pbs_common::
+    SC_AUTHORIZATION_SERVICE_UNKNOWN_SIGNING_KEY;
 using ::privacy_sandbox::pbs_common::SuccessExecutionResult;
 using json = nlohmann::json;
 
@@ -61,14 +63,6 @@ constexpr char kAuthHeaderFormat[] = "Bearer %s";
 
 constexpr char kAuthorizedDomain[] = "authorized_domain";
 
-constexpr size_t kIdTokenParts = 3;
-
-const std::vector<std::string>& GetRequiredJWTComponents() {
-  static const auto* const components =
-      new std::vector<std::string>{"iss", "aud", "sub", "iat", "exp"};
-  return *components;
-}
-
 }  // namespace
 
 ExecutionResult GcpHttpRequestResponseAuthInterceptor::PrepareRequest(
@@ -79,9 +73,41 @@ ExecutionResult GcpHttpRequestResponseAuthInterceptor::PrepareRequest(
     return FailureExecutionResult(SC_AUTHORIZATION_SERVICE_BAD_TOKEN);
   }
 
+  if (jwt_verifier_ && jwt_verifier_->HasKeys()) {
+    auto claims_or =
+        jwt_verifier_->Verify(authorization_metadata.authorization_token);
+    if (claims_or.result() ==
+        FailureExecutionResult(SC_AUTHORIZATION_SERVICE_UNKNOWN_SIGNING_KEY)) {
+      // The keys were likely rotated and are being fetched again. Until then
+      // the token is left to the authorization service to verify.
+      RETURN_IF_FAILURE(
+          ParseUnverifiedToken(authorization_metadata.authorization_token));
+    } else if (!claims_or.Successful()) {
+      return claims_or.result();
+    }
+  } else {
+    RETURN_IF_FAILURE(
+        ParseUnverifiedToken(authorization_metadata.authorization_token));
+  }
+
+  // A verified token still goes to the authorization service, which is the
+  // one mapping the claimed identity to its authorized domain. This only
+  // happens on authorization proxy cache misses.
+  http_request.headers->insert({std::string(kClaimedIdentityHeader),
+                                authorization_metadata.claimed_identity});
+
+  http_request.headers->insert(
+      {std::string(kAuthorizationHeader),
+       absl::StrFormat(kAuthHeaderFormat,
+                       authorization_metadata.authorization_token)});
+
+  return SuccessExecutionResult();
+}
+
+ExecutionResult GcpHttpRequestResponseAuthInterceptor::ParseUnverifiedToken(
+    const std::string& authorization_token) {
   // The token is split like so: <HEADER>.<PAYLOAD>.<SIGNATURE>
-  std::vector<std::string> parts =
-      absl::StrSplit(authorization_metadata.authorization_token, '.');
+  std::vector<std::string> parts = absl::StrSplit(authorization_token, '.');
   if (parts.size() != kIdTokenParts) {
     return FailureExecutionResult(SC_AUTHORIZATION_SERVICE_BAD_TOKEN);
   }
@@ -115,15 +141,6 @@ ExecutionResult GcpHttpRequestResponseAuthInterceptor::PrepareRequest(
                    })) {
     return FailureExecutionResult(SC_AUTHORIZATION_SERVICE_BAD_TOKEN);
   }
-
-  http_request.headers->insert({std::string(kClaimedIdentityHeader),
-                                authorization_metadata.claimed_identity});
-
-  http_request.headers->insert(
-      {std::string(kAuthorizationHeader),
-       absl::StrFormat(kAuthHeaderFormat,
-                       authorization_metadata.authorization_token)});
-
   return SuccessExecutionResult();
 }
 
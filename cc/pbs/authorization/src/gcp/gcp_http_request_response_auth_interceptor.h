@@ -17,11 +17,14 @@
 #pragma once
 
 #include <memory>
+#include <string>
+#include <utility>
 
 #include "cc/core/interface/authorization_proxy_interface.h"
 #include "cc/core/interface/config_provider_interface.h"
 #include "cc/core/interface/http_request_response_auth_interceptor_interface.h"
 #include "cc/core/interface/http_types.h"
+#include "cc/pbs/authorization/src/gcp/gcp_jwt_verifier.h"
 #include "cc/public/core/interface/execution_result.h"
 
 namespace privacy_sandbox::pbs {
@@ -35,6 +38,18 @@ class GcpHttpRequestResponseAuthInterceptor
       std::shared_ptr<pbs_common::ConfigProviderInterface> config_provider)
       : config_provider_(config_provider) {}
 
+  /**
+   * @brief Verifies the token signature and claims locally with
+   * jwt_verifier before the authorization request is sent. Tokens are only
+   * checked for well-formedness until the verifier has loaded its keys, and
+   * when they are signed by a key it does not know yet.
+   */
+  GcpHttpRequestResponseAuthInterceptor(
+      std::shared_ptr<pbs_common::ConfigProviderInterface> config_provider,
+      std::shared_ptr<GcpJwtVerifier> jwt_verifier)
+      : config_provider_(config_provider),
+        jwt_verifier_(std::move(jwt_verifier)) {}
+
   pbs_common::ExecutionResult PrepareRequest(
       const pbs_common::AuthorizationMetadata& authorization_metadata,
       pbs_common::HttpRequest& http_request) override;
@@ -45,7 +60,13 @@ class GcpHttpRequestResponseAuthInterceptor
       const pbs_common::HttpResponse& http_response) override;
 
  private:
+  /// Checks that the token is a JWT with the required claims, without
+  /// verifying it.
+  pbs_common::ExecutionResult ParseUnverifiedToken(
+      const std::string& authorization_token);
+
   std::shared_ptr<pbs_common::ConfigProviderInterface> config_provider_;
+  std::shared_ptr<GcpJwtVerifier> jwt_verifier_;
 };
 
 }  // namespace privacy_sandbox::pbs
@@ -0,0 +1,554 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cc/pbs/authorization/src/gcp/gcp_jwt_verifier.h"
+
+#include <openssl/bn.h>
+#include <openssl/ec.h>
+#include <openssl/ecdsa.h>
+#include <openssl/nid.h>
+#include <openssl/rsa.h>
+#include <openssl/sha.h>
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "cc/core/authorization_service/src/error_codes.h"
+#include "cc/core/common/global_logger/src/global_logger.h"
+#include "cc/core/common/time_provider/src/time_provider.h"
+#include "cc/core/common/uuid/src/uuid.h"
+#include "cc/core/utils/src/base64.h"
+
+namespace privacy_sandbox::pbs {
+namespace {
+
+using ::privacy_sandbox::pbs_common::AsyncContext;
+using ::privacy_sandbox::pbs_common::Base64Decode;
+using ::privacy_sandbox::pbs_common::ExecutionResult;
+using ::privacy_sandbox::pbs_common::ExecutionResultOr;
+using ::privacy_sandbox::pbs_common::FailureExecutionResult;
+using ::privacy_sandbox::pbs_common::HttpHeaders;
+using ::privacy_sandbox::pbs_common::HttpMethod;
+using ::privacy_sandbox::pbs_common::HttpRequest;
+using ::privacy_sandbox::pbs_common::HttpResponse;
+using ::privacy_sandbox::pbs_common::kZeroUuid;
+using ::privacy_sandbox::pbs_common::PadBase64Encoding;
+using ::privacy_sandbox::pbs_common::SC_AUTHORIZATION_SERVICE_BAD_TOKEN;
+using ::privacy_sandbox::pbs_common::SC_AUTHORIZATION_SERVICE_INVALID_JWKS;
+using ::privacy_sandbox::pbs_common::SuccessExecutionResult;
+using ::privacy_sandbox::pbs_common::Timestamp;
+using ::privacy_sandbox::pbs_common::TimeProvider;
+using json = nlohmann::json;
+
+constexpr char kGcpJwtVerifier[] = "GcpJwtVerifier";
+
+constexpr char kRs256[] = "RS256";
+constexpr char kEs256[] = "ES256";
+
+// Size of each of the r and s halves of a P-256 ECDSA JWS signature.
+constexpr size_t kEs256SignatureHalfBytes = 32;
+
+// RSA keys weaker than this are refused.
+constexpr unsigned kMinRsaKeyBits = 2048;
+
+// Decodes the unpadded base64url encoding used by JWS and JWK.
+ExecutionResult Base64UrlDecode(const std::string& encoded,
+                                std::string& decoded) {
+  std::string standard = encoded;
+  std::replace(standard.begin(), standard.end(), '-', '+');
+  std::replace(standard.begin(), standard.end(), '_', '/');
+  auto padded_or = PadBase64Encoding(standard);
+  if (!padded_or.Successful()) {
+    return padded_or.result();
+  }
+  return Base64Decode(*padded_or, decoded);
+}
+
+std::unique_ptr<BIGNUM, decltype(&BN_free)> DecodeBignum(
+    const json& jwk, const char* member) {
+  std::unique_ptr<BIGNUM, decltype(&BN_free)> bignum(nullptr, &BN_free);
+  if (!jwk.contains(member) || !jwk[member].is_string()) {
+    return bignum;
+  }
+  std::string bytes;
+  if (!Base64UrlDecode(jwk[member].get<std::string>(), bytes).Successful()) {
+    return bignum;
+  }
+  bignum.reset(BN_bin2bn(reinterpret_cast<const uint8_t*>(bytes.data()),
+                         bytes.size(), nullptr));
+  return bignum;
+}
+
+EVP_PKEY* ParseRsaKey(const json& jwk) {
+  auto modulus = DecodeBignum(jwk, "n");
+  auto exponent = DecodeBignum(jwk, "e");
+  if (!modulus || !exponent ||
+      BN_num_bits(modulus.get()) < static_cast<int>(kMinRsaKeyBits)) {
+    return nullptr;
+  }
+  std::unique_ptr<RSA, decltype(&RSA_free)> rsa(RSA_new(), &RSA_free);
+  if (!rsa ||
+      RSA_set0_key(rsa.get(), modulus.get(), exponent.get(), nullptr) != 1) {
+    return nullptr;
+  }
+  // Owned by the RSA key now.
+  modulus.release();
+  exponent.release();
+
+  EVP_PKEY* key = EVP_PKEY_new();
+  if (key == nullptr || EVP_PKEY_assign_RSA(key, rsa.get()) != 1) {
+    EVP_PKEY_free(key);
+    return nullptr;
+  }
+  rsa.release();
+  return key;
+}
+
+EVP_PKEY* ParseEcKey(const json& jwk) {
+  if (!jwk.contains("crv") || jwk["crv"] != "P-256") {
+    return nullptr;
+  }
+  auto x = DecodeBignum(jwk, "x");
+  auto y = DecodeBignum(jwk, "y");
+  if (!x || !y) {
+    return nullptr;
+  }
+  std::unique_ptr<EC_KEY, decltype(&EC_KEY_free)> ec_key(
+      EC_KEY_new_by_curve_name(NID_X9_62_prime256v1), &EC_KEY_free);
+  if (!ec_key || EC_KEY_set_public_key_affine_coordinates(
+                     ec_key.get(), x.get(), y.get()) != 1) {
+    return nullptr;
+  }
+
+  EVP_PKEY* key = EVP_PKEY_new();
+  if (key == nullptr || EVP_PKEY_assign_EC_KEY(key, ec_key.get()) != 1) {
+    EVP_PKEY_free(key);
+    return nullptr;
+  }
+  ec_key.release();
+  return key;
+}
+
+// Converts the fixed size r || s JWS encoding of an ES256 signature to the
+// DER encoding expected by EVP_DigestVerify.
+bool ConvertEs256SignatureToDer(const std::string& signature,
+                                std::string& der_signature) {
+  if (signature.size() != 2 * kEs256SignatureHalfBytes) {
+    return false;
+  }
+  const auto* bytes = reinterpret_cast<const uint8_t*>(signature.data());
+  std::unique_ptr<ECDSA_SIG, decltype(&ECDSA_SIG_free)> ecdsa_signature(
+      ECDSA_SIG_new(), &ECDSA_SIG_free);
+  BIGNUM* r = BN_bin2bn(bytes, kEs256SignatureHalfBytes, nullptr);
+  BIGNUM* s = BN_bin2bn(bytes + kEs256SignatureHalfBytes,
+                        kEs256SignatureHalfBytes, nullptr);
+  if (!ecdsa_signature || r == nullptr || s == nullptr ||
+      ECDSA_SIG_set0(ecdsa_signature.get(), r, s) != 1) {
+    BN_free(r);
+    BN_free(s);
+    return false;
+  }
+
+  int der_length = i2d_ECDSA_SIG(ecdsa_signature.get(), nullptr);
+  if (der_length <= 0) {
+    return false;
+  }
+  der_signature.resize(der_length);
+  auto* der_bytes = reinterpret_cast<uint8_t*>(der_signature.data());
+  return i2d_ECDSA_SIG(ecdsa_signature.get(), &der_bytes) == der_length;
+}
+
+std::string ComputeTokenDigest(const std::string& token) {
+  std::string digest(SHA256_DIGEST_LENGTH, '\0');
+  SHA256(reinterpret_cast<const uint8_t*>(token.data()), token.size(),
+         reinterpret_cast<uint8_t*>(digest.data()));
+  return digest;
+}
+
+bool HasAudience(const json& audience_claim, const std::string& audience) {
+  if (audience_claim.is_string()) {
+    return audience_claim.get<std::string>() == audience;
+  }
+  if (audience_claim.is_array()) {
+    return std::any_of(audience_claim.begin(), audience_claim.end(),
+                       [&audience](const json& value) {
+                         return value.is_string() &&
+                                value.get<std::string>() == audience;
+                       });
+  }
+  return false;
+}
+
+int64_t GetWallTimeInSeconds() {
+  return std::chrono::duration_cast<std::chrono::seconds>(
+             TimeProvider::GetWallTimestampInNanoseconds())
+      .count();
+}
+
+}  // namespace
+
+const std::vector<std::string>& GetRequiredJWTComponents() {
+  static const auto* const components =
+      new std::vector<std::string>{"iss", "aud", "sub", "iat", "exp"};
+  return *components;
+}
+
+GcpJwtVerifier::GcpJwtVerifier(
+    GcpJwtVerifierOptions options,
+    std::shared_ptr<pbs_common::HttpClientInterface> http_client)
+    : options_(std::move(options)),
+      http_client_(std::move(http_client)),
+      next_fetch_timestamp_(0),
+      last_fetch_timestamp_(0),
+      is_fetching_(false) {
+  if (!options_.jwks_file_path.empty()) {
+    auto execution_result = LoadJwksFromFile(options_.jwks_file_path);
+    if (!execution_result.Successful()) {
+      SCP_ERROR(kGcpJwtVerifier, kZeroUuid, execution_result,
+                absl::StrCat("Failed to load the JWKS file ",
+                             options_.jwks_file_path));
+    }
+  }
+}
+
+ExecutionResult GcpJwtVerifier::LoadJwks(
+    const std::string& jwks_json) noexcept {
+  json jwks;
+  try {
+    jwks = json::parse(jwks_json);
+  } catch (...) {
+    return FailureExecutionResult(SC_AUTHORIZATION_SERVICE_INVALID_JWKS);
+  }
+  if (!jwks.is_object() || !jwks.contains("keys") ||
+      !jwks["keys"].is_array()) {
+    return FailureExecutionResult(SC_AUTHORIZATION_SERVICE_INVALID_JWKS);
+  }
+
+  auto keys = std::make_shared<KeySet>();
+  for (const auto& jwk : jwks["keys"]) {
+    if (!jwk.is_object() || !jwk.contains("kid") || !jwk["kid"].is_string() ||
+        !jwk.contains("kty") || !jwk["kty"].is_string()) {
+      continue;
+    }
+    VerificationKey verification_key;
+    const auto& key_type = jwk["kty"].get_ref<const std::string&>();
+    if (key_type == "RSA") {
+      verification_key.algorithm = kRs256;
+      verification_key.key.reset(ParseRsaKey(jwk));
+    } else if (key_type == "EC") {
+      verification_key.algorithm = kEs256;
+      verification_key.key.reset(ParseEcKey(jwk));
+    }
+    // A key pinned to another algorithm is never used for verification.
+    if (!verification_key.key ||
+        (jwk.contains("alg") && jwk["alg"] != verification_key.algorithm)) {
+      continue;
+    }
+    keys->insert_or_assign(jwk["kid"].get<std::string>(),
+                           std::move(verification_key));
+  }
+  if (keys->empty()) {
+    return FailureExecutionResult(SC_AUTHORIZATION_SERVICE_INVALID_JWKS);
+  }
+
+  absl::MutexLock lock(&keys_mutex_);
+  keys_ = std::move(keys);
+  return SuccessExecutionResult();
+}
+
+ExecutionResult GcpJwtVerifier::LoadJwksFromFile(
+    const std::string& jwks_file_path) noexcept {
+  std::ifstream jwks_file(jwks_file_path);
+  if (!jwks_file) {
+    return FailureExecutionResult(SC_AUTHORIZATION_SERVICE_INVALID_JWKS);
+  }
+  std::stringstream jwks_json;
+  jwks_json << jwks_file.rdbuf();
+  return LoadJwks(jwks_json.str());
+}
+
+bool GcpJwtVerifier::HasKeys() noexcept {
+  {
+    absl::MutexLock lock(&keys_mutex_);
+    if (keys_) {
+      return true;
+    }
+  }
+  MaybeFetchJwks(/*force=*/false);
+  return false;
+}
+
+void GcpJwtVerifier::MaybeFetchJwks(bool force) noexcept {
+  if (!http_client_ || options_.jwks_uri.empty()) {
+    return;
+  }
+  // The response callback only holds a weak reference to the verifier.
+  auto weak_self = weak_from_this();
+  if (weak_self.expired()) {
+    return;
+  }
+
+  // Forced fetches are throttled by the retry interval so that tokens with
+  // unknown key ids cannot make every request fetch the JWKS.
+  auto now = TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks();
+  auto next_fetch = next_fetch_timestamp_.load();
+  if (force) {
+    next_fetch = std::min(
+        next_fetch,
+        static_cast<Timestamp>(
+            std::chrono::nanoseconds(options_.jwks_retry_interval).count()) +
+            last_fetch_timestamp_.load());
+  }
+  if (now < next_fetch) {
+    return;
+  }
+  bool expected = false;
+  if (!is_fetching_.compare_exchange_strong(expected, true)) {
+    return;
+  }
+  last_fetch_timestamp_ = now;
+
+  auto http_request = std::make_shared<HttpRequest>();
+  http_request->method = HttpMethod::GET;
+  http_request->path = std::make_shared<pbs_common::Uri>(options_.jwks_uri);
+  http_request->headers = std::make_shared<HttpHeaders>();
+  http_request->is_idempotent = true;
+  AsyncContext<HttpRequest, HttpResponse> http_context(
+      std::move(http_request),
+      [weak_self](AsyncContext<HttpRequest, HttpResponse>& http_context) {
+        if (auto self = weak_self.lock()) {
+          self->HandleJwksResponse(http_context);
+        }
+      },
+      kZeroUuid, kZeroUuid);
+
+  auto execution_result = http_client_->PerformRequest(http_context);
+  if (!execution_result.Successful()) {
+    SCP_WARNING(kGcpJwtVerifier, kZeroUuid,
+                absl::StrCat("Failed to request the JWKS from ",
+                             options_.jwks_uri));
+    next_fetch_timestamp_ =
+        now + std::chrono::nanoseconds(options_.jwks_retry_interval).count();
+    is_fetching_ = false;
+  }
+}
+
+void GcpJwtVerifier::HandleJwksResponse(
+    AsyncContext<HttpRequest, HttpResponse>& http_context) noexcept {
+  auto execution_result = http_context.result;
+  if (execution_result.Successful()) {
+    execution_result = LoadJwks(http_context.response->body.ToString());
+  }
+
+  auto now = TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks();
+  if (execution_result.Successful()) {
+    next_fetch_timestamp_ =
+        now + std::chrono::nanoseconds(options_.jwks_refresh_interval).count();
+  } else {
+    SCP_WARNING(kGcpJwtVerifier, kZeroUuid,
+                absl::StrCat("Failed to fetch the JWKS from ",
+                             options_.jwks_uri));
+    next_fetch_timestamp_ =
+        now + std::chrono::nanoseconds(options_.jwks_retry_interval).count();
+  }
+  is_fetching_ = false;
+}
+
+ExecutionResultOr<std::shared_ptr<const JwtClaims>> GcpJwtVerifier::Verify(
+    const std::string& token) noexcept {
+  MaybeFetchJwks(/*force=*/false);
+
+  auto token_digest = ComputeTokenDigest(token);
+  std::shared_ptr<const JwtClaims> claims;
+  {
+    absl::MutexLock lock(&verified_tokens_mutex_);
+    auto it = verified_tokens_.find(token_digest);
+    if (it != verified_tokens_.end()) {
+      claims = it->second;
+    }
+  }
+  if (claims) {
+    RETURN_IF_FAILURE(CheckValidity(*claims));
+    return claims;
+  }
+
+  // The token is split like so: <HEADER>.<PAYLOAD>.<SIGNATURE>
+  std::vector<std::string> parts = absl::StrSplit(token, '.');
+  if (parts.size() != kIdTokenParts) {
+    return FailureExecutionResult(SC_AUTHORIZATION_SERVICE_BAD_TOKEN);
+  }
+  RETURN_IF_FAILURE(VerifySignature(
+      parts[0], token.substr(0, parts[0].size() + 1 + parts[1].size()),
+      parts[2]));
+
+  std::string payload;
+  if (!Base64UrlDecode(parts[1], payload).Successful()) {
+    return FailureExecutionResult(SC_AUTHORIZATION_SERVICE_BAD_TOKEN);
+  }
+  json payload_json;
+  try {
+    payload_json = json::parse(payload);
+  } catch (...) {
+    return FailureExecutionResult(SC_AUTHORIZATION_SERVICE_BAD_TOKEN);
+  }
+  if (!payload_json.is_object() ||
+      !std::all_of(GetRequiredJWTComponents().begin(),
+                   GetRequiredJWTComponents().end(),
+                   [&payload_json](const auto& component) {
+                     return payload_json.contains(component);
+                   }) ||
+      !payload_json["iss"].is_string() || !payload_json["sub"].is_string() ||
+      !payload_json["iat"].is_number() || !payload_json["exp"].is_number()) {
+    return FailureExecutionResult(SC_AUTHORIZATION_SERVICE_BAD_TOKEN);
+  }
+
+  auto verified_claims = std::make_shared<JwtClaims>();
+  verified_claims->issuer = payload_json["iss"].get<std::string>();
+  verified_claims->subject = payload_json["sub"].get<std::string>();
+  if (payload_json.contains("email") && payload_json["email"].is_string()) {
+    verified_claims->email = payload_json["email"].get<std::string>();
+  }
+  verified_claims->issued_at = payload_json["iat"].get<int64_t>();
+  verified_claims->expiration = payload_json["exp"].get<int64_t>();
+
+  if (std::find(options_.issuers.begin(), options_.issuers.end(),
+                verified_claims->issuer) == options_.issuers.end()) {
+    return FailureExecutionResult(SC_AUTHORIZATION_SERVICE_BAD_TOKEN);
+  }
+  // Without an expected audience, no token is accepted.
+  if (options_.audience.empty() ||
+      !HasAudience(payload_json["aud"], options_.audience)) {
+    return FailureExecutionResult(SC_AUTHORIZATION_SERVICE_BAD_TOKEN);
+  }
+  RETURN_IF_FAILURE(CheckValidity(*verified_claims));
+
+  absl::MutexLock lock(&verified_tokens_mutex_);
+  CacheVerifiedToken(std::move(token_digest), verified_claims);
+  return verified_claims;
+}
+
+void GcpJwtVerifier::CacheVerifiedToken(
+    std::string token_digest,
+    std::shared_ptr<const JwtClaims> claims) noexcept {
+  // Another request may have verified the same token in the meantime.
+  if (verified_tokens_.contains(token_digest)) {
+    return;
+  }
+
+  auto now = GetWallTimeInSeconds();
+  while (!verified_token_expirations_.empty()) {
+    auto oldest = verified_token_expirations_.begin();
+    if (oldest->first + options_.clock_skew.count() > now &&
+        verified_tokens_.size() < options_.max_verified_tokens) {
+      break;
+    }
+    verified_tokens_.erase(oldest->second);
+    verified_token_expirations_.erase(oldest);
+  }
+
+  verified_token_expirations_.emplace(claims->expiration, token_digest);
+  verified_tokens_.emplace(std::move(token_digest), std::move(claims));
+}
+
+ExecutionResult GcpJwtVerifier::VerifySignature(
+    const std::string& encoded_header, const std::string& signed_data,
+    const std::string& encoded_signature) noexcept {
+  std::string header;
+  if (!Base64UrlDecode(encoded_header, header).Successful()) {
+    return FailureExecutionResult(SC_AUTHORIZATION_SERVICE_BAD_TOKEN);
+  }
+  json header_json;
+  try {
+    header_json = json::parse(header);
+  } catch (...) {
+    return FailureExecutionResult(SC_AUTHORIZATION_SERVICE_BAD_TOKEN);
+  }
+  if (!header_json.is_object() || !header_json.contains("alg") ||
+      !header_json["alg"].is_string() || !header_json.contains("kid") ||
+      !header_json["kid"].is_string()) {
+    return FailureExecutionResult(SC_AUTHORIZATION_SERVICE_BAD_TOKEN);
+  }
+
+  std::shared_ptr<const KeySet> keys;
+  {
+    absl::MutexLock lock(&keys_mutex_);
+    keys = keys_;
+  }
+  if (!keys) {
+    return FailureExecutionResult(SC_AUTHORIZATION_SERVICE_BAD_TOKEN);
+  }
+  auto key_it = keys->find(header_json["kid"].get<std::string>());
+  if (key_it == keys->end()) {
+    // The signing keys may have been rotated since the last fetch.
+    MaybeFetchJwks(/*force=*/true);
+    return FailureExecutionResult(
+        SC_AUTHORIZATION_SERVICE_UNKNOWN_SIGNING_KEY);
+  }
+  // The algorithm is taken from the key rather than from the token so that a
+  // token cannot pick a weaker algorithm for the key.
+  const auto& verification_key = key_it->second;
+  if (header_json["alg"] != verification_key.algorithm) {
+    return FailureExecutionResult(SC_AUTHORIZATION_SERVICE_BAD_TOKEN);
+  }
+
+  std::string signature;
+  if (!Base64UrlDecode(encoded_signature, signature).Successful()) {
+    return FailureExecutionResult(SC_AUTHORIZATION_SERVICE_BAD_TOKEN);
+  }
+  if (verification_key.algorithm == kEs256) {
+    std::string der_signature;
+    if (!ConvertEs256SignatureToDer(signature, der_signature)) {
+      return FailureExecutionResult(SC_AUTHORIZATION_SERVICE_BAD_TOKEN);
+    }
+    signature = std::move(der_signature);
+  }
+
+  std::unique_ptr<EVP_MD_CTX, decltype(&EVP_MD_CTX_free)> md_context(
+      EVP_MD_CTX_new(), &EVP_MD_CTX_free);
+  if (!md_context ||
+      EVP_DigestVerifyInit(md_context.get(), nullptr, EVP_sha256(), nullptr,
+                           verification_key.key.get()) != 1 ||
+      EVP_DigestVerify(
+          md_context.get(),
+          reinterpret_cast<const uint8_t*>(signature.data()), signature.size(),
+          reinterpret_cast<const uint8_t*>(signed_data.data()),
+          signed_data.size()) != 1) {
+    return FailureExecutionResult(SC_AUTHORIZATION_SERVICE_BAD_TOKEN);
+  }
+  return SuccessExecutionResult();
+}
+
+ExecutionResult GcpJwtVerifier::CheckValidity(
+    const JwtClaims& claims) const noexcept {
+  auto now = GetWallTimeInSeconds();
+  auto clock_skew = options_.clock_skew.count();
+  if (claims.expiration + clock_skew <= now ||
+      claims.issued_at - clock_skew > now) {
+    return FailureExecutionResult(SC_AUTHORIZATION_SERVICE_BAD_TOKEN);
+  }
+  return SuccessExecutionResult();
+}
+
+}  // namespace privacy_sandbox::pbs
@@ -0,0 +1,195 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <openssl/evp.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "cc/core/interface/async_context.h"
+#include "cc/core/interface/http_client_interface.h"
+#include "cc/core/interface/http_types.h"
+#include "cc/core/interface/type_def.h"
+#include "cc/public/core/interface/execution_result.h"
+
+namespace privacy_sandbox::pbs {
+
+// Endpoint publishing the keys Google signs ID tokens with.
+inline constexpr char kGoogleJwksUri[] =
+    "https://www.googleapis.com/oauth2/v3/certs";
+
+// How often the JWKS is fetched again from the JWKS endpoint.
+inline constexpr std::chrono::seconds kDefaultJwksRefreshInterval =
+    std::chrono::hours(1);
+
+// How long to wait before fetching the JWKS again after a failed fetch.
+inline constexpr std::chrono::seconds kDefaultJwksRetryInterval =
+    std::chrono::seconds(30);
+
+// Tolerated clock difference when checking the "exp" and "iat" claims.
+inline constexpr std::chrono::seconds kDefaultJwtClockSkew =
+    std::chrono::seconds(60);
+
+// Upper bound of verified tokens whose claims are kept in memory.
+inline constexpr size_t kDefaultMaxVerifiedTokens = 100000;
+
+// An ID token is split like so: <HEADER>.<PAYLOAD>.<SIGNATURE>
+inline constexpr size_t kIdTokenParts = 3;
+
+// The claims every ID token must have.
+const std::vector<std::string>& GetRequiredJWTComponents();
+
+struct GcpJwtVerifierOptions {
+  // Expected "aud" claim. Every token is rejected when empty.
+  std::string audience;
+  // Accepted "iss" claims.
+  std::vector<std::string> issuers = {"https://accounts.google.com",
+                                      "accounts.google.com"};
+  // Endpoint the JWKS is periodically fetched from. Nothing is fetched when
+  // empty.
+  std::string jwks_uri;
+  // Local JWKS file loaded on construction, e.g. for tests or hosts without
+  // access to the JWKS endpoint.
+  std::string jwks_file_path;
+  std::chrono::seconds jwks_refresh_interval = kDefaultJwksRefreshInterval;
+  std::chrono::seconds jwks_retry_interval = kDefaultJwksRetryInterval;
+  std::chrono::seconds clock_skew = kDefaultJwtClockSkew;
+  size_t max_verified_tokens = kDefaultMaxVerifiedTokens;
+};
+
+// The claims of a verified ID token.
+struct JwtClaims {
+  std::string issuer;
+  std::string subject;
+  std::string email;
+  // Seconds since epoch.
+  int64_t issued_at = 0;
+  int64_t expiration = 0;
+};
+
+/**
+ * @brief Verifies RS256 and ES256 signed ID tokens and their claims locally
+ * against a cached JSON Web Key Set (JWKS).
+ *
+ * The JWKS is loaded from a local file, fetched from the JWKS endpoint, or
+ * both. Fetches happen in the background off the verification path: on the
+ * first verification, once the refresh interval elapsed, and when a token is
+ * signed by an unknown key (key rotation). The claims of verified tokens are
+ * cached by token digest so that a token is only decoded and verified once.
+ *
+ * Fetching requires the verifier to be owned by a std::shared_ptr.
+ */
+class GcpJwtVerifier : public std::enable_shared_from_this<GcpJwtVerifier> {
+ public:
+  explicit GcpJwtVerifier(
+      GcpJwtVerifierOptions options,
+      std::shared_ptr<pbs_common::HttpClientInterface> http_client = nullptr);
+
+  /**
+   * @brief Replaces the cached keys with the RSA and P-256 EC keys of the
+   * given JWKS document. Keys of other types are ignored.
+   */
+  pbs_common::ExecutionResult LoadJwks(const std::string& jwks_json) noexcept;
+
+  /// Replaces the cached keys with the keys of the given JWKS file.
+  pbs_common::ExecutionResult LoadJwksFromFile(
+      const std::string& jwks_file_path) noexcept;
+
+  /**
+   * @brief Returns true once a JWKS has been loaded. Kicks off the first JWKS
+   * fetch when no keys are loaded yet.
+   */
+  bool HasKeys() noexcept;
+
+  /**
+   * @brief Verifies the signature and the "iss", "aud", "exp" and "iat"
+   * claims of the token.
+   *
+   * @return The verified claims, SC_AUTHORIZATION_SERVICE_UNKNOWN_SIGNING_KEY
+   * if the token is signed by a key which is not cached, e.g. since the keys
+   * were rotated, or SC_AUTHORIZATION_SERVICE_BAD_TOKEN if the token is
+   * malformed, expired, issued for another audience or by another issuer, or
+   * its signature does not match.
+   */
+  pbs_common::ExecutionResultOr<std::shared_ptr<const JwtClaims>> Verify(
+      const std::string& token) noexcept;
+
+ protected:
+  struct KeyDeleter {
+    void operator()(EVP_PKEY* key) const { EVP_PKEY_free(key); }
+  };
+
+  struct VerificationKey {
+    std::string algorithm;
+    std::unique_ptr<EVP_PKEY, KeyDeleter> key;
+  };
+
+  using KeySet = absl::flat_hash_map<std::string, VerificationKey>;
+
+  /// Fetches the JWKS in the background if a fetch is due or forced.
+  void MaybeFetchJwks(bool force) noexcept;
+
+  /// Handles the JWKS endpoint response.
+  void HandleJwksResponse(
+      pbs_common::AsyncContext<pbs_common::HttpRequest,
+                               pbs_common::HttpResponse>& http_context) noexcept;
+
+  /// Verifies the signature of a token split into its three parts.
+  pbs_common::ExecutionResult VerifySignature(
+      const std::string& encoded_header, const std::string& signed_data,
+      const std::string& encoded_signature) noexcept;
+
+  /// Checks the time dependent claims against the current time.
+  pbs_common::ExecutionResult CheckValidity(
+      const JwtClaims& claims) const noexcept;
+
+  /// Caches the claims of a verified token, evicting the expired tokens and,
+  /// once full, the tokens expiring first.
+  void CacheVerifiedToken(std::string token_digest,
+                          std::shared_ptr<const JwtClaims> claims) noexcept
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(verified_tokens_mutex_);
+
+  GcpJwtVerifierOptions options_;
+  std::shared_ptr<pbs_common::HttpClientInterface> http_client_;
+
+  mutable absl::Mutex keys_mutex_;
+  std::shared_ptr<const KeySet> keys_ ABSL_GUARDED_BY(keys_mutex_);
+
+  /// Steady clock timestamp after which the JWKS is fetched again.
+  std::atomic<pbs_common::Timestamp> next_fetch_timestamp_;
+  /// Steady clock timestamp of the last JWKS fetch.
+  std::atomic<pbs_common::Timestamp> last_fetch_timestamp_;
+  std::atomic<bool> is_fetching_;
+
+  absl::Mutex verified_tokens_mutex_;
+  /// Verified claims keyed by the SHA-256 digest of the token.
+  absl::flat_hash_map<std::string, std::shared_ptr<const JwtClaims>>
+      verified_tokens_ ABSL_GUARDED_BY(verified_tokens_mutex_);
+  /// The digests of verified_tokens_, by expiration of their token.
+  std::multimap<int64_t, std::string> verified_token_expirations_
+      ABSL_GUARDED_BY(verified_tokens_mutex_);
+};
+
+}  // namespace privacy_sandbox::pbs
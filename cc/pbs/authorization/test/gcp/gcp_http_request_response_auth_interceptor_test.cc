@@ -66,6 +66,16 @@ constexpr char kAuthorizationHeader[] = "Authorization";
 
 constexpr char kIdentity[] = "identity";
 
+constexpr char kJwks[] = R"""({
+  "keys": [{
+    "kid": "key",
+    "kty": "RSA",
+    "alg": "RS256",
+    "e": "AQAB",
+    "n": "ySbwXEt29VYNvu5Yu7spNztixfVTHSec9zSb37eKmJkMpqct-f7zsVVdouN0kuTH3Vt2wMn9jsp4oRinR9hT9fJAI7W2quzYPo16MGs6KdxfSlfRHlrKNwWFRtOt06wIeKD251p4paUAH5LJggxgThC0hW3u5H7Ef-fkbV0n-P6_DmKe97HwvP2AaXoKh8FXDl8KDE7vwAKf03ziwo1IjpaePAG4rBPUYe8Gw75nt1iz-pc50HeYKhWMFoTOr7Sz150QLwd5aP5Gn_9JUyBsGrFevfW_IZGlcam-VHYvwxISwiBPwojpgrL_8d0NGB3xemucdluZfHWvfPVbcOKcQQ"
+  }]
+})""";
+
 const std::vector<std::string>& GetRequiredJWTComponents() {
   static const auto* const components =
       new std::vector<std::string>{"iss", "aud", "sub", "iat", "exp"};
@@ -172,6 +182,53 @@ TEST_F(GcpHttpRequestResponseAuthInterceptorTest,
       ResultIs(FailureExecutionResult(SC_AUTHORIZATION_SERVICE_BAD_TOKEN)));
 }
 
+TEST_F(GcpHttpRequestResponseAuthInterceptorTest,
+       PrepareRequestWithoutVerifierKeysOnlyParsesToken) {
+  subject_ = GcpHttpRequestResponseAuthInterceptor(
+      /*config_provider=*/nullptr,
+      std::make_shared<GcpJwtVerifier>(GcpJwtVerifierOptions()));
+  EXPECT_THAT(subject_.PrepareRequest(authorization_metadata_, http_request_),
+              IsSuccessful());
+}
+
+TEST_F(GcpHttpRequestResponseAuthInterceptorTest,
+       PrepareRequestFailsIfTokenNotVerified) {
+  auto jwt_verifier =
+      std::make_shared<GcpJwtVerifier>(GcpJwtVerifierOptions());
+  ASSERT_THAT(jwt_verifier->LoadJwks(kJwks), IsSuccessful());
+  subject_ = GcpHttpRequestResponseAuthInterceptor(/*config_provider=*/nullptr,
+                                                   jwt_verifier);
+  EXPECT_THAT(
+      subject_.PrepareRequest(authorization_metadata_, http_request_),
+      ResultIs(FailureExecutionResult(SC_AUTHORIZATION_SERVICE_BAD_TOKEN)));
+  EXPECT_TRUE(http_request_.headers->empty());
+}
+
+TEST_F(GcpHttpRequestResponseAuthInterceptorTest,
+       PrepareRequestOnlyParsesTokenSignedByUnknownKey) {
+  auto jwt_verifier =
+      std::make_shared<GcpJwtVerifier>(GcpJwtVerifierOptions());
+  ASSERT_THAT(jwt_verifier->LoadJwks(kJwks), IsSuccessful());
+  subject_ = GcpHttpRequestResponseAuthInterceptor(/*config_provider=*/nullptr,
+                                                   jwt_verifier);
+  // Signed by a key published after the JWKS was loaded.
+  json header_json = {{"alg", "RS256"}, {"kid", "rotated-key"}};
+  std::string header;
+  ASSERT_THAT(Base64Encode(header_json.dump(), header), IsSuccessful());
+  std::string jwt;
+  ASSERT_THAT(Base64Encode(token_json_.dump(), jwt), IsSuccessful());
+  authorization_metadata_.authorization_token =
+      absl::StrCat(header, ".", jwt, ".signature");
+
+  EXPECT_THAT(subject_.PrepareRequest(authorization_metadata_, http_request_),
+              IsSuccessful());
+  const auto& headers = *http_request_.headers;
+  ASSERT_NE(headers.find(kAuthorizationHeader), headers.end());
+  EXPECT_EQ(
+      headers.find(kAuthorizationHeader)->second,
+      absl::StrCat("Bearer ", authorization_metadata_.authorization_token));
+}
+
 TEST_F(GcpHttpRequestResponseAuthInterceptorTest, ObtainAuthorizedMetadata) {
   json response_json = json::parse(R"""({
       "authorized_domain": "domain"
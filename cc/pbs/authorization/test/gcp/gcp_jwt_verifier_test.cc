@@ -0,0 +1,452 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cc/pbs/authorization/src/gcp/gcp_jwt_verifier.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <openssl/bn.h>
+#include <openssl/ec.h>
+#include <openssl/ecdsa.h>
+#include <openssl/evp.h>
+#include <openssl/nid.h>
+#include <openssl/rsa.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "cc/core/authorization_service/src/error_codes.h"
+#include "cc/core/http2_client/mock/mock_http_client.h"
+#include "cc/core/utils/src/base64.h"
+#include "cc/public/core/interface/execution_result.h"
+#include "cc/public/core/test/interface/execution_result_matchers.h"
+
+namespace privacy_sandbox::pbs {
+namespace {
+
+using ::privacy_sandbox::pbs_common::AsyncContext;
+using ::privacy_sandbox::pbs_common::Base64Encode;
+using ::privacy_sandbox::pbs_common::BytesBuffer;
+using ::privacy_sandbox::pbs_common::FailureExecutionResult;
+using ::privacy_sandbox::pbs_common::HttpRequest;
+using ::privacy_sandbox::pbs_common::HttpResponse;
+using ::privacy_sandbox::pbs_common::IsSuccessful;
+using ::privacy_sandbox::pbs_common::IsSuccessfulAndHolds;
+using ::privacy_sandbox::pbs_common::MockHttpClient;
+using ::privacy_sandbox::pbs_common::ResultIs;
+using ::privacy_sandbox::pbs_common::SC_AUTHORIZATION_SERVICE_BAD_TOKEN;
+using ::privacy_sandbox::pbs_common::SC_AUTHORIZATION_SERVICE_INVALID_JWKS;
+using ::privacy_sandbox::pbs_common::
+    SC_AUTHORIZATION_SERVICE_UNKNOWN_SIGNING_KEY;
+using ::privacy_sandbox::pbs_common::SuccessExecutionResult;
+using ::testing::Eq;
+using ::testing::Field;
+using ::testing::Ne;
+using ::testing::Pointee;
+
+using json = nlohmann::json;
+
+constexpr char kAudience[] = "https://pbs.example.com";
+constexpr char kIssuer[] = "https://accounts.google.com";
+constexpr char kEmail[] = "adtech@project.iam.gserviceaccount.com";
+constexpr char kRsaKeyId[] = "rsa-key";
+constexpr char kEcKeyId[] = "ec-key";
+constexpr char kJwksUri[] = "https://www.example.com/certs";
+
+std::string Base64UrlEncode(const std::string& decoded) {
+  std::string encoded;
+  if (!Base64Encode(decoded, encoded).Successful()) {
+    throw std::runtime_error("error encoding");
+  }
+  encoded.erase(std::remove(encoded.begin(), encoded.end(), '='),
+                encoded.end());
+  std::replace(encoded.begin(), encoded.end(), '+', '-');
+  std::replace(encoded.begin(), encoded.end(), '/', '_');
+  return encoded;
+}
+
+std::string BignumToBytes(const BIGNUM* bignum, size_t size = 0) {
+  size_t length = BN_num_bytes(bignum);
+  std::string bytes(std::max(size, length), '\0');
+  BN_bn2bin(bignum,
+            reinterpret_cast<uint8_t*>(bytes.data()) + bytes.size() - length);
+  return bytes;
+}
+
+int64_t NowInSeconds() {
+  return std::chrono::duration_cast<std::chrono::seconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+class GcpJwtVerifierTest : public testing::Test {
+ protected:
+  GcpJwtVerifierTest() {
+    std::unique_ptr<BIGNUM, decltype(&BN_free)> exponent(BN_new(), &BN_free);
+    BN_set_word(exponent.get(), RSA_F4);
+    RSA* rsa = RSA_new();
+    RSA_generate_key_ex(rsa, 2048, exponent.get(), nullptr);
+    rsa_key_.reset(EVP_PKEY_new());
+    EVP_PKEY_assign_RSA(rsa_key_.get(), rsa);
+
+    EC_KEY* ec_key = EC_KEY_new_by_curve_name(NID_X9_62_prime256v1);
+    EC_KEY_generate_key(ec_key);
+    ec_key_.reset(EVP_PKEY_new());
+    EVP_PKEY_assign_EC_KEY(ec_key_.get(), ec_key);
+
+    const BIGNUM* modulus = nullptr;
+    const BIGNUM* public_exponent = nullptr;
+    RSA_get0_key(rsa, &modulus, &public_exponent, nullptr);
+    std::unique_ptr<BIGNUM, decltype(&BN_free)> x(BN_new(), &BN_free);
+    std::unique_ptr<BIGNUM, decltype(&BN_free)> y(BN_new(), &BN_free);
+    EC_POINT_get_affine_coordinates_GFp(EC_KEY_get0_group(ec_key),
+                                        EC_KEY_get0_public_key(ec_key),
+                                        x.get(), y.get(), nullptr);
+
+    jwks_ = json{
+        {"keys",
+         json::array(
+             {{{"kid", kRsaKeyId},
+               {"kty", "RSA"},
+               {"alg", "RS256"},
+               {"n", Base64UrlEncode(BignumToBytes(modulus))},
+               {"e", Base64UrlEncode(BignumToBytes(public_exponent))}},
+              {{"kid", kEcKeyId},
+               {"kty", "EC"},
+               {"crv", "P-256"},
+               {"x", Base64UrlEncode(BignumToBytes(x.get(), 32))},
+               {"y", Base64UrlEncode(BignumToBytes(y.get(), 32))}}})}}
+                .dump();
+
+    claims_ = {{"iss", kIssuer},      {"aud", kAudience},
+               {"sub", "1234567890"}, {"email", kEmail},
+               {"iat", NowInSeconds()}, {"exp", NowInSeconds() + 3600}};
+
+    options_.audience = kAudience;
+  }
+
+  std::string SignRs256(const std::string& signed_data) {
+    std::unique_ptr<EVP_MD_CTX, decltype(&EVP_MD_CTX_free)> md_context(
+        EVP_MD_CTX_new(), &EVP_MD_CTX_free);
+    size_t signature_length = EVP_PKEY_size(rsa_key_.get());
+    std::string signature(signature_length, '\0');
+    EVP_DigestSignInit(md_context.get(), nullptr, EVP_sha256(), nullptr,
+                       rsa_key_.get());
+    EVP_DigestSign(md_context.get(),
+                   reinterpret_cast<uint8_t*>(signature.data()),
+                   &signature_length,
+                   reinterpret_cast<const uint8_t*>(signed_data.data()),
+                   signed_data.size());
+    signature.resize(signature_length);
+    return signature;
+  }
+
+  std::string SignEs256(const std::string& signed_data) {
+    std::unique_ptr<EVP_MD_CTX, decltype(&EVP_MD_CTX_free)> md_context(
+        EVP_MD_CTX_new(), &EVP_MD_CTX_free);
+    size_t signature_length = EVP_PKEY_size(ec_key_.get());
+    std::string der_signature(signature_length, '\0');
+    EVP_DigestSignInit(md_context.get(), nullptr, EVP_sha256(), nullptr,
+                       ec_key_.get());
+    EVP_DigestSign(md_context.get(),
+                   reinterpret_cast<uint8_t*>(der_signature.data()),
+                   &signature_length,
+                   reinterpret_cast<const uint8_t*>(signed_data.data()),
+                   signed_data.size());
+
+    // JWS uses the fixed size r || s encoding rather than DER.
+    const auto* der_bytes =
+        reinterpret_cast<const uint8_t*>(der_signature.data());
+    std::unique_ptr<ECDSA_SIG, decltype(&ECDSA_SIG_free)> ecdsa_signature(
+        d2i_ECDSA_SIG(nullptr, &der_bytes, signature_length), &ECDSA_SIG_free);
+    const BIGNUM* r = nullptr;
+    const BIGNUM* s = nullptr;
+    ECDSA_SIG_get0(ecdsa_signature.get(), &r, &s);
+    return BignumToBytes(r, 32) + BignumToBytes(s, 32);
+  }
+
+  std::string MakeToken(const std::string& algorithm,
+                        const std::string& key_id) {
+    auto signed_data = absl::StrCat(
+        Base64UrlEncode(
+            json{{"alg", algorithm}, {"kid", key_id}, {"typ", "JWT"}}.dump()),
+        ".", Base64UrlEncode(claims_.dump()));
+    auto signature =
+        algorithm == "ES256" ? SignEs256(signed_data) : SignRs256(signed_data);
+    return absl::StrCat(signed_data, ".", Base64UrlEncode(signature));
+  }
+
+  std::shared_ptr<GcpJwtVerifier> MakeVerifierWithKeys() {
+    auto verifier = std::make_shared<GcpJwtVerifier>(options_);
+    EXPECT_THAT(verifier->LoadJwks(jwks_), IsSuccessful());
+    return verifier;
+  }
+
+  struct KeyDeleter {
+    void operator()(EVP_PKEY* key) const { EVP_PKEY_free(key); }
+  };
+
+  std::unique_ptr<EVP_PKEY, KeyDeleter> rsa_key_;
+  std::unique_ptr<EVP_PKEY, KeyDeleter> ec_key_;
+  std::string jwks_;
+  json claims_;
+  GcpJwtVerifierOptions options_;
+};
+
+TEST_F(GcpJwtVerifierTest, VerifiesRs256Token) {
+  auto verifier = MakeVerifierWithKeys();
+  EXPECT_TRUE(verifier->HasKeys());
+  EXPECT_THAT(verifier->Verify(MakeToken("RS256", kRsaKeyId)),
+              IsSuccessfulAndHolds(Pointee(Field(&JwtClaims::email, kEmail))));
+}
+
+TEST_F(GcpJwtVerifierTest, VerifiesEs256Token) {
+  auto verifier = MakeVerifierWithKeys();
+  EXPECT_THAT(verifier->Verify(MakeToken("ES256", kEcKeyId)),
+              IsSuccessfulAndHolds(Pointee(Field(&JwtClaims::email, kEmail))));
+}
+
+TEST_F(GcpJwtVerifierTest, ReturnsCachedClaimsForSameToken) {
+  auto verifier = MakeVerifierWithKeys();
+  auto token = MakeToken("RS256", kRsaKeyId);
+  auto first_claims_or = verifier->Verify(token);
+  ASSERT_THAT(first_claims_or, IsSuccessful());
+  EXPECT_THAT(verifier->Verify(token),
+              IsSuccessfulAndHolds(Eq(*first_claims_or)));
+}
+
+TEST_F(GcpJwtVerifierTest, EvictsTheTokensExpiringFirstOnceFull) {
+  options_.max_verified_tokens = 2;
+  auto verifier = MakeVerifierWithKeys();
+  auto make_token_expiring_in = [&](int64_t seconds) {
+    claims_["exp"] = NowInSeconds() + seconds;
+    return MakeToken("RS256", kRsaKeyId);
+  };
+  auto late_token = make_token_expiring_in(3000);
+  auto early_token = make_token_expiring_in(1000);
+  auto late_claims_or = verifier->Verify(late_token);
+  auto early_claims_or = verifier->Verify(early_token);
+  ASSERT_THAT(late_claims_or, IsSuccessful());
+  ASSERT_THAT(early_claims_or, IsSuccessful());
+
+  ASSERT_THAT(verifier->Verify(make_token_expiring_in(2000)), IsSuccessful());
+  EXPECT_THAT(verifier->Verify(late_token),
+              IsSuccessfulAndHolds(Eq(*late_claims_or)));
+  // Verified again rather than taken from the cache.
+  EXPECT_THAT(verifier->Verify(early_token),
+              IsSuccessfulAndHolds(Ne(*early_claims_or)));
+}
+
+TEST_F(GcpJwtVerifierTest, RejectsTamperedPayload) {
+  auto verifier = MakeVerifierWithKeys();
+  auto token = MakeToken("RS256", kRsaKeyId);
+  claims_["email"] = "attacker@example.com";
+  std::vector<std::string> parts = absl::StrSplit(token, '.');
+  auto tampered_token = absl::StrCat(parts[0], ".",
+                                     Base64UrlEncode(claims_.dump()), ".",
+                                     parts[2]);
+  EXPECT_THAT(
+      verifier->Verify(tampered_token),
+      ResultIs(FailureExecutionResult(SC_AUTHORIZATION_SERVICE_BAD_TOKEN)));
+}
+
+TEST_F(GcpJwtVerifierTest, RejectsAlgorithmNotMatchingKey) {
+  auto verifier = MakeVerifierWithKeys();
+  // Signed by the EC key but claims to use the RSA key.
+  auto token = MakeToken("ES256", kRsaKeyId);
+  EXPECT_THAT(
+      verifier->Verify(token),
+      ResultIs(FailureExecutionResult(SC_AUTHORIZATION_SERVICE_BAD_TOKEN)));
+}
+
+TEST_F(GcpJwtVerifierTest, RejectsInvalidClaims) {
+  auto verifier = MakeVerifierWithKeys();
+  json valid_claims = claims_;
+
+  claims_["exp"] = NowInSeconds() - 3600;
+  EXPECT_THAT(
+      verifier->Verify(MakeToken("RS256", kRsaKeyId)),
+      ResultIs(FailureExecutionResult(SC_AUTHORIZATION_SERVICE_BAD_TOKEN)));
+
+  claims_ = valid_claims;
+  claims_["iat"] = NowInSeconds() + 3600;
+  EXPECT_THAT(
+      verifier->Verify(MakeToken("RS256", kRsaKeyId)),
+      ResultIs(FailureExecutionResult(SC_AUTHORIZATION_SERVICE_BAD_TOKEN)));
+
+  claims_ = valid_claims;
+  claims_["aud"] = "https://other.example.com";
+  EXPECT_THAT(
+      verifier->Verify(MakeToken("RS256", kRsaKeyId)),
+      ResultIs(FailureExecutionResult(SC_AUTHORIZATION_SERVICE_BAD_TOKEN)));
+
+  claims_ = valid_claims;
+  claims_["iss"] = "https://issuer.example.com";
+  EXPECT_THAT(
+      verifier->Verify(MakeToken("RS256", kRsaKeyId)),
+      ResultIs(FailureExecutionResult(SC_AUTHORIZATION_SERVICE_BAD_TOKEN)));
+
+  claims_ = valid_claims;
+  claims_.erase("sub");
+  EXPECT_THAT(
+      verifier->Verify(MakeToken("RS256", kRsaKeyId)),
+      ResultIs(FailureExecutionResult(SC_AUTHORIZATION_SERVICE_BAD_TOKEN)));
+
+  claims_ = valid_claims;
+  claims_["aud"] = json::array({"https://other.example.com", kAudience});
+  EXPECT_THAT(verifier->Verify(MakeToken("RS256", kRsaKeyId)),
+              IsSuccessful());
+}
+
+TEST_F(GcpJwtVerifierTest, RejectsEveryTokenWithoutAudience) {
+  options_.audience.clear();
+  auto verifier = MakeVerifierWithKeys();
+  EXPECT_THAT(
+      verifier->Verify(MakeToken("RS256", kRsaKeyId)),
+      ResultIs(FailureExecutionResult(SC_AUTHORIZATION_SERVICE_BAD_TOKEN)));
+}
+
+TEST_F(GcpJwtVerifierTest, RejectsMalformedToken) {
+  auto verifier = MakeVerifierWithKeys();
+  EXPECT_THAT(
+      verifier->Verify("two.parts"),
+      ResultIs(FailureExecutionResult(SC_AUTHORIZATION_SERVICE_BAD_TOKEN)));
+  EXPECT_THAT(
+      verifier->Verify("bad.json.web_token"),
+      ResultIs(FailureExecutionResult(SC_AUTHORIZATION_SERVICE_BAD_TOKEN)));
+}
+
+TEST_F(GcpJwtVerifierTest, RejectsInvalidJwks) {
+  GcpJwtVerifier verifier(options_);
+  EXPECT_THAT(
+      verifier.LoadJwks("not json"),
+      ResultIs(FailureExecutionResult(SC_AUTHORIZATION_SERVICE_INVALID_JWKS)));
+  EXPECT_THAT(
+      verifier.LoadJwks(R"({"keys": [{"kid": "a", "kty": "oct"}]})"),
+      ResultIs(FailureExecutionResult(SC_AUTHORIZATION_SERVICE_INVALID_JWKS)));
+  EXPECT_FALSE(verifier.HasKeys());
+}
+
+TEST_F(GcpJwtVerifierTest, LoadsJwksFromFile) {
+  options_.jwks_file_path = absl::StrCat(testing::TempDir(), "/jwks.json");
+  std::ofstream(options_.jwks_file_path) << jwks_;
+
+  auto verifier = std::make_shared<GcpJwtVerifier>(options_);
+  EXPECT_TRUE(verifier->HasKeys());
+  EXPECT_THAT(verifier->Verify(MakeToken("RS256", kRsaKeyId)),
+              IsSuccessful());
+}
+
+TEST_F(GcpJwtVerifierTest, FetchesJwksFromEndpoint) {
+  auto http_client = std::make_shared<MockHttpClient>();
+  int fetches = 0;
+  http_client->perform_request_mock =
+      [&](AsyncContext<HttpRequest, HttpResponse>& context) {
+        EXPECT_EQ(*context.request->path, kJwksUri);
+        ++fetches;
+        context.response = std::make_shared<HttpResponse>();
+        context.response->body = BytesBuffer(jwks_);
+        context.result = SuccessExecutionResult();
+        context.Finish();
+        return SuccessExecutionResult();
+      };
+  options_.jwks_uri = kJwksUri;
+
+  auto verifier = std::make_shared<GcpJwtVerifier>(options_, http_client);
+  // The first check kicks off the fetch.
+  EXPECT_FALSE(verifier->HasKeys());
+  EXPECT_TRUE(verifier->HasKeys());
+  EXPECT_EQ(fetches, 1);
+
+  EXPECT_THAT(verifier->Verify(MakeToken("RS256", kRsaKeyId)),
+              IsSuccessful());
+  EXPECT_EQ(fetches, 1);
+
+  // Unknown keys trigger a fetch, throttled by the retry interval.
+  EXPECT_THAT(verifier->Verify(MakeToken("RS256", "rotated-key")),
+              ResultIs(FailureExecutionResult(
+                  SC_AUTHORIZATION_SERVICE_UNKNOWN_SIGNING_KEY)));
+  EXPECT_EQ(fetches, 1);
+}
+
+TEST_F(GcpJwtVerifierTest, FetchesJwksForUnknownKey) {
+  auto http_client = std::make_shared<MockHttpClient>();
+  int fetches = 0;
+  http_client->perform_request_mock =
+      [&](AsyncContext<HttpRequest, HttpResponse>& context) {
+        ++fetches;
+        context.response = std::make_shared<HttpResponse>();
+        context.response->body = BytesBuffer(jwks_);
+        context.result = SuccessExecutionResult();
+        context.Finish();
+        return SuccessExecutionResult();
+      };
+  options_.jwks_uri = kJwksUri;
+  options_.jwks_retry_interval = std::chrono::seconds(0);
+
+  auto verifier = std::make_shared<GcpJwtVerifier>(options_, http_client);
+  EXPECT_FALSE(verifier->HasKeys());
+  EXPECT_EQ(fetches, 1);
+
+  EXPECT_THAT(verifier->Verify(MakeToken("RS256", "rotated-key")),
+              ResultIs(FailureExecutionResult(
+                  SC_AUTHORIZATION_SERVICE_UNKNOWN_SIGNING_KEY)));
+  EXPECT_EQ(fetches, 2);
+}
+
+TEST_F(GcpJwtVerifierTest, VerifiesTokenOfRotatedKeyOnceFetched) {
+  auto http_client = std::make_shared<MockHttpClient>();
+  // The EC key is only published by the second fetch.
+  json jwks = json::parse(jwks_);
+  json rsa_jwks = jwks;
+  rsa_jwks["keys"].erase(1);
+  std::vector<std::string> published_jwks = {rsa_jwks.dump(), jwks.dump()};
+  size_t fetches = 0;
+  http_client->perform_request_mock =
+      [&](AsyncContext<HttpRequest, HttpResponse>& context) {
+        context.response = std::make_shared<HttpResponse>();
+        context.response->body = BytesBuffer(
+            published_jwks[std::min(fetches++, published_jwks.size() - 1)]);
+        context.result = SuccessExecutionResult();
+        context.Finish();
+        return SuccessExecutionResult();
+      };
+  options_.jwks_uri = kJwksUri;
+  options_.jwks_retry_interval = std::chrono::seconds(0);
+
+  auto verifier = std::make_shared<GcpJwtVerifier>(options_, http_client);
+  EXPECT_FALSE(verifier->HasKeys());
+  auto token = MakeToken("ES256", kEcKeyId);
+  EXPECT_THAT(verifier->Verify(token),
+              ResultIs(FailureExecutionResult(
+                  SC_AUTHORIZATION_SERVICE_UNKNOWN_SIGNING_KEY)));
+  EXPECT_EQ(fetches, 2);
+
+  EXPECT_THAT(verifier->Verify(token),
+              IsSuccessfulAndHolds(Pointee(Field(&JwtClaims::email, kEmail))));
+}
+
+}  // namespace
+}  // namespace privacy_sandbox::pbs
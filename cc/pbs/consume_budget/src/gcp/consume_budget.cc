@@ -197,7 +197,7 @@ ExecutionResult BudgetConsumptionHelper::ConsumeBudgetsSyncWithBudgetConsumer(
             ? captured_execution_result
             : FailureExecutionResult(SC_CONSUME_BUDGET_FAIL_TO_COMMIT);
     if (captured_execution_result.status_code == SC_CONSUME_BUDGET_EXHAUSTED) {
-      SCP_WARNING_CONTEXT(
+      SCP_DEBUG_CONTEXT(
           kComponentName, consume_budgets_context,
           absl::StrFormat("ConsumeBudgets failed. Error code %d, message: %s, "
                           "final_execution_result: %s",
@@ -36,6 +36,8 @@ DEFINE_ERROR_CODE(SC_CONSUME_BUDGET_EXHAUSTED, SC_PBS_CONSUME_BUDGET, 0x0004,
                   "Failed to consume budget because budget is exhausted.",
                   pbs_common::HttpStatusCode::CONFLICT)
 
+MARK_AS_EXPECTED_OUTCOME(SC_CONSUME_BUDGET_EXHAUSTED)
+
 }  // namespace privacy_sandbox::pbs
 
 #endif  // CC_PBS_CONSUME_BUDGET_SRC_GCP_ERROR_CODES_H_
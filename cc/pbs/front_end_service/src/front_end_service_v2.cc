@@ -81,6 +81,9 @@ constexpr char kFrontEndService[] = "FrontEndServiceV2";
 constexpr char kTransactionLastExecutionTimestampHeader[] =
     "x-gscp-transaction-last-execution-timestamp";
 constexpr char kFakeLastExecutionTimestamp[] = "1234";
+// The lines logged per second by each error path which can log for every
+// request.
+constexpr size_t kMaxRequestErrorLogsPerSecond = 10;
 
 // Considering an estimated load of 75 keys per transaction with a standard
 // deviation of 20.
@@ -309,7 +312,7 @@ std::string FrontEndServiceV2::ObtainTransactionOrigin(
   // If transaction origin is supplied in the header use that instead. The
   // transaction origin in the header is useful if a peer coordinator is
   // resolving a transaction on behalf of a client.
-  auto request_headers = *http_context.request->headers;
+  const auto& request_headers = *http_context.request->headers;
   ExecutionResultOr<std::string> transaction_origin =
       ExtractTransactionOrigin(request_headers);
   if (transaction_origin.Successful() && !transaction_origin.value().empty()) {
@@ -376,8 +379,9 @@ ExecutionResult FrontEndServiceV2::ParseRequestWithBudgetConsumer(
                                  http_context.request->body.bytes->end());
   auto parse_status = JsonStringToMessage(request_body, &request_proto);
   if (!parse_status.ok()) {
-    SCP_INFO(kFrontEndService, kZeroUuid,
-             absl::StrCat("Failed to parse request ", parse_status.message()));
+    SCP_INFO_RATE_LIMITED(
+        kFrontEndService, kZeroUuid, kMaxRequestErrorLogsPerSecond,
+        absl::StrCat("Failed to parse request ", parse_status.message()));
     return FailureExecutionResult(
         SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST_BODY);
   }
@@ -396,22 +400,6 @@ ExecutionResult FrontEndServiceV2::PrepareTransaction(
     AsyncContext<HttpRequest, HttpResponse>& http_context) {
   SCP_DEBUG_CONTEXT(kFrontEndService, http_context,
                     "Start PrepareTransaction.");
-  const std::string reporting_origin_metric_label =
-      GetReportingOriginMetricLabel();
-
-  absl::flat_hash_map<absl::string_view, std::string> labels = {
-      {kMetricLabelTransactionPhase, kMetricLabelPrepareTransaction},
-      {kMetricLabelKeyReportingOrigin, reporting_origin_metric_label},
-      {kPbsClaimedIdentityLabel,
-       GetClaimedIdentityOrUnknownValue(http_context)},
-      {kScpHttpRequestClientVersionLabel,
-       GetUserAgentOrUnknownValue(http_context)}};
-
-  if (const std::string* auth_domain =
-          http_context.request->auth_context.authorized_domain.get();
-      auth_domain != nullptr) {
-    labels.try_emplace(kPbsAuthDomainLabel, *auth_domain);
-  }
 
   ExecutionResultOr<std::string> transaction_id =
       ExtractTransactionId(http_context);
@@ -419,11 +407,34 @@ ExecutionResult FrontEndServiceV2::PrepareTransaction(
     return transaction_id.result();
   }
 
+  // The metrics of the transaction share their labels, built once.
+  std::shared_ptr<const absl::flat_hash_map<absl::string_view, std::string>>
+      metric_labels;
+  if (metric_router_ != nullptr) {
+    absl::flat_hash_map<absl::string_view, std::string> labels = {
+        {kMetricLabelTransactionPhase, kMetricLabelPrepareTransaction},
+        {kMetricLabelKeyReportingOrigin, GetReportingOriginMetricLabel()},
+        {kPbsClaimedIdentityLabel,
+         GetClaimedIdentityOrUnknownValue(http_context)},
+        {kScpHttpRequestClientVersionLabel,
+         GetUserAgentOrUnknownValue(http_context)}};
+
+    if (const std::string* auth_domain =
+            http_context.request->auth_context.authorized_domain.get();
+        auth_domain != nullptr) {
+      labels.try_emplace(kPbsAuthDomainLabel, *auth_domain);
+    }
+    metric_labels =
+        std::make_shared<const absl::flat_hash_map<absl::string_view,
+                                                   std::string>>(
+            std::move(labels));
+  }
+
   AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse>
       consume_budget_context(
           std::make_shared<ConsumeBudgetsRequest>(),
           std::bind_front(&FrontEndServiceV2::OnConsumeBudgetCallback, this,
-                          http_context, *transaction_id),
+                          http_context, *transaction_id, metric_labels),
           http_context);
   consume_budget_context.response = std::make_shared<ConsumeBudgetsResponse>();
 
@@ -439,7 +450,12 @@ ExecutionResult FrontEndServiceV2::PrepareTransaction(
 
   if (keys_per_transaction_count_) {
     opentelemetry::context::Context context;
-    keys_per_transaction_count_->Record(key_count, labels, context);
+    keys_per_transaction_count_->Record(
+        key_count,
+        metric_router_->GetOrCreateAttributes(kKeysPerTransaction,
+                                              *metric_labels)
+            ->Get(),
+        context);
   }
   if (key_count == 0) {
     return FailureExecutionResult(SC_PBS_FRONT_END_SERVICE_NO_KEYS_AVAILABLE);
@@ -473,25 +489,10 @@ ExecutionResult FrontEndServiceV2::PrepareTransaction(
 void FrontEndServiceV2::OnConsumeBudgetCallback(
     AsyncContext<HttpRequest, HttpResponse> http_context,
     std::string transaction_id,
+    std::shared_ptr<const absl::flat_hash_map<absl::string_view, std::string>>
+        metric_labels,
     AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse>&
         consume_budget_context) {
-  const std::string reporting_origin_metric_label =
-      GetReportingOriginMetricLabel();
-
-  absl::flat_hash_map<absl::string_view, std::string> labels = {
-      {kMetricLabelTransactionPhase, kMetricLabelPrepareTransaction},
-      {kMetricLabelKeyReportingOrigin, reporting_origin_metric_label},
-      {kPbsClaimedIdentityLabel,
-       GetClaimedIdentityOrUnknownValue(http_context)},
-      {kScpHttpRequestClientVersionLabel,
-       GetUserAgentOrUnknownValue(http_context)}};
-
-  if (std::string* auth_domain =
-          http_context.request->auth_context.authorized_domain.get();
-      auth_domain != nullptr) {
-    labels.try_emplace(kPbsAuthDomainLabel, *auth_domain);
-  }
-
   const std::vector<size_t>& budget_exhausted_indices =
       consume_budget_context.response->budget_exhausted_indices;
   if (!budget_exhausted_indices.empty()) {
@@ -506,8 +507,9 @@ void FrontEndServiceV2::OnConsumeBudgetCallback(
       // diagnosis on the transaction execution errors.
       //
       // This behavior is consistent with front_end_service.cc
-      SCP_ERROR_CONTEXT(
+      SCP_ERROR_CONTEXT_RATE_LIMITED(
           kFrontEndService, http_context, serialization_execution_result,
+          kMaxRequestErrorLogsPerSecond,
           absl::StrFormat("Serialization of the transaction response failed. "
                           "transaction_id: %s.",
                           transaction_id.c_str()));
@@ -517,7 +519,9 @@ void FrontEndServiceV2::OnConsumeBudgetCallback(
   if (!consume_budget_context.result.Successful()) {
     if (consume_budget_context.result.status_code ==
         SC_CONSUME_BUDGET_EXHAUSTED) {
-      SCP_WARNING_CONTEXT(
+      // An exhausted budget is an expected outcome, which is counted rather
+      // than logged.
+      SCP_DEBUG_CONTEXT(
           kFrontEndService, http_context,
           absl::StrFormat(
               "Failed to consume budget due to budget exhausted. "
@@ -528,13 +532,18 @@ void FrontEndServiceV2::OnConsumeBudgetCallback(
       // Count number of budgets exhausted.
       if (budgets_exhausted_) {
         opentelemetry::context::Context context;
-        budgets_exhausted_->Record(budget_exhausted_indices.size(), labels,
-                                   context);
+        budgets_exhausted_->Record(
+            budget_exhausted_indices.size(),
+            metric_router_->GetOrCreateAttributes(kBudgetExhausted,
+                                                  *metric_labels)
+                ->Get(),
+            context);
       }
 
     } else {
-      SCP_ERROR_CONTEXT(
+      SCP_ERROR_CONTEXT_RATE_LIMITED(
           kFrontEndService, http_context, consume_budget_context.result,
+          kMaxRequestErrorLogsPerSecond,
           absl::StrFormat("Failed to consume budget. transaction_id: %s.",
                           transaction_id.c_str()));
     }
@@ -548,7 +557,12 @@ void FrontEndServiceV2::OnConsumeBudgetCallback(
     size_t key_count =
         consume_budget_context.request->budget_consumer->GetKeyCount();
     opentelemetry::context::Context context;
-    successful_budget_consumed_counter_->Record(key_count, labels, context);
+    successful_budget_consumed_counter_->Record(
+        key_count,
+        metric_router_->GetOrCreateAttributes(kSuccessfulBudgetConsumed,
+                                              *metric_labels)
+            ->Get(),
+        context);
   }
 
   InsertBackwardCompatibleHeaders(http_context);
@@ -18,6 +18,8 @@
 #include <memory>
 #include <string>
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
 #include "cc/core/interface/async_context.h"
 #include "cc/core/interface/async_executor_interface.h"
 #include "cc/core/interface/config_provider_interface.h"
@@ -92,6 +94,9 @@ class FrontEndServiceV2 : public FrontEndServiceInterface {
                                pbs_common::HttpResponse>
           http_context,
       std::string transaction_id,
+      std::shared_ptr<
+          const absl::flat_hash_map<absl::string_view, std::string>>
+          metric_labels,
       pbs_common::AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse>&
           consume_budget_context);
 
@@ -18,6 +18,7 @@
 
 #include <memory>
 
+#include "absl/base/nullability.h"
 #include "cc/core/interface/authorization_proxy_interface.h"
 #include "cc/core/interface/http_client_interface.h"
 #include "cc/core/interface/initializable_interface.h"
@@ -53,13 +54,14 @@ class CloudPlatformDependencyFactoryInterface
    *
    * @param async_executor
    * @param http_client
+   * @param metric_router Optional metric router for authorization metrics.
    * @return std::unique_ptr<AuthorizationProxyInterface>
    */
   virtual std::unique_ptr<pbs_common::AuthorizationProxyInterface>
   ConstructAuthorizationProxyClient(
       std::shared_ptr<pbs_common::AsyncExecutorInterface> async_executor,
-      std::shared_ptr<pbs_common::HttpClientInterface>
-          http_client) noexcept = 0;
+      std::shared_ptr<pbs_common::HttpClientInterface> http_client,
+      absl::Nullable<pbs_common::MetricRouter*> metric_router) noexcept = 0;
 
   // Constructs an AWS Client to talk to the authentication endpoint. This is
   // only used on GCP to authenticate requests that come from AWS PBS to GCP PBS
@@ -67,8 +69,8 @@ class CloudPlatformDependencyFactoryInterface
   virtual std::unique_ptr<pbs_common::AuthorizationProxyInterface>
   ConstructAwsAuthorizationProxyClient(
       std::shared_ptr<pbs_common::AsyncExecutorInterface> async_executor,
-      std::shared_ptr<pbs_common::HttpClientInterface>
-          http_client) noexcept = 0;
+      std::shared_ptr<pbs_common::HttpClientInterface> http_client,
+      absl::Nullable<pbs_common::MetricRouter*> metric_router) noexcept = 0;
 
   virtual std::unique_ptr<pbs::BudgetConsumptionHelperInterface>
   ConstructBudgetConsumptionHelper(
@@ -40,11 +40,35 @@ static constexpr char kAuthServiceEndpoint[] = "google_scp_pbs_auth_endpoint";
 // AWS PBS to GCP PBS via DNS.
 static constexpr char kAlternateAuthServiceEndpoint[] =
     "google_scp_pbs_alternate_auth_endpoint";
+// Fraction of the authorization cache entry lifetime after which a cache hit
+// re-authorizes the entry in the background.
+static constexpr char kAuthorizationCacheRefreshAheadFraction[] =
+    "google_scp_pbs_auth_cache_refresh_ahead_fraction";
+// Approximate upper bound, in bytes, of the memory held by the authorization
+// cache.
+static constexpr char kAuthorizationCacheMaxSizeBytes[] =
+    "google_scp_pbs_auth_cache_max_size_bytes";
+// Whether ID tokens are verified locally against Google's signing keys before
+// they are sent to the authorization service.
+static constexpr char kAuthJwtVerificationEnabled[] =
+    "google_scp_pbs_auth_jwt_verification_enabled";
+// Expected audience of locally verified ID tokens. Required when the local
+// verification is enabled.
+static constexpr char kAuthJwtAudience[] = "google_scp_pbs_auth_jwt_audience";
+// Endpoint of the JSON Web Key Set used for local ID token verification.
+static constexpr char kAuthJwksUri[] = "google_scp_pbs_auth_jwks_uri";
+// Local JSON Web Key Set file used for local ID token verification.
+static constexpr char kAuthJwksFilePath[] = "google_scp_pbs_auth_jwks_file_path";
 
 // Logging
 static constexpr char kEnabledLogLevels[] =
     "google_scp_core_enabled_log_levels";
 static constexpr char kLogProvider[] = "google_scp_pbs_log_provider";
+// Number of log lines buffered for a background thread to write them, rather
+// than the request threads. Lines are dropped when the buffer is full. The
+// request threads write them if unset or 0.
+static constexpr char kAsyncLogBufferSize[] =
+    "google_scp_pbs_async_log_buffer_size";
 
 // HTTP2 Server TLS context
 static constexpr char kHttp2ServerUseTls[] =
@@ -54,6 +78,56 @@ static constexpr char kHttp2ServerPrivateKeyFilePath[] =
 static constexpr char kHttp2ServerCertificateFilePath[] =
     "google_scp_pbs_http2_server_certificate_file_path";
 
+// HTTP2 Server response compression. Response bodies of at least this many
+// bytes are gzip compressed for clients accepting it. Disabled if unset or 0.
+static constexpr char kHttp2ServerResponseCompressionMinSize[] =
+    "google_scp_pbs_http2_server_response_compression_min_size";
+
+// HTTP2 Server SO_REUSEPORT listeners. When greater than 1, the server runs
+// this many listeners on its port, each with one io thread pinned to a core.
+static constexpr char kHttp2ServerReusePortListeners[] =
+    "google_scp_pbs_http2_server_reuse_port_listeners";
+
+// HTTP2 Server connection limits. Connections older than the max age, or which
+// received the max number of requests, are drained with a graceful GOAWAY so
+// that clients rebalance over the current instances. No limit if unset or 0.
+static constexpr char kHttp2ServerMaxConnectionAgeInSeconds[] =
+    "google_scp_pbs_http2_server_max_connection_age_in_seconds";
+static constexpr char kHttp2ServerMaxConnectionRequests[] =
+    "google_scp_pbs_http2_server_max_connection_requests";
+// How long the in-flight requests are given to complete on shutdown, after
+// every connection was sent a GOAWAY. Connections are closed right away if
+// unset or 0.
+static constexpr char kHttp2ServerDrainTimeoutInMillis[] =
+    "google_scp_pbs_http2_server_drain_timeout_in_millis";
+// HTTP2 Server admission control. Requests beyond the max concurrent requests
+// are rejected with 503 and a Retry-After header. No limit if unset or 0. When
+// adaptive, the limit decreases while requests are slower than the latency
+// threshold and increases back to the max otherwise.
+static constexpr char kHttp2ServerMaxConcurrentRequests[] =
+    "google_scp_pbs_http2_server_max_concurrent_requests";
+static constexpr char kHttp2ServerAdaptiveConcurrencyLimit[] =
+    "google_scp_pbs_http2_server_adaptive_concurrency_limit";
+static constexpr char kHttp2ServerAdmissionLatencyThresholdInMillis[] =
+    "google_scp_pbs_http2_server_admission_latency_threshold_in_millis";
+// HTTP2 Server TLS session tickets, rotating the ticket keys at this interval.
+// Tickets are not issued if unset or 0.
+static constexpr char kHttp2ServerTlsSessionTicketKeyRotationInSeconds[] =
+    "google_scp_pbs_http2_server_tls_session_ticket_key_rotation_in_seconds";
+// HTTP2 Client hedging of the idempotent requests, e.g. the authorization
+// requests, sent again on another connection when still in flight after this
+// delay. Not hedged if unset or 0.
+static constexpr char kHttp2ClientHedgingDelayInMillis[] =
+    "google_scp_pbs_http2_client_hedging_delay_in_millis";
+// HTTP2 Client retries, as a percentage of the requests. Not limited if unset
+// or 0.
+static constexpr char kHttp2ClientRetryBudgetPercent[] =
+    "google_scp_pbs_http2_client_retry_budget_percent";
+// HTTP2 Client consecutive failures to a host after which its requests fail
+// right away for a while. Never if unset or 0.
+static constexpr char kHttp2ClientCircuitBreakerFailureThreshold[] =
+    "google_scp_pbs_http2_client_circuit_breaker_failure_threshold";
+
 // Health service
 static constexpr char kPBSHealthServiceEnableMemoryAndStorageCheck[] =
     "google_scp_pbs_health_service_enable_mem_and_storage_check";
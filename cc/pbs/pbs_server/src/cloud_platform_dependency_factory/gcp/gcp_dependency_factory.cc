@@ -21,6 +21,7 @@
 #include <variant>
 
 #include "cc/core/authorization_proxy/src/authorization_proxy.h"
+#include "cc/core/authorization_service/src/error_codes.h"
 #include "cc/core/common/global_logger/src/global_logger.h"
 #include "cc/core/common/uuid/src/uuid.h"
 #include "cc/core/interface/configuration_keys.h"
@@ -50,19 +51,27 @@ namespace privacy_sandbox::pbs {
 using ::privacy_sandbox::pbs_common::AsyncExecutorInterface;
 using ::privacy_sandbox::pbs_common::AuthorizationProxy;
 using ::privacy_sandbox::pbs_common::AuthorizationProxyInterface;
+using ::privacy_sandbox::pbs_common::AuthorizationProxyOptions;
 using ::privacy_sandbox::pbs_common::ConfigProviderInterface;
 using ::privacy_sandbox::pbs_common::ExecutionResult;
 using ::privacy_sandbox::pbs_common::ExecutionResultOr;
+using ::privacy_sandbox::pbs_common::FailureExecutionResult;
 using ::privacy_sandbox::pbs_common::GcpTokenFetcher;
 using ::privacy_sandbox::pbs_common::GetConfigValue;
+using ::privacy_sandbox::pbs_common::GetOtlpGrpcMetricExporterOptions;
+using ::privacy_sandbox::pbs_common::GetOtlpMetricExportLimits;
 using ::privacy_sandbox::pbs_common::GrpcAuthConfig;
 using ::privacy_sandbox::pbs_common::GrpcIdTokenAuthenticator;
 using ::privacy_sandbox::pbs_common::HttpClientInterface;
 using ::privacy_sandbox::pbs_common::kAlternateCloudServiceRegion;
+using ::privacy_sandbox::pbs_common::kDefaultAuthorizationCacheMaxSizeBytes;
+using ::privacy_sandbox::pbs_common::
+    kDefaultAuthorizationCacheRefreshAheadFraction;
 using ::privacy_sandbox::pbs_common::kHttpServerDnsRoutingEnabled;
 using ::privacy_sandbox::pbs_common::kZeroUuid;
 using ::privacy_sandbox::pbs_common::MetricRouter;
 using ::privacy_sandbox::pbs_common::OtlpGrpcAuthedMetricExporter;
+using ::privacy_sandbox::pbs_common::SC_AUTHORIZATION_SERVICE_INVALID_CONFIG;
 using ::privacy_sandbox::pbs_common::SuccessExecutionResult;
 using ::privacy_sandbox::pbs_common::TimeDuration;
 
@@ -129,27 +138,65 @@ ExecutionResult GcpDependencyFactory::ReadConfigurations() {
     }
   }
 
+  auth_cache_refresh_ahead_fraction_ = GetConfigValue(
+      std::string(kAuthorizationCacheRefreshAheadFraction),
+      kDefaultAuthorizationCacheRefreshAheadFraction, *config_provider_);
+  auth_cache_max_size_bytes_ =
+      GetConfigValue(std::string(kAuthorizationCacheMaxSizeBytes),
+                     kDefaultAuthorizationCacheMaxSizeBytes, *config_provider_);
+
+  auth_jwt_verification_enabled_ = GetConfigValue(
+      std::string(kAuthJwtVerificationEnabled), false, *config_provider_);
+  jwt_verifier_options_.audience = GetConfigValue(
+      std::string(kAuthJwtAudience), std::string(), *config_provider_);
+  if (auth_jwt_verification_enabled_ &&
+      jwt_verifier_options_.audience.empty()) {
+    execution_result =
+        FailureExecutionResult(SC_AUTHORIZATION_SERVICE_INVALID_CONFIG);
+    SCP_CRITICAL(kGcpDependencyProvider, kZeroUuid, execution_result,
+                 "The JWT audience must be set to verify tokens locally.");
+    return execution_result;
+  }
+  jwt_verifier_options_.jwks_uri =
+      GetConfigValue(std::string(kAuthJwksUri), std::string(kGoogleJwksUri),
+                     *config_provider_);
+  jwt_verifier_options_.jwks_file_path = GetConfigValue(
+      std::string(kAuthJwksFilePath), std::string(), *config_provider_);
+
   return SuccessExecutionResult();
 }
 
 std::unique_ptr<AuthorizationProxyInterface>
 GcpDependencyFactory::ConstructAuthorizationProxyClient(
     std::shared_ptr<AsyncExecutorInterface> async_executor,
-    std::shared_ptr<HttpClientInterface> http_client) noexcept {
+    std::shared_ptr<HttpClientInterface> http_client,
+    absl::Nullable<MetricRouter*> metric_router) noexcept {
+  std::shared_ptr<GcpJwtVerifier> jwt_verifier;
+  if (auth_jwt_verification_enabled_) {
+    jwt_verifier =
+        std::make_shared<GcpJwtVerifier>(jwt_verifier_options_, http_client);
+  }
   return std::make_unique<AuthorizationProxy>(
       auth_service_endpoint_, async_executor, http_client,
       std::make_unique<GcpHttpRequestResponseAuthInterceptor>(
-          config_provider_));
+          config_provider_, std::move(jwt_verifier)),
+      AuthorizationProxyOptions(auth_cache_refresh_ahead_fraction_,
+                                auth_cache_max_size_bytes_),
+      metric_router);
 }
 
 std::unique_ptr<AuthorizationProxyInterface>
 GcpDependencyFactory::ConstructAwsAuthorizationProxyClient(
     std::shared_ptr<AsyncExecutorInterface> async_executor,
-    std::shared_ptr<HttpClientInterface> http_client) noexcept {
+    std::shared_ptr<HttpClientInterface> http_client,
+    absl::Nullable<MetricRouter*> metric_router) noexcept {
   return std::make_unique<AuthorizationProxy>(
       alternate_auth_service_endpoint_, async_executor, http_client,
       std::make_unique<AwsHttpRequestResponseAuthInterceptor>(
-          alternate_cloud_service_region_, config_provider_));
+          alternate_cloud_service_region_, config_provider_),
+      AuthorizationProxyOptions(auth_cache_refresh_ahead_fraction_,
+                                auth_cache_max_size_bytes_),
+      metric_router);
 }
 
 std::unique_ptr<pbs::BudgetConsumptionHelperInterface>
@@ -209,21 +256,16 @@ std::unique_ptr<MetricRouter> GcpDependencyFactory::ConstructMetricRouter(
         std::make_unique<GrpcIdTokenAuthenticator>(
             std::move(metric_auth_config), std::move(metric_token_fetcher));
 
-    const std::string exporter_path =
-        GetConfigValue(std::string(pbs_common::kOtelExporterOtlpEndpointKey),
-                       std::string(pbs_common::kOtelExporterOtlpEndpointValue),
-                       *config_provider_);
+    auto exporter = std::make_unique<OtlpGrpcAuthedMetricExporter>(
+        GetOtlpGrpcMetricExporterOptions(*config_provider_),
+        std::move(metric_id_token_authenticator),
+        GetOtlpMetricExportLimits(*config_provider_));
+    OtlpGrpcAuthedMetricExporter* authed_exporter = exporter.get();
 
-    opentelemetry::exporter::otlp::OtlpGrpcMetricExporterOptions
-        exporter_options;
-    exporter_options.endpoint = exporter_path;
-
-    std::unique_ptr<opentelemetry::sdk::metrics::PushMetricExporter> exporter =
-        std::make_unique<OtlpGrpcAuthedMetricExporter>(
-            exporter_options, std::move(metric_id_token_authenticator));
-
-    return std::make_unique<MetricRouter>(config_provider_, std::move(resource),
-                                          std::move(exporter));
+    auto metric_router = std::make_unique<MetricRouter>(
+        config_provider_, std::move(resource), std::move(exporter));
+    authed_exporter->RegisterMetrics(*metric_router);
+    return metric_router;
   } else if (exporter_config == "googlecloud") {
     SCP_INFO(kGcpDependencyProvider, kZeroUuid,
              "Using value: " + exporter_config +
@@ -19,7 +19,9 @@
 #include <memory>
 #include <string>
 
+#include "cc/core/authorization_proxy/src/authorization_proxy.h"
 #include "cc/core/interface/async_executor_interface.h"
+#include "cc/pbs/authorization/src/gcp/gcp_jwt_verifier.h"
 #include "cc/pbs/interface/cloud_platform_dependency_factory_interface.h"
 #include "opentelemetry/sdk/resource/resource.h"
 
@@ -35,13 +37,15 @@ class GcpDependencyFactory : public CloudPlatformDependencyFactoryInterface {
   std::unique_ptr<pbs_common::AuthorizationProxyInterface>
   ConstructAuthorizationProxyClient(
       std::shared_ptr<pbs_common::AsyncExecutorInterface> async_executor,
-      std::shared_ptr<pbs_common::HttpClientInterface> http_client) noexcept
+      std::shared_ptr<pbs_common::HttpClientInterface> http_client,
+      absl::Nullable<pbs_common::MetricRouter*> metric_router) noexcept
       override;
 
   std::unique_ptr<pbs_common::AuthorizationProxyInterface>
   ConstructAwsAuthorizationProxyClient(
       std::shared_ptr<pbs_common::AsyncExecutorInterface> async_executor,
-      std::shared_ptr<pbs_common::HttpClientInterface> http_client) noexcept
+      std::shared_ptr<pbs_common::HttpClientInterface> http_client,
+      absl::Nullable<pbs_common::MetricRouter*> metric_router) noexcept
       override;
 
   std::unique_ptr<pbs::BudgetConsumptionHelperInterface>
@@ -67,6 +71,12 @@ class GcpDependencyFactory : public CloudPlatformDependencyFactoryInterface {
   std::string auth_service_endpoint_;
   std::string alternate_auth_service_endpoint_;
   std::string alternate_cloud_service_region_;
+  double auth_cache_refresh_ahead_fraction_ =
+      pbs_common::kDefaultAuthorizationCacheRefreshAheadFraction;
+  size_t auth_cache_max_size_bytes_ =
+      pbs_common::kDefaultAuthorizationCacheMaxSizeBytes;
+  bool auth_jwt_verification_enabled_ = false;
+  GcpJwtVerifierOptions jwt_verifier_options_;
 };
 
 }  // namespace privacy_sandbox::pbs
@@ -58,14 +58,16 @@ ExecutionResult LocalDependencyFactory::ReadConfigurations() {
 std::unique_ptr<AuthorizationProxyInterface>
 LocalDependencyFactory::ConstructAuthorizationProxyClient(
     std::shared_ptr<AsyncExecutorInterface> async_executor,
-    std::shared_ptr<HttpClientInterface> http_client) noexcept {
+    std::shared_ptr<HttpClientInterface> http_client,
+    absl::Nullable<MetricRouter*> metric_router) noexcept {
   return std::make_unique<LocalAuthorizationProxy>();
 }
 
 std::unique_ptr<AuthorizationProxyInterface>
 LocalDependencyFactory::ConstructAwsAuthorizationProxyClient(
     std::shared_ptr<AsyncExecutorInterface> async_executor,
-    std::shared_ptr<HttpClientInterface> http_client) noexcept {
+    std::shared_ptr<HttpClientInterface> http_client,
+    absl::Nullable<MetricRouter*> metric_router) noexcept {
   return nullptr;
 }
 
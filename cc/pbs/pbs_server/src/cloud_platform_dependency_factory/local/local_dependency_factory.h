@@ -34,13 +34,15 @@ class LocalDependencyFactory : public CloudPlatformDependencyFactoryInterface {
   std::unique_ptr<pbs_common::AuthorizationProxyInterface>
   ConstructAuthorizationProxyClient(
       std::shared_ptr<pbs_common::AsyncExecutorInterface> async_executor,
-      std::shared_ptr<pbs_common::HttpClientInterface> http_client) noexcept
+      std::shared_ptr<pbs_common::HttpClientInterface> http_client,
+      absl::Nullable<pbs_common::MetricRouter*> metric_router) noexcept
       override;
 
   std::unique_ptr<pbs_common::AuthorizationProxyInterface>
   ConstructAwsAuthorizationProxyClient(
       std::shared_ptr<pbs_common::AsyncExecutorInterface> async_executor,
-      std::shared_ptr<pbs_common::HttpClientInterface> http_client) noexcept
+      std::shared_ptr<pbs_common::HttpClientInterface> http_client,
+      absl::Nullable<pbs_common::MetricRouter*> metric_router) noexcept
       override;
 
   std::unique_ptr<pbs::BudgetConsumptionHelperInterface>
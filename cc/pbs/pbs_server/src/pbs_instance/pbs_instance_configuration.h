@@ -59,6 +59,35 @@ struct PBSInstanceConfig {
   bool http2_server_use_tls = false;
   std::shared_ptr<std::string> http2_server_private_key_file_path;
   std::shared_ptr<std::string> http2_server_certificate_file_path;
+
+  // Minimum size of the HTTP2 Server responses to compress, 0 if disabled.
+  size_t http2_server_response_compression_min_size = 0;
+
+  // Number of HTTP2 Server SO_REUSEPORT listeners, a single listener if 0.
+  size_t http2_server_reuse_port_listeners = 0;
+
+  // HTTP2 Server connection limits and shutdown drain timeout, 0 if disabled.
+  size_t http2_server_max_connection_age_in_seconds = 0;
+  size_t http2_server_max_connection_requests = 0;
+  size_t http2_server_drain_timeout_in_millis = 0;
+
+  // HTTP2 Server admission control, disabled if the max is 0. The latency
+  // threshold of the adaptive limit keeps its default if 0.
+  size_t http2_server_max_concurrent_requests = 0;
+  bool http2_server_adaptive_concurrency_limit = false;
+  size_t http2_server_admission_latency_threshold_in_millis = 0;
+
+  // HTTP2 Server TLS session tickets, disabled if 0.
+  size_t http2_server_tls_session_ticket_key_rotation_in_seconds = 0;
+
+  // HTTP2 Client hedging of the idempotent requests, disabled if 0.
+  size_t http2_client_hedging_delay_in_millis = 0;
+
+  // HTTP2 Client retry budget, in percent of the requests, disabled if 0.
+  size_t http2_client_retry_budget_percent = 0;
+
+  // HTTP2 Client circuit breaker failure threshold, disabled if 0.
+  size_t http2_client_circuit_breaker_failure_threshold = 0;
 };
 
 /**
@@ -177,6 +206,90 @@ GetPBSInstanceConfigFromConfigProvider(
           SC_PBS_INVALID_HTTP2_SERVER_CERT_FILE_PATH);
     }
   }
+
+  // Response compression is optional, and stays disabled if the key is unset.
+  if (!config_provider
+           ->Get(kHttp2ServerResponseCompressionMinSize,
+                 pbs_instance_config.http2_server_response_compression_min_size)
+           .Successful()) {
+    pbs_instance_config.http2_server_response_compression_min_size = 0;
+  }
+
+  // A single listener shared by all the io threads is used if the key is unset.
+  if (!config_provider
+           ->Get(kHttp2ServerReusePortListeners,
+                 pbs_instance_config.http2_server_reuse_port_listeners)
+           .Successful()) {
+    pbs_instance_config.http2_server_reuse_port_listeners = 0;
+  }
+
+  // Connection limits and draining are optional, and disabled if unset.
+  if (!config_provider
+           ->Get(kHttp2ServerMaxConnectionAgeInSeconds,
+                 pbs_instance_config.http2_server_max_connection_age_in_seconds)
+           .Successful()) {
+    pbs_instance_config.http2_server_max_connection_age_in_seconds = 0;
+  }
+  if (!config_provider
+           ->Get(kHttp2ServerMaxConnectionRequests,
+                 pbs_instance_config.http2_server_max_connection_requests)
+           .Successful()) {
+    pbs_instance_config.http2_server_max_connection_requests = 0;
+  }
+  if (!config_provider
+           ->Get(kHttp2ServerDrainTimeoutInMillis,
+                 pbs_instance_config.http2_server_drain_timeout_in_millis)
+           .Successful()) {
+    pbs_instance_config.http2_server_drain_timeout_in_millis = 0;
+  }
+
+  // Admission control is optional, and disabled if unset.
+  if (!config_provider
+           ->Get(kHttp2ServerMaxConcurrentRequests,
+                 pbs_instance_config.http2_server_max_concurrent_requests)
+           .Successful()) {
+    pbs_instance_config.http2_server_max_concurrent_requests = 0;
+  }
+  if (!config_provider
+           ->Get(kHttp2ServerAdaptiveConcurrencyLimit,
+                 pbs_instance_config.http2_server_adaptive_concurrency_limit)
+           .Successful()) {
+    pbs_instance_config.http2_server_adaptive_concurrency_limit = false;
+  }
+  if (!config_provider
+           ->Get(kHttp2ServerAdmissionLatencyThresholdInMillis,
+                 pbs_instance_config
+                     .http2_server_admission_latency_threshold_in_millis)
+           .Successful()) {
+    pbs_instance_config.http2_server_admission_latency_threshold_in_millis = 0;
+  }
+  if (!config_provider
+           ->Get(kHttp2ServerTlsSessionTicketKeyRotationInSeconds,
+                 pbs_instance_config
+                     .http2_server_tls_session_ticket_key_rotation_in_seconds)
+           .Successful()) {
+    pbs_instance_config
+        .http2_server_tls_session_ticket_key_rotation_in_seconds = 0;
+  }
+  if (!config_provider
+           ->Get(kHttp2ClientHedgingDelayInMillis,
+                 pbs_instance_config.http2_client_hedging_delay_in_millis)
+           .Successful()) {
+    pbs_instance_config.http2_client_hedging_delay_in_millis = 0;
+  }
+  if (!config_provider
+           ->Get(kHttp2ClientRetryBudgetPercent,
+                 pbs_instance_config.http2_client_retry_budget_percent)
+           .Successful()) {
+    pbs_instance_config.http2_client_retry_budget_percent = 0;
+  }
+  if (!config_provider
+           ->Get(kHttp2ClientCircuitBreakerFailureThreshold,
+                 pbs_instance_config
+                     .http2_client_circuit_breaker_failure_threshold)
+           .Successful()) {
+    pbs_instance_config.http2_client_circuit_breaker_failure_threshold = 0;
+  }
   return pbs_instance_config;
 }
 }  // namespace privacy_sandbox::pbs
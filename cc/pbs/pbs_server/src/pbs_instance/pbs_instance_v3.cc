@@ -14,6 +14,7 @@
 
 #include "cc/pbs/pbs_server/src/pbs_instance/pbs_instance_v3.h"
 
+#include <chrono>
 #include <memory>
 #include <string>
 #include <utility>
@@ -42,8 +43,14 @@ using ::privacy_sandbox::pbs_common::Http2Server;
 using ::privacy_sandbox::pbs_common::Http2ServerOptions;
 using ::privacy_sandbox::pbs_common::HttpClient;
 using ::privacy_sandbox::pbs_common::HttpClientOptions;
+using ::privacy_sandbox::pbs_common::kDefaultHttp2ReadTimeoutInSeconds;
+using ::privacy_sandbox::pbs_common::kDefaultMaxConnectionsPerHost;
+using ::privacy_sandbox::pbs_common::kDefaultRetryStrategyDelayInMs;
+using ::privacy_sandbox::pbs_common::kDefaultRetryStrategyMaxRetries;
 using ::privacy_sandbox::pbs_common::kZeroUuid;
 using ::privacy_sandbox::pbs_common::PassThruAuthorizationProxy;
+using ::privacy_sandbox::pbs_common::RetryStrategyOptions;
+using ::privacy_sandbox::pbs_common::RetryStrategyType;
 using ::privacy_sandbox::pbs_common::SuccessExecutionResult;
 
 PBSInstanceV3::PBSInstanceV3(
@@ -93,12 +100,24 @@ ExecutionResult PBSInstanceV3::CreateComponents() noexcept {
   io_async_executor_ = std::make_shared<AsyncExecutor>(
       pbs_instance_config_.io_async_executor_thread_pool_size,
       pbs_instance_config_.io_async_executor_queue_size);
+  // Jittered, so that the requests failing together do not retry together.
+  HttpClientOptions http2_client_options(
+      RetryStrategyOptions(RetryStrategyType::ExponentialWithEqualJitter,
+                           kDefaultRetryStrategyDelayInMs,
+                           kDefaultRetryStrategyMaxRetries),
+      kDefaultMaxConnectionsPerHost, kDefaultHttp2ReadTimeoutInSeconds);
+  http2_client_options.hedging.delay_in_ms =
+      pbs_instance_config_.http2_client_hedging_delay_in_millis;
+  http2_client_options.retry_budget.ratio =
+      pbs_instance_config_.http2_client_retry_budget_percent / 100.0;
+  http2_client_options.circuit_breaker.failure_threshold =
+      pbs_instance_config_.http2_client_circuit_breaker_failure_threshold;
   http2_client_ = std::make_shared<HttpClient>(
-      async_executor_, HttpClientOptions(), metric_router_.get());
+      async_executor_, http2_client_options, metric_router_.get());
 
   authorization_proxy_ =
       cloud_platform_dependency_factory_->ConstructAuthorizationProxyClient(
-          async_executor_, http2_client_);
+          async_executor_, http2_client_, metric_router_.get());
 
   pass_thru_authorization_proxy_ =
       std::make_shared<PassThruAuthorizationProxy>();
@@ -107,10 +126,34 @@ ExecutionResult PBSInstanceV3::CreateComponents() noexcept {
       pbs_instance_config_.http2_server_use_tls,
       pbs_instance_config_.http2_server_private_key_file_path,
       pbs_instance_config_.http2_server_certificate_file_path);
+  http2_server_options.response_compression_min_size =
+      pbs_instance_config_.http2_server_response_compression_min_size;
+  http2_server_options.reuse_port_listeners =
+      pbs_instance_config_.http2_server_reuse_port_listeners;
+  http2_server_options.max_connection_age_seconds =
+      pbs_instance_config_.http2_server_max_connection_age_in_seconds;
+  http2_server_options.max_connection_requests =
+      pbs_instance_config_.http2_server_max_connection_requests;
+  http2_server_options.drain_timeout_ms =
+      pbs_instance_config_.http2_server_drain_timeout_in_millis;
+  http2_server_options.admission_control.max_concurrent_requests =
+      pbs_instance_config_.http2_server_max_concurrent_requests;
+  http2_server_options.admission_control.adaptive =
+      pbs_instance_config_.http2_server_adaptive_concurrency_limit;
+  if (pbs_instance_config_.http2_server_admission_latency_threshold_in_millis >
+      0) {
+    http2_server_options.admission_control.latency_threshold =
+        std::chrono::milliseconds(
+            pbs_instance_config_
+                .http2_server_admission_latency_threshold_in_millis);
+  }
+  http2_server_options.tls_session_ticket_key_rotation_seconds =
+      pbs_instance_config_
+          .http2_server_tls_session_ticket_key_rotation_in_seconds;
 
   std::shared_ptr<AuthorizationProxyInterface> aws_authorization_proxy =
       cloud_platform_dependency_factory_->ConstructAwsAuthorizationProxyClient(
-          async_executor_, http2_client_);
+          async_executor_, http2_client_, metric_router_.get());
   http_server_ = std::make_shared<Http2Server>(
       *pbs_instance_config_.host_address, *pbs_instance_config_.host_port,
       pbs_instance_config_.http2server_thread_pool_size, async_executor_,
@@ -25,6 +25,7 @@
 #include "absl/log/check.h"
 #include "cc/core/common/global_logger/src/global_logger.h"
 #include "cc/core/config_provider/src/env_config_provider.h"
+#include "cc/core/logger/src/log_providers/async/async_log_provider.h"
 #include "cc/core/logger/src/log_providers/stdout/stdout_log_provider.h"
 #include "cc/core/logger/src/log_providers/syslog/syslog_log_provider.h"
 #include "cc/core/logger/src/log_utils.h"
@@ -44,6 +45,8 @@ namespace {
 
 using ::privacy_sandbox::pbs::CloudPlatformDependencyFactoryInterface;
 using ::privacy_sandbox::pbs::PBSInstanceV3;
+using ::privacy_sandbox::pbs_common::AsyncLogProvider;
+using ::privacy_sandbox::pbs_common::AsyncLogProviderOptions;
 using ::privacy_sandbox::pbs_common::ConfigProviderInterface;
 using ::privacy_sandbox::pbs_common::EnvConfigProvider;
 using ::privacy_sandbox::pbs_common::ExecutionResultOr;
@@ -53,6 +56,7 @@ using ::privacy_sandbox::pbs_common::Logger;
 using ::privacy_sandbox::pbs_common::LoggerInterface;
 using ::privacy_sandbox::pbs_common::LogLevel;
 using ::privacy_sandbox::pbs_common::LogLevelFromString;
+using ::privacy_sandbox::pbs_common::LogProviderInterface;
 using ::privacy_sandbox::pbs_common::ServiceInterface;
 using ::privacy_sandbox::pbs_common::StdoutLogProvider;
 using ::privacy_sandbox::pbs_common::SuccessExecutionResult;
@@ -161,17 +165,28 @@ int main(int argc, char** argv) {
     GlobalLogger::SetGlobalLogLevels(log_levels);
   }
 
-  std::unique_ptr<LoggerInterface> logger_ptr;
+  std::unique_ptr<LogProviderInterface> log_provider_ptr;
   if (std::string log_provider;
       config_provider->Get(privacy_sandbox::pbs::kLogProvider, log_provider)
           .Successful() &&
       log_provider == kStdoutLogProvider) {
-    logger_ptr =
-        std::make_unique<Logger>(std::make_unique<StdoutLogProvider>());
+    log_provider_ptr = std::make_unique<StdoutLogProvider>();
   } else {
-    logger_ptr =
-        std::make_unique<Logger>(std::make_unique<SyslogLogProvider>());
+    log_provider_ptr = std::make_unique<SyslogLogProvider>();
   }
+  if (size_t async_log_buffer_size = 0;
+      config_provider
+          ->Get(privacy_sandbox::pbs::kAsyncLogBufferSize,
+                async_log_buffer_size)
+          .Successful() &&
+      async_log_buffer_size > 0) {
+    AsyncLogProviderOptions async_log_provider_options;
+    async_log_provider_options.capacity = async_log_buffer_size;
+    log_provider_ptr = std::make_unique<AsyncLogProvider>(
+        std::move(log_provider_ptr), async_log_provider_options);
+  }
+  std::unique_ptr<LoggerInterface> logger_ptr =
+      std::make_unique<Logger>(std::move(log_provider_ptr));
   if (!logger_ptr->Init().Successful()) {
     throw std::runtime_error("Cannot initialize logger.");
   }
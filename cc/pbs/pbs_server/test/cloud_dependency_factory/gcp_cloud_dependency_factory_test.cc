@@ -20,6 +20,7 @@
 #include <memory>
 
 #include "cc/core/async_executor/src/async_executor.h"
+#include "cc/core/authorization_service/src/error_codes.h"
 #include "cc/core/config_provider/mock/mock_config_provider.h"
 #include "cc/core/http2_client/mock/mock_http_client.h"
 #include "cc/core/interface/async_executor_interface.h"
@@ -34,6 +35,7 @@ namespace {
 using ::privacy_sandbox::pbs_common::AsyncExecutor;
 using ::privacy_sandbox::pbs_common::AsyncExecutorInterface;
 using ::privacy_sandbox::pbs_common::ExecutionResult;
+using ::privacy_sandbox::pbs_common::FailureExecutionResult;
 using ::privacy_sandbox::pbs_common::kCloudServiceRegion;
 using ::privacy_sandbox::pbs_common::kGcpProjectId;
 using ::privacy_sandbox::pbs_common::kSpannerDatabase;
@@ -41,6 +43,7 @@ using ::privacy_sandbox::pbs_common::kSpannerInstance;
 using ::privacy_sandbox::pbs_common::MockConfigProvider;
 using ::privacy_sandbox::pbs_common::MockHttpClient;
 using ::privacy_sandbox::pbs_common::ResultIs;
+using ::privacy_sandbox::pbs_common::SC_AUTHORIZATION_SERVICE_INVALID_CONFIG;
 using ::privacy_sandbox::pbs_common::SuccessExecutionResult;
 
 class GcpCloudDependencyFactoryTest : public ::testing::Test {
@@ -84,12 +87,24 @@ class GcpCloudDependencyFactoryTest : public ::testing::Test {
 
 TEST_F(GcpCloudDependencyFactoryTest, ConstructAuthorizationProxyClient) {
   auto proxy = gcp_factory_.ConstructAuthorizationProxyClient(
-      async_executor1_, mock_http_client_);
+      async_executor1_, mock_http_client_, /*metric_router=*/nullptr);
   EXPECT_THAT(proxy->Init(), ResultIs(SuccessExecutionResult()));
   EXPECT_THAT(proxy->Run(), ResultIs(SuccessExecutionResult()));
   EXPECT_THAT(proxy->Stop(), ResultIs(SuccessExecutionResult()));
 }
 
+TEST_F(GcpCloudDependencyFactoryTest,
+       InitFailsIfJwtVerificationEnabledWithoutAudience) {
+  mock_config_provider_->SetBool(kAuthJwtVerificationEnabled, true);
+  GcpDependencyFactory gcp_factory(mock_config_provider_);
+  EXPECT_THAT(gcp_factory.Init(),
+              ResultIs(FailureExecutionResult(
+                  SC_AUTHORIZATION_SERVICE_INVALID_CONFIG)));
+
+  mock_config_provider_->Set(kAuthJwtAudience, "https://pbs.example.com");
+  EXPECT_THAT(gcp_factory.Init(), ResultIs(SuccessExecutionResult()));
+}
+
 TEST_F(GcpCloudDependencyFactoryTest, ConstructBudgetConsumptionHelper) {
   auto helper = gcp_factory_.ConstructBudgetConsumptionHelper(
       async_executor1_.get(), async_executor2_.get());